@@ -272,6 +272,21 @@ int alice(Firebird::UtilSvc* uSvc)
 			}
 		}
 
+		if (table->in_sw_value & sw_parallel)
+		{
+			if (--argc <= 0) {
+				ALICE_error(137);	// msg 137: number of parallel workers required
+			}
+			ALICE_upper_case(*argv++, string, sizeof(string));
+			if (!(tdgbl->ALICE_data.ua_parallel_workers = atoi(string)))
+			{
+				ALICE_error(7);	// msg 7: numeric value required
+			}
+			if (tdgbl->ALICE_data.ua_parallel_workers < 0) {
+				ALICE_error(114);	// msg 114: positive or zero numeric value required
+			}
+		}
+
 		if (table->in_sw_value & sw_housekeeping)
 		{
 			if (--argc <= 0) {
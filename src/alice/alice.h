@@ -87,6 +87,7 @@ struct user_action
 	SLONG ua_sweep_interval;
 	TraNumber ua_transaction;
 	SLONG ua_page_buffers;
+	SLONG ua_parallel_workers;
 	USHORT ua_debug;
 	ULONG ua_val_errors[MAX_VAL_ERRORS];
 	//TEXT ua_log_file[MAXPATHLEN];
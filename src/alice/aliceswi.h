@@ -65,6 +65,7 @@ const SINT64 sw_nolinger		= QUADCONST(0x0000001000000000);
 const SINT64 sw_icu				= QUADCONST(0x0000002000000000);
 const SINT64 sw_role			= QUADCONST(0x0000004000000000);
 const SINT64 sw_replica			= QUADCONST(0x0000008000000000);
+const SINT64 sw_parallel		= QUADCONST(0x0000010000000000);
 
 
 enum alice_switches
@@ -121,7 +122,8 @@ enum alice_switches
 	IN_SW_ALICE_NOLINGER			=	47,
 	IN_SW_ALICE_ICU					=	48,
 	IN_SW_ALICE_ROLE				=	49,
-	IN_SW_ALICE_REPLICA				=	50
+	IN_SW_ALICE_REPLICA				=	50,
+	IN_SW_ALICE_PARALLEL			=	51
 };
 
 static const char* const ALICE_SW_ASYNC	= "ASYNC";
@@ -200,6 +202,9 @@ static const Switches::in_sw_tab_t alice_in_sw_table[] =
 	{IN_SW_ALICE_ONLINE, isc_spb_prp_db_online, "ONLINE", sw_online,
 		0, 0, false, true, 40, 1	, NULL},
 	// msg 40: \t-online\t\tdatabase online
+	{IN_SW_ALICE_PARALLEL, isc_spb_rpr_par_workers, "PARALLEL", sw_parallel,
+		sw_sweep, 0, false, false, 136, 3, NULL},
+	// msg 136: -par(allel) parallel workers <n> (-sweep)
 	{IN_SW_ALICE_PROMPT, 0, "PROMPT", sw_prompt,
 		sw_list, 0, false, false, 41, 2, NULL},
 	// msg 41: \t-prompt\t\tprompt for commit/rollback (-l)
@@ -227,7 +232,7 @@ static const Switches::in_sw_tab_t alice_in_sw_table[] =
 		0, 0, false, false, 111, 2, NULL},
 	// msg 111: \t-SQL_dialect\t\set dataabse dialect n
 	{IN_SW_ALICE_SWEEP, isc_spb_rpr_sweep_db, "SWEEP", sw_sweep,
-		0, ~(sw_sweep | sw_user | sw_password | sw_nolinger | sw_role), false, true, 45, 2, NULL},
+		0, ~(sw_sweep | sw_user | sw_password | sw_nolinger | sw_role | sw_parallel), false, true, 45, 2, NULL},
 	// msg 45: \t-sweep\t\tforce garbage collection
 	{IN_SW_ALICE_SHUT, isc_spb_prp_shutdown_mode, "SHUTDOWN", sw_shut,
 		0, ~(sw_shut | sw_attach | sw_cache | sw_force | sw_tran | sw_user | sw_password | sw_role),
@@ -203,8 +203,11 @@ static void buildDpb(Firebird::ClumpletWriter& dpb, const SINT64 switches)
 	dpb.insertTag(isc_dpb_gfix_attach);
 	tdgbl->uSvc->fillDpb(dpb);
 
-	if (switches & sw_sweep) {
+	if (switches & sw_sweep)
+	{
 		dpb.insertByte(isc_dpb_sweep, isc_dpb_records);
+		if (switches & sw_parallel)
+			dpb.insertInt(isc_dpb_parallel_workers, tdgbl->ALICE_data.ua_parallel_workers);
 	}
 	else if (switches & sw_activate) {
 		dpb.insertTag(isc_dpb_activate_shadow);
@@ -716,6 +716,21 @@ int gbak(Firebird::UtilSvc* uSvc)
 				// msg 259 expected page buffers, encountered "%s"
 			}
 			break;
+		case IN_SW_BURP_PARALLEL:
+			if (tdgbl->gbl_sw_parallel_workers)
+				BURP_error(333, true, SafeArg() << in_sw_tab->in_sw_name << tdgbl->gbl_sw_parallel_workers);
+			if (++itr >= argc)
+			{
+				BURP_error(404, true);
+				// msg 404 parallel workers parameter missing
+			}
+			tdgbl->gbl_sw_parallel_workers = get_number(argv[itr]);
+			if (tdgbl->gbl_sw_parallel_workers <= 0)
+			{
+				BURP_error(405, true, argv[itr]);
+				// msg 405 expected parallel workers, encountered "%s"
+			}
+			break;
 		case IN_SW_BURP_MODE:
 			if (tdgbl->gbl_sw_mode)
 			{
@@ -1350,6 +1365,9 @@ int gbak(Firebird::UtilSvc* uSvc)
 	tdgbl->action->act_file = NULL;
 	tdgbl->action->act_action = ACT_unknown;
 
+	// Worker attachments of parallel backup use the same parameters
+	tdgbl->gbl_dpb_data.assign(dpb.getBuffer(), dpb.getBufferLength());
+
 	action = open_files(file1, &file2, sw_replace, dpb);
 
 	MVOL_init(tdgbl->io_buffer_size);
@@ -1466,6 +1484,14 @@ void BURP_abort()
  *
  **************************************/
 	BurpGlobals* tdgbl = BurpGlobals::getSpecific();
+
+	// Failure of a worker thread is reported by the main one
+	if (tdgbl->gbl_worker)
+	{
+		BURP_exit_local(FINI_ERROR, tdgbl);
+		return;
+	}
+
 	USHORT code = tdgbl->action && tdgbl->action->act_action == ACT_backup_fini ? 351 : 83;
 	// msg 351 Error closing database, but backup file is OK
 	// msg 83 Exiting before completion due to errors
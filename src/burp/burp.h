@@ -274,6 +274,7 @@ enum att_type {
 	att_relation_ext_file_name, // name of file for external tables
 	att_relation_type,
 	att_relation_sql_security,
+	att_relation_codec,
 
 	// Field attributes (used for both global and local fields)
 
@@ -914,6 +915,7 @@ const FB_UINT64 MIN_SPLIT_SIZE	= FB_CONST64(2048);		// bytes
 // Global switches and data
 
 struct BurpCrypt;
+class RestoreWorkers;
 
 
 class GblPool
@@ -946,6 +948,7 @@ public:
 		: ThreadData(ThreadData::tddGBL),
 		  GblPool(us->isService()),
 		  defaultCollations(getPool()),
+		  gbl_dpb_data(getPool()),
 		  uSvc(us),
 		  verboseInterval(10000),
 		  flag_on_line(true),
@@ -1003,6 +1006,7 @@ public:
 	const SCHAR*	gbl_sw_password;
 	SLONG		gbl_sw_skip_count;
 	SLONG		gbl_sw_page_buffers;
+	SLONG		gbl_sw_parallel_workers;
 	burp_fil*	gbl_sw_files;
 	burp_fil*	gbl_sw_backup_files;
 	gfld*		gbl_global_fields;
@@ -1012,6 +1016,7 @@ public:
 	ULONG		io_buffer_size;
 	redirect_vals	sw_redirect;
 	bool		burp_throw;
+	bool		gbl_worker;		// thread of parallel backup, errors are reported by the main one
 
 	UCHAR*		blk_io_ptr;
 	int			blk_io_cnt;
@@ -1039,6 +1044,7 @@ public:
 #endif
 	UCHAR*		gbl_io_ptr;
 	int			gbl_io_cnt;
+	Firebird::UCharBuffer*	gbl_io_chunk;	// output of a backup worker, written instead of the file
 	UCHAR*		gbl_compress_buffer;
 	UCHAR*		gbl_crypt_buffer;
 	ULONG		gbl_crypt_left;
@@ -1074,6 +1080,7 @@ public:
 	Firebird::IAttachment*	db_handle;
 	Firebird::ITransaction*	tr_handle;
 	Firebird::ITransaction*	global_trans;
+	RestoreWorkers*	gbl_restore_workers;
 	DESC		file_desc;
 	int			exit_code;
 	UCHAR*		head_of_mem_list;
@@ -1116,6 +1123,7 @@ public:
 	Firebird::IRequest*	handles_get_ref_constraint_req_handle1;
 	Firebird::IRequest*	handles_get_rel_constraint_req_handle1;
 	Firebird::IRequest*	handles_get_relation_req_handle1;
+	Firebird::IRequest*	handles_get_relation_req_handle2;
 	Firebird::IRequest*	handles_get_security_class_req_handle1;
 	Firebird::IRequest*	handles_get_sql_roles_req_handle1;
 	Firebird::IRequest*	handles_get_trigger_message_req_handle1;
@@ -1128,6 +1136,7 @@ public:
 	Firebird::IRequest*	handles_get_view_req_handle1;
 
 	// The handles_put.. are for backup.
+	Firebird::IRequest*	handles_put_data_req_handle1;
 	Firebird::IRequest*	handles_put_index_req_handle1;
 	Firebird::IRequest*	handles_put_index_req_handle2;
 	Firebird::IRequest*	handles_put_index_req_handle3;
@@ -1170,6 +1179,7 @@ public:
 
 	Firebird::Array<Firebird::Pair<Firebird::NonPooled<Firebird::MetaName, Firebird::MetaName> > >
 		defaultCollations;
+	Firebird::UCharBuffer gbl_dpb_data;	// parameters of the database attachment
 	Firebird::UtilSvc* uSvc;
 	ULONG verboseInterval;	// How many records should be backed up or restored before we show this message
 	bool flag_on_line;		// indicates whether we will bring the database on-line
@@ -98,6 +98,8 @@ const int IN_SW_BURP_CRYPT				= 51;	// name of crypt plugin
 
 const int IN_SW_BURP_INCLUDE_DATA		= 52;	// backup data from tables
 
+const int IN_SW_BURP_PARALLEL			= 53;	// parallel workers for data and index creation
+
 /**************************************************************************/
 
 static const char* const BURP_SW_MODE_RO = "READ_ONLY";
@@ -162,6 +164,8 @@ static const Switches::in_sw_tab_t reference_burp_in_sw_table[] =
 				// msg 186: @1OLD_DESCRIPTIONS save old style metadata descriptions
 	{IN_SW_BURP_P,	isc_spb_res_page_size,		"PAGE_SIZE",		0, 0, 0, false, false,	101,	1, NULL, boRestore},
 				// msg 101: @1PAGE_SIZE override default page size
+	{IN_SW_BURP_PARALLEL, isc_spb_bkp_parallel_workers, "PARALLEL", 0, 0, 0, false, false,	403,	3, NULL, boGeneral},
+				// msg 403: @1PAR(ALLEL) parallel workers
 	{IN_SW_BURP_PASS, 0,						"PASSWORD", 		0, 0, 0, false, false,	190,	3, NULL, boGeneral},
 				// msg 190: @1PA(SSWORD) Firebird password
 	{IN_SW_BURP_RECREATE, 0,					"RECREATE_DATABASE", 0, 0, 0, false, false,	284,	1, NULL, boMain},
@@ -88,6 +88,7 @@ static const UCHAR*	mvol_write_block(BurpGlobals*, const UCHAR*, ULONG);
 static FB_UINT64 mvol_fini_write(BurpGlobals*, int*, UCHAR**);
 static void	 mvol_init_write(BurpGlobals*, const char*, int*, UCHAR**);
 static void	 brio_fini(BurpGlobals*);
+static void	 write_io_buffer(BurpGlobals*);
 
 static const int MAX_HEADER_SIZE		= 512;
 static const int ZC_BUFSIZE				= IO_BUFFER_SIZE;
@@ -672,6 +673,29 @@ void MVOL_init(ULONG io_buf_size)
 }
 
 
+//____________________________________________________________
+//
+// Make a worker of parallel backup write its output to tdgbl->gbl_io_chunk,
+// the chunks are passed to the backup file by the main thread.
+//
+void MVOL_init_chunk(BurpGlobals* tdgbl)
+{
+	fb_assert(tdgbl->gbl_io_chunk);
+
+	tdgbl->gbl_compress_buffer = FB_NEW_POOL(tdgbl->getPool()) UCHAR[ZC_BUFSIZE];
+	tdgbl->gbl_io_cnt = ZC_BUFSIZE;
+	tdgbl->gbl_io_ptr = tdgbl->gbl_compress_buffer;
+}
+
+
+void MVOL_fini_chunk(BurpGlobals* tdgbl)
+{
+	delete[] tdgbl->gbl_compress_buffer;
+	tdgbl->gbl_compress_buffer = NULL;
+	tdgbl->gbl_io_chunk = NULL;
+}
+
+
 static void brio_fini(BurpGlobals* tdgbl)
 {
 	delete[] tdgbl->gbl_compress_buffer;
@@ -1090,12 +1114,23 @@ void MVOL_write(BurpGlobals* tdgbl)
 	fb_assert(tdgbl->gbl_io_ptr >= tdgbl->gbl_compress_buffer);
 	fb_assert(tdgbl->gbl_io_ptr <= tdgbl->gbl_compress_buffer + ZC_BUFSIZE);
 
-	zip_write_block(tdgbl, tdgbl->gbl_compress_buffer, tdgbl->gbl_io_ptr - tdgbl->gbl_compress_buffer, false);
+	write_io_buffer(tdgbl);
 
 	tdgbl->gbl_io_cnt = ZC_BUFSIZE;
 	tdgbl->gbl_io_ptr = tdgbl->gbl_compress_buffer;
 }
 
+// Pass the IO buffer down to the compressor, or to the chunk of a backup worker
+static void write_io_buffer(BurpGlobals* tdgbl)
+{
+	const ULONG length = tdgbl->gbl_io_ptr - tdgbl->gbl_compress_buffer;
+
+	if (tdgbl->gbl_io_chunk)
+		tdgbl->gbl_io_chunk->add(tdgbl->gbl_compress_buffer, length);
+	else
+		zip_write_block(tdgbl, tdgbl->gbl_compress_buffer, length, false);
+}
+
 UCHAR mvol_write(const UCHAR c, int* io_cnt, UCHAR** io_ptr)
 {
 	const UCHAR* ptr;
@@ -1322,7 +1357,7 @@ const UCHAR* MVOL_write_block(BurpGlobals* tdgbl, const UCHAR* ptr, ULONG count)
 		// If buffer full, write it
 		if (tdgbl->gbl_io_cnt <= 0)
 		{
-			zip_write_block(tdgbl, tdgbl->gbl_compress_buffer, tdgbl->gbl_io_ptr - tdgbl->gbl_compress_buffer, false);
+			write_io_buffer(tdgbl);
 
 			tdgbl->gbl_io_ptr = tdgbl->gbl_compress_buffer;
 			tdgbl->gbl_io_cnt = ZC_BUFSIZE;
@@ -73,4 +73,33 @@ void ZLib::freeFunc(void*, void* address)
 	MemoryPool::globalFree(address);
 }
 
+ZStd::ZStd(Firebird::MemoryPool&)
+{
+#ifdef WIN_NT
+	Firebird::PathName name("libzstd.dll");
+#else
+	Firebird::PathName name("libzstd." SHRLIB_EXT ".1");
+#endif
+	z.reset(ModuleLoader::fixAndLoadModule(status, name));
+	if (z)
+		symbols();
+}
+
+void ZStd::symbols()
+{
+#define FB_ZSYMB(A) z->findSymbol(status, "ZSTD_" STRINGIZE(A), A); if (!A) { z.reset(NULL); return; }
+	FB_ZSYMB(createCStream)
+	FB_ZSYMB(freeCStream)
+	FB_ZSYMB(initCStream)
+	FB_ZSYMB(compressStream)
+	FB_ZSYMB(flushStream)
+	FB_ZSYMB(createDStream)
+	FB_ZSYMB(freeDStream)
+	FB_ZSYMB(initDStream)
+	FB_ZSYMB(decompressStream)
+	FB_ZSYMB(isError)
+	FB_ZSYMB(maxCLevel)
+#undef FB_ZSYMB
+}
+
 #endif // HAVE_ZLIB_H
@@ -59,6 +59,53 @@ namespace Firebird {
 
 		void symbols();
 	};
+
+	// Streaming API of zstd library. It's a part of the stable zstd API since
+	// version 1.0, declared here to not depend on zstd.h at build time.
+	class ZStd
+	{
+	public:
+		struct CStream;
+		struct DStream;
+
+		struct InBuffer
+		{
+			const void* src;
+			size_t size;
+			size_t pos;
+		};
+
+		struct OutBuffer
+		{
+			void* dst;
+			size_t size;
+			size_t pos;
+		};
+
+		explicit ZStd(Firebird::MemoryPool&);
+
+		CStream* (*createCStream)();
+		size_t (*freeCStream)(CStream* zcs);
+		size_t (*initCStream)(CStream* zcs, int compressionLevel);
+		size_t (*compressStream)(CStream* zcs, OutBuffer* output, InBuffer* input);
+		size_t (*flushStream)(CStream* zcs, OutBuffer* output);
+		DStream* (*createDStream)();
+		size_t (*freeDStream)(DStream* zds);
+		size_t (*initDStream)(DStream* zds);
+		size_t (*decompressStream)(DStream* zds, OutBuffer* output, InBuffer* input);
+		unsigned (*isError)(size_t code);
+		int (*maxCLevel)();
+
+		operator bool() { return z.hasData(); }
+		bool operator!() { return !z.hasData(); }
+
+		ISC_STATUS_ARRAY status;
+
+	private:
+		AutoPtr<ModuleLoader::Module> z;
+
+		void symbols();
+	};
 }
 #endif // HAVE_ZLIB_H
 
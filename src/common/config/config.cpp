@@ -230,7 +230,20 @@ const Config::ConfigEntry Config::entries[MAX_CONFIG_KEY] =
 	{TYPE_INTEGER,		"TipCacheBlockSize",		(ConfigValue) 4194304}, // bytes
 	{TYPE_BOOLEAN,		"ReadConsistency",			(ConfigValue) true},
 	{TYPE_BOOLEAN,		"ClearGTTAtRetaining",		(ConfigValue) false},
-	{TYPE_STRING,		"DataTypeCompatibility",	(ConfigValue) NULL}
+	{TYPE_STRING,		"DataTypeCompatibility",	(ConfigValue) NULL},
+	{TYPE_INTEGER,		"ReadAheadWindow",			(ConfigValue) 64},		// pages
+	{TYPE_STRING,		"IOBackend",				(ConfigValue) "Sync"},
+	{TYPE_INTEGER,		"DbCachePartitions",		(ConfigValue) 0},		// auto
+	{TYPE_STRING,		"CachePolicy",				(ConfigValue) "LRU"},
+	{TYPE_INTEGER,		"ParallelWorkers",			(ConfigValue) 1},
+	{TYPE_INTEGER,		"MaxParallelWorkers",		(ConfigValue) 64},
+	{TYPE_INTEGER,		"HashAggregateMemory",		(ConfigValue) 16777216},	// bytes
+	{TYPE_INTEGER,		"MaxInlineBlobSize",		(ConfigValue) 16384},	// bytes
+	{TYPE_STRING,		"WireCompressionCodec",		(ConfigValue) "Zstd"},
+	{TYPE_INTEGER,		"WireCompressionLevel",		(ConfigValue) 0},		// codec default
+	{TYPE_INTEGER,		"StatementCacheSize",		(ConfigValue) 100},		// statements
+	{TYPE_INTEGER,		"GroupCommitDelay",			(ConfigValue) 0},		// ms
+	{TYPE_INTEGER,		"UserTraceLogBuffer",		(ConfigValue) 0}		// KB
 };
 
 /******************************************************************************
@@ -706,6 +719,12 @@ FB_UINT64 Config::getMaxUserTraceLogSize()
 	return (FB_UINT64)(SINT64) getDefaultConfig()->values[KEY_MAX_TRACELOG_SIZE];
 }
 
+ULONG Config::getUserTraceLogBuffer()
+{
+	const SINT64 rc = (SINT64) getDefaultConfig()->values[KEY_USER_TRACE_LOG_BUFFER];
+	return rc < 0 ? 0 : (rc > 1024 * 1024 ? 1024 * 1024 : (ULONG) rc);
+}
+
 int Config::getServerMode()
 {
 	static int rc = -1;
@@ -951,3 +970,88 @@ const char* Config::getDataTypeCompatibility() const
 {
 	return get<const char*>(KEY_DATA_TYPE_COMPATIBILITY);
 }
+
+ULONG Config::getReadAheadWindow() const
+{
+	const SINT64 rc = get<SINT64>(KEY_READ_AHEAD_WINDOW);
+	return rc < 0 ? 0 : (ULONG) rc;
+}
+
+int Config::getIOBackend() const
+{
+	const char* textMode = get<const char*>(KEY_IO_BACKEND);
+
+	if (textMode && fb_utils::stricmp(textMode, "IoUring") == 0)
+		return IO_BACKEND_IO_URING;
+
+	return IO_BACKEND_SYNC;
+}
+
+ULONG Config::getDbCachePartitions() const
+{
+	const SINT64 rc = get<SINT64>(KEY_DB_CACHE_PARTITIONS);
+	return rc < 0 ? 0 : (ULONG) rc;
+}
+
+int Config::getCachePolicy() const
+{
+	const char* textMode = get<const char*>(KEY_CACHE_POLICY);
+
+	if (textMode && fb_utils::stricmp(textMode, "2Q") == 0)
+		return CACHE_POLICY_2Q;
+
+	return CACHE_POLICY_LRU;
+}
+
+ULONG Config::getParallelWorkers() const
+{
+	const SINT64 rc = get<SINT64>(KEY_PARALLEL_WORKERS);
+	return rc < 1 ? 1 : (rc > 64 ? 64 : (ULONG) rc);
+}
+
+ULONG Config::getMaxParallelWorkers() const
+{
+	const SINT64 rc = get<SINT64>(KEY_MAX_PARALLEL_WORKERS);
+	return rc < 1 ? 1 : (rc > 64 ? 64 : (ULONG) rc);
+}
+
+ULONG Config::getHashAggregateMemory() const
+{
+	const SINT64 rc = get<SINT64>(KEY_HASH_AGGREGATE_MEMORY);
+	return rc < 0 ? 0 : (rc > MAX_ULONG ? MAX_ULONG : (ULONG) rc);
+}
+
+ULONG Config::getMaxInlineBlobSize() const
+{
+	// Inline blobs are buffered by the client the same way as blob segments
+	const SINT64 rc = get<SINT64>(KEY_MAX_INLINE_BLOB_SIZE);
+	return rc < 0 ? 0 : (rc > MAX_USHORT ? MAX_USHORT : (ULONG) rc);
+}
+
+int Config::getWireCompressionCodec() const
+{
+	const char* textCodec = get<const char*>(KEY_WIRE_COMPRESSION_CODEC);
+
+	if (textCodec && fb_utils::stricmp(textCodec, "Zlib") == 0)
+		return WIRE_COMPRESS_ZLIB;
+
+	return WIRE_COMPRESS_ZSTD;
+}
+
+int Config::getWireCompressionLevel() const
+{
+	// Range of the level is checked by the codec
+	return (int) get<SINT64>(KEY_WIRE_COMPRESSION_LEVEL);
+}
+
+ULONG Config::getStatementCacheSize() const
+{
+	const SINT64 rc = get<SINT64>(KEY_STATEMENT_CACHE_SIZE);
+	return rc < 0 ? 0 : (rc > MAX_USHORT ? MAX_USHORT : (ULONG) rc);
+}
+
+int Config::getGroupCommitDelay() const
+{
+	const int rc = get<int>(KEY_GROUP_COMMIT_DELAY);
+	return rc < -1 ? -1 : (rc > 1000 ? 1000 : rc);
+}
@@ -79,6 +79,15 @@ const int MODE_SUPER = 0;
 const int MODE_SUPERCLASSIC = 1;
 const int MODE_CLASSIC = 2;
 
+const int IO_BACKEND_SYNC = 0;
+const int IO_BACKEND_IO_URING = 1;
+
+const int CACHE_POLICY_LRU = 0;
+const int CACHE_POLICY_2Q = 1;
+
+const int WIRE_COMPRESS_ZLIB = 0;
+const int WIRE_COMPRESS_ZSTD = 1;
+
 const char* const CONFIG_FILE = "firebird.conf";
 
 class Config : public Firebird::RefCounted, public Firebird::GlobalStorage
@@ -156,6 +165,19 @@ public:
 		KEY_READ_CONSISTENCY,
 		KEY_CLEAR_GTT_RETAINING,
 		KEY_DATA_TYPE_COMPATIBILITY,
+		KEY_READ_AHEAD_WINDOW,
+		KEY_IO_BACKEND,
+		KEY_DB_CACHE_PARTITIONS,
+		KEY_CACHE_POLICY,
+		KEY_PARALLEL_WORKERS,
+		KEY_MAX_PARALLEL_WORKERS,
+		KEY_HASH_AGGREGATE_MEMORY,
+		KEY_MAX_INLINE_BLOB_SIZE,
+		KEY_WIRE_COMPRESSION_CODEC,
+		KEY_WIRE_COMPRESSION_LEVEL,
+		KEY_STATEMENT_CACHE_SIZE,
+		KEY_GROUP_COMMIT_DELAY,
+		KEY_USER_TRACE_LOG_BUFFER,
 		MAX_CONFIG_KEY		// keep it last
 	};
 
@@ -353,6 +375,9 @@ public:
 
 	static FB_UINT64 getMaxUserTraceLogSize();
 
+	// Size in KB of the shared memory ring buffer of user trace sessions, 0 means log files
+	static ULONG getUserTraceLogBuffer();
+
 	static int getServerMode();
 
 	const char* getPlugins(unsigned int type) const;
@@ -393,6 +418,42 @@ public:
 	bool getClearGTTAtRetaining() const;
 
 	const char* getDataTypeCompatibility() const;
+
+	// Number of pages the cache reader prefetches ahead of sequential scans
+	ULONG getReadAheadWindow() const;
+
+	// Method used to pass page writes to the operating system
+	int getIOBackend() const;
+
+	// Number of independently locked page cache partitions, 0 - choose automatically
+	ULONG getDbCachePartitions() const;
+
+	// Page cache buffers replacement policy
+	int getCachePolicy() const;
+
+	// Number of threads a single sort, index creation or sweep may use
+	ULONG getParallelWorkers() const;
+
+	// Upper limit for the above, including values requested by attachments
+	ULONG getMaxParallelWorkers() const;
+
+	// Memory a single hash aggregation may use before spilling, 0 disables hash aggregation
+	ULONG getHashAggregateMemory() const;
+
+	// Max size of a blob sent to the client together with the fetched row, 0 disables inline blobs
+	ULONG getMaxInlineBlobSize() const;
+
+	// Codec the client asks for when wire compression is on
+	int getWireCompressionCodec() const;
+
+	// Compression level of the data sent over the wire, 0 - codec default
+	int getWireCompressionLevel() const;
+
+	// Number of released statements an attachment keeps prepared, 0 disables the cache
+	ULONG getStatementCacheSize() const;
+
+	// Milliseconds a commit waits for others to flush pages together, -1 disables group commit
+	int getGroupCommitDelay() const;
 };
 
 // Implementation of interface to access master configuration file
@@ -129,6 +129,7 @@ static const TOK tokens[] =
 	{TOK_COMMITTED, "COMMITTED", true},
 	{TOK_COMMON, "COMMON", true},
 	{TOK_COMPARE_DECFLOAT, "COMPARE_DECFLOAT", true},
+	{TOK_COMPRESSION, "COMPRESSION", true},
 	{TOK_COMPUTED, "COMPUTED", true},
 	{TOK_CONDITIONAL, "CONDITIONAL", true},
 	{TOK_CONNECT, "CONNECT", false},
@@ -350,6 +351,7 @@ static const TOK tokens[] =
 	{TOK_PAGE, "PAGE", true},
 	{TOK_PAGES, "PAGES", true},
 	{TOK_PAGE_SIZE, "PAGE_SIZE", true},
+	{TOK_PARALLEL, "PARALLEL", true},
 	{TOK_PARAMETER, "PARAMETER", false},
 	{TOK_PARTITION, "PARTITION", true},
 	{TOK_PASSWORD, "PASSWORD", true},
@@ -533,6 +535,7 @@ static const TOK tokens[] =
 	{TOK_WITH, "WITH", false},
 	{TOK_WITHOUT, "WITHOUT", false},
 	{TOK_WORK, "WORK", true},
+	{TOK_WORKERS, "WORKERS", true},
 	{TOK_WRITE, "WRITE", true},
 	{TOK_YEAR, "YEAR", false},
 	{TOK_YEARDAY, "YEARDAY", true},
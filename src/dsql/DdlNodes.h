@@ -1311,7 +1311,8 @@ public:
 			TYPE_DROP_COLUMN,
 			TYPE_DROP_CONSTRAINT,
 			TYPE_ALTER_SQL_SECURITY,
-			TYPE_ALTER_PUBLICATION
+			TYPE_ALTER_PUBLICATION,
+			TYPE_ALTER_RECORD_CODEC
 		};
 
 		explicit Clause(MemoryPool& p, Type aType)
@@ -1553,6 +1554,7 @@ public:
 	Firebird::Array<NestConst<Clause> > clauses;
 	Nullable<bool> ssDefiner;
 	Nullable<bool> replicationState;
+	Firebird::MetaName recordCodec;
 };
 
 
@@ -1822,6 +1824,33 @@ public:
 };
 
 
+class SetTableStatisticsNode : public DdlNode
+{
+public:
+	SetTableStatisticsNode(MemoryPool& p, const Firebird::MetaName& aName)
+		: DdlNode(p),
+		  name(p, aName),
+		  columns(NULL)
+	{
+	}
+
+public:
+	virtual Firebird::string internalPrint(NodePrinter& printer) const;
+	virtual void checkPermission(thread_db* tdbb, jrd_tra* transaction);
+	virtual void execute(thread_db* tdbb, DsqlCompilerScratch* dsqlScratch, jrd_tra* transaction);
+
+protected:
+	virtual void putErrorPrefix(Firebird::Arg::StatusVector& statusVector)
+	{
+		statusVector << Firebird::Arg::Gds(isc_dsql_alter_table_failed) << name;
+	}
+
+public:
+	Firebird::MetaName name;
+	NestConst<ValueListNode> columns;
+};
+
+
 class DropIndexNode : public DdlNode
 {
 public:
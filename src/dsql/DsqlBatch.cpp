@@ -26,8 +26,10 @@
 
 #include "../jrd/EngineInterface.h"
 #include "../jrd/jrd.h"
+#include "../jrd/tra.h"
 #include "../jrd/status.h"
 #include "../jrd/exe_proto.h"
+#include "../jrd/btr.h"
 #include "../dsql/dsql.h"
 #include "../dsql/errd_proto.h"
 #include "../common/classes/ClumpletReader.h"
@@ -58,6 +60,21 @@ namespace {
 	private:
 		thread_db* m_tdbb;
 	};
+
+	// Rows stored by the batch miss their index entries until the keys are flushed,
+	// so a transaction which failed to flush them may only be rolled back
+	void flushKeys(thread_db* tdbb, DeferredIndexKeys* keys, jrd_tra* transaction)
+	{
+		try
+		{
+			keys->flush(tdbb, transaction);
+		}
+		catch (const Exception&)
+		{
+			transaction->tra_flags |= TRA_invalidated;
+			throw;
+		}
+	}
 }
 
 DsqlBatch::DsqlBatch(dsql_req* req, const dsql_msg* /*message*/, IMessageMetadata* inMeta, ClumpletReader& pb)
@@ -660,99 +677,133 @@ private:
 	const dsql_msg* message = m_request->getStatement()->getSendMsg();
 	bool startRequest = true;
 
+	// bulk load the rows of a plain insert: keys of non-unique indices are collected
+	// and merged into the indices in key order when all messages are sent
+	AutoPtr<DeferredIndexKeys> deferredKeys;
+	if (m_request->getStatement()->getType() == DsqlCompiledStatement::TYPE_INSERT)
+	{
+		jrd_rel* const relation = DeferredIndexKeys::getTarget(req->getStatement());
+		if (relation)
+			deferredKeys = FB_NEW_POOL(m_request->getPool()) DeferredIndexKeys(m_request->getPool(), relation);
+	}
+	AutoSetRestore<DeferredIndexKeys*> deferredFlag(&req->req_deferred_keys, deferredKeys);
+
 	// process messages
 	ULONG remains;
 	UCHAR* data;
-	while ((remains = m_messages.get(&data)) > 0)
+	try
 	{
-		if (remains < m_messageSize)
-		{
-			ERRD_post(Arg::Gds(isc_sqlerr) << Arg::Num(-104) <<
-				Arg::Gds(isc_batch_blob_buf) <<
-				Arg::Gds(isc_batch_small_data) << "messages");
-		}
-
-		while (remains >= m_messageSize)
+		while ((remains = m_messages.get(&data)) > 0)
 		{
-			if (startRequest)
+			if (remains < m_messageSize)
 			{
-				EXE_unwind(tdbb, req);
-				EXE_start(tdbb, req, transaction);
-				startRequest = false;
+				ERRD_post(Arg::Gds(isc_sqlerr) << Arg::Num(-104) <<
+					Arg::Gds(isc_batch_blob_buf) <<
+					Arg::Gds(isc_batch_small_data) << "messages");
 			}
 
-			// skip alignment data
-			UCHAR* alignedData = FB_ALIGN(data, m_alignment);
-			if (alignedData != data)
+			while (remains >= m_messageSize)
 			{
-				remains -= (alignedData - data);
-				data = alignedData;
-				continue;
-			}
-
-			// translate blob IDs
-			fb_assert(intptr_t(data) % m_alignment == 0);
-			for (unsigned i = 0; i < m_blobMeta.getCount(); ++i)
-			{
-				const SSHORT* nullFlag = reinterpret_cast<const SSHORT*>(&data[m_blobMeta[i].nullOffset]);
-				if (*nullFlag)
-					continue;
+				if (startRequest)
+				{
+					EXE_unwind(tdbb, req);
+					EXE_start(tdbb, req, transaction);
+					startRequest = false;
+				}
 
-				ISC_QUAD* id = reinterpret_cast<ISC_QUAD*>(&data[m_blobMeta[i].offset]);
-				if (id->gds_quad_high == 0 && id->gds_quad_low == 0)
+				// skip alignment data
+				UCHAR* alignedData = FB_ALIGN(data, m_alignment);
+				if (alignedData != data)
+				{
+					remains -= (alignedData - data);
+					data = alignedData;
 					continue;
+				}
 
-				ISC_QUAD newId;
-				if (!m_blobMap.get(*id, newId))
+				// translate blob IDs
+				fb_assert(intptr_t(data) % m_alignment == 0);
+				for (unsigned i = 0; i < m_blobMeta.getCount(); ++i)
 				{
-					ERRD_post(Arg::Gds(isc_sqlerr) << Arg::Num(-104) <<
-						Arg::Gds(isc_batch_blob_id) << Arg::Quad(id));
-				}
+					const SSHORT* nullFlag = reinterpret_cast<const SSHORT*>(&data[m_blobMeta[i].nullOffset]);
+					if (*nullFlag)
+						continue;
 
-				m_blobMap.remove(*id);
-				*id = newId;
-			}
+					ISC_QUAD* id = reinterpret_cast<ISC_QUAD*>(&data[m_blobMeta[i].offset]);
+					if (id->gds_quad_high == 0 && id->gds_quad_low == 0)
+						continue;
 
-			// map message to internal engine format
-			m_request->mapInOut(tdbb, false, message, m_meta, NULL, data);
-			data += m_messageSize;
-			remains -= m_messageSize;
+					ISC_QUAD newId;
+					if (!m_blobMap.get(*id, newId))
+					{
+						ERRD_post(Arg::Gds(isc_sqlerr) << Arg::Num(-104) <<
+							Arg::Gds(isc_batch_blob_id) << Arg::Quad(id));
+					}
 
-			UCHAR* msgBuffer = m_request->req_msg_buffers[message->msg_buffer_number];
-			try
-			{
-				// runsend data to request and collect stats
-				ULONG before = req->req_records_inserted + req->req_records_updated +
-					req->req_records_deleted;
-				EXE_send(tdbb, req, message->msg_number, message->msg_length, msgBuffer);
-				ULONG after = req->req_records_inserted + req->req_records_updated +
-					req->req_records_deleted;
-				completionState->regUpdate(after - before);
-			}
-			catch (const Exception& ex)
-			{
-				FbLocalStatus status;
-				ex.stuffException(&status);
-				tdbb->tdbb_status_vector->init();
+					m_blobMap.remove(*id);
+					*id = newId;
+				}
 
-				JTransliterate trLit(tdbb);
-				completionState->regError(&status, &trLit);
+				// map message to internal engine format
+				m_request->mapInOut(tdbb, false, message, m_meta, NULL, data);
+				data += m_messageSize;
+				remains -= m_messageSize;
 
-				if (!(m_flags & (1 << IBatch::TAG_MULTIERROR)))
+				UCHAR* msgBuffer = m_request->req_msg_buffers[message->msg_buffer_number];
+				try
 				{
-					cancel(tdbb);
-					remains = 0;
-					break;
+					// runsend data to request and collect stats
+					ULONG before = req->req_records_inserted + req->req_records_updated +
+						req->req_records_deleted;
+					EXE_send(tdbb, req, message->msg_number, message->msg_length, msgBuffer);
+					ULONG after = req->req_records_inserted + req->req_records_updated +
+						req->req_records_deleted;
+					completionState->regUpdate(after - before);
+
+					if (deferredKeys)
+						deferredKeys->accept();
 				}
+				catch (const Exception& ex)
+				{
+					if (deferredKeys)
+						deferredKeys->discard();
+
+					FbLocalStatus status;
+					ex.stuffException(&status);
+					tdbb->tdbb_status_vector->init();
 
-				startRequest = true;
+					JTransliterate trLit(tdbb);
+					completionState->regError(&status, &trLit);
+
+					if (!(m_flags & (1 << IBatch::TAG_MULTIERROR)))
+					{
+						cancel(tdbb);
+						remains = 0;
+						break;
+					}
+
+					startRequest = true;
+				}
+
+				if (deferredKeys && deferredKeys->isFull())
+					flushKeys(tdbb, deferredKeys, transaction);
 			}
+
+			UCHAR* alignedData = FB_ALIGN(data, m_alignment);
+			m_messages.remained(remains, alignedData - data);
 		}
+	}
+	catch (const Exception&)
+	{
+		// rows stored before the failure stay in the transaction, so should their keys
+		if (deferredKeys && !(transaction->tra_flags & TRA_invalidated))
+			flushKeys(tdbb, deferredKeys, transaction);
 
-		UCHAR* alignedData = FB_ALIGN(data, m_alignment);
-		m_messages.remained(remains, alignedData - data);
+		throw;
 	}
 
+	if (deferredKeys)
+		flushKeys(tdbb, deferredKeys, transaction);
+
 	DEB_BATCH(fprintf(stderr, "Sent %d messages\n", completionState->getSize(tdbb->tdbb_status_vector)));
 
 	// make sure all blobs were used in messages
@@ -84,6 +84,9 @@ void DsqlCursor::close(thread_db* tdbb, DsqlCursor* cursor)
 				trace.fetch(true, ITracePlugin::RESULT_SUCCESS);
 			}
 
+			// The cursor is closed before it was fetched completely
+			request->accountLatency();
+
 			if (request->req_traced && TraceManager::need_dsql_free(attachment))
 			{
 				TraceSQLStatementImpl stmt(request, NULL);
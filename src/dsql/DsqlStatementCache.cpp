@@ -0,0 +1,151 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird Project
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#include "firebird.h"
+#include "../dsql/DsqlStatementCache.h"
+#include "../dsql/dsql.h"
+#include "../jrd/jrd.h"
+#include "../jrd/req.h"
+#include "../jrd/jrd_proto.h"
+
+using namespace Firebird;
+using namespace Jrd;
+
+
+// Make the cache key of a statement text prepared with the given options.
+void DsqlStatementCache::makeKey(string& key, ULONG length, const TEXT* text,
+	USHORT dialect, bool isInternalRequest)
+{
+	key.reserve(length + 2);
+	key.assign(1, (char) dialect);
+	key.append(1, isInternalRequest ? '1' : '0');
+	key.append(text, length);
+}
+
+
+// Take the statement prepared with the given key out of the cache.
+dsql_req* DsqlStatementCache::get(const string& key)
+{
+	dsql_req* request = NULL;
+
+	if (!map.get(key, request))
+	{
+		misses++;
+		return NULL;
+	}
+
+	map.remove(key);
+
+	FB_SIZE_T pos;
+	if (order.find(request, pos))
+		order.remove(pos);
+
+	hits++;
+	return request;
+}
+
+
+// Keep the released request prepared for the next prepare of the same text.
+// Returns false if the request can't be cached and should be destroyed.
+bool DsqlStatementCache::put(thread_db* tdbb, dsql_req* request, ULONG maxCount)
+{
+	if (!maxCount || request->req_cache_key.isEmpty() || map.exist(request->req_cache_key))
+		return false;
+
+	const DsqlCompiledStatement* const statement = request->getStatement();
+
+	switch (statement->getType())
+	{
+		case DsqlCompiledStatement::TYPE_SELECT:
+		case DsqlCompiledStatement::TYPE_SELECT_UPD:
+		case DsqlCompiledStatement::TYPE_INSERT:
+		case DsqlCompiledStatement::TYPE_DELETE:
+		case DsqlCompiledStatement::TYPE_UPDATE:
+		case DsqlCompiledStatement::TYPE_EXEC_PROCEDURE:
+		case DsqlCompiledStatement::TYPE_EXEC_BLOCK:
+		case DsqlCompiledStatement::TYPE_SELECT_BLOCK:
+			break;
+
+		default:
+			return false;
+	}
+
+	// Positioned updates and the cursors they refer to depend on each other
+
+	if (statement->getParentRequest() || request->cursors.hasData() || !request->req_request)
+		return false;
+
+	request->reset(tdbb);
+
+	if (request->req_request->req_flags & req_active)
+	{
+		ThreadStatusGuard status_vector(tdbb);
+
+		try
+		{
+			JRD_unwind_request(tdbb, request->req_request);
+		}
+		catch (const Exception&)
+		{
+			return false;
+		}
+	}
+
+	// Nothing below may wait, otherwise an AST could purge the cache in between
+
+	while (order.getCount() >= maxCount)
+	{
+		dsql_req* const oldest = order[0];
+		order.remove((FB_SIZE_T) 0);
+		map.remove(oldest->req_cache_key);
+
+		release(tdbb, oldest);
+	}
+
+	map.put(request->req_cache_key, request);
+	order.add(request);
+
+	return true;
+}
+
+
+// Release all cached requests. Called when somebody needs the objects they use.
+void DsqlStatementCache::purge(thread_db* tdbb)
+{
+	if (order.isEmpty())
+		return;
+
+	// Releasing a request may deliver ASTs which purge the cache again
+
+	HalfStaticArray<dsql_req*, 16> requests(*tdbb->getDefaultPool());
+	requests.add(order.begin(), order.getCount());
+
+	order.clear();
+	map.clear();
+
+	for (dsql_req** iter = requests.begin(); iter != requests.end(); ++iter)
+		release(tdbb, *iter);
+}
+
+
+void DsqlStatementCache::release(thread_db* tdbb, dsql_req* request)
+{
+	Jrd::ContextPoolHolder context(tdbb, &request->getPool());
+	dsql_req::destroy(tdbb, request, true);
+}
@@ -0,0 +1,75 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird Project
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#ifndef DSQL_STATEMENT_CACHE_H
+#define DSQL_STATEMENT_CACHE_H
+
+#include "../common/classes/alloc.h"
+#include "../common/classes/array.h"
+#include "../common/classes/fb_string.h"
+#include "../common/classes/GenericMap.h"
+
+namespace Jrd {
+
+class dsql_req;
+class thread_db;
+
+// Prepared DML statements released by the user. A statement prepared again
+// with the same text and options is taken from here instead of being parsed
+// and compiled. The cache belongs to the attachment, cached statements keep
+// their existence locks and are purged when somebody wants to change the
+// objects they use.
+
+class DsqlStatementCache : public Firebird::PermanentStorage
+{
+public:
+	explicit DsqlStatementCache(MemoryPool& p)
+		: PermanentStorage(p), map(p), order(p), hits(0), misses(0)
+	{
+	}
+
+	static void makeKey(Firebird::string& key, ULONG length, const TEXT* text,
+		USHORT dialect, bool isInternalRequest);
+
+	dsql_req* get(const Firebird::string& key);
+	bool put(thread_db* tdbb, dsql_req* request, ULONG maxCount);
+	void purge(thread_db* tdbb);
+
+	FB_UINT64 getHits() const
+	{
+		return hits;
+	}
+
+	FB_UINT64 getMisses() const
+	{
+		return misses;
+	}
+
+private:
+	static void release(thread_db* tdbb, dsql_req* request);
+
+	Firebird::GenericMap<Firebird::Pair<Firebird::Left<Firebird::string, dsql_req*> > > map;
+	Firebird::Array<dsql_req*> order;	// least recently released first
+	FB_UINT64 hits;
+	FB_UINT64 misses;
+};
+
+} // namespace Jrd
+
+#endif // DSQL_STATEMENT_CACHE_H
@@ -8549,6 +8549,13 @@ SetSessionNode::SetSessionNode(MemoryPool& pool, Type aType, ULONG aVal, UCHAR b
 {
 	// TYPE_IDLE_TIMEOUT should be set in seconds
 	// TYPE_STMT_TIMEOUT should be set in milliseconds
+	// TYPE_PARALLEL_WORKERS is a plain number of threads
+
+	if (aType == TYPE_PARALLEL_WORKERS)
+	{
+		m_value = aVal;
+		return;
+	}
 
 	ULONG mult = 1;
 
@@ -8603,6 +8610,10 @@ void SetSessionNode::execute(thread_db* tdbb, dsql_req* request, jrd_tra** /*tra
 	case TYPE_STMT_TIMEOUT:
 		att->setStatementTimeout(m_value);
 		break;
+
+	case TYPE_PARALLEL_WORKERS:
+		att->setParallelWorkers(m_value);
+		break;
 	}
 }
 
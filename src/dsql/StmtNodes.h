@@ -1705,7 +1705,7 @@ public:
 class SetSessionNode : public SessionManagementNode
 {
 public:
-	enum Type { TYPE_IDLE_TIMEOUT, TYPE_STMT_TIMEOUT };
+	enum Type { TYPE_IDLE_TIMEOUT, TYPE_STMT_TIMEOUT, TYPE_PARALLEL_WORKERS };
 
 	SetSessionNode(MemoryPool& pool, Type aType, ULONG aVal, UCHAR blr_timepart);
 
@@ -84,6 +84,7 @@ static ULONG	get_request_info(thread_db*, dsql_req*, ULONG, UCHAR*);
 static dsql_dbb*	init(Jrd::thread_db*, Jrd::Attachment*);
 static dsql_req* prepareRequest(thread_db*, dsql_dbb*, jrd_tra*, ULONG, const TEXT*, USHORT, bool);
 static dsql_req* prepareStatement(thread_db*, dsql_dbb*, jrd_tra*, ULONG, const TEXT*, USHORT, bool);
+static void releaseRequest(thread_db*, dsql_req*);
 static UCHAR*	put_item(UCHAR, const USHORT, const UCHAR*, UCHAR*, const UCHAR* const);
 static void		release_statement(DsqlCompiledStatement* statement);
 static void		sql_info(thread_db*, dsql_req*, ULONG, const UCHAR*, ULONG, UCHAR*);
@@ -277,6 +278,8 @@ bool DsqlDmlRequest::fetch(thread_db* tdbb, UCHAR* msgBuffer)
 
 	dsql_msg* message = (dsql_msg*) statement->getReceiveMsg();
 
+	const SINT64 startClock = fb_utils::query_performance_counter();
+
 	// Set up things for tracing this call
 	Jrd::Attachment* att = req_dbb->dbb_attachment;
 	TraceDSQLFetch trace(att, this);
@@ -302,6 +305,9 @@ bool DsqlDmlRequest::fetch(thread_db* tdbb, UCHAR* msgBuffer)
 
 		delayedFormat = NULL;
 		trace.fetch(true, ITracePlugin::RESULT_SUCCESS);
+
+		req_exec_elapsed += fb_utils::query_performance_counter() - startClock;
+		accountLatency();
 		return false;
 	}
 
@@ -309,6 +315,8 @@ bool DsqlDmlRequest::fetch(thread_db* tdbb, UCHAR* msgBuffer)
 	delayedFormat = NULL;
 
 	trace.fetch(false, ITracePlugin::RESULT_SUCCESS);
+
+	req_exec_elapsed += fb_utils::query_performance_counter() - startClock;
 	return true;
 }
 
@@ -336,7 +344,7 @@ void DSQL_free_statement(thread_db* tdbb, dsql_req* request, USHORT option)
 	if (option & DSQL_drop)
 	{
 		// Release everything associated with the request
-		dsql_req::destroy(tdbb, request, true);
+		releaseRequest(tdbb, request);
 	}
 	/*
 	else if (option & DSQL_unprepare)
@@ -362,6 +370,18 @@ void DSQL_free_statement(thread_db* tdbb, dsql_req* request, USHORT option)
 }
 
 
+// Release the prepared statements kept by the attachment after the user released them.
+void DSQL_purge_statement_cache(thread_db* tdbb)
+{
+	SET_TDBB(tdbb);
+
+	Jrd::Attachment* const attachment = tdbb->getAttachment();
+
+	if (attachment && attachment->att_dsql_instance)
+		attachment->att_dsql_instance->dbb_statement_cache.purge(tdbb);
+}
+
+
 /**
 
  	DSQL_prepare
@@ -576,7 +596,7 @@ void DSQL_execute_immediate(thread_db* tdbb, Jrd::Attachment* attachment, jrd_tr
 
 		request->execute(tdbb, tra_handle, in_meta, in_msg, out_meta, out_msg, singleton);
 
-		dsql_req::destroy(tdbb, request, true);
+		releaseRequest(tdbb, request);
 	}
 	catch (const Firebird::Exception&)
 	{
@@ -836,6 +856,8 @@ void DsqlDmlRequest::execute(thread_db* tdbb, jrd_tra** traHandle,
 				  Arg::Gds(isc_unprepared_stmt));
 	}
 
+	const SINT64 startClock = fb_utils::query_performance_counter();
+
 	// If there is no data required, just start the request
 
 	const dsql_msg* message = statement->getSendMsg();
@@ -919,6 +941,11 @@ void DsqlDmlRequest::execute(thread_db* tdbb, jrd_tra** traHandle,
 	}
 
 	trace.finish(have_cursor, ITracePlugin::RESULT_SUCCESS);
+
+	// The execution of a cursor lasts until it's fetched completely or closed
+	req_exec_elapsed = fb_utils::query_performance_counter() - startClock;
+	if (!have_cursor)
+		accountLatency();
 }
 
 void DsqlDdlRequest::dsqlPass(thread_db* tdbb, DsqlCompilerScratch* scratch, bool* destroyScratchPool,
@@ -977,6 +1004,9 @@ void DsqlDdlRequest::execute(thread_db* tdbb, jrd_tra** traHandle,
 
 	fb_utils::init_status(tdbb->tdbb_status_vector);
 
+	// Cached statements may depend on the objects being changed
+	req_dbb->dbb_statement_cache.purge(tdbb);
+
 	// run all statements under savepoint control
 	{	// scope
 		AutoSavePoint savePoint(tdbb, req_transaction);
@@ -1064,6 +1094,9 @@ void DsqlSessionManagementRequest::execute(thread_db* tdbb, jrd_tra** traHandle,
 	bool singleton)
 {
 	node->execute(tdbb, this, traHandle);
+
+	// Cached statements were prepared with the previous session settings
+	req_dbb->dbb_statement_cache.purge(tdbb);
 }
 
 
@@ -1456,8 +1489,43 @@ static void checkD(IStatus* st)
 static dsql_req* prepareRequest(thread_db* tdbb, dsql_dbb* database, jrd_tra* transaction,
 	ULONG textLength, const TEXT* text, USHORT clientDialect, bool isInternalRequest)
 {
-	return prepareStatement(tdbb, database, transaction, textLength, text, clientDialect,
+	if (!database->dbb_attachment->att_database->dbb_config->getStatementCacheSize() ||
+		!text || clientDialect > SQL_DIALECT_CURRENT)
+	{
+		return prepareStatement(tdbb, database, transaction, textLength, text, clientDialect,
+			isInternalRequest);
+	}
+
+	if (textLength == 0)
+		textLength = static_cast<ULONG>(strlen(text));
+
+	string key;
+	DsqlStatementCache::makeKey(key, textLength, text, clientDialect, isInternalRequest);
+
+	dsql_req* request = database->dbb_statement_cache.get(key);
+
+	if (request)
+	{
+		// The statement is still valid, otherwise it would be purged from the cache
+
+		TraceDSQLPrepare trace(database->dbb_attachment, transaction, textLength, text);
+
+		request->req_transaction = transaction ? transaction :
+			database->dbb_attachment->getSysTransaction();
+		request->req_traced = true;
+
+		trace.setStatement(request);
+		trace.prepare(ITracePlugin::RESULT_SUCCESS);
+
+		return request;
+	}
+
+	request = prepareStatement(tdbb, database, transaction, textLength, text, clientDialect,
 		isInternalRequest);
+
+	request->req_cache_key = key;
+
+	return request;
 }
 
 
@@ -1686,6 +1754,18 @@ static UCHAR* put_item(	UCHAR	item,
 }
 
 
+// Release a request released by the user, or keep it in the statement cache.
+static void releaseRequest(thread_db* tdbb, dsql_req* request)
+{
+	dsql_dbb* const database = request->req_dbb;
+	const ULONG cacheSize =
+		database->dbb_attachment->att_database->dbb_config->getStatementCacheSize();
+
+	if (!database->dbb_statement_cache.put(tdbb, request, cacheSize))
+		dsql_req::destroy(tdbb, request, true);
+}
+
+
 // Release a compiled statement.
 static void release_statement(DsqlCompiledStatement* statement)
 {
@@ -1739,6 +1819,8 @@ dsql_req::dsql_req(MemoryPool& pool)
 	  req_batch(NULL),
 	  req_user_descs(req_pool),
 	  req_traced(false),
+	  req_exec_elapsed(0),
+	  req_cache_key(req_pool),
 	  req_timeout(0)
 {
 }
@@ -1849,17 +1931,64 @@ TimeoutTimer* dsql_req::setupTimer(thread_db* tdbb)
 	return req_timer;
 }
 
-// Release a dynamic request.
-void dsql_req::destroy(thread_db* tdbb, dsql_req* request, bool drop)
+// Release the runtime state of a dynamic request.
+void dsql_req::reset(thread_db* tdbb)
 {
 	SET_TDBB(tdbb);
 
-	if (request->req_timer)
+	if (req_timer)
 	{
-		request->req_timer->stop();
-		request->req_timer = NULL;
+		req_timer->stop();
+		req_timer = NULL;
 	}
 
+	// If the request had an open cursor, close it
+
+	if (req_cursor)
+		DsqlCursor::close(tdbb, req_cursor);
+
+	if (req_batch)
+	{
+		delete req_batch;
+		req_batch = nullptr;
+	}
+
+	Jrd::Attachment* att = req_dbb->dbb_attachment;
+	const bool need_trace_free = req_traced && TraceManager::need_dsql_free(att);
+	if (need_trace_free)
+	{
+		TraceSQLStatementImpl stmt(this, NULL);
+		TraceManager::event_dsql_free(att, &stmt, DSQL_drop);
+	}
+	req_traced = false;
+
+	if (req_cursor_name.hasData())
+	{
+		req_dbb->dbb_cursors.remove(req_cursor_name);
+		req_cursor_name = "";
+	}
+
+	req_timeout = 0;
+	req_user_descs.clear();
+}
+
+// Account the finished execution in the latency histogram of the statement.
+void dsql_req::accountLatency()
+{
+	if (req_request && req_exec_elapsed)
+	{
+		req_request->req_latency.add(req_exec_elapsed * 1000000 /
+			fb_utils::query_performance_frequency());
+	}
+
+	req_exec_elapsed = 0;
+}
+
+// Release a dynamic request.
+void dsql_req::destroy(thread_db* tdbb, dsql_req* request, bool drop)
+{
+	SET_TDBB(tdbb);
+
 	// If request is parent, orphan the children and release a portion of their requests
 
 	for (FB_SIZE_T i = 0; i < request->cursors.getCount(); ++i)
@@ -1878,31 +2007,7 @@ void dsql_req::destroy(thread_db* tdbb, dsql_req* request, bool drop)
 		//release_statement(child);
 	}
 
-	// If the request had an open cursor, close it
-
-	if (request->req_cursor)
-		DsqlCursor::close(tdbb, request->req_cursor);
-
-	if (request->req_batch)
-	{
-		delete request->req_batch;
-		request->req_batch = nullptr;
-	}
-
-	Jrd::Attachment* att = request->req_dbb->dbb_attachment;
-	const bool need_trace_free = request->req_traced && TraceManager::need_dsql_free(att);
-	if (need_trace_free)
-	{
-		TraceSQLStatementImpl stmt(request, NULL);
-		TraceManager::event_dsql_free(att, &stmt, DSQL_drop);
-	}
-	request->req_traced = false;
-
-	if (request->req_cursor_name.hasData())
-	{
-		request->req_dbb->dbb_cursors.remove(request->req_cursor_name);
-		request->req_cursor_name = "";
-	}
+	request->reset(tdbb);
 
 	// If a request has been compiled, release it now
 
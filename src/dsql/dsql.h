@@ -48,6 +48,7 @@
 #include "../dsql/BlrDebugWriter.h"
 #include "../dsql/ddl_proto.h"
 #include "../dsql/DsqlCursor.h"
+#include "../dsql/DsqlStatementCache.h"
 
 
 #ifdef DEV_BUILD
@@ -144,6 +145,7 @@ public:
 	Attachment*		dbb_attachment;
 	Firebird::MetaName dbb_dfl_charset;
 	bool			dbb_no_charset;
+	DsqlStatementCache dbb_statement_cache;	// prepared statements released by the user
 
 	explicit dsql_dbb(MemoryPool& p)
 		: dbb_relations(p),
@@ -154,7 +156,8 @@ public:
 		  dbb_charsets_by_id(p),
 		  dbb_cursors(p),
 		  dbb_pool(p),
-		  dbb_dfl_charset(p)
+		  dbb_dfl_charset(p),
+		  dbb_statement_cache(p)
 	{}
 
 	~dsql_dbb();
@@ -613,6 +616,12 @@ public:
 	void mapInOut(Jrd::thread_db* tdbb, bool toExternal, const dsql_msg* message, Firebird::IMessageMetadata* meta,
 		UCHAR* dsql_msg_buf, const UCHAR* in_dsql_msg_buf = NULL);
 
+	// Release the runtime state of the request, it remains prepared
+	void reset(thread_db* tdbb);
+
+	// Account the finished execution in the latency histogram of the statement
+	void accountLatency();
+
 	static void destroy(thread_db* tdbb, dsql_req* request, bool drop);
 
 private:
@@ -637,6 +646,8 @@ public:
 	SINT64 req_fetch_elapsed;		// Number of clock ticks spent while fetching rows for this request since we reported it last time
 	SINT64 req_fetch_rowcount;		// Total number of rows returned by this request
 	bool req_traced;				// request is traced via TraceAPI
+	SINT64 req_exec_elapsed;		// Number of clock ticks spent by the current execution, including fetches
+	Firebird::string req_cache_key;	// key in the statement cache, if cacheable
 
 protected:
 	unsigned int req_timeout;					// query timeout in milliseconds, set by the user
@@ -674,6 +674,13 @@ using namespace Firebird;
 %token <metaNamePtr> CLEAR
 %token <metaNamePtr> OLDEST
 
+// parallel processing
+%token <metaNamePtr> PARALLEL
+%token <metaNamePtr> WORKERS
+
+// record compression
+%token <metaNamePtr> COMPRESSION
+
 // precedence declarations for expression evaluation
 
 %left	OR
@@ -2196,6 +2203,13 @@ table_attribute($relationNode)
 		{ setClause($relationNode->ssDefiner, "SQL SECURITY", $1); }
 	| publication_state
 		{ setClause($relationNode->replicationState, "PUBLICATION", $1); }
+	| record_codec_clause
+		{ setClause($relationNode->recordCodec, "COMPRESSION", *$1); }
+	;
+
+%type <metaNamePtr> record_codec_clause
+record_codec_clause
+	: COMPRESSION valid_symbol_name		{ $$ = $2; }
 	;
 
 %type <boolVal> sql_security_clause
@@ -4163,6 +4177,13 @@ alter_op($relationNode)
 				newNode<RelationNode::Clause>(RelationNode::Clause::TYPE_ALTER_SQL_SECURITY);
 			$relationNode->clauses.add(clause);
 		}
+	| SET record_codec_clause
+		{
+			setClause($relationNode->recordCodec, "COMPRESSION", *$2);
+			RelationNode::Clause* clause =
+				newNode<RelationNode::Clause>(RelationNode::Clause::TYPE_ALTER_RECORD_CODEC);
+			$relationNode->clauses.add(clause);
+		}
 	| ENABLE PUBLICATION
 		{
 			setClause($relationNode->replicationState, "PUBLICATION", true);
@@ -5441,6 +5462,8 @@ session_statement
 		{ $$ = newNode<SetSessionNode>(SetSessionNode::TYPE_IDLE_TIMEOUT, $5, $6); }
 	| SET STATEMENT TIMEOUT long_integer timepart_ses_stmt_tout
 		{ $$ = newNode<SetSessionNode>(SetSessionNode::TYPE_STMT_TIMEOUT, $4, $5); }
+	| SET PARALLEL WORKERS long_integer
+		{ $$ = newNode<SetSessionNode>(SetSessionNode::TYPE_PARALLEL_WORKERS, $4, 0); }
 	;
 
 %type <blrOp> timepart_sesion_idle_tout
@@ -5612,6 +5635,12 @@ table_list
 set_statistics
 	: SET STATISTICS INDEX symbol_index_name
 		{ $$ = newNode<SetStatisticsNode>(*$4); }
+	| SET STATISTICS TABLE symbol_table_name column_parens_opt
+		{
+			SetTableStatisticsNode* node = newNode<SetTableStatisticsNode>(*$4);
+			node->columns = $5;
+			$$ = node;
+		}
 	;
 
 %type <ddlNode> comment
@@ -8937,6 +8966,7 @@ non_reserved_word
 	| CLEAR
 	| COUNTER
 	| COMPARE_DECFLOAT
+	| COMPRESSION
 	| CONNECTIONS
 	| CONSISTENCY
 	| CRC32
@@ -8971,6 +9001,7 @@ non_reserved_word
 	| OLDEST
 	| OTHERS
 	| OVERRIDING
+	| PARALLEL
 	| PERCENT_RANK
 	| POOL
 	| PRECEDING
@@ -8993,6 +9024,7 @@ non_reserved_word
 	| TIES
 	| TOTALORDER
 	| TRAPS
+	| WORKERS
 	| ZONE
 	;
 
@@ -128,6 +128,7 @@
 #define isc_dpb_set_bind                  93
 #define isc_dpb_decfloat_round            94
 #define isc_dpb_decfloat_traps            95
+#define isc_dpb_parallel_workers          96
 
 
 /**************************************************/
@@ -412,6 +413,7 @@
 #define isc_spb_bkp_keyname				 17
 #define isc_spb_bkp_crypt				 18
 #define isc_spb_bkp_include_data         19
+#define isc_spb_bkp_parallel_workers     20
 #define isc_spb_bkp_ignore_checksums     0x01
 #define isc_spb_bkp_ignore_limbo         0x02
 #define isc_spb_bkp_metadata_only        0x04
@@ -503,6 +505,7 @@
 #define isc_spb_rpr_commit_trans_64		49
 #define isc_spb_rpr_rollback_trans_64	50
 #define isc_spb_rpr_recover_two_phase_64	51
+#define isc_spb_rpr_par_workers			52
 
 #define isc_spb_rpr_validate_db			0x01
 #define isc_spb_rpr_sweep_db			0x02
@@ -531,6 +534,7 @@
 #define isc_spb_res_crypt				isc_spb_bkp_crypt
 #define isc_spb_res_stat				isc_spb_bkp_stat
 #define isc_spb_res_metadata_only		isc_spb_bkp_metadata_only
+#define isc_spb_res_parallel_workers	isc_spb_bkp_parallel_workers
 #define isc_spb_res_deactivate_idx		0x0100
 #define isc_spb_res_no_shadow			0x0200
 #define isc_spb_res_no_validity			0x0400
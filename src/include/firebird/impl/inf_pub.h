@@ -162,9 +162,18 @@ enum db_info_types
 
 	fb_info_wire_crypt = 140,
 
+	fb_info_wire_compression = 141,
+
 	isc_info_db_last_value   /* Leave this LAST! */
 };
 
+enum db_info_wire_compression	/* codec reported in fb_info_wire_compression */
+{
+	fb_info_wire_compression_none = 0,
+	fb_info_wire_compression_zlib = 1,
+	fb_info_wire_compression_zstd = 2
+};
+
 enum db_info_crypt			/* flags set in fb_info_crypt_state */
 {
 	fb_info_crypt_encrypted = 0x01,
@@ -250,6 +250,7 @@ Jrd::Attachment::Attachment(MemoryPool* pool, Database* dbb)
 	  att_pools(*pool),
 	  att_idle_timeout(0),
 	  att_stmt_timeout(0),
+	  att_parallel_workers(0),
 	  att_batches(*pool),
 	  att_initial_options(*pool)
 {
@@ -958,6 +959,15 @@ unsigned int Attachment::getActualIdleTimeout() const
 	return timeout;
 }
 
+unsigned int Attachment::getParallelWorkers() const
+{
+	const Config* const config = att_database->dbb_config;
+	const unsigned int workers = att_parallel_workers ?
+		att_parallel_workers : config->getParallelWorkers();
+
+	return MIN(workers, config->getMaxParallelWorkers());
+}
+
 void Attachment::setupIdleTimer(bool clear)
 {
 	unsigned int timeout = clear ? 0 : getActualIdleTimeout();
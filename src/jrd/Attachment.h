@@ -597,6 +597,14 @@ public:
 		att_stmt_timeout = timeOut;
 	}
 
+	void setParallelWorkers(unsigned int workers)
+	{
+		att_parallel_workers = workers;
+	}
+
+	// number of threads a sort may use, limited by MaxParallelWorkers
+	unsigned int getParallelWorkers() const;
+
 	// evaluate new value or clear idle timer
 	void setupIdleTimer(bool clear);
 
@@ -674,6 +682,7 @@ private:
 
 	unsigned int att_idle_timeout;		// seconds
 	unsigned int att_stmt_timeout;		// milliseconds
+	unsigned int att_parallel_workers;	// 0 - use ParallelWorkers setting
 	Firebird::RefPtr<IdleTimer> att_idle_timer;
 
 	Firebird::Array<JBatch*> att_batches;
@@ -0,0 +1,429 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird Project
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#include "firebird.h"
+#include "../common/classes/Hash.h"
+#include "../common/classes/NoThrowTimeStamp.h"
+#include "../jrd/jrd.h"
+#include "../jrd/req.h"
+#include "../jrd/intl.h"
+#include "../jrd/ColumnStatistics.h"
+#include "../jrd/dpm_proto.h"
+#include "../jrd/evl_proto.h"
+#include "../jrd/intl_proto.h"
+#include "../jrd/mov_proto.h"
+#include "../jrd/vio_proto.h"
+
+#include <algorithm>
+#include <math.h>
+
+using namespace Firebird;
+using namespace Jrd;
+
+namespace
+{
+	// Maximum number of data pages read while collecting statistics
+	const ULONG SAMPLE_PAGES = 300;
+
+	// Statistics become outdated when the table size changes by that fraction
+	const double OUTDATED_FRACTION = 0.1;
+
+	// Number of leading key bytes making the ordinal value of a string
+	const unsigned ORDINAL_KEY_BYTES = 6;
+
+	const UCHAR HISTOGRAM_VERSION = 1;
+
+	// Values of a single column read from the sampled records
+	struct ColumnSample
+	{
+		explicit ColumnSample(MemoryPool& p)
+			: hashes(p), ordinals(p), nulls(0), ordered(true)
+		{
+		}
+
+		Array<ULONG> hashes;
+		Array<double> ordinals;
+		SINT64 nulls;
+		bool ordered;
+	};
+
+	// Make the binary comparable form of the value
+	void makeKey(thread_db* tdbb, const dsc* desc, UCharBuffer& key)
+	{
+		if (!desc->isText())
+		{
+			key.assign(desc->dsc_address, desc->dsc_length);
+			return;
+		}
+
+		USHORT idxType, length;
+
+		if (IS_INTL_DATA(desc))
+		{
+			idxType = INTL_INDEX_TYPE(desc);
+			length = INTL_key_length(tdbb, idxType, desc->getStringLength());
+		}
+		else
+		{
+			idxType = (desc->getTextType() == ttype_binary) ? idx_byte_array : idx_string;
+			length = desc->getStringLength();
+		}
+
+		dsc to;
+		to.makeText(length, ttype_binary, key.getBuffer(length));
+		key.shrink(INTL_string_to_key(tdbb, idxType, desc, &to, INTL_KEY_UNIQUE));
+	}
+
+	// Map the value into a double keeping the ordering of the column type
+	bool makeOrdinal(thread_db* tdbb, const dsc* desc, const UCharBuffer& key, double& ordinal)
+	{
+		switch (desc->dsc_dtype)
+		{
+			case dtype_text:
+			case dtype_cstring:
+			case dtype_varying:
+				ordinal = 0;
+				for (unsigned i = 0; i < ORDINAL_KEY_BYTES; i++)
+					ordinal = ordinal * 256 + (i < key.getCount() ? key[i] : 0);
+				return true;
+
+			case dtype_sql_date:
+				ordinal = *(ISC_DATE*) desc->dsc_address;
+				return true;
+
+			case dtype_sql_time:
+			case dtype_sql_time_tz:
+			case dtype_ex_time_tz:
+				ordinal = *(ISC_TIME*) desc->dsc_address;
+				return true;
+
+			case dtype_timestamp:
+			case dtype_timestamp_tz:
+			case dtype_ex_timestamp_tz:
+			{
+				const ISC_TIMESTAMP* const ts = (ISC_TIMESTAMP*) desc->dsc_address;
+				ordinal = (double) ts->timestamp_date * NoThrowTimeStamp::ISC_TICKS_PER_DAY +
+					ts->timestamp_time;
+				return true;
+			}
+
+			case dtype_boolean:
+				ordinal = *desc->dsc_address ? 1 : 0;
+				return true;
+
+			default:
+				if (desc->isNumeric() || desc->isDecOrInt())
+				{
+					ordinal = MOV_get_double(tdbb, desc);
+					return true;
+				}
+				break;
+		}
+
+		return false;
+	}
+}
+
+
+double ColumnStatistics::getEqualitySelectivity(const double* value) const
+{
+	const double notNull = 1 - nullFraction;
+	double selectivity = (distinctValues > 1) ? notNull / distinctValues : notNull;
+
+	if (value && bounds.getCount() > 1)
+	{
+		// Frequent values fill whole buckets of the equi-depth histogram
+
+		FB_SIZE_T buckets = 0;
+
+		for (FB_SIZE_T i = 1; i < bounds.getCount(); i++)
+		{
+			if (bounds[i - 1] == *value && bounds[i] == *value)
+				buckets++;
+		}
+
+		selectivity = MAX(selectivity, notNull * buckets / (bounds.getCount() - 1));
+	}
+
+	return selectivity;
+}
+
+bool ColumnStatistics::getRangeSelectivity(const double* lower, bool excludeLower,
+	const double* upper, bool excludeUpper, double& selectivity) const
+{
+	if (bounds.getCount() < 2)
+		return false;
+
+	const double notNull = 1 - nullFraction;
+	const double from = lower ? getFraction(*lower, excludeLower) : 0;
+	const double to = upper ? getFraction(*upper, !excludeUpper) : 1;
+
+	// Assume at least a single value to be found
+	const double minimum = (distinctValues > 1) ? notNull / distinctValues : notNull;
+
+	selectivity = MAX(notNull * (to - from), minimum);
+	return true;
+}
+
+// Return the fraction of non-NULL values being less than (or equal to) the given one
+double ColumnStatistics::getFraction(double value, bool inclusive) const
+{
+	const FB_SIZE_T count = bounds.getCount();
+	fb_assert(count > 1);
+
+	if (value < bounds[0] || (value == bounds[0] && !inclusive))
+		return 0;
+
+	if (value > bounds[count - 1] || (value == bounds[count - 1] && inclusive))
+		return 1;
+
+	// Find the bucket holding the value, the bucket low bound is exclusive
+	// unless we're looking for an inclusive fraction
+
+	FB_SIZE_T low = 0, high = count - 1;
+
+	while (high - low > 1)
+	{
+		const FB_SIZE_T middle = (low + high) / 2;
+
+		if (bounds[middle] < value || (inclusive && bounds[middle] == value))
+			low = middle;
+		else
+			high = middle;
+	}
+
+	const double width = bounds[high] - bounds[low];
+	const double part = (width > 0) ? (value - bounds[low]) / width : 0.5;
+
+	return (low + part) / (count - 1);
+}
+
+void ColumnStatistics::getHistogram(UCharBuffer& data) const
+{
+	// Bounds are stored in the native byte order, as the database itself
+
+	data.clear();
+
+	if (bounds.getCount() > 1)
+	{
+		data.add(HISTOGRAM_VERSION);
+		data.add((const UCHAR*) bounds.begin(), bounds.getCount() * sizeof(double));
+	}
+}
+
+void ColumnStatistics::setHistogram(const UCHAR* data, ULONG length)
+{
+	bounds.clear();
+
+	if (!length || data[0] != HISTOGRAM_VERSION)
+		return;
+
+	const ULONG count = (length - 1) / sizeof(double);
+
+	if (count > 1)
+		memcpy(bounds.getBuffer(count), data + 1, count * sizeof(double));
+}
+
+// Compute the ordinal value of a literal compared with the given column
+bool ColumnStatistics::getOrdinal(thread_db* tdbb, const dsc* value, const dsc* fieldDesc,
+	double& ordinal)
+{
+	if (value->isNull() || value->isBlob() || fieldDesc->isBlob())
+		return false;
+
+	// Use aligned storage for the converted value
+	HalfStaticArray<SINT64, 32> buffer;
+	dsc desc = *fieldDesc;
+	desc.dsc_address = (UCHAR*) buffer.getBuffer((desc.dsc_length + sizeof(SINT64) - 1) / sizeof(SINT64));
+
+	try
+	{
+		MOV_move(tdbb, const_cast<dsc*>(value), &desc);
+
+		UCharBuffer key;
+
+		if (desc.isText())
+			makeKey(tdbb, &desc, key);
+
+		return makeOrdinal(tdbb, &desc, key, ordinal);
+	}
+	catch (const Exception&)
+	{
+		// The value doesn't fit the column, leave it up to the default estimations
+	}
+
+	return false;
+}
+
+
+RelationStatistics::~RelationStatistics()
+{
+	for (ColumnStatistics** iter = columns.begin(); iter != columns.end(); ++iter)
+		delete *iter;
+}
+
+ColumnStatistics* RelationStatistics::add(USHORT id)
+{
+	while (columns.getCount() <= id)
+		columns.add(NULL);
+
+	if (!columns[id])
+		columns[id] = FB_NEW_POOL(getPool()) ColumnStatistics(getPool());
+
+	return columns[id];
+}
+
+bool RelationStatistics::isOutdated(SINT64 sampledPages, ULONG dataPages)
+{
+	const double difference = (double) sampledPages - dataPages;
+	return fabs(difference) > MAX(sampledPages, 1) * OUTDATED_FRACTION;
+}
+
+// Read the records of data pages spread evenly over the table and compute
+// the NULL fraction, the number of distinct values (using the Duj1 estimator)
+// and the equi-depth histogram of the given fields.
+void RelationStatistics::collect(thread_db* tdbb, jrd_tra* transaction, jrd_rel* relation,
+	const Array<USHORT>& fields)
+{
+	SET_TDBB(tdbb);
+	Database* const dbb = tdbb->getDatabase();
+	MemoryPool& pool = *tdbb->getDefaultPool();
+
+	dataPages = DPM_data_pages(tdbb, relation);
+	const ULONG samplePages = MIN(dataPages, SAMPLE_PAGES);
+
+	ObjectsArray<ColumnSample> samples(pool);
+
+	for (FB_SIZE_T i = 0; i < fields.getCount(); i++)
+		samples.add();
+
+	record_param rpb;
+	rpb.rpb_relation = relation;
+	rpb.getWindow(tdbb).win_flags = WIN_large_scan;
+	rpb.rpb_org_scans = relation->rel_scan_count++;
+
+	SINT64 sampledRecords = 0;
+	UCharBuffer key;
+
+	try
+	{
+		for (ULONG page = 0; page < samplePages; page++)
+		{
+			const FB_UINT64 sequence = (FB_UINT64) page * dataPages / samplePages;
+			rpb.rpb_number.setValue((SINT64) (sequence * dbb->dbb_max_records) - 1);
+
+			while (VIO_next_record(tdbb, &rpb, transaction, &pool, true))
+			{
+				sampledRecords++;
+
+				for (FB_SIZE_T i = 0; i < fields.getCount(); i++)
+				{
+					ColumnSample& sample = samples[i];
+					dsc desc;
+
+					if (!EVL_field(relation, rpb.rpb_record, fields[i], &desc))
+					{
+						sample.nulls++;
+						continue;
+					}
+
+					makeKey(tdbb, &desc, key);
+					sample.hashes.add(InternalHash::hash(key.getCount(), key.begin()));
+
+					double ordinal;
+
+					if (sample.ordered && makeOrdinal(tdbb, &desc, key, ordinal))
+						sample.ordinals.add(ordinal);
+					else
+						sample.ordered = false;
+				}
+
+				if (--tdbb->tdbb_quantum < 0)
+					JRD_reschedule(tdbb, 0, true);
+			}
+		}
+	}
+	catch (const Exception&)
+	{
+		--relation->rel_scan_count;
+		delete rpb.rpb_record;
+		throw;
+	}
+
+	--relation->rel_scan_count;
+	delete rpb.rpb_record;
+
+	recordCount = samplePages ? sampledRecords * dataPages / samplePages : 0;
+
+	for (FB_SIZE_T i = 0; i < fields.getCount(); i++)
+	{
+		ColumnSample& sample = samples[i];
+		ColumnStatistics* const column = add(fields[i]);
+
+		column->nullFraction = sampledRecords ? (double) sample.nulls / sampledRecords : 0;
+		column->distinctValues = 0;
+		column->bounds.clear();
+
+		const FB_SIZE_T count = sample.hashes.getCount();
+
+		if (!count)
+			continue;
+
+		// Count the distinct values of the sample and the ones seen only once
+
+		std::sort(sample.hashes.begin(), sample.hashes.end());
+
+		double distinct = 0, singles = 0;
+
+		for (FB_SIZE_T j = 0; j < count; )
+		{
+			FB_SIZE_T k = j + 1;
+
+			while (k < count && sample.hashes[k] == sample.hashes[j])
+				k++;
+
+			distinct++;
+
+			if (k - j == 1)
+				singles++;
+
+			j = k;
+		}
+
+		const double total = MAX((double) recordCount * (1 - column->nullFraction), (double) count);
+		const double n = count;
+
+		column->distinctValues = n * distinct / (n - singles + singles * n / total);
+		column->distinctValues = MIN(MAX(column->distinctValues, distinct), total);
+
+		// Build the equi-depth histogram
+
+		if (sample.ordered)
+		{
+			fb_assert(sample.ordinals.getCount() == count);
+			std::sort(sample.ordinals.begin(), sample.ordinals.end());
+
+			const FB_SIZE_T buckets = MIN(count, (FB_SIZE_T) ColumnStatistics::MAX_BUCKETS);
+			column->bounds.add(sample.ordinals[0]);
+
+			for (FB_SIZE_T j = 1; j <= buckets; j++)
+				column->bounds.add(sample.ordinals[(FB_UINT64) count * j / buckets - 1]);
+		}
+	}
+}
@@ -0,0 +1,96 @@
+/*
+ *  The contents of this file are subject to the Initial
+ *  Developer's Public License Version 1.0 (the "License");
+ *  you may not use this file except in compliance with the
+ *  License. You may obtain a copy of the License at
+ *  http://www.ibphoenix.com/main.nfs?a=ibphoenix&page=ibp_idpl.
+ *
+ *  Software distributed under the License is distributed AS IS,
+ *  WITHOUT WARRANTY OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing rights
+ *  and limitations under the License.
+ *
+ *  The Original Code was created by the Firebird Project
+ *  for the Firebird Open Source RDBMS project.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+ */
+
+#ifndef JRD_COLUMN_STATISTICS_H
+#define JRD_COLUMN_STATISTICS_H
+
+#include "../common/classes/alloc.h"
+#include "../common/classes/array.h"
+#include "../common/dsc.h"
+
+namespace Jrd {
+
+class jrd_rel;
+class jrd_tra;
+class thread_db;
+
+// Statistics of a table column. They are collected by sampling the data pages
+// of the table and stored in RDB$COLUMN_STATISTICS.
+
+class ColumnStatistics
+{
+public:
+	static const unsigned MAX_BUCKETS = 64;
+
+	explicit ColumnStatistics(MemoryPool& p)
+		: nullFraction(0), distinctValues(0), bounds(p)
+	{
+	}
+
+	double getEqualitySelectivity(const double* value) const;
+	bool getRangeSelectivity(const double* lower, bool excludeLower,
+		const double* upper, bool excludeUpper, double& selectivity) const;
+
+	void getHistogram(Firebird::UCharBuffer& data) const;
+	void setHistogram(const UCHAR* data, ULONG length);
+
+	static bool getOrdinal(thread_db* tdbb, const dsc* value, const dsc* fieldDesc, double& ordinal);
+
+	double nullFraction;			// fraction of NULL values
+	double distinctValues;			// estimated number of distinct non-NULL values
+	Firebird::Array<double> bounds;	// bucket bounds of the equi-depth histogram, if any
+
+private:
+	double getFraction(double value, bool inclusive) const;
+};
+
+// Column statistics of a table
+
+class RelationStatistics : public Firebird::PermanentStorage
+{
+public:
+	explicit RelationStatistics(MemoryPool& p)
+		: PermanentStorage(p), recordCount(0), dataPages(0), columns(p)
+	{
+	}
+
+	~RelationStatistics();
+
+	const ColumnStatistics* get(USHORT id) const
+	{
+		return (id < columns.getCount()) ? columns[id] : NULL;
+	}
+
+	ColumnStatistics* add(USHORT id);
+
+	void collect(thread_db* tdbb, jrd_tra* transaction, jrd_rel* relation,
+		const Firebird::Array<USHORT>& fields);
+
+	static bool isOutdated(SINT64 sampledPages, ULONG dataPages);
+
+	SINT64 recordCount;		// estimated number of records
+	ULONG dataPages;		// number of data pages when sampled
+
+private:
+	Firebird::Array<ColumnStatistics*> columns;
+};
+
+} // namespace Jrd
+
+#endif // JRD_COLUMN_STATISTICS_H
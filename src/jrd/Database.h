@@ -455,10 +455,8 @@ public:
 	USHORT dbb_max_records;				// max record per data page
 	USHORT dbb_max_idx;					// max number of indexes on a root page
 
-#ifdef SUPERSERVER_V2
 	USHORT dbb_prefetch_sequence;		// sequence to pace frequency of prefetch requests
 	USHORT dbb_prefetch_pages;			// prefetch pages per request
-#endif
 
 	Firebird::PathName dbb_filename;	// filename string
 	Firebird::PathName dbb_database_name;	// database visible name (file name or alias)
@@ -611,6 +609,11 @@ public:
 		return (dbb_flags & DBB_read_only) != 0;
 	}
 
+	USHORT getEncodedOds() const
+	{
+		return ENCODE_ODS(dbb_ods_version, dbb_minor_version);
+	}
+
 	// returns true if sweeper thread could start
 	bool allowSweepThread(thread_db* tdbb);
 	// returns true if sweep could run
@@ -47,6 +47,8 @@
 #include "../jrd/RecordBuffer.h"
 #include "../jrd/Monitoring.h"
 #include "../jrd/Function.h"
+#include "../dsql/dsql.h"
+#include "../jrd/replication/Applier.h"
 
 #ifdef WIN_NT
 #include <process.h>
@@ -420,6 +422,9 @@ MonitoringSnapshot::MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool)
 	RecordBuffer* const ctx_var_buffer = allocBuffer(tdbb, pool, rel_mon_ctx_vars);
 	RecordBuffer* const mem_usage_buffer = allocBuffer(tdbb, pool, rel_mon_mem_usage);
 	RecordBuffer* const tab_stat_buffer = allocBuffer(tdbb, pool, rel_mon_tab_stats);
+	RecordBuffer* const cache_part_buffer = allocBuffer(tdbb, pool, rel_mon_cache_parts);
+	RecordBuffer* const wait_stat_buffer = allocBuffer(tdbb, pool, rel_mon_wait_stats);
+	RecordBuffer* const stmt_latency_buffer = allocBuffer(tdbb, pool, rel_mon_stmt_latency);
 
 	// Dump our own data and downgrade the lock, if required
 
@@ -549,6 +554,15 @@ MonitoringSnapshot::MonitoringSnapshot(thread_db* tdbb, MemoryPool& pool)
 		case rel_mon_tab_stats:
 			buffer = tab_stat_buffer;
 			break;
+		case rel_mon_cache_parts:
+			buffer = cache_part_buffer;
+			break;
+		case rel_mon_wait_stats:
+			buffer = wait_stat_buffer;
+			break;
+		case rel_mon_stmt_latency:
+			buffer = stmt_latency_buffer;
+			break;
 		default:
 			fb_assert(false);
 		}
@@ -608,6 +622,13 @@ RecordBuffer* SnapshotData::getData(int id) const
 
 RecordBuffer* SnapshotData::allocBuffer(thread_db* tdbb, MemoryPool& pool, int rel_id)
 {
+	// Monitoring tables added in later ODS versions are dropped by INI_init2()
+	// for older databases, don't resurrect them
+
+	const vec<jrd_rel*>* const relations = tdbb->getAttachment()->att_relations;
+	if (!relations || rel_id >= (int) relations->count() || !(*relations)[rel_id])
+		return NULL;
+
 	jrd_rel* const relation = MET_lookup_relation_id(tdbb, rel_id, false);
 	fb_assert(relation);
 	MET_scan_relation(tdbb, relation);
@@ -908,6 +929,8 @@ void Monitoring::putDatabase(thread_db* tdbb, SnapshotData::DumpRecord& record)
 		putStatistics(record, zero_rt_stats, stat_id, stat_database);
 		putMemoryUsage(record, zero_mem_stats, stat_id, stat_database);
 	}
+
+	putCachePartitions(record, database->dbb_bcb);
 }
 
 
@@ -1000,6 +1023,19 @@ void Monitoring::putAttachment(SnapshotData::DumpRecord& record, const Jrd::Atta
 		record.storeTimestampTz(f_mon_att_idle_timer, idleTimer);
 	// statement timeout, milliseconds
 	record.storeInteger(f_mon_att_stmt_timeout, attachment->getStatementTimeout());
+	// statement cache usage
+	if (attachment->att_dsql_instance)
+	{
+		const DsqlStatementCache& cache = attachment->att_dsql_instance->dbb_statement_cache;
+		record.storeInteger(f_mon_att_stmt_cache_hits, cache.getHits());
+		record.storeInteger(f_mon_att_stmt_cache_misses, cache.getMisses());
+	}
+	// replication apply state
+	if (attachment->att_repl_applier)
+	{
+		record.storeInteger(f_mon_att_repl_lag, attachment->att_repl_applier->getLag());
+		record.storeInteger(f_mon_att_repl_queue, attachment->att_repl_applier->getQueueLength());
+	}
 
 	record.write();
 
@@ -1139,6 +1175,7 @@ void Monitoring::putRequest(SnapshotData::DumpRecord& record, const jrd_req* req
 
 	putStatistics(record, request->req_stats, stat_id, stat_statement);
 	putMemoryUsage(record, request->req_memory_stats, stat_id, stat_statement);
+	putLatency(record, request->req_latency, request->getRequestId());
 }
 
 
@@ -1220,6 +1257,10 @@ void Monitoring::putStatistics(SnapshotData::DumpRecord& record, const RuntimeSt
 	record.storeInteger(f_mon_io_page_writes, statistics.getValue(RuntimeStatistics::PAGE_WRITES));
 	record.storeInteger(f_mon_io_page_fetches, statistics.getValue(RuntimeStatistics::PAGE_FETCHES));
 	record.storeInteger(f_mon_io_page_marks, statistics.getValue(RuntimeStatistics::PAGE_MARKS));
+	record.storeInteger(f_mon_io_page_prefetches, statistics.getValue(RuntimeStatistics::PAGE_PREFETCHES));
+	record.storeInteger(f_mon_io_page_prefetch_hits, statistics.getValue(RuntimeStatistics::PAGE_PREFETCH_HITS));
+	record.storeInteger(f_mon_io_page_write_runs, statistics.getValue(RuntimeStatistics::PAGE_WRITE_RUNS));
+	record.storeInteger(f_mon_io_page_run_writes, statistics.getValue(RuntimeStatistics::PAGE_RUN_WRITES));
 	record.write();
 
 	// logical I/O statistics (global)
@@ -1243,6 +1284,22 @@ void Monitoring::putStatistics(SnapshotData::DumpRecord& record, const RuntimeSt
 	record.storeInteger(f_mon_rec_imgc, statistics.getValue(RuntimeStatistics::RECORD_IMGC));
 	record.write();
 
+	// wait statistics
+	record.reset(rel_mon_wait_stats);
+	record.storeGlobalId(f_mon_wait_stat_id, id);
+	record.storeInteger(f_mon_wait_stat_group, stat_group);
+	record.storeInteger(f_mon_wait_latch_waits, statistics.getValue(RuntimeStatistics::LATCH_WAITS));
+	record.storeInteger(f_mon_wait_latch_time, statistics.getValue(RuntimeStatistics::LATCH_WAIT_TIME));
+	record.storeInteger(f_mon_wait_lock_waits, statistics.getValue(RuntimeStatistics::LOCK_WAITS));
+	record.storeInteger(f_mon_wait_lock_time, statistics.getValue(RuntimeStatistics::LOCK_WAIT_TIME));
+	record.storeInteger(f_mon_wait_read_waits, statistics.getValue(RuntimeStatistics::READ_WAITS));
+	record.storeInteger(f_mon_wait_read_time, statistics.getValue(RuntimeStatistics::READ_WAIT_TIME));
+	record.storeInteger(f_mon_wait_write_waits, statistics.getValue(RuntimeStatistics::WRITE_WAITS));
+	record.storeInteger(f_mon_wait_write_time, statistics.getValue(RuntimeStatistics::WRITE_WAIT_TIME));
+	record.storeInteger(f_mon_wait_temp_waits, statistics.getValue(RuntimeStatistics::TEMP_WAITS));
+	record.storeInteger(f_mon_wait_temp_time, statistics.getValue(RuntimeStatistics::TEMP_WAIT_TIME));
+	record.write();
+
 	// logical I/O statistics (table wise)
 
 	for (RuntimeStatistics::Iterator iter = statistics.begin(); iter != statistics.end(); ++iter)
@@ -1299,6 +1356,51 @@ void Monitoring::putContextVars(SnapshotData::DumpRecord& record, const StringMa
 }
 
 
+void Monitoring::putCachePartitions(SnapshotData::DumpRecord& record, const BufferControl* bcb)
+{
+	if (!bcb)
+		return;
+
+	// The counters are read without locking, thus they're approximate
+
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+	{
+		const BufferPartition* const part = bcb->bcb_partitions[i];
+
+		record.reset(rel_mon_cache_parts);
+		record.storeInteger(f_mon_cp_id, part->bcp_id);
+		record.storeInteger(f_mon_cp_page_bufs, part->bcp_count);
+		record.storeInteger(f_mon_cp_dirty_pages, part->bcp_dirty_count);
+		record.storeInteger(f_mon_cp_hash_waits, part->bcp_hash_waits.value());
+		record.storeInteger(f_mon_cp_lru_waits, part->bcp_lru_waits.value());
+		record.storeInteger(f_mon_cp_dirty_waits, part->bcp_dirty_waits.value());
+		record.write();
+	}
+}
+
+
+void Monitoring::putLatency(SnapshotData::DumpRecord& record, const LatencyHistogram& latency,
+							SINT64 stmt_id)
+{
+	// Only the buckets with executions are reported
+
+	for (unsigned i = 0; i < LatencyHistogram::BUCKETS; i++)
+	{
+		const FB_UINT64 count = latency.getCount(i);
+
+		if (!count)
+			continue;
+
+		record.reset(rel_mon_stmt_latency);
+		record.storeInteger(f_mon_lat_stmt_id, stmt_id);
+		if (const FB_UINT64 limit = LatencyHistogram::getLimit(i))
+			record.storeInteger(f_mon_lat_limit, limit);
+		record.storeInteger(f_mon_lat_executions, count);
+		record.write();
+	}
+}
+
+
 void Monitoring::putMemoryUsage(SnapshotData::DumpRecord& record, const MemoryStats& stats,
 								int stat_id, int stat_group)
 {
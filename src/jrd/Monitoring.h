@@ -35,10 +35,12 @@
 namespace Jrd {
 
 // forward declarations
+class BufferControl;
 class jrd_rel;
 class Record;
 class RecordBuffer;
 class RuntimeStatistics;
+class LatencyHistogram;
 
 class SnapshotData
 {
@@ -405,6 +407,8 @@ private:
 	static void putStatistics(SnapshotData::DumpRecord&, const RuntimeStatistics&, int, int);
 	static void putContextVars(SnapshotData::DumpRecord&, const Firebird::StringMap&, SINT64, bool);
 	static void putMemoryUsage(SnapshotData::DumpRecord&, const Firebird::MemoryStats&, int, int);
+	static void putCachePartitions(SnapshotData::DumpRecord&, const BufferControl*);
+	static void putLatency(SnapshotData::DumpRecord&, const LatencyHistogram&, SINT64);
 };
 
 } // namespace
@@ -33,6 +33,7 @@
 #include "../jrd/btr.h"
 #include "../jrd/intl.h"
 #include "../jrd/Collation.h"
+#include "../jrd/ColumnStatistics.h"
 #include "../jrd/rse.h"
 #include "../jrd/ods.h"
 #include "../jrd/Optimizer.h"
@@ -395,6 +396,9 @@ OptimizerRetrieval::OptimizerRetrieval(MemoryPool& p, OptimizerBlk* opt,
 	CompilerScratch::csb_repeat* csb_tail = &csb->csb_rpt[this->stream];
 	relation = csb_tail->csb_relation;
 
+	// Column statistics collected by SET STATISTICS TABLE, if any
+	statistics = relation ? MET_get_statistics(tdbb, relation) : NULL;
+
 	// Allocate needed indexScratches
 
 	index_desc* idx = csb_tail->csb_idx->items;
@@ -584,10 +588,16 @@ InversionCandidate* OptimizerRetrieval::generateInversion()
 			node->computable(csb, stream, true) &&
 			!invCandidate->matches.exist(node))
 		{
-			const ComparativeBoolNode* const cmpNode = nodeAs<ComparativeBoolNode>(node);
+			double factor;
+
+			if (!getFilterSelectivity(node, factor))
+			{
+				const ComparativeBoolNode* const cmpNode = nodeAs<ComparativeBoolNode>(node);
+
+				factor = (cmpNode && cmpNode->blrOp == blr_eql) ?
+					REDUCE_SELECTIVITY_FACTOR_EQUALITY : REDUCE_SELECTIVITY_FACTOR_INEQUALITY;
+			}
 
-			const double factor = (cmpNode && cmpNode->blrOp == blr_eql) ?
-				REDUCE_SELECTIVITY_FACTOR_EQUALITY : REDUCE_SELECTIVITY_FACTOR_INEQUALITY;
 			invCandidate->selectivity *= factor;
 		}
 	}
@@ -1086,6 +1096,16 @@ void OptimizerRetrieval::getInversionCandidates(InversionCandidateList* inversio
 					//		   much bigger bitmap than expected here. I think
 					//		   appropriate reduce selectivity factors are required
 					//		   to be applied here.
+
+					// Column statistics do reflect both nulls and skewed values,
+					// so use them for the leading segment if they're available
+					double columnSelectivity;
+
+					if (j == 0 && !scratch.idx->idx_expression &&
+						getSegmentSelectivity(segment, scratch.idx->idx_rpt[j].idx_field, columnSelectivity))
+					{
+						scratch.selectivity = columnSelectivity;
+					}
 				}
 				else
 				{
@@ -1129,13 +1149,28 @@ void OptimizerRetrieval::getInversionCandidates(InversionCandidateList* inversio
 							break;
 					}
 
-					// Adjust the compound selectivity using the reduce factor.
-					// It should be better than the previous segment but worse
-					// than a full match.
-					const double diffSelectivity = scratch.selectivity - selectivity;
-					selectivity += (diffSelectivity * factor);
-					fb_assert(selectivity <= scratch.selectivity);
-					scratch.selectivity = selectivity;
+					double fraction;
+
+					if (segment->scanType != segmentScanNone &&
+						segment->scanType != segmentScanStarting &&
+						!scratch.idx->idx_expression &&
+						getSegmentSelectivity(segment, scratch.idx->idx_rpt[j].idx_field, fraction))
+					{
+						// The histogram tells the fraction of the matching records,
+						// but it cannot be better than a full match
+						selectivity = MAX(scratch.selectivity * fraction, selectivity);
+						scratch.selectivity = MIN(selectivity, scratch.selectivity);
+					}
+					else
+					{
+						// Adjust the compound selectivity using the reduce factor.
+						// It should be better than the previous segment but worse
+						// than a full match.
+						const double diffSelectivity = scratch.selectivity - selectivity;
+						selectivity += (diffSelectivity * factor);
+						fb_assert(selectivity <= scratch.selectivity);
+						scratch.selectivity = selectivity;
+					}
 
 					if (segment->scanType != segmentScanNone)
 					{
@@ -2512,6 +2547,228 @@ void OptimizerRetrieval::printFinalCandidate(const InversionCandidate* candidate
 #endif
 
 
+const ColumnStatistics* OptimizerRetrieval::getColumnStatistics(const ValueExprNode* node,
+	USHORT& fieldId) const
+{
+/**************************************
+ *
+ *	g e t C o l u m n S t a t i s t i c s
+ *
+ **************************************
+ *
+ * Functional description
+ *	Return the statistics of the column
+ *	referenced by the given field node.
+ *
+ **************************************/
+	if (!statistics)
+		return NULL;
+
+	const FieldNode* const fieldNode = nodeAs<FieldNode>(node);
+
+	if (!fieldNode || fieldNode->fieldStream != stream)
+		return NULL;
+
+	fieldId = fieldNode->fieldId;
+	return statistics->get(fieldId);
+}
+
+bool OptimizerRetrieval::getLiteralOrdinal(const ValueExprNode* node, USHORT fieldId,
+	double& ordinal) const
+{
+/**************************************
+ *
+ *	g e t L i t e r a l O r d i n a l
+ *
+ **************************************
+ *
+ * Functional description
+ *	Map the literal value compared with the
+ *	given column to the histogram domain.
+ *
+ **************************************/
+	const CastNode* const castNode = nodeAs<CastNode>(node);
+
+	if (castNode)
+		node = castNode->source;
+
+	const LiteralNode* const literal = nodeAs<LiteralNode>(node);
+
+	if (!literal)
+		return false;
+
+	const Format* const format = MET_current(tdbb, relation);
+
+	if (fieldId >= format->fmt_count)
+		return false;
+
+	return ColumnStatistics::getOrdinal(tdbb, &literal->litDesc, &format->fmt_desc[fieldId], ordinal);
+}
+
+bool OptimizerRetrieval::getFilterSelectivity(const BoolExprNode* node, double& selectivity) const
+{
+/**************************************
+ *
+ *	g e t F i l t e r S e l e c t i v i t y
+ *
+ **************************************
+ *
+ * Functional description
+ *	Estimate the selectivity of a filter
+ *	using the column statistics.
+ *
+ **************************************/
+	if (!statistics)
+		return false;
+
+	USHORT fieldId;
+
+	if (const NotBoolNode* const notNode = nodeAs<NotBoolNode>(node))
+	{
+		if (!getFilterSelectivity(notNode->arg, selectivity))
+			return false;
+
+		selectivity = 1 - selectivity;
+		return true;
+	}
+
+	if (const MissingBoolNode* const missingNode = nodeAs<MissingBoolNode>(node))
+	{
+		const ColumnStatistics* const column = getColumnStatistics(missingNode->arg, fieldId);
+
+		if (!column)
+			return false;
+
+		selectivity = column->nullFraction;
+		return true;
+	}
+
+	const ComparativeBoolNode* const cmpNode = nodeAs<ComparativeBoolNode>(node);
+
+	if (!cmpNode)
+		return false;
+
+	UCHAR blrOp = cmpNode->blrOp;
+	const ValueExprNode* value = cmpNode->arg2;
+	const ColumnStatistics* column = getColumnStatistics(cmpNode->arg1, fieldId);
+
+	if (!column && blrOp != blr_between)
+	{
+		// Try the reversed comparison
+		column = getColumnStatistics(cmpNode->arg2, fieldId);
+		value = cmpNode->arg1;
+
+		switch (blrOp)
+		{
+			case blr_gtr:
+				blrOp = blr_lss;
+				break;
+			case blr_geq:
+				blrOp = blr_leq;
+				break;
+			case blr_lss:
+				blrOp = blr_gtr;
+				break;
+			case blr_leq:
+				blrOp = blr_geq;
+				break;
+		}
+	}
+
+	if (!column)
+		return false;
+
+	double ordinal, upper;
+
+	switch (blrOp)
+	{
+		case blr_eql:
+		case blr_equiv:
+			selectivity = column->getEqualitySelectivity(
+				getLiteralOrdinal(value, fieldId, ordinal) ? &ordinal : NULL);
+			return true;
+
+		case blr_neq:
+			selectivity = 1 - column->nullFraction - column->getEqualitySelectivity(
+				getLiteralOrdinal(value, fieldId, ordinal) ? &ordinal : NULL);
+			selectivity = MAX(selectivity, 0);
+			return true;
+
+		case blr_gtr:
+		case blr_geq:
+			return getLiteralOrdinal(value, fieldId, ordinal) &&
+				column->getRangeSelectivity(&ordinal, blrOp == blr_gtr, NULL, false, selectivity);
+
+		case blr_lss:
+		case blr_leq:
+			return getLiteralOrdinal(value, fieldId, ordinal) &&
+				column->getRangeSelectivity(NULL, false, &ordinal, blrOp == blr_lss, selectivity);
+
+		case blr_between:
+			return getLiteralOrdinal(cmpNode->arg2, fieldId, ordinal) &&
+				getLiteralOrdinal(cmpNode->arg3, fieldId, upper) &&
+				column->getRangeSelectivity(&ordinal, false, &upper, false, selectivity);
+	}
+
+	return false;
+}
+
+bool OptimizerRetrieval::getSegmentSelectivity(const IndexScratchSegment* segment, USHORT fieldId,
+	double& selectivity) const
+{
+/**************************************
+ *
+ *	g e t S e g m e n t S e l e c t i v i t y
+ *
+ **************************************
+ *
+ * Functional description
+ *	Estimate the fraction of records matching
+ *	the index segment using the column statistics.
+ *
+ **************************************/
+	const ColumnStatistics* const column = statistics ? statistics->get(fieldId) : NULL;
+
+	if (!column)
+		return false;
+
+	double lower, upper;
+
+	switch (segment->scanType)
+	{
+		case segmentScanMissing:
+			selectivity = column->nullFraction;
+			return true;
+
+		case segmentScanEqual:
+		case segmentScanEquivalent:
+			selectivity = column->getEqualitySelectivity(
+				getLiteralOrdinal(segment->lowerValue, fieldId, lower) ? &lower : NULL);
+			return true;
+
+		case segmentScanBetween:
+			return getLiteralOrdinal(segment->lowerValue, fieldId, lower) &&
+				getLiteralOrdinal(segment->upperValue, fieldId, upper) &&
+				column->getRangeSelectivity(&lower, segment->excludeLower,
+					&upper, segment->excludeUpper, selectivity);
+
+		case segmentScanGreater:
+			return getLiteralOrdinal(segment->lowerValue, fieldId, lower) &&
+				column->getRangeSelectivity(&lower, segment->excludeLower,
+					NULL, false, selectivity);
+
+		case segmentScanLess:
+			return getLiteralOrdinal(segment->upperValue, fieldId, upper) &&
+				column->getRangeSelectivity(NULL, false,
+					&upper, segment->excludeUpper, selectivity);
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
 bool OptimizerRetrieval::validateStarts(IndexScratch* indexScratch, ComparativeBoolNode* cmpNode,
 	USHORT segment) const
 {
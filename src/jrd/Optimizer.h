@@ -44,6 +44,9 @@
 
 namespace Jrd {
 
+class ColumnStatistics;
+class RelationStatistics;
+
 
 // AB: 2005-11-05
 // Constants below needs some discussions and ideas
@@ -211,6 +214,12 @@ protected:
 	bool validateStarts(IndexScratch* indexScratch, ComparativeBoolNode* cmpNode,
 		USHORT segment) const;
 
+	const ColumnStatistics* getColumnStatistics(const ValueExprNode* node, USHORT& fieldId) const;
+	bool getLiteralOrdinal(const ValueExprNode* node, USHORT fieldId, double& ordinal) const;
+	bool getFilterSelectivity(const BoolExprNode* node, double& selectivity) const;
+	bool getSegmentSelectivity(const IndexScratchSegment* segment, USHORT fieldId,
+		double& selectivity) const;
+
 private:
 	MemoryPool& pool;
 	thread_db* tdbb;
@@ -230,6 +239,7 @@ public:
 	bool createIndexScanNodes;
 	bool setConjunctionsMatched;
 	InversionCandidate* navigationCandidate;
+	const RelationStatistics* statistics;
 };
 
 class IndexRelationship
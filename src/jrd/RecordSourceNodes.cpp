@@ -1629,12 +1629,35 @@ RecordSource* AggregateSourceNode::generate(thread_db* tdbb, OptimizerBlk* opt,
 		rse->flags |= RseNode::FLAG_OPT_FIRST_ROWS;
 	}
 
+	// Allow the optimizer to group the records by hashing instead of sorting them
+	// if the hash aggregation supports the grouping keys and aggregate functions.
+	// The optimizer resets the flag if it prefers to sort.
+
+	if (!rse->rse_aggregate && !rse->rse_plan && group && !orderedGroups &&
+		tdbb->getDatabase()->dbb_config->getHashAggregateMemory() &&
+		HashAggregate::isSupported(tdbb, csb, &group->expressions, map))
+	{
+		rse->flags |= RseNode::FLAG_OPT_HASH_GROUPING;
+	}
+	else
+		rse->flags &= ~RseNode::FLAG_OPT_HASH_GROUPING;
+
 	RecordSource* const nextRsb = OPT_compile(tdbb, csb, rse, &deliverStack);
 
 	// allocate and optimize the record source block
 
-	AggregatedStream* const rsb = FB_NEW_POOL(*tdbb->getDefaultPool()) AggregatedStream(tdbb, csb,
-		stream, (group ? &group->expressions : NULL), map, nextRsb);
+	RecordSource* rsb;
+
+	if (rse->flags & RseNode::FLAG_OPT_HASH_GROUPING)
+	{
+		rsb = FB_NEW_POOL(*tdbb->getDefaultPool()) HashAggregate(tdbb, csb,
+			stream, &group->expressions, map, nextRsb);
+	}
+	else
+	{
+		rsb = FB_NEW_POOL(*tdbb->getDefaultPool()) AggregatedStream(tdbb, csb,
+			stream, (group ? &group->expressions : NULL), map, nextRsb);
+	}
 
 	if (rse->rse_aggregate)
 	{
@@ -468,6 +468,7 @@ public:
 		  dsqlWindow(false),
 		  group(NULL),
 		  map(NULL),
+		  orderedGroups(false),
 		  rse(NULL)
 	{
 	}
@@ -517,6 +518,7 @@ public:
 	bool dsqlWindow;
 	NestConst<SortNode> group;
 	NestConst<MapNode> map;
+	bool orderedGroups;		// parent relies on groups being returned in the GROUP BY order
 
 private:
 	NestConst<RseNode> rse;
@@ -665,6 +667,7 @@ public:
 	static const unsigned FLAG_DSQL_COMPARATIVE	= 0x10;	// transformed from DSQL ComparativeBoolNode
 	static const unsigned FLAG_OPT_FIRST_ROWS	= 0x20;	// optimize retrieval for first rows
 	static const unsigned FLAG_LATERAL			= 0x40;	// lateral derived table
+	static const unsigned FLAG_OPT_HASH_GROUPING	= 0x80;	// grouping may be done by hashing instead of sorting
 
 	explicit RseNode(MemoryPool& pool)
 		: TypedNode<RecordSourceNode, RecordSourceNode::TYPE_RSE>(pool),
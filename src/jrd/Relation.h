@@ -33,6 +33,7 @@ namespace Jrd
 {
 
 class BoolExprNode;
+class RelationStatistics;
 class RseNode;
 class StmtNode;
 
@@ -265,6 +266,8 @@ public:
 
 	TriState	rel_repl_state;			// replication state
 
+	RelationStatistics*	rel_statistics;		// sampled column statistics, if any
+
 	Firebird::Mutex rel_drop_mutex;
 
 	bool isSystem() const;
@@ -397,6 +400,7 @@ const ULONG REL_jrd_view				= 0x10000;	// relation is VIEW
 const ULONG REL_gc_blocking				= 0x20000;	// request to downgrade\release gc lock
 const ULONG REL_gc_disabled				= 0x40000;	// gc is disabled temporarily
 const ULONG REL_gc_lockneed				= 0x80000;	// gc lock should be acquired
+const ULONG REL_stats_loaded			= 0x100000;	// column statistics are loaded
 
 
 /// class jrd_rel
@@ -405,7 +409,7 @@ inline jrd_rel::jrd_rel(MemoryPool& p)
 	: rel_pool(&p), rel_flags(REL_gc_lockneed),
 	  rel_name(p), rel_owner_name(p), rel_security_name(p),
 	  rel_view_contexts(p), rel_gc_records(p), rel_ss_definer(false),
-	  rel_pages_base(p)
+	  rel_statistics(NULL), rel_pages_base(p)
 {
 }
 
@@ -67,6 +67,22 @@ public:
 		RECORD_RPT_READS,
 		RECORD_IMGC,
 		RECORD_LAST_ITEM = RECORD_IMGC,
+		PAGE_PREFETCHES,
+		PAGE_PREFETCH_HITS,
+		PAGE_WRITE_RUNS,
+		PAGE_RUN_WRITES,
+		SORT_PARALLEL_RUNS,
+		SORT_PARALLEL_TIME,
+		LATCH_WAITS,		// every number of waits is followed
+		LATCH_WAIT_TIME,	// by the time spent, in microseconds
+		LOCK_WAITS,
+		LOCK_WAIT_TIME,
+		READ_WAITS,
+		READ_WAIT_TIME,
+		WRITE_WAITS,
+		WRITE_WAIT_TIME,
+		TEMP_WAITS,
+		TEMP_WAIT_TIME,
 		TOTAL_ITEMS		// last
 	};
 
@@ -241,9 +257,10 @@ public:
 		if (baseStats.allChgNumber != newStats.allChgNumber)
 		{
 			const size_t FIRST_ITEM = relStatsOnly ? REL_BASE_OFFSET : 0;
+			const size_t LAST_ITEM = relStatsOnly ? REL_BASE_OFFSET + REL_TOTAL_ITEMS : TOTAL_ITEMS;
 
 			allChgNumber++;
-			for (size_t i = FIRST_ITEM; i < TOTAL_ITEMS; ++i)
+			for (size_t i = FIRST_ITEM; i < LAST_ITEM; ++i)
 				values[i] += newStats.values[i] - baseStats.values[i];
 
 			if (baseStats.relChgNumber != newStats.relChgNumber)
@@ -363,6 +380,45 @@ private:
 	static Firebird::GlobalPtr<RuntimeStatistics> dummy;
 };
 
+// Log-bucketed histogram of execution times. Bucket N counts executions
+// shorter than 2^N microseconds, the last one counts all the longer ones.
+
+class LatencyHistogram
+{
+public:
+	static const unsigned BUCKETS = 32;
+
+	LatencyHistogram()
+	{
+		memset(counts, 0, sizeof(counts));
+	}
+
+	void add(FB_UINT64 micros)
+	{
+		unsigned n = 0;
+		while (n < BUCKETS - 1 && (micros >> n))
+			n++;
+
+		counts[n]++;
+	}
+
+	FB_UINT64 getCount(unsigned n) const
+	{
+		fb_assert(n < BUCKETS);
+		return counts[n];
+	}
+
+	// Upper bound of the bucket in microseconds, 0 for the unbounded last one
+	static FB_UINT64 getLimit(unsigned n)
+	{
+		fb_assert(n < BUCKETS);
+		return (n < BUCKETS - 1) ? (FB_UINT64(1) << n) : 0;
+	}
+
+private:
+	FB_UINT64 counts[BUCKETS];
+};
+
 } // namespace
 
 #endif // JRD_RUNTIME_STATISTICS_H
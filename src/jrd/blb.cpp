@@ -2326,10 +2326,8 @@ blob_page* blb::get_next_page(thread_db* tdbb, WIN* window)
 	}
 
 	SET_TDBB(tdbb);
-#ifdef SUPERSERVER_V2
 	Database* dbb = tdbb->getDatabase();
-	ULONG pages[PREFETCH_MAX_PAGES];
-#endif
+	SLONG pages[PREFETCH_MAX_PAGES];
 
 	const vcl& vector = *blb_pages;
 
@@ -2337,7 +2335,6 @@ blob_page* blb::get_next_page(thread_db* tdbb, WIN* window)
 	// Level 1 blobs are much easier -- page number is in vector.
 	if (blb_level == 1)
 	{
-#ifdef SUPERSERVER_V2
 		// Perform prefetch of blob level 1 data pages.
 
 		if (!(blb_sequence % dbb->dbb_prefetch_sequence))
@@ -2351,7 +2348,7 @@ blob_page* blb::get_next_page(thread_db* tdbb, WIN* window)
 
 			CCH_PREFETCH(tdbb, pages, i);
 		}
-#endif
+
 		window->win_page = vector[blb_sequence];
 		page = (blob_page*) CCH_FETCH(tdbb, window, LCK_read, pag_blob);
 	}
@@ -2359,7 +2356,7 @@ blob_page* blb::get_next_page(thread_db* tdbb, WIN* window)
 	{
 		window->win_page = vector[blb_sequence / blb_pointers];
 		page = (blob_page*) CCH_FETCH(tdbb, window, LCK_read, pag_blob);
-#ifdef SUPERSERVER_V2
+
 		// Perform prefetch of blob level 2 data pages.
 
 		USHORT sequence = blb_sequence % blb_pointers;
@@ -2376,7 +2373,7 @@ blob_page* blb::get_next_page(thread_db* tdbb, WIN* window)
 
 			CCH_PREFETCH(tdbb, pages, i);
 		}
-#endif
+
 		page = (blob_page*) CCH_HANDOFF(tdbb, window,
 										page->blp_page[blb_sequence % blb_pointers],
 										LCK_read, pag_blob);
@@ -258,6 +258,86 @@ struct IndexCreation
 	SLONG duplicates;
 };
 
+// Keys of the non-unique indices of a relation bulk loaded by a batch.
+// They are collected while the rows are stored and inserted into the
+// indices in key order when the batch is done, so every leaf page is
+// visited once instead of once per row.
+
+class DeferredIndexKeys
+{
+	struct Entry
+	{
+		SINT64 number;
+		ULONG offset;
+		USHORT length;
+		USHORT indexId;
+		USHORT nulls;
+		UCHAR flags;
+	};
+
+	class Compare
+	{
+	public:
+		explicit Compare(const UCHAR* data)
+			: m_data(data)
+		{}
+
+		bool operator()(const Entry& e1, const Entry& e2) const;
+
+	private:
+		const UCHAR* const m_data;
+	};
+
+public:
+	static const ULONG MAX_DATA_SIZE = 16 * 1024 * 1024;	// flush when so many key bytes are kept
+
+	DeferredIndexKeys(MemoryPool& p, jrd_rel* relation)
+		: m_relation(relation), m_data(p), m_entries(p), m_acceptedData(0), m_acceptedEntries(0)
+	{}
+
+	static jrd_rel* getTarget(const JrdStatement* statement);
+
+	jrd_rel* getRelation() const
+	{
+		return m_relation;
+	}
+
+	static bool defer(const index_desc* idx)
+	{
+		return !(idx->idx_flags & (idx_unique | idx_primary | idx_foreign));
+	}
+
+	bool isFull() const
+	{
+		return m_acceptedData >= MAX_DATA_SIZE;
+	}
+
+	void add(const index_desc* idx, const temporary_key* key, RecordNumber number);
+
+	// Keys of the row being stored become part of the batch
+	void accept()
+	{
+		m_acceptedData = m_data.getCount();
+		m_acceptedEntries = m_entries.getCount();
+	}
+
+	// The row being stored has been undone, forget its keys
+	void discard()
+	{
+		m_data.shrink(m_acceptedData);
+		m_entries.shrink(m_acceptedEntries);
+	}
+
+	void flush(thread_db* tdbb, jrd_tra* transaction);
+
+private:
+	jrd_rel* const m_relation;
+	Firebird::Array<UCHAR> m_data;
+	Firebird::Array<Entry> m_entries;
+	FB_SIZE_T m_acceptedData;
+	FB_SIZE_T m_acceptedEntries;
+};
+
 // Class used to report any index related errors
 
 class IndexErrorContext
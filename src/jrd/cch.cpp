@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <thread>
 #include "../jrd/jrd.h"
 #include "../jrd/que.h"
 #include "../jrd/lck.h"
@@ -77,10 +78,6 @@ using namespace Firebird;
 IMPLEMENT_TRACE_ROUTINE(cch_trace, "CCH")
 #endif
 
-#ifdef SUPERSERVER_V2
-#define CACHE_READER
-#endif
-
 
 static inline void PAGE_LOCK_RELEASE(thread_db* tdbb, BufferControl* bcb, Lock* lock)
 {
@@ -115,23 +112,19 @@ enum LatchState
 	lsPageChanged
 };
 
-static void adjust_scan_count(WIN* window, bool mustRead);
+static void adjust_scan_count(thread_db* tdbb, WIN* window, bool mustRead);
 static BufferDesc* alloc_bdb(thread_db*, BufferControl*, UCHAR **);
 static Lock* alloc_page_lock(Jrd::thread_db*, BufferDesc*);
 static int blocking_ast_bdb(void*);
-#ifdef CACHE_READER
-static void prefetch_epilogue(Prefetch*, FbStatusVector *);
-static void prefetch_init(Prefetch*, thread_db*);
-static void prefetch_io(Prefetch*, FbStatusVector *);
-static void prefetch_prologue(Prefetch*, SLONG *);
-#endif
 static void check_precedence(thread_db*, WIN*, PageNumber);
 static void clear_precedence(thread_db*, BufferDesc*);
 static BufferDesc* dealloc_bdb(BufferDesc*);
 static void down_grade(thread_db*, BufferDesc*, int high = 0);
 static bool expand_buffers(thread_db*, ULONG);
-static BufferDesc* find_buffer(BufferControl* bcb, const PageNumber page, bool findPending);
+static BufferDesc* find_buffer(BufferControl* bcb, BufferPartition* part, const PageNumber page,
+	bool findPending);
 static BufferDesc* get_buffer(thread_db*, const PageNumber, SyncType, int);
+static ULONG get_partition_count(const Database*, ULONG);
 static int get_related(BufferDesc*, PagesArray&, int, const ULONG);
 static ULONG get_prec_walk_mark(BufferControl*);
 static LatchState latch_buffer(thread_db*, Sync&, BufferDesc*, const PageNumber, SyncType, int);
@@ -139,56 +132,124 @@ static LockState lock_buffer(thread_db*, BufferDesc*, const SSHORT, const SCHAR)
 static ULONG memory_init(thread_db*, BufferControl*, SLONG);
 static void page_validation_error(thread_db*, win*, SSHORT);
 static void purgePrecedence(BufferControl*, BufferDesc*);
+static void resize_partition(BufferControl*, BufferPartition*);
 static SSHORT related(BufferDesc*, const BufferDesc*, SSHORT, const ULONG);
 static bool writeable(BufferDesc*);
 static bool is_writeable(BufferDesc*, const ULONG);
 static int write_buffer(thread_db*, BufferDesc*, const PageNumber, const bool, FbStatusVector* const,
-	const bool);
-static bool write_page(thread_db*, BufferDesc*, FbStatusVector* const, const bool);
+	const bool, IoBatch* = NULL);
+static bool write_page(thread_db*, BufferDesc*, FbStatusVector* const, const bool, IoBatch* = NULL);
+static void page_written(thread_db*, BufferDesc*);
+static bool write_batch(thread_db*, IoBatch&, const bool);
 static bool set_diff_page(thread_db*, BufferDesc*);
 static void clear_dirty_flag_and_nbak_state(thread_db*, BufferDesc*);
 
 
 
-static inline void insertDirty(BufferControl* bcb, BufferDesc* bdb)
+// Lock one of the cache partition's sync objects counting the contention
+
+static inline void lockPartition(Sync& sync, SyncType type, AtomicCounter& waits)
+{
+	if (!sync.lockConditional(type))
+	{
+		++waits;
+		sync.lock(type);
+	}
+}
+
+static inline void insertDirty(BufferDesc* bdb)
 {
 	if (bdb->bdb_dirty.que_forward != &bdb->bdb_dirty)
 		return;
 
-	Sync dirtySync(&bcb->bcb_syncDirtyBdbs, "insertDirty");
-	dirtySync.lock(SYNC_EXCLUSIVE);
+	BufferPartition* const part = bdb->bdb_partition;
+
+	Sync dirtySync(&part->bcp_syncDirty, "insertDirty");
+	lockPartition(dirtySync, SYNC_EXCLUSIVE, part->bcp_dirty_waits);
 
 	if (bdb->bdb_dirty.que_forward != &bdb->bdb_dirty)
 		return;
 
-	bcb->bcb_dirty_count++;
-	QUE_INSERT(bcb->bcb_dirty, bdb->bdb_dirty);
+	part->bcp_dirty_count++;
+	QUE_INSERT(part->bcp_dirty, bdb->bdb_dirty);
 }
 
-static inline void removeDirty(BufferControl* bcb, BufferDesc* bdb)
+static inline void removeDirty(BufferDesc* bdb)
 {
 	if (bdb->bdb_dirty.que_forward == &bdb->bdb_dirty)
 		return;
 
-	Sync dirtySync(&bcb->bcb_syncDirtyBdbs, "removeDirty");
-	dirtySync.lock(SYNC_EXCLUSIVE);
+	BufferPartition* const part = bdb->bdb_partition;
+
+	Sync dirtySync(&part->bcp_syncDirty, "removeDirty");
+	lockPartition(dirtySync, SYNC_EXCLUSIVE, part->bcp_dirty_waits);
 
 	if (bdb->bdb_dirty.que_forward == &bdb->bdb_dirty)
 		return;
 
-	fb_assert(bcb->bcb_dirty_count > 0);
+	fb_assert(part->bcp_dirty_count > 0);
 
-	bcb->bcb_dirty_count--;
+	part->bcp_dirty_count--;
 	QUE_DELETE(bdb->bdb_dirty);
 	QUE_INIT(bdb->bdb_dirty);
 }
 
+// Buffer replacement policy. Callers must hold bcp_syncLRU of the partition.
+
+// Put buffer just assigned to the page into LRU que. With 2Q policy page
+// goes into probation que unless it was evicted from there not long ago.
+
+static inline void lruInsert(BufferControl* bcb, BufferPartition* part, BufferDesc* bdb,
+	const PageNumber& page)
+{
+	fb_assert(!bdb->bdb_probation);
+
+	if (bcb->bcb_policy == CACHE_POLICY_2Q && !part->bcp_ghosts.remove(page))
+	{
+		bdb->bdb_probation = true;
+		part->bcp_probation_count++;
+		QUE_INSERT(part->bcp_probation, bdb->bdb_in_use);
+	}
+	else
+		QUE_INSERT(part->bcp_in_use, bdb->bdb_in_use);
+}
+
+// Remove buffer from LRU que. If buffer is going to be reused for another
+// page, remember its current page when it was not promoted yet.
+
+static inline void lruRemove(BufferPartition* part, BufferDesc* bdb, bool evict)
+{
+	QUE_DELETE(bdb->bdb_in_use);
+	QUE_INIT(bdb->bdb_in_use);
+
+	if (bdb->bdb_probation)
+	{
+		bdb->bdb_probation = false;
+		part->bcp_probation_count--;
+
+		// Pages used by large scans and garbage collector only are not
+		// worth to be promoted when read again
+
+		if (evict && !(bdb->bdb_flags & BDB_scan_only))
+			part->bcp_ghosts.add(bdb->bdb_page);
+	}
+}
+
+// Make buffer the first candidate for reuse in its que
+
+static inline void lruAppend(BufferPartition* part, BufferDesc* bdb)
+{
+	QUE_DELETE(bdb->bdb_in_use);
+	QUE_APPEND(bdb->bdb_probation ? part->bcp_probation : part->bcp_in_use, bdb->bdb_in_use);
+}
+
 static void flushDirty(thread_db* tdbb, SLONG transaction_mask, const bool sys_only);
+static void groupFlush(thread_db* tdbb, SLONG transaction_mask, bool tip);
 static void flushAll(thread_db* tdbb, USHORT flush_flag);
 static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, FB_SIZE_T count);
 
 static void recentlyUsed(BufferDesc* bdb);
-static void requeueRecentlyUsed(BufferControl* bcb);
+static void requeueRecentlyUsed(BufferPartition* part);
 
 
 const ULONG MIN_BUFFER_SEGMENT = 65536;
@@ -226,12 +287,13 @@ void CCH_clean_page(thread_db* tdbb, PageNumber page)
 		return;
 
 	BufferControl* bcb = dbb->dbb_bcb;
+	BufferPartition* const part = bcb->getPartition(page);
 	BufferDesc* bdb = NULL;
 	{
-		Sync bcbSync(&bcb->bcb_syncObject, "CCH_clean_page");
-		bcbSync.lock(SYNC_SHARED);
+		Sync bcbSync(&part->bcp_syncObject, "CCH_clean_page");
+		lockPartition(bcbSync, SYNC_SHARED, part->bcp_hash_waits);
 
-		bdb = find_buffer(bcb, page, false);
+		bdb = find_buffer(bcb, part, page, false);
 		if (!bdb)
 			return;
 
@@ -260,21 +322,20 @@ void CCH_clean_page(thread_db* tdbb, PageNumber page)
 		bdb->bdb_mark_transaction = 0;
 
 		if (!(bdb->bdb_bcb->bcb_flags & BCB_keep_pages))
-			removeDirty(dbb->dbb_bcb, bdb);
+			removeDirty(bdb);
 
 		bdb->bdb_flags &= ~(BDB_must_write | BDB_system_dirty | BDB_db_dirty);
 		clear_dirty_flag_and_nbak_state(tdbb, bdb);
 	}
 
 	{
-		Sync lruSync(&bcb->bcb_syncLRU, "CCH_release");
-		lruSync.lock(SYNC_EXCLUSIVE);
+		Sync lruSync(&part->bcp_syncLRU, "CCH_release");
+		lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
 
 		if (bdb->bdb_flags & BDB_lru_chained)
-			requeueRecentlyUsed(bcb);
+			requeueRecentlyUsed(part);
 
-		QUE_DELETE(bdb->bdb_in_use);
-		QUE_APPEND(bcb->bcb_in_use, bdb->bdb_in_use);
+		lruAppend(part, bdb);
 	}
 
 	bdb->release(tdbb, true);
@@ -746,7 +807,7 @@ pag* CCH_fetch(thread_db* tdbb, WIN* window, int lock_type, SCHAR page_type, int
 		return NULL;			// latch or lock timeout
 	}
 
-	adjust_scan_count(window, lockState == lsLocked);
+	adjust_scan_count(tdbb, window, lockState == lsLocked);
 
 	// Validate the fetched page matches the expected type
 
@@ -1012,14 +1073,29 @@ void CCH_forget_page(thread_db* tdbb, WIN* window)
 		dbb->dbb_flags &= ~DBB_suspend_bgio;
 
 	clear_dirty_flag_and_nbak_state(tdbb, bdb);
+	BufferPartition* const part = bdb->bdb_partition;
+
+	removeDirty(bdb);
+
+	{
+		Sync lruSync(&part->bcp_syncLRU, FB_FUNCTION);
+		lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
+
+		if (bdb->bdb_flags & BDB_lru_chained)
+			requeueRecentlyUsed(part);
+
+		lruRemove(part, bdb, false);
+	}
+
 	bdb->bdb_flags = 0;
-	BufferControl* bcb = dbb->dbb_bcb;
 
-	removeDirty(bcb, bdb);
+	Sync bcbSync(&part->bcp_syncObject, FB_FUNCTION);
+	lockPartition(bcbSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
 
-	QUE_DELETE(bdb->bdb_in_use);
 	QUE_DELETE(bdb->bdb_que);
-	QUE_INSERT(bcb->bcb_empty, bdb->bdb_que);
+	QUE_INSERT(part->bcp_empty, bdb->bdb_que);
+
+	bcbSync.unlock();
 
 	if (tdbb->tdbb_flags & TDBB_no_cache_unwind)
 		bdb->release(tdbb, true);
@@ -1061,6 +1137,13 @@ void CCH_fini(thread_db* tdbb)
 	bcb->bcb_rpt = NULL;
 	bcb->bcb_count = 0;
 
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+		delete bcb->bcb_partitions[i];
+
+	delete[] bcb->bcb_partitions;
+	bcb->bcb_partitions = NULL;
+	bcb->bcb_part_count = 0;
+
 	while (bcb->bcb_memory.hasData())
 		bcb->bcb_bufferpool->deallocate(bcb->bcb_memory.pop());
 
@@ -1108,6 +1191,9 @@ void CCH_flush(thread_db* tdbb, USHORT flush_flag, TraNumber tra_number)
 		}
 		else
 #endif
+		if (transaction_mask && CCH_group_commit(tdbb))
+			groupFlush(tdbb, transaction_mask, (flush_flag & FLUSH_TIP) != 0);
+		else
 			flushDirty(tdbb, transaction_mask, sys_only);
 	}
 	else
@@ -1185,6 +1271,31 @@ void CCH_flush(thread_db* tdbb, USHORT flush_flag, TraNumber tra_number)
 	SDW_check(tdbb);
 }
 
+bool CCH_group_commit(thread_db* tdbb)
+{
+/**************************************
+ *
+ *	C C H _ g r o u p _ c o m m i t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Check if pages of concurrently committing transactions
+ *	are flushed together. It makes sense with the shared
+ *	cache and synchronous writes only.
+ *
+ **************************************/
+	SET_TDBB(tdbb);
+	Database* const dbb = tdbb->getDatabase();
+
+	if (!(dbb->dbb_flags & DBB_shared) || dbb->dbb_config->getGroupCommitDelay() < 0)
+		return false;
+
+	const PageSpace* const pageSpace = dbb->dbb_page_manager.findPageSpace(DB_PAGE_SPACE);
+	return (pageSpace->file->fil_flags & FIL_force_write) != 0;
+}
+
+
 void CCH_flush_ast(thread_db* tdbb)
 {
 /**************************************
@@ -1296,11 +1407,12 @@ void CCH_get_related(thread_db* tdbb, PageNumber page, PagesArray &lowPages)
 
 	Database* dbb = tdbb->getDatabase();
 	BufferControl* bcb = dbb->dbb_bcb;
+	BufferPartition* const part = bcb->getPartition(page);
 
-	Sync bcbSync(&bcb->bcb_syncObject, "CCH_get_related");
-	bcbSync.lock(SYNC_SHARED);
+	Sync bcbSync(&part->bcp_syncObject, "CCH_get_related");
+	lockPartition(bcbSync, SYNC_SHARED, part->bcp_hash_waits);
 
-	BufferDesc* bdb = find_buffer(bcb, page, false);
+	BufferDesc* bdb = find_buffer(bcb, part, page, false);
 	bcbSync.unlock();
 
 	if (bdb)
@@ -1411,7 +1523,7 @@ pag* CCH_handoff(thread_db*	tdbb, WIN* window, ULONG page, int lock, SCHAR page_
 			bdb->downgrade(SYNC_SHARED);
 	}
 
-	adjust_scan_count(window, must_read == lsLocked);
+	adjust_scan_count(tdbb, window, must_read == lsLocked);
 
 	// Validate the fetched page matches the expected type
 
@@ -1486,15 +1598,21 @@ void CCH_init(thread_db* tdbb, ULONG number)
 	bcb->bcb_flags = shared ? BCB_exclusive : 0;
 	//bcb->bcb_flags = BCB_exclusive;	// TODO detect real state using LM
 
-	QUE_INIT(bcb->bcb_in_use);
-	QUE_INIT(bcb->bcb_dirty);
-	bcb->bcb_dirty_count = 0;
-	QUE_INIT(bcb->bcb_empty);
+	// Split the cache into partitions, buffers are spread over them evenly
+
+	bcb->bcb_policy = dbb->dbb_config->getCachePolicy();
+	bcb->bcb_part_count = get_partition_count(dbb, number);
+	bcb->bcb_partitions = FB_NEW_POOL(*bcb->bcb_bufferpool) BufferPartition*[bcb->bcb_part_count];
+
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+		bcb->bcb_partitions[i] = FB_NEW_POOL(*bcb->bcb_bufferpool) BufferPartition(i);
 
 	// initialization of memory is system-specific
 
 	bcb->bcb_count = memory_init(tdbb, bcb, static_cast<SLONG>(number));
-	bcb->bcb_free_minimum = (SSHORT) MIN(bcb->bcb_count / 4, 128);
+
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+		resize_partition(bcb, bcb->bcb_partitions[i]);
 
 	if (bcb->bcb_count < MIN_PAGE_BUFFERS)
 		ERR_post(Arg::Gds(isc_cache_too_small));
@@ -1517,22 +1635,33 @@ void CCH_init2(thread_db* tdbb)
 	Database* dbb = tdbb->getDatabase();
 	BufferControl* bcb = dbb->dbb_bcb;
 
-	if (!(bcb->bcb_flags & BCB_exclusive) || (bcb->bcb_flags & (BCB_cache_writer | BCB_writer_start)))
+	if (!(bcb->bcb_flags & BCB_exclusive))
 		return;
 
-#ifdef CACHE_READER
-	if (gds__thread_start(cache_reader, dbb, THREAD_high, 0, 0))
+	const Attachment* att = tdbb->getAttachment();
+
+	if (!(bcb->bcb_flags & (BCB_cache_reader | BCB_reader_start)) &&
+		dbb->dbb_prefetch_pages && !(att->att_flags & ATT_security_db))
 	{
-		ERR_bugcheck_msg("cannot start thread");
-	}
+		// reader startup in progress
+		bcb->bcb_flags |= BCB_reader_start;
+
+		try
+		{
+			bcb->bcb_reader_fini.run(bcb);
+		}
+		catch (const Exception&)
+		{
+			bcb->bcb_flags &= ~BCB_reader_start;
+			ERR_bugcheck_msg("cannot start cache reader thread");
+		}
 
-	{ // scope
-		Database::Checkout dcoHolder(dbb, FB_FUNCTION);
-		dbb->dbb_reader_init.enter();
+		bcb->bcb_reader_init.enter();
 	}
-#endif
 
-	const Attachment* att = tdbb->getAttachment();
+	if (bcb->bcb_flags & (BCB_cache_writer | BCB_writer_start))
+		return;
+
 	if (!(dbb->dbb_flags & DBB_read_only) && !(att->att_flags & ATT_security_db))
 	{
 		// writer startup in progress
@@ -1634,7 +1763,7 @@ void CCH_mark(thread_db* tdbb, WIN* window, bool mark_system, bool must_write)
 	bdb->bdb_flags |= newFlags;
 
 	if (!(tdbb->tdbb_flags & TDBB_sweeper) || (bdb->bdb_flags & BDB_system_dirty))
-		insertDirty(bcb, bdb);
+		insertDirty(bdb);
 
 	bdb->bdb_flags |= BDB_marked | BDB_dirty;
 }
@@ -1722,7 +1851,6 @@ void CCH_precedence(thread_db* tdbb, WIN* window, PageNumber page)
 }
 
 
-#ifdef CACHE_READER
 void CCH_prefetch(thread_db* tdbb, SLONG* pages, SSHORT count)
 {
 /**************************************
@@ -1733,9 +1861,8 @@ void CCH_prefetch(thread_db* tdbb, SLONG* pages, SSHORT count)
  *
  * Functional description
  *	Given a vector of pages, set corresponding bits
- *	in global prefetch bitmap. Initiate an asynchronous
- *	I/O and get the cache reader reading in our behalf
- *	as well.
+ *	in global prefetch bitmap and get the cache reader
+ *	reading in our behalf.
  *
  **************************************/
 	SET_TDBB(tdbb);
@@ -1748,36 +1875,28 @@ void CCH_prefetch(thread_db* tdbb, SLONG* pages, SSHORT count)
 		return;
 	}
 
-	// Switch default pool to permanent pool for setting bits in prefetch bitmap.
-	Jrd::ContextPoolHolder context(tdbb, bcb->bcb_bufferpool);
-
 	// The global prefetch bitmap is the key to the I/O coalescense mechanism which dovetails
 	// all thread prefetch requests to minimize sequential I/O requests.
-	// It also enables multipage I/O by implicitly sorting page vector requests.
+	// It also implicitly sorts page vector requests.
 
-	SLONG first_page = 0;
-	for (const SLONG* const end = pages + count; pages < end;)
-	{
-		const SLONG page = *pages++;
-		if (page)
+	bool queued = false;
+	{	// scope
+		MutexLockGuard guard(bcb->bcb_prefetch_mutex, FB_FUNCTION);
+
+		for (const SLONG* const end = pages + count; pages < end; pages++)
 		{
-			SBM_set(tdbb, &bcb->bcb_prefetch, page);
-			if (!first_page)
-				first_page = page;
+			const SLONG page = *pages;
+
+			if (page > 0)
+			{
+				PBM_SET(bcb->bcb_bufferpool, &bcb->bcb_prefetch, page);
+				queued = true;
+			}
 		}
 	}
 
-	// Not likely that the caller's page vector was empty but check anyway.
-
-	if (first_page)
-	{
-		prf prefetch;
-
-		prefetch_init(&prefetch, tdbb);
-		prefetch_prologue(&prefetch, &first_page);
-		prefetch_io(&prefetch, tdbb->tdbb_status_vector);
-		prefetch_epilogue(&prefetch, tdbb->tdbb_status_vector);
-	}
+	if (queued && !(bcb->bcb_flags & BCB_reader_active))
+		bcb->bcb_reader_sem.release();
 }
 
 
@@ -1792,16 +1911,98 @@ bool CCH_prefetch_pages(thread_db* tdbb)
  * Functional description
  *	Check the prefetch bitmap for a set
  *	of pages and read them into the cache.
+ *	Return true if there was something to do.
  *
  **************************************/
+	SET_TDBB(tdbb);
+	Database* dbb = tdbb->getDatabase();
+	BufferControl* bcb = dbb->dbb_bcb;
 
-	// Placeholder to be implemented when predictive prefetch is
-	// enabled. This is called by VIO/garbage_collector() when it
-	// is idle to help satisfy the prefetch demand.
+	// Pick up the lowest pages from the prefetch bitmap. The bitmap is
+	// sorted, so the pages will be read in ascending order.
 
-	return false;
+	ULONG pages[PREFETCH_MAX_PAGES];
+	FB_SIZE_T count = 0;
+
+	{	// scope
+		MutexLockGuard guard(bcb->bcb_prefetch_mutex, FB_FUNCTION);
+
+		PageBitmap* const bitmap = bcb->bcb_prefetch;
+
+		if (bitmap && bitmap->getFirst())
+		{
+			do {
+				pages[count++] = bitmap->current();
+			} while (count < PREFETCH_MAX_PAGES && bitmap->getNext());
+
+			for (FB_SIZE_T i = 0; i < count; i++)
+				bitmap->clear(pages[i]);
+		}
+	}
+
+	if (!count)
+		return false;
+
+	for (FB_SIZE_T i = 0; i < count; i++)
+	{
+		if (!(bcb->bcb_flags & BCB_cache_reader) || (dbb->dbb_flags & DBB_suspend_bgio))
+			break;
+
+		const PageNumber page(DB_PAGE_SPACE, pages[i]);
+
+		{	// scope
+			BufferPartition* const part = bcb->getPartition(page);
+
+			Sync bcbSync(&part->bcp_syncObject, FB_FUNCTION);
+			lockPartition(bcbSync, SYNC_SHARED, part->bcp_hash_waits);
+
+			if (find_buffer(bcb, part, page, true))
+				continue;
+		}
+
+		// Don't wait for the buffer: if somebody else is already
+		// dealing with the page there is nothing to prefetch.
+
+		BufferDesc* const bdb = get_buffer(tdbb, page, SYNC_EXCLUSIVE, 0);
+
+		if (!bdb)
+			continue;
+
+		if (!(bdb->bdb_flags & BDB_read_pending))
+		{
+			bdb->release(tdbb, true);
+			continue;
+		}
+
+		WIN window(page);
+		window.win_bdb = bdb;
+		window.win_buffer = bdb->bdb_buffer;
+		window.win_flags = 0;
+
+		try
+		{
+			CCH_fetch_page(tdbb, &window, true);
+		}
+		catch (const Exception&)
+		{
+			// The buffer is still marked as read pending, thus the regular
+			// fetch will re-read the page and report the error, if any
+
+			if (bdb->ourExclusiveLock())
+				bdb->release(tdbb, true);
+			throw;
+		}
+
+		// Pages are prefetched for large scans only
+
+		bdb->bdb_flags |= (BDB_prefetch | BDB_scan_only);
+		bdb->release(tdbb, true);
+
+		tdbb->bumpStats(RuntimeStatistics::PAGE_PREFETCHES);
+	}
+
+	return true;
 }
-#endif // CACHE_READER
 
 
 bool set_diff_page(thread_db* tdbb, BufferDesc* bdb)
@@ -1949,7 +2150,7 @@ void CCH_release(thread_db* tdbb, WIN* window, const bool release_tail)
 
 			if (!write_buffer(tdbb, bdb, bdb->bdb_page, false, tdbb->tdbb_status_vector, true))
 			{
-				insertDirty(bcb, bdb);
+				insertDirty(bdb);
 				CCH_unwind(tdbb, true);
 			}
 		}
@@ -1992,23 +2193,24 @@ void CCH_release(thread_db* tdbb, WIN* window, const bool release_tail)
 				if (window->win_flags & WIN_garbage_collector)
 					bdb->bdb_flags &= ~BDB_garbage_collect;
 
-				{ // bcb_syncLRU scope
-					Sync lruSync(&bcb->bcb_syncLRU, "CCH_release");
-					lruSync.lock(SYNC_EXCLUSIVE);
+				{ // bcp_syncLRU scope
+					BufferPartition* const part = bdb->bdb_partition;
+
+					Sync lruSync(&part->bcp_syncLRU, "CCH_release");
+					lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
 
 					if (bdb->bdb_flags & BDB_lru_chained)
 					{
-						requeueRecentlyUsed(bcb);
+						requeueRecentlyUsed(part);
 					}
 
-					QUE_DELETE(bdb->bdb_in_use);
-					QUE_APPEND(bcb->bcb_in_use, bdb->bdb_in_use);
+					lruAppend(part, bdb);
 				}
 
 				if ((bcb->bcb_flags & BCB_cache_writer) &&
 					(bdb->bdb_flags & (BDB_dirty | BDB_db_dirty)) )
 				{
-					insertDirty(bcb, bdb);
+					insertDirty(bdb);
 
 					bcb->bcb_flags |= BCB_free_pending;
 					if (!(bcb->bcb_flags & BCB_writer_active))
@@ -2101,16 +2303,19 @@ void CCH_shutdown(thread_db* tdbb)
 	if (!bcb)
 		return;
 
-#ifdef CACHE_READER
+	// Wait for cache reader startup to complete
+
+	while (bcb->bcb_flags & BCB_reader_start)
+		Thread::yield();
+
 	// Shutdown the dedicated cache reader for this database
 
 	if (bcb->bcb_flags & BCB_cache_reader)
 	{
 		bcb->bcb_flags &= ~BCB_cache_reader;
-		dbb->dbb_reader_sem.release();
-		dbb->dbb_reader_fini.enter();
+		bcb->bcb_reader_sem.release();
+		bcb->bcb_reader_fini.waitForCompletion();
 	}
-#endif
 
 	// Wait for cache writer startup to complete
 
@@ -2420,7 +2625,7 @@ bool CCH_write_all_shadows(thread_db* tdbb, Shadow* shadow, BufferDesc* bdb, Ods
 }
 
 
-static void adjust_scan_count(WIN* window, bool mustRead)
+static void adjust_scan_count(thread_db* tdbb, WIN* window, bool mustRead)
 {
 /**************************************
  *
@@ -2437,15 +2642,24 @@ static void adjust_scan_count(WIN* window, bool mustRead)
 	// Otherwise zero the buffer scan count to prevent the buffer
 	// from being queued to the LRU tail.
 
+	// Page read on behalf of a large scan or the garbage collector stays
+	// a low priority one for the replacement policy until used by someone else.
+
 	if (window->win_flags & WIN_large_scan)
 	{
 		if (mustRead || (bdb->bdb_flags & BDB_prefetch) || bdb->bdb_scan_count < 0)
 			bdb->bdb_scan_count = window->win_scans;
+
+		if (mustRead)
+			bdb->bdb_flags |= BDB_scan_only;
 	}
 	else if (window->win_flags & WIN_garbage_collector)
 	{
 		if (mustRead)
+		{
 			bdb->bdb_scan_count = -1;
+			bdb->bdb_flags |= BDB_scan_only;
+		}
 
 		if (bdb->bdb_flags & BDB_garbage_collect)
 			window->win_flags |= WIN_garbage_collect;
@@ -2458,9 +2672,14 @@ static void adjust_scan_count(WIN* window, bool mustRead)
 	else
 	{
 		bdb->bdb_scan_count = 0;
-		if (bdb->bdb_flags & BDB_garbage_collect)
-			bdb->bdb_flags &= ~BDB_garbage_collect;
+		if (bdb->bdb_flags & (BDB_garbage_collect | BDB_scan_only))
+			bdb->bdb_flags &= ~(BDB_garbage_collect | BDB_scan_only);
 	}
+
+	// The first reference to a prefetched page makes it a regular one
+
+	if ((bdb->bdb_flags & BDB_prefetch) && (bdb->bdb_flags.exchangeBitAnd(~BDB_prefetch) & BDB_prefetch))
+		tdbb->bumpStats(RuntimeStatistics::PAGE_PREFETCH_HITS);
 }
 
 
@@ -2492,7 +2711,11 @@ static BufferDesc* alloc_bdb(thread_db* tdbb, BufferControl* bcb, UCHAR** memory
 	bdb->bdb_buffer = (pag*) *memory;
 	*memory += bcb->bcb_page_size;
 
-	QUE_INSERT(bcb->bcb_empty, bdb->bdb_que);
+	BufferPartition* const part = bcb->bcb_partitions[bcb->bcb_next_partition++ % bcb->bcb_part_count];
+	bdb->bdb_partition = part;
+	part->bcp_count++;
+
+	QUE_INSERT(part->bcp_empty, bdb->bdb_que);
 
 	return bdb;
 }
@@ -2610,19 +2833,22 @@ static void flushDirty(thread_db* tdbb, SLONG transaction_mask, const bool sys_o
 	BufferControl* bcb = dbb->dbb_bcb;
 	Firebird::HalfStaticArray<BufferDesc*, 1024> flush;
 
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
 	{  // dirtySync scope
-		Sync dirtySync(&bcb->bcb_syncDirtyBdbs, "flushDirty");
-		dirtySync.lock(SYNC_EXCLUSIVE);
+		BufferPartition* const part = bcb->bcb_partitions[i];
 
-		QUE que_inst = bcb->bcb_dirty.que_forward, next;
-		for (; que_inst != &bcb->bcb_dirty; que_inst = next)
+		Sync dirtySync(&part->bcp_syncDirty, "flushDirty");
+		lockPartition(dirtySync, SYNC_EXCLUSIVE, part->bcp_dirty_waits);
+
+		QUE que_inst = part->bcp_dirty.que_forward, next;
+		for (; que_inst != &part->bcp_dirty; que_inst = next)
 		{
 			next = que_inst->que_forward;
 			BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_dirty);
 
 			if (!(bdb->bdb_flags & BDB_dirty))
 			{
-				removeDirty(bcb, bdb);
+				removeDirty(bdb);
 				continue;
 			}
 
@@ -2640,6 +2866,95 @@ static void flushDirty(thread_db* tdbb, SLONG transaction_mask, const bool sys_o
 }
 
 
+// Flush pages of the committing transaction together with the pages of other
+// transactions committing at the same time. The first of them becomes the leader
+// of the group: it lets the others join for GroupCommitDelay milliseconds and
+// while the previous group is being written, then writes the pages of all of
+// them by single flushDirty() call. Precedence is handled by flushPages as
+// usual, the others just wait for the flush of their group. If it fails, they
+// flush their pages themselves to get the error.
+// The TIP changes of the group are written by the second pass, after the data
+// pages. Its members have already waited for each other, so there is no delay.
+static void groupFlush(thread_db* tdbb, SLONG transaction_mask, bool tip)
+{
+	Database* const dbb = tdbb->getDatabase();
+	BufferControl* const bcb = dbb->dbb_bcb;
+	const int delay = tip ? 0 : dbb->dbb_config->getGroupCommitDelay();
+
+	ULONG group;
+	SLONG flush_mask = transaction_mask;
+	bool leader = false;
+
+	{	// scope
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+
+		{	// scope
+			MutexLockGuard guard(bcb->bcb_commit_mutex, FB_FUNCTION);
+
+			bcb->bcb_commit_mask |= transaction_mask;
+			group = bcb->bcb_commit_group;
+
+			if (bcb->bcb_commit_leader)
+			{
+				while (bcb->bcb_commit_done < group)
+					bcb->bcb_commit_cond.wait(bcb->bcb_commit_mutex);
+
+				if (bcb->bcb_commit_failed < group)
+					return;
+			}
+			else
+				bcb->bcb_commit_leader = leader = true;
+		}
+
+		if (leader)
+		{
+			if (delay > 0)
+				Thread::sleep(delay);
+
+			MutexLockGuard guard(bcb->bcb_commit_mutex, FB_FUNCTION);
+
+			while (bcb->bcb_commit_flushing)
+				bcb->bcb_commit_cond.wait(bcb->bcb_commit_mutex);
+
+			flush_mask = bcb->bcb_commit_mask;
+			bcb->bcb_commit_mask = 0;
+			bcb->bcb_commit_group++;
+			bcb->bcb_commit_leader = false;
+			bcb->bcb_commit_flushing = true;
+		}
+	}
+
+	if (!leader)
+	{
+		flushDirty(tdbb, flush_mask, false);
+		return;
+	}
+
+	try
+	{
+		flushDirty(tdbb, flush_mask, false);
+	}
+	catch (const Exception&)
+	{
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		MutexLockGuard guard(bcb->bcb_commit_mutex, FB_FUNCTION);
+
+		bcb->bcb_commit_failed = group;
+		bcb->bcb_commit_done = group;
+		bcb->bcb_commit_flushing = false;
+		bcb->bcb_commit_cond.notifyAll();
+		throw;
+	}
+
+	EngineCheckout cout(tdbb, FB_FUNCTION);
+	MutexLockGuard guard(bcb->bcb_commit_mutex, FB_FUNCTION);
+
+	bcb->bcb_commit_done = group;
+	bcb->bcb_commit_flushing = false;
+	bcb->bcb_commit_cond.notifyAll();
+}
+
+
 // Collect pages modified by garbage collector or all dirty pages or release page
 // locks - depending of flush_flag, and write it to disk.
 // See also comments in flushPages.
@@ -2648,7 +2963,12 @@ static void flushAll(thread_db* tdbb, USHORT flush_flag)
 	SET_TDBB(tdbb);
 	Database* dbb = tdbb->getDatabase();
 	BufferControl* bcb = dbb->dbb_bcb;
-	Firebird::HalfStaticArray<BufferDesc*, 1024> flush(bcb->bcb_dirty_count);
+
+	ULONG dirtyCount = 0;
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+		dirtyCount += bcb->bcb_partitions[i]->bcp_dirty_count;
+
+	Firebird::HalfStaticArray<BufferDesc*, 1024> flush(dirtyCount);
 
 	const bool all_flag = (flush_flag & FLUSH_ALL) != 0;
 	const bool sweep_flag = (flush_flag & FLUSH_SWEEP) != 0;
@@ -2727,6 +3047,29 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 	FB_SIZE_T written = 0;
 	bool writeAll = false;
 
+	// If I/O layer is able to coalesce adjacent pages or to keep many writes
+	// in flight, collect them into batch.
+	// Batch is written at the end of every pass, thus pages which should be
+	// written after the queued ones (by precedence) are not eligible till the
+	// next pass. Queued buffers stay latched and IO-locked until written, so
+	// never wait for another buffer while the batch is not empty.
+
+	Database* const dbb = tdbb->getDatabase();
+	AutoPtr<IoBatch> batch;
+
+	if (count > 1)
+	{
+		jrd_file* const file = dbb->dbb_page_manager.findPageSpace(DB_PAGE_SPACE)->file;
+
+		if (PIO_write_batch_supported(file))
+		{
+			// Flush may run without the default pool set, e.g. at database shutdown
+			MemoryPool& pool = *dbb->dbb_bcb->bcb_bufferpool;
+			batch = FB_NEW_POOL(pool) IoBatch(pool, file, dbb->dbb_page_size, PAGE_ALIGNMENT,
+				MIN(count, IO_BATCH_PAGES));
+		}
+	}
+
 	while (!iter.isEmpty())
 	{
 		bool found = false;
@@ -2737,7 +3080,15 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 			if (!bdb)
 				continue;
 
-			bdb->addRef(tdbb, release_flag ? SYNC_EXCLUSIVE : SYNC_SHARED);
+			const SyncType syncType = release_flag ? SYNC_EXCLUSIVE : SYNC_SHARED;
+
+			if (!batch || !bdb->addRefConditional(tdbb, syncType))
+			{
+				if (batch && !write_batch(tdbb, *batch, release_flag))
+					CCH_unwind(tdbb, true);
+
+				bdb->addRef(tdbb, syncType);
+			}
 
 			BufferControl* bcb = bdb->bdb_bcb;
 			if (!writeAll)
@@ -2753,7 +3104,40 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 
 				if (!all_flag || bdb->bdb_flags & (BDB_db_dirty | BDB_dirty))
 				{
-					if (!write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, status, true))
+					if (batch && !writeAll)
+					{
+						if (!bdb->lockIOConditional(tdbb))
+						{
+							if (!write_batch(tdbb, *batch, release_flag))
+								CCH_unwind(tdbb, true);
+
+							bdb->lockIO(tdbb);
+						}
+
+						const FB_SIZE_T queued = batch->getCount();
+						const int result =
+							write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, status, true, batch);
+
+						bdb->unLockIO(tdbb);
+
+						if (!result)
+							CCH_unwind(tdbb, true);
+
+						if (batch->getCount() > queued)
+						{
+							// Buffer is released by write_batch()
+
+							iter.mark();
+							found = true;
+							written++;
+
+							if (batch->isFull() && !write_batch(tdbb, *batch, release_flag))
+								CCH_unwind(tdbb, true);
+
+							continue;
+						}
+					}
+					else if (!write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, status, true))
 						CCH_unwind(tdbb, true);
 				}
 
@@ -2774,6 +3158,9 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 			}
 		}
 
+		if (batch && !write_batch(tdbb, *batch, release_flag))
+			CCH_unwind(tdbb, true);
+
 		if (!found)
 			writeAll = true;
 
@@ -2784,159 +3171,183 @@ static void flushPages(thread_db* tdbb, USHORT flush_flag, BufferDesc** begin, F
 }
 
 
-#ifdef CACHE_READER
-void BufferControl::cache_reader(BufferControl* bcb)
+static bool write_batch(thread_db* tdbb, IoBatch& batch, const bool release_flag)
 {
 /**************************************
  *
- *	c a c h e _ r e a d e r
+ *	w r i t e _ b a t c h
  *
  **************************************
  *
  * Functional description
- *	Prefetch pages into cache for sequential scans.
- *	Use asynchronous I/O to keep two prefetch requests
- *	busy at a time.
+ *	Write pages queued by flushPages() and release
+ *	their buffers. Failed buffers are left latched
+ *	for CCH_unwind().
  *
  **************************************/
-	Database* dbb = bcb->bcb_database;
-	Database::SyncGuard dsGuard(dbb);
-
-	FbLocalStatus status_vector;
-
-	// Establish a thread context.
-	ThreadContextHolder tdbb(status_vector);
-
-	// Dummy attachment needed for lock owner identification.
-	tdbb->setDatabase(dbb);
-	Jrd::Attachment* const attachment = Attachment::create(dbb, nullptr);
-	tdbb->setAttachment(attachment);
-	attachment->att_filename = dbb->dbb_filename;
-	Jrd::ContextPoolHolder context(tdbb, bcb->bcb_bufferpool);
-
-	// This try block is specifically to protect the LCK_init call: if
-	// LCK_init fails we won't be able to accomplish anything anyway, so
-	// return, unlike the other try blocks further down the page.
+	if (batch.isEmpty())
+		return true;
 
-	BufferControl* bcb = NULL;
+	Database* const dbb = tdbb->getDatabase();
+	FbStatusVector* const status = tdbb->tdbb_status_vector;
 
-	try {
+	PIO_write_batch(tdbb, batch);
 
-		LCK_init(tdbb, LCK_OWNER_attachment);
-		TRA_init(attachment);
-		bcb = dbb->dbb_bcb;
-		bcb->bcb_flags |= BCB_cache_reader;
-		dbb->dbb_reader_init.post();	// Notify our creator that we have started
-	}
-	catch (const Firebird::Exception& ex)
+	bool result = true;
+	for (FB_SIZE_T i = 0; i < batch.getCount(); i++)
 	{
-		ex.stuffException(status_vector);
-		iscDbLogStatus(dbb->dbb_filename.c_str(), status_vector);
-		return 0;
-	}
+		IoBatch::Item& item = batch[i];
+		BufferDesc* const bdb = item.bdb;
+		BufferControl* const bcb = bdb->bdb_bcb;
 
-	try {
+		// Repeat failed write synchronously to get the error reported
 
-	// Set up dual prefetch control blocks to keep multiple prefetch
-	// requests active at a time. Also helps to prevent the cache reader
-	// from becoming dedicated or locked into a single request's prefetch demands.
+		if (!item.done && (!result || !PIO_write(tdbb, batch.getFile(), bdb, (pag*) item.buffer, status)))
+		{
+			bdb->bdb_flags |= BDB_io_error;
+			dbb->dbb_flags |= DBB_suspend_bgio;
+			bdb->unLockIO(tdbb);
 
-	prf prefetch1, prefetch2;
-	prefetch_init(&prefetch1, tdbb);
-	prefetch_init(&prefetch2, tdbb);
+			result = false;
+			continue;
+		}
 
-	while (bcb->bcb_flags & BCB_cache_reader)
+		page_written(tdbb, bdb);
+		bdb->unLockIO(tdbb);
+		clear_precedence(tdbb, bdb);
+
+		if (release_flag)
+			PAGE_LOCK_RELEASE(tdbb, bcb, bdb->bdb_lock);
+
+		bdb->release(tdbb, !release_flag && !(bdb->bdb_flags & BDB_dirty));
+	}
+
+	batch.clear();
+	return result;
+}
+
+
+void BufferControl::cache_reader(BufferControl* bcb)
+{
+/**************************************
+ *
+ *	c a c h e _ r e a d e r
+ *
+ **************************************
+ *
+ * Functional description
+ *	Prefetch pages into cache for sequential scans.
+ *
+ **************************************/
+	FbLocalStatus status_vector;
+	Database* const dbb = bcb->bcb_database;
+
+	try
 	{
-		bcb->bcb_flags |= BCB_reader_active;
-		bool found = false;
-		SLONG starting_page = -1;
-		prf* next_prefetch = &prefetch1;
+		UserId user;
+		user.setUserName("Cache Reader");
+
+		Jrd::Attachment* const attachment = Jrd::Attachment::create(dbb);
+		RefPtr<SysStableAttachment> sAtt(FB_NEW SysStableAttachment(attachment));
+		attachment->setStable(sAtt);
+		attachment->att_filename = dbb->dbb_filename;
+		attachment->att_user = &user;
+
+		BackgroundContextHolder tdbb(dbb, attachment, &status_vector, FB_FUNCTION);
 
-		if (dbb->dbb_flags & DBB_suspend_bgio)
+		try
 		{
-			Database::Checkout dcoHolder(dbb, FB_FUNCTION);
-			dbb->dbb_reader_sem.tryEnter(10);
-			continue;
-		}
+			LCK_init(tdbb, LCK_OWNER_attachment);
+			PAG_header(tdbb, true);
+			PAG_attachment_id(tdbb);
+			TRA_init(attachment);
 
-		// Make a pass thru the global prefetch bitmap looking for something
-		// to read. When the entire bitmap has been scanned and found to be
-		// empty then wait for new requests.
+			Monitoring::publishAttachment(tdbb);
 
-		do {
-			if (!(prefetch1.prf_flags & PRF_active) &&
-				SBM_next(bcb->bcb_prefetch, &starting_page, RSE_get_forward))
-			{
-				found = true;
-				prefetch_prologue(&prefetch1, &starting_page);
-				prefetch_io(&prefetch1, status_vector);
-			}
+			sAtt->initDone();
+
+			bcb->bcb_flags |= BCB_cache_reader;
+			bcb->bcb_flags &= ~BCB_reader_start;
+
+			// Notify our creator that we have started
+			bcb->bcb_reader_init.release();
 
-			if (!(prefetch2.prf_flags & PRF_active) &&
-				SBM_next(bcb->bcb_prefetch, &starting_page, RSE_get_forward))
+			while (bcb->bcb_flags & BCB_cache_reader)
 			{
-				found = true;
-				prefetch_prologue(&prefetch2, &starting_page);
-				prefetch_io(&prefetch2, status_vector);
-			}
+				bcb->bcb_flags |= BCB_reader_active;
 
-			prf* post_prefetch = next_prefetch;
-			next_prefetch = (post_prefetch == &prefetch1) ? &prefetch2 : &prefetch1;
+				if (dbb->dbb_flags & DBB_suspend_bgio)
+				{
+					EngineCheckout cout(tdbb, FB_FUNCTION);
+					bcb->bcb_reader_sem.tryEnter(10);
+					continue;
+				}
 
-			if (post_prefetch->prf_flags & PRF_active)
-				prefetch_epilogue(post_prefetch, status_vector);
+				// Make a pass thru the global prefetch bitmap looking for something
+				// to read. If there's more work to do voluntarily ask to be rescheduled.
+				// Otherwise, wait for event notification.
 
-			if (found)
-			{
-				// If the cache writer or garbage collector is idle, put
-				// them to work prefetching pages.
-#ifdef CACHE_WRITER
-				if ((bcb->bcb_flags & BCB_cache_writer) && !(bcb->bcb_flags & BCB_writer_active))
-					dbb_writer_sem.release();
-#endif
-#ifdef GARBAGE_THREAD
-				if ((dbb->dbb_flags & DBB_garbage_collector) && !(dbb->dbb_flags & DBB_gc_active))
-					dbb->dbb_gc_sem.release();
-#endif
-			}
-		} while (prefetch1.prf_flags & PRF_active || prefetch2.prf_flags & PRF_active);
+				bool found = false;
 
-		// If there's more work to do voluntarily ask to be rescheduled.
-		// Otherwise, wait for event notification.
-		BufferDesc* bdb;
-		if (found)
-			JRD_reschedule(tdbb, 0, true);
-		else if (bcb->bcb_flags & BCB_free_pending &&
-			(bdb = get_buffer(tdbb, FREE_PAGE, LATCH_none, 1)))
-		{
-			// In our spare time, help writer clean the cache.
+				try
+				{
+					found = CCH_prefetch_pages(tdbb);
+				}
+				catch (const Firebird::Exception& ex)
+				{
+					// Read errors are not fatal for the cache reader, the page
+					// will be read again by the thread which really needs it
+
+					ex.stuffException(&status_vector);
+					iscDbLogStatus(dbb->dbb_filename.c_str(), &status_vector);
+					status_vector->init();
+				}
 
-			write_buffer(tdbb, bdb, bdb->bdb_page, true, status_vector, true);
+				if (found)
+				{
+					JRD_reschedule(tdbb, 0, true);
+				}
+				else
+				{
+					bcb->bcb_flags &= ~BCB_reader_active;
+					EngineCheckout cout(tdbb, FB_FUNCTION);
+					bcb->bcb_reader_sem.tryEnter(10);
+				}
+			}
 		}
-		else
+		catch (const Firebird::Exception& ex)
 		{
-			bcb->bcb_flags &= ~BCB_reader_active;
-			Database::Checkout dcoHolder(dbb, FB_FUNCTION);
-			dbb->dbb_reader_sem.tryEnter(10);
+			ex.stuffException(&status_vector);
+			iscDbLogStatus(dbb->dbb_filename.c_str(), &status_vector);
+			// continue execution to clean up
 		}
-		bcb = dbb->dbb_bcb;
+
+		Monitoring::cleanupAttachment(tdbb);
+		attachment->releaseLocks(tdbb);
+		LCK_fini(tdbb, LCK_OWNER_attachment);
+
+		attachment->releaseRelations(tdbb);
+	}	// try
+	catch (const Firebird::Exception& ex)
+	{
+		bcb->exceptionHandler(ex, cache_reader);
 	}
 
-	LCK_fini(tdbb, LCK_OWNER_attachment);
-	Jrd::Attachment::destroy(attachment);	// no need saving warning error strings here
-	tdbb->setAttachment(NULL);
 	bcb->bcb_flags &= ~BCB_cache_reader;
-	dbb->dbb_reader_fini.post();
 
-	}	// try
+	try
+	{
+		if (bcb->bcb_flags & BCB_reader_start)
+		{
+			bcb->bcb_flags &= ~BCB_reader_start;
+			bcb->bcb_reader_init.release();
+		}
+	}
 	catch (const Firebird::Exception& ex)
 	{
-		ex.stuffException(status_vector);
-		iscDbLogStatus(dbb->dbb_filename.c_str(), status_vector);
+		bcb->exceptionHandler(ex, cache_reader);
 	}
-	return 0;
 }
-#endif
 
 
 void BufferControl::cache_writer(BufferControl* bcb)
@@ -2987,9 +3398,6 @@ void BufferControl::cache_writer(BufferControl* bcb)
 			while (bcb->bcb_flags & BCB_cache_writer)
 			{
 				bcb->bcb_flags |= BCB_writer_active;
-#ifdef CACHE_READER
-				SLONG starting_page = -1;
-#endif
 
 				if (dbb->dbb_flags & DBB_suspend_bgio)
 				{
@@ -3022,19 +3430,6 @@ void BufferControl::cache_writer(BufferControl* bcb)
 				{
 					JRD_reschedule(tdbb, 0, true);
 				}
-#ifdef CACHE_READER
-				else if (SBM_next(bcb->bcb_prefetch, &starting_page, RSE_get_forward))
-				{
-					// Prefetch some pages in our spare time and in the process
-					// garbage collect the prefetch bitmap.
-					prf prefetch;
-
-					prefetch_init(&prefetch, tdbb);
-					prefetch_prologue(&prefetch, &starting_page);
-					prefetch_io(&prefetch, status_vector);
-					prefetch_epilogue(&prefetch, status_vector);
-				}
-#endif
 				else
 				{
 					bcb->bcb_flags &= ~BCB_writer_active;
@@ -3139,10 +3534,12 @@ static void check_precedence(thread_db* tdbb, WIN* window, PageNumber page)
 
 	// Start by finding the buffer containing the high priority page
 
-	Sync bcbSync(&bcb->bcb_syncObject, "check_precedence");
-	bcbSync.lock(SYNC_SHARED);
+	BufferPartition* const part = bcb->getPartition(page);
+
+	Sync bcbSync(&part->bcp_syncObject, "check_precedence");
+	lockPartition(bcbSync, SYNC_SHARED, part->bcp_hash_waits);
 
-	BufferDesc* high = find_buffer(bcb, page, false);
+	BufferDesc* high = find_buffer(bcb, part, page, false);
 	bcbSync.unlock();
 
 	if (!high)
@@ -3288,6 +3685,7 @@ static BufferDesc* dealloc_bdb(BufferDesc* bdb)
 	{
 		delete bdb->bdb_lock;
 		QUE_DELETE(bdb->bdb_que);
+		bdb->bdb_partition->bcp_count--;
 
 		delete bdb;
 	}
@@ -3530,6 +3928,29 @@ static bool expand_buffers(thread_db* tdbb, ULONG number)
 	Sync syncBcb(&bcb->bcb_syncObject, "expand_buffers");
 	syncBcb.lock(SYNC_EXCLUSIVE);
 
+	// New buffers are put into partitions' empty queues and hash tables
+	// are rebuilt, thus block every partition. Always lock them in order.
+
+	class PartitionsGuard
+	{
+	public:
+		explicit PartitionsGuard(BufferControl* bcb)
+			: m_bcb(bcb)
+		{
+			for (ULONG i = 0; i < m_bcb->bcb_part_count; i++)
+				m_bcb->bcb_partitions[i]->bcp_syncObject.lock(NULL, SYNC_EXCLUSIVE, "expand_buffers");
+		}
+
+		~PartitionsGuard()
+		{
+			for (ULONG i = m_bcb->bcb_part_count; i > 0; i--)
+				m_bcb->bcb_partitions[i - 1]->bcp_syncObject.unlock(NULL, SYNC_EXCLUSIVE);
+		}
+
+	private:
+		BufferControl* const m_bcb;
+	} partitionsGuard(bcb);
+
 	// for Win16 platform, we want to ensure that no cache buffer ever ends on a segment boundary
 	// CVC: Is this code obsolete or only the comment?
 
@@ -3546,31 +3967,15 @@ static bool expand_buffers(thread_db* tdbb, ULONG number)
 	bcb->bcb_rpt = new_rpt;
 
 	bcb->bcb_count = number;
-	bcb->bcb_free_minimum = (SSHORT) MIN(number / 4, 128);	/* 25% clean page reserve */
 
 	const bcb_repeat* const new_end = bcb->bcb_rpt + number;
 
-	// Initialize tail of new buffer control block
-	bcb_repeat* new_tail;
-	for (new_tail = bcb->bcb_rpt; new_tail < new_end; new_tail++)
-		QUE_INIT(new_tail->bcb_page_mod);
-
 	// Move any active buffers from old block to new
 
-	new_tail = bcb->bcb_rpt;
+	bcb_repeat* new_tail = bcb->bcb_rpt;
 
-	for (bcb_repeat* old_tail = old_rpt; old_tail < old_end; old_tail++, new_tail++)
-	{
+	for (const bcb_repeat* old_tail = old_rpt; old_tail < old_end; old_tail++, new_tail++)
 		new_tail->bcb_bdb = old_tail->bcb_bdb;
-		while (QUE_NOT_EMPTY(old_tail->bcb_page_mod))
-		{
-			QUE que_inst = old_tail->bcb_page_mod.que_forward;
-			BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_que);
-			QUE_DELETE(*que_inst);
-			QUE mod_que = &bcb->bcb_rpt[bdb->bdb_page.getPageNum() % bcb->bcb_count].bcb_page_mod;
-			QUE_INSERT(*mod_que, *que_inst);
-		}
-	}
 
 	// Allocate new buffer descriptor blocks
 
@@ -3598,14 +4003,18 @@ static bool expand_buffers(thread_db* tdbb, ULONG number)
 
 	// Set up new buffer control, release old buffer control, and clean up
 
+	for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+		resize_partition(bcb, bcb->bcb_partitions[i]);
+
 	delete[] old_rpt;
 
 	return true;
 }
 
-static BufferDesc* find_buffer(BufferControl* bcb, const PageNumber page, bool findPending)
+static BufferDesc* find_buffer(BufferControl* bcb, BufferPartition* part, const PageNumber page,
+	bool findPending)
 {
-	QUE mod_que = &bcb->bcb_rpt[page.getPageNum() % bcb->bcb_count].bcb_page_mod;
+	QUE mod_que = part->getHashChain(bcb->getHashKey(page));
 	QUE que_inst = mod_que->que_forward;
 	for (; que_inst != mod_que; que_inst = que_inst->que_forward)
 	{
@@ -3616,8 +4025,8 @@ static BufferDesc* find_buffer(BufferControl* bcb, const PageNumber page, bool f
 
 	if (findPending)
 	{
-		que_inst = bcb->bcb_pending.que_forward;
-		for (; que_inst != &bcb->bcb_pending; que_inst = que_inst->que_forward)
+		que_inst = part->bcp_pending.que_forward;
+		for (; que_inst != &part->bcp_pending; que_inst = que_inst->que_forward)
 		{
 			BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_que);
 			if (bdb->bdb_page == page || bdb->bdb_pending_page == page)
@@ -3716,11 +4125,63 @@ static BufferDesc* get_buffer(thread_db* tdbb, const PageNumber page, SyncType s
 	Database* dbb = tdbb->getDatabase();
 	BufferControl* bcb = dbb->dbb_bcb;
 
-	Sync bcbSync(&bcb->bcb_syncObject, "get_buffer");
-	if (page != FREE_PAGE)
+	QUE que_inst;
+
+	if (page == FREE_PAGE)
+	{
+		// This code is only used by the background I/O threads:
+		// cache writer, cache reader and garbage collector.
+		// Look for the least recently used dirty buffer in every partition.
+
+		//Database::Checkout dcoHolder(dbb);
+
+		for (ULONG i = 0; i < bcb->bcb_part_count; i++)
+		{
+			BufferPartition* const part = bcb->bcb_partitions[i];
+
+			Sync partSync(&part->bcp_syncObject, "get_buffer");
+			lockPartition(partSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
+
+			Sync lruSync(&part->bcp_syncLRU, "get_buffer");
+			lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
+
+			int walk = part->bcp_free_minimum;
+			que* const lru_ques[] = {&part->bcp_probation, &part->bcp_in_use};
+
+			for (unsigned n = 0; n < FB_NELEM(lru_ques) && walk; n++)
+			{
+				que* const lru = lru_ques[n];
+
+				for (que_inst = lru->que_backward; que_inst != lru; que_inst = que_inst->que_backward)
+				{
+					BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_in_use);
+
+					if (bdb->bdb_use_count || (bdb->bdb_flags & BDB_free_pending))
+						continue;
+
+					if (bdb->bdb_flags & BDB_db_dirty)
+					{
+						//tdbb->bumpStats(RuntimeStatistics::PAGE_FETCHES); shouldn't it be here?
+						return bdb;
+					}
+
+					if (!--walk)
+						break;
+				}
+			}
+		}
+
+		// hvlad: removed in Vulcan
+		bcb->bcb_flags &= ~BCB_free_pending;
+		return NULL;
+	}
+
+	BufferPartition* const part = bcb->getPartition(page);
+
+	Sync bcbSync(&part->bcp_syncObject, "get_buffer");
 	{
-		bcbSync.lock(SYNC_SHARED);
-		BufferDesc* bdb = find_buffer(bcb, page, true);
+		lockPartition(bcbSync, SYNC_SHARED, part->bcp_hash_waits);
+		BufferDesc* bdb = find_buffer(bcb, part, page, true);
 		while (bdb)
 		{
 			const LatchState ret = latch_buffer(tdbb, bcbSync, bdb, page, syncType, wait);
@@ -3733,22 +4194,20 @@ static BufferDesc* get_buffer(thread_db* tdbb, const PageNumber page, SyncType s
 			if (ret == lsTimeout)
 				return NULL;
 
-			bcbSync.lock(SYNC_SHARED);
-			bdb = find_buffer(bcb, page, true);
+			lockPartition(bcbSync, SYNC_SHARED, part->bcp_hash_waits);
+			bdb = find_buffer(bcb, part, page, true);
 		}
 		bcbSync.unlock();
 	}
 
-	bcbSync.lock(SYNC_EXCLUSIVE);
+	lockPartition(bcbSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
 
-	QUE que_inst;
-	int walk = bcb->bcb_free_minimum;
+	int walk = part->bcp_free_minimum;
 	while (true)
 	{
-		if (page != FREE_PAGE)
 		{
 			// Check to see if buffer has already been assigned to page
-			BufferDesc* bdb = find_buffer(bcb, page, true);
+			BufferDesc* bdb = find_buffer(bcb, part, page, true);
 			while (bdb)
 			{
 				const LatchState ret = latch_buffer(tdbb, bcbSync, bdb, page, syncType, wait);
@@ -3761,60 +4220,25 @@ static BufferDesc* get_buffer(thread_db* tdbb, const PageNumber page, SyncType s
 				if (ret == lsTimeout)
 					return NULL;
 
-				bcbSync.lock(SYNC_EXCLUSIVE);
-				bdb = find_buffer(bcb, page, true);
-			}
-		}
-		else // page == FREE_PAGE
-		{
-			// This code is only used by the background I/O threads:
-			// cache writer, cache reader and garbage collector.
-
-			//Database::Checkout dcoHolder(dbb);
-
-			Sync lruSync(&bcb->bcb_syncLRU, "get_buffer");
-			lruSync.lock(SYNC_EXCLUSIVE);
-
-			for (que_inst = bcb->bcb_in_use.que_backward;
-				 que_inst != &bcb->bcb_in_use; que_inst = que_inst->que_backward)
-			{
-				BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_in_use);
-
-				if (bdb->bdb_use_count || (bdb->bdb_flags & BDB_free_pending))
-					continue;
-
-				if (bdb->bdb_flags & BDB_db_dirty)
-				{
-					//tdbb->bumpStats(RuntimeStatistics::PAGE_FETCHES); shouldn't it be here?
-					return bdb;
-				}
-
-				if (!--walk)
-				{
-					bcb->bcb_flags &= ~BCB_free_pending;
-					break;
-				}
+				lockPartition(bcbSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
+				bdb = find_buffer(bcb, part, page, true);
 			}
-
-			// hvlad: removed in Vulcan
-			bcb->bcb_flags &= ~BCB_free_pending;
-			return NULL;
 		}
 
 		// If there is an empty buffer sitting around, allocate it
 
-		if (QUE_NOT_EMPTY(bcb->bcb_empty))
+		if (QUE_NOT_EMPTY(part->bcp_empty))
 		{
-			que_inst = bcb->bcb_empty.que_forward;
+			que_inst = part->bcp_empty.que_forward;
 			QUE_DELETE(*que_inst);
 			BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_que);
 
-			bcb->bcb_inuse++;
+			part->bcp_inuse++;
 			bdb->addRef(tdbb, SYNC_EXCLUSIVE);
 
 			if (page != FREE_PAGE)
 			{
-				QUE mod_que = &bcb->bcb_rpt[page.getPageNum() % bcb->bcb_count].bcb_page_mod;
+				QUE mod_que = part->getHashChain(bcb->getHashKey(page));
 				QUE_INSERT(*mod_que, *que_inst);
 #ifdef SUPERSERVER_V2
 				// Reserve a buffer for header page with deferred header
@@ -3826,17 +4250,17 @@ static BufferDesc* get_buffer(thread_db* tdbb, const PageNumber page, SyncType s
 				if (page != HEADER_PAGE_NUMBER)
 #endif
 				{
-					Sync lruSync(&bcb->bcb_syncLRU, "get_buffer");
-					lruSync.lock(SYNC_EXCLUSIVE);
+					Sync lruSync(&part->bcp_syncLRU, "get_buffer");
+					lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
 
-					QUE_INSERT(bcb->bcb_in_use, bdb->bdb_in_use);
+					lruInsert(bcb, part, bdb, page);
 				}
 			}
 
 			// This correction for bdb_use_count below is needed to
 			// avoid a deadlock situation in latching code.  It's not
 			// clear though how the bdb_use_count can get < 0 for a bdb
-			// in bcb_empty queue
+			// in bcp_empty queue
 
 			if (bdb->bdb_use_count < 0)
 				BUGCHECK(301);	// msg 301 Non-zero use_count of a buffer in the empty que_inst
@@ -3857,171 +4281,195 @@ static BufferDesc* get_buffer(thread_db* tdbb, const PageNumber page, SyncType s
 			return bdb;
 		}
 
-		Sync lruSync(&bcb->bcb_syncLRU, "get_buffer");
-		lruSync.lock(SYNC_EXCLUSIVE);
+		Sync lruSync(&part->bcp_syncLRU, "get_buffer");
+		lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
 
-		if (bcb->bcb_lru_chain.load() != NULL)
-			requeueRecentlyUsed(bcb);
+		if (part->bcp_lru_chain.load() != NULL)
+			requeueRecentlyUsed(part);
 
-		for (que_inst = bcb->bcb_in_use.que_backward;
-			 que_inst != &bcb->bcb_in_use;
-			 que_inst = que_inst->que_backward)
-		{
-			// get the oldest buffer as the least recently used -- note
-			// that since there are no empty buffers this queue cannot be empty
+		// Choose the que to take the victim from. With 2Q policy buffers are
+		// taken from the probation que while it's larger than its target size.
+		// Probation que is always empty with LRU policy.
 
-			if (bcb->bcb_in_use.que_forward == &bcb->bcb_in_use)
-				BUGCHECK(213);	// msg 213 insufficient cache size
+		que* lru_ques[] = {&part->bcp_in_use, &part->bcp_probation};
 
-			BufferDesc* oldest = BLOCK(que_inst, BufferDesc, bdb_in_use);
+		if (part->bcp_probation_count > part->bcp_probation_target)
+			std::swap(lru_ques[0], lru_ques[1]);
 
-			if (oldest->bdb_flags & BDB_lru_chained)
-				continue;
+		bool exhausted = true;
 
-			if (oldest->bdb_use_count || !oldest->addRefConditional(tdbb, SYNC_EXCLUSIVE))
-				continue;
+		for (unsigned n = 0; n < FB_NELEM(lru_ques) && exhausted; n++)
+		{
+			que* const lru = lru_ques[n];
 
-			if ((oldest->bdb_flags & BDB_free_pending) || !writeable(oldest))
+			for (que_inst = lru->que_backward; que_inst != lru; que_inst = que_inst->que_backward)
 			{
-				oldest->release(tdbb, true);
-				continue;
-			}
+				// get the oldest buffer as the least recently used -- note
+				// that since there are no empty buffers this queue cannot be empty
 
-#ifdef SUPERSERVER_V2
-			// If page has been prefetched but not yet fetched, let
-			// it cycle once more thru LRU queue before re-using it.
+				if (lru->que_forward == lru)
+					BUGCHECK(213);	// msg 213 insufficient cache size
 
-			if (oldest->bdb_flags & BDB_prefetch)
-			{
-				oldest->bdb_flags &= ~BDB_prefetch;
-				que_inst = que_inst->que_forward;
-				QUE_MOST_RECENTLY_USED(oldest->bdb_in_use);
-				//LATCH_MUTEX_RELEASE;
-				continue;
-			}
-#endif
+				BufferDesc* oldest = BLOCK(que_inst, BufferDesc, bdb_in_use);
 
-			if ((bcb->bcb_flags & BCB_cache_writer) &&
-				(oldest->bdb_flags & (BDB_dirty | BDB_db_dirty)) )
-			{
-				bcb->bcb_flags |= BCB_free_pending;
+				if (oldest->bdb_flags & BDB_lru_chained)
+					continue;
 
-				if (!(bcb->bcb_flags & BCB_writer_active))
-					bcb->bcb_writer_sem.release();
+				if (oldest->bdb_use_count || !oldest->addRefConditional(tdbb, SYNC_EXCLUSIVE))
+					continue;
 
-				if (walk)
+				if ((oldest->bdb_flags & BDB_free_pending) || !writeable(oldest))
 				{
 					oldest->release(tdbb, true);
-					if (!--walk)
-						break;
+					continue;
+				}
 
+				// If page has been prefetched but not yet fetched, let
+				// it cycle once more thru LRU queue before re-using it.
+
+				if (oldest->bdb_flags & BDB_prefetch)
+				{
+					oldest->bdb_flags &= ~BDB_prefetch;
+					oldest->release(tdbb, true);
+					que_inst = que_inst->que_forward;
+					QUE_MOST_RECENTLY_USED(*lru, oldest->bdb_in_use);
 					continue;
 				}
-			}
 
-			BufferDesc* bdb = oldest;
+				if ((bcb->bcb_flags & BCB_cache_writer) &&
+					(oldest->bdb_flags & (BDB_dirty | BDB_db_dirty)) )
+				{
+					bcb->bcb_flags |= BCB_free_pending;
 
-			// hvlad: we already have bcb_lruSync here
-			//recentlyUsed(bdb);
-			fb_assert(!(bdb->bdb_flags & BDB_lru_chained));
-			QUE_DELETE(bdb->bdb_in_use);
-			QUE_INSERT(bcb->bcb_in_use, bdb->bdb_in_use);
+					if (!(bcb->bcb_flags & BCB_writer_active))
+						bcb->bcb_writer_sem.release();
 
-			lruSync.unlock();
+					if (walk)
+					{
+						oldest->release(tdbb, true);
+						if (!--walk)
+						{
+							exhausted = false;
+							break;
+						}
+
+						continue;
+					}
+				}
 
-			bdb->bdb_flags |= BDB_free_pending;
-			bdb->bdb_pending_page = page;
+				BufferDesc* bdb = oldest;
 
-			QUE_DELETE(bdb->bdb_que);
-			QUE_INSERT(bcb->bcb_pending, bdb->bdb_que);
+				// hvlad: we already have bcb_lruSync here
+				//recentlyUsed(bdb);
+				fb_assert(!(bdb->bdb_flags & BDB_lru_chained));
+				lruRemove(part, bdb, true);
+				lruInsert(bcb, part, bdb, page);
 
-			const bool needCleanup = (bdb->bdb_flags & (BDB_dirty | BDB_db_dirty)) ||
-				QUE_NOT_EMPTY(bdb->bdb_higher) || QUE_NOT_EMPTY(bdb->bdb_lower);
+				lruSync.unlock();
 
-			if (needCleanup)
-			{
-				bcbSync.unlock();
+				bdb->bdb_flags |= BDB_free_pending;
+				bdb->bdb_pending_page = page;
+
+				QUE_DELETE(bdb->bdb_que);
+				QUE_INSERT(part->bcp_pending, bdb->bdb_que);
 
-				// If the buffer selected is dirty, arrange to have it written.
+				const bool needCleanup = (bdb->bdb_flags & (BDB_dirty | BDB_db_dirty)) ||
+					QUE_NOT_EMPTY(bdb->bdb_higher) || QUE_NOT_EMPTY(bdb->bdb_lower);
 
-				if (bdb->bdb_flags & (BDB_dirty | BDB_db_dirty))
+				if (needCleanup)
 				{
-					const bool write_thru = (bcb->bcb_flags & BCB_exclusive);
-					if (!write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, tdbb->tdbb_status_vector, true))
-					{
-						bcbSync.lock(SYNC_EXCLUSIVE);
-						bdb->bdb_flags &= ~BDB_free_pending;
-						QUE_DELETE(bdb->bdb_in_use);
-						QUE_APPEND(bcb->bcb_in_use, bdb->bdb_in_use);
-						bcbSync.unlock();
+					bcbSync.unlock();
 
-						bdb->release(tdbb, true);
-						CCH_unwind(tdbb, true);
-					}
-				}
+					// If the buffer selected is dirty, arrange to have it written.
 
-				// If the buffer is still in the dirty tree, remove it.
-				// In any case, release any lock it may have.
+					if (bdb->bdb_flags & (BDB_dirty | BDB_db_dirty))
+					{
+						const bool write_thru = (bcb->bcb_flags & BCB_exclusive);
+						if (!write_buffer(tdbb, bdb, bdb->bdb_page, write_thru, tdbb->tdbb_status_vector, true))
+						{
+							lockPartition(bcbSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
+							bdb->bdb_flags &= ~BDB_free_pending;
+							lockPartition(lruSync, SYNC_EXCLUSIVE, part->bcp_lru_waits);
+							lruAppend(part, bdb);
+							lruSync.unlock();
+							bcbSync.unlock();
+
+							bdb->release(tdbb, true);
+							CCH_unwind(tdbb, true);
+						}
+					}
 
-				removeDirty(bcb, bdb);
+					// If the buffer is still in the dirty tree, remove it.
+					// In any case, release any lock it may have.
 
-				// Cleanup any residual precedence blocks.  Unless something is
-				// screwed up, the only precedence blocks that can still be hanging
-				// around are ones cleared at AST level.
+					removeDirty(bdb);
 
-				if (QUE_NOT_EMPTY(bdb->bdb_higher) || QUE_NOT_EMPTY(bdb->bdb_lower))
-				{
-					Sync precSync(&bcb->bcb_syncPrecedence, "get_buffer");
-					precSync.lock(SYNC_EXCLUSIVE);
+					// Cleanup any residual precedence blocks.  Unless something is
+					// screwed up, the only precedence blocks that can still be hanging
+					// around are ones cleared at AST level.
 
-					while (QUE_NOT_EMPTY(bdb->bdb_higher))
+					if (QUE_NOT_EMPTY(bdb->bdb_higher) || QUE_NOT_EMPTY(bdb->bdb_lower))
 					{
-						QUE que2 = bdb->bdb_higher.que_forward;
-						Precedence* precedence = BLOCK(que2, Precedence, pre_higher);
-						QUE_DELETE(precedence->pre_higher);
-						QUE_DELETE(precedence->pre_lower);
-						precedence->pre_hi = (BufferDesc*) bcb->bcb_free;
-						bcb->bcb_free = precedence;
+						Sync precSync(&bcb->bcb_syncPrecedence, "get_buffer");
+						precSync.lock(SYNC_EXCLUSIVE);
+
+						while (QUE_NOT_EMPTY(bdb->bdb_higher))
+						{
+							QUE que2 = bdb->bdb_higher.que_forward;
+							Precedence* precedence = BLOCK(que2, Precedence, pre_higher);
+							QUE_DELETE(precedence->pre_higher);
+							QUE_DELETE(precedence->pre_lower);
+							precedence->pre_hi = (BufferDesc*) bcb->bcb_free;
+							bcb->bcb_free = precedence;
+						}
+
+						clear_precedence(tdbb, bdb);
 					}
 
-					clear_precedence(tdbb, bdb);
+					lockPartition(bcbSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
 				}
 
-				bcbSync.lock(SYNC_EXCLUSIVE);
-			}
-
-			QUE_DELETE(bdb->bdb_que);	// bcb_pending
+				QUE_DELETE(bdb->bdb_que);	// bcp_pending
 
-			QUE mod_que = &bcb->bcb_rpt[page.getPageNum() % bcb->bcb_count].bcb_page_mod;
-			QUE_INSERT((*mod_que), bdb->bdb_que);
-			bdb->bdb_flags &= ~BDB_free_pending;
+				QUE mod_que = part->getHashChain(bcb->getHashKey(page));
+				QUE_INSERT((*mod_que), bdb->bdb_que);
+				bdb->bdb_flags &= ~BDB_free_pending;
 
-			// This correction for bdb_use_count below is needed to
-			// avoid a deadlock situation in latching code.  It's not
-			// clear though how the bdb_use_count can get < 0 for a bdb
-			// in bcb_empty queue
+				// This correction for bdb_use_count below is needed to
+				// avoid a deadlock situation in latching code.  It's not
+				// clear though how the bdb_use_count can get < 0 for a bdb
+				// in bcp_empty queue
 
-			if (bdb->bdb_use_count < 0)
-				BUGCHECK(301);	/* msg 301 Non-zero use_count of a buffer in the empty Que */
+				if (bdb->bdb_use_count < 0)
+					BUGCHECK(301);	/* msg 301 Non-zero use_count of a buffer in the empty Que */
 
-			bdb->bdb_page = page;
-			bdb->bdb_flags &= BDB_lru_chained; // yes, clear all except BDB_lru_chained
-			bdb->bdb_flags |= BDB_read_pending;
-			bdb->bdb_scan_count = 0;
+				bdb->bdb_page = page;
+				bdb->bdb_flags &= BDB_lru_chained; // yes, clear all except BDB_lru_chained
+				bdb->bdb_flags |= BDB_read_pending;
+				bdb->bdb_scan_count = 0;
 
-			bcbSync.unlock();
+				bcbSync.unlock();
 
-			if (page != FREE_PAGE)
-				bdb->bdb_lock->lck_logical = LCK_none;
-			else
-				PAGE_LOCK_RELEASE(tdbb, bcb, bdb->bdb_lock);
+				if (page != FREE_PAGE)
+					bdb->bdb_lock->lck_logical = LCK_none;
+				else
+					PAGE_LOCK_RELEASE(tdbb, bcb, bdb->bdb_lock);
 
-			tdbb->bumpStats(RuntimeStatistics::PAGE_FETCHES);
-			return bdb;
+				tdbb->bumpStats(RuntimeStatistics::PAGE_FETCHES);
+				return bdb;
+			}
 		}
 
-		if (que_inst == &bcb->bcb_in_use)
+		if (exhausted)
+		{
+			// Partition is out of buffers. Expanding the cache blocks all
+			// partitions, so don't hold our one meanwhile.
+
+			lruSync.unlock();
+			bcbSync.unlock();
 			expand_buffers(tdbb, bcb->bcb_count + 75);
+			lockPartition(bcbSync, SYNC_EXCLUSIVE, part->bcp_hash_waits);
+		}
 	}
 }
 
@@ -4253,20 +4701,113 @@ static LockState lock_buffer(thread_db* tdbb, BufferDesc* bdb, const SSHORT wait
 }
 
 
-static ULONG memory_init(thread_db* tdbb, BufferControl* bcb, SLONG number)
+static ULONG get_partition_count(const Database* dbb, ULONG number)
 {
 /**************************************
  *
- *	m e m o r y _ i n i t
+ *	g e t _ p a r t i t i o n _ c o u n t
  *
  **************************************
  *
  * Functional description
- *	Initialize memory for the cache.
- *	Return number of buffers allocated.
+ *	Choose number of partitions for the cache of given
+ *	number of buffers.
  *
  **************************************/
-	SET_TDBB(tdbb);
+	ULONG count = dbb->dbb_config->getDbCachePartitions();
+
+	if (!count)
+	{
+		// Largest power of two not exceeding number of CPU cores,
+		// but don't make partitions too small
+
+		const ULONG cpus = std::thread::hardware_concurrency();
+
+		count = 1;
+		while (count * 2 <= cpus && count * 2 * MIN_PARTITION_BUFFERS <= number)
+			count *= 2;
+	}
+
+	count = MIN(count, MAX_CACHE_PARTITIONS);
+	count = MIN(count, number / MIN_PAGE_BUFFERS);
+
+	return MAX(count, 1);
+}
+
+
+static void resize_partition(BufferControl* bcb, BufferPartition* part)
+{
+/**************************************
+ *
+ *	r e s i z e _ p a r t i t i o n
+ *
+ **************************************
+ *
+ * Functional description
+ *	Adjust partition hash table and free buffers
+ *	threshold to the number of its buffers.
+ *
+ **************************************/
+	const ULONG old_size = part->bcp_hash_size;
+	que* const old_hash = part->bcp_hash;
+
+	const ULONG new_size = MAX(part->bcp_count, 1);
+
+	if (new_size > old_size)
+	{
+		part->bcp_hash = FB_NEW_POOL(*bcb->bcb_bufferpool) que[new_size];
+		part->bcp_hash_size = new_size;
+
+		for (ULONG i = 0; i < new_size; i++)
+			QUE_INIT(part->bcp_hash[i]);
+
+		// Move buffers from old hash chains to the new ones
+
+		for (ULONG i = 0; i < old_size; i++)
+		{
+			que* const old_chain = &old_hash[i];
+
+			while (QUE_NOT_EMPTY(*old_chain))
+			{
+				QUE que_inst = old_chain->que_forward;
+				BufferDesc* bdb = BLOCK(que_inst, BufferDesc, bdb_que);
+				QUE_DELETE(*que_inst);
+				QUE_INSERT(*part->getHashChain(bcb->getHashKey(bdb->bdb_page)), *que_inst);
+			}
+		}
+
+		delete[] old_hash;
+	}
+
+	part->bcp_free_minimum = (SSHORT) MIN(part->bcp_count / 4, 128);	// 25% clean page reserve
+
+	if (bcb->bcb_policy == CACHE_POLICY_2Q)
+	{
+		// Sizes of probation que and of ghost pages list suggested by 2Q authors
+
+		Sync lruSync(&part->bcp_syncLRU, "resize_partition");
+		lruSync.lock(SYNC_EXCLUSIVE);
+
+		part->bcp_probation_target = part->bcp_count / 4;
+		part->bcp_ghosts.resize(*bcb->bcb_bufferpool, MAX(part->bcp_count / 2, 1), bcb->bcb_part_count);
+	}
+}
+
+
+static ULONG memory_init(thread_db* tdbb, BufferControl* bcb, SLONG number)
+{
+/**************************************
+ *
+ *	m e m o r y _ i n i t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Initialize memory for the cache.
+ *	Return number of buffers allocated.
+ *
+ **************************************/
+	SET_TDBB(tdbb);
 	Database* const dbb = tdbb->getDatabase();
 
 	UCHAR* memory = NULL;
@@ -4321,8 +4862,6 @@ static ULONG memory_init(thread_db* tdbb, BufferControl* bcb, SLONG number)
 			old_buffers = buffers;
 		}
 
-		QUE_INIT(tail->bcb_page_mod);
-
 		try
 		{
 			tail->bcb_bdb = alloc_bdb(tdbb, bcb, &memory);
@@ -4396,200 +4935,6 @@ static void page_validation_error(thread_db* tdbb, WIN* window, SSHORT type)
 }
 
 
-#ifdef CACHE_READER
-static void prefetch_epilogue(Prefetch* prefetch, FbStatusVector* status_vector)
-{
-/**************************************
- *
- *	p r e f e t c h _ e p i l o g u e
- *
- **************************************
- *
- * Functional description
- *	Stall on asynchronous I/O completion.
- *	Move data from prefetch buffer to database
- *	buffers, compute the checksum, and release
- *	the latch.
- *
- **************************************/
-	if (!(prefetch->prf_flags & PRF_active))
-		return;
-
-	thread_db* tdbb = prefetch->prf_tdbb;
-	Database* dbb = tdbb->getDatabase();
-
-	prefetch->prf_piob.piob_wait = TRUE;
-	const bool async_status = PIO_status(dbb, &prefetch->prf_piob, status_vector);
-
-	// If there was an I/O error release all buffer latches acquired for the prefetch request.
-
-	if (!async_status)
-	{
-		BufferDesc** next_bdb = prefetch->prf_bdbs;
-		for (USHORT i = 0; i < prefetch->prf_max_prefetch; i++)
-		{
-			if (*next_bdb)
-				release_bdb(tdbb, *next_bdb, true, false, false);
-
-			next_bdb++;
-		}
-		prefetch->prf_flags &= ~PRF_active;
-		return;
-	}
-
-	const SCHAR* next_buffer = prefetch->prf_io_buffer;
-	BufferDesc** next_bdb = prefetch->prf_bdbs;
-
-	for (USHORT i = 0; i < prefetch->prf_max_prefetch; i++)
-	{
-		if (*next_bdb)
-		{
-			pag* page = (*next_bdb)->bdb_buffer;
-			if (next_buffer != reinterpret_cast<char*>(page))
-				memcpy(page, next_buffer, (ULONG) dbb->dbb_page_size);
-
-			if (page->pag_pageno == (*next_bdb)->bdb_page.getPageNum())
-			{
-				(*next_bdb)->bdb_flags &= ~(BDB_read_pending | BDB_not_valid);
-				(*next_bdb)->bdb_flags |= BDB_prefetch;
-			}
-
-			release_bdb(tdbb, *next_bdb, true, false, false);
-		}
-
-		next_buffer += dbb->dbb_page_size;
-		next_bdb++;
-	}
-
-	prefetch->prf_flags &= ~PRF_active;
-}
-
-
-static void prefetch_init(Prefetch* prefetch, thread_db* tdbb)
-{
-/**************************************
- *
- *	p r e f e t c h _ i n i t
- *
- **************************************
- *
- * Functional description
- *	Initialize prefetch data structure.
- *	Most systems that allow access to "raw" I/O
- *	interfaces want the buffer address aligned.
- *
- **************************************/
-	Database* dbb = tdbb->getDatabase();
-
-	prefetch->prf_tdbb = tdbb;
-	prefetch->prf_flags = 0;
-	prefetch->prf_max_prefetch = PREFETCH_MAX_TRANSFER / dbb->dbb_page_size;
-	prefetch->prf_aligned_buffer =
-		(SCHAR*) (((U_IPTR) &prefetch->prf_unaligned_buffer + MIN_PAGE_SIZE - 1) &
-		~((U_IPTR) MIN_PAGE_SIZE - 1));
-}
-
-
-static void prefetch_io(Prefetch* prefetch, FbStatusVector* status_vector)
-{
-/**************************************
- *
- *	p r e f e t c h _ i o
- *
- **************************************
- *
- * Functional description
- *	Queue an asynchronous I/O to read
- *	multiple pages into prefetch buffer.
- *
- **************************************/
-	thread_db* tdbb = prefetch->prf_tdbb;
-	Database* dbb = tdbb->getDatabase();
-
-	if (!prefetch->prf_page_count)
-		prefetch->prf_flags &= ~PRF_active;
-	else
-	{
-		// Get the cache reader working on our behalf too
-
-		if (!(dbb->dbb_bcb->bcb_flags & BCB_reader_active))
-			dbb->dbb_reader_sem.post();
-
-		const bool async_status =
-			PIO_read_ahead(dbb, prefetch->prf_start_page, prefetch->prf_io_buffer,
-						   prefetch->prf_page_count, &prefetch->prf_piob, status_vector);
-		if (!async_status)
-		{
-			BufferDesc** next_bdb = prefetch->prf_bdbs;
-			for (USHORT i = 0; i < prefetch->prf_max_prefetch; i++)
-			{
-				if (*next_bdb)
-					release_bdb(tdbb, *next_bdb, true, false, false);
-
-				next_bdb++;
-			}
-			prefetch->prf_flags &= ~PRF_active;
-		}
-	}
-}
-
-
-static void prefetch_prologue(Prefetch* prefetch, SLONG* start_page)
-{
-/**************************************
- *
- *	p r e f e t c h _ p r o l o g u e
- *
- **************************************
- *
- * Functional description
- *	Search for consecutive pages to be prefetched
- *	and latch them for I/O.
- *
- **************************************/
-	thread_db* tdbb = prefetch->prf_tdbb;
-	Database* dbb = tdbb->getDatabase();
-	BufferControl* bcb = dbb->dbb_bcb;
-
-	prefetch->prf_start_page = *start_page;
-	prefetch->prf_page_count = 0;
-	prefetch->prf_flags |= PRF_active;
-
-	BufferDesc** next_bdb = prefetch->prf_bdbs;
-	for (USHORT i = 0; i < prefetch->prf_max_prefetch; i++)
-	{
-		*next_bdb = 0;
-		if (SBM_clear(bcb->bcb_prefetch, *start_page) &&
-			(*next_bdb = get_buffer(tdbb, *start_page, LATCH_shared, 0)))
-		{
-			if ((*next_bdb)->bdb_flags & BDB_read_pending)
-				prefetch->prf_page_count = i + 1;
-			else
-			{
-				release_bdb(tdbb, *next_bdb, true, false, false);
-				*next_bdb = 0;
-			}
-		}
-
-		next_bdb++;
-		(*start_page)++;
-	}
-
-	// Optimize non-sequential list prefetching to transfer directly to database buffers.
-
-	BufferDesc* bdb;
-	if (prefetch->prf_page_count == 1 && (bdb = prefetch->prf_bdbs[0]))
-		prefetch->prf_io_buffer = reinterpret_cast<char*>(bdb->bdb_buffer);
-	else
-		prefetch->prf_io_buffer = prefetch->prf_aligned_buffer;
-
-	// Reset starting page for next bitmap walk
-
-	--(*start_page);
-}
-#endif // CACHE_READER
-
-
 static SSHORT related(BufferDesc* low, const BufferDesc* high, SSHORT limit, const ULONG mark)
 {
 /**************************************
@@ -4721,7 +5066,8 @@ static int write_buffer(thread_db* tdbb,
 						BufferDesc* bdb,
 						const PageNumber page,
 						const bool write_thru,
-						FbStatusVector* const status, const bool write_this_page)
+						FbStatusVector* const status, const bool write_this_page,
+						IoBatch* batch)
 {
 /**************************************
  *
@@ -4752,6 +5098,10 @@ static int write_buffer(thread_db* tdbb,
  *		though.  Probable action: re-establich the
  * 		need to write this page and retry write.
  *
+ * If batch is given, the page image may be queued into it instead of
+ * being written immediately. Such page is returned still IO-locked,
+ * see write_batch().
+ *
  **************************************/
 	SET_TDBB(tdbb);
 #ifdef SUPERSERVER_V2
@@ -4849,7 +5199,12 @@ static int write_buffer(thread_db* tdbb,
 	if ((bdb->bdb_flags & BDB_dirty || (write_thru && bdb->bdb_flags & BDB_db_dirty)) &&
 		!(bdb->bdb_flags & BDB_marked))
 	{
-		result = write_page(tdbb, bdb, status, false);
+		const FB_SIZE_T queued = batch ? batch->getCount() : 0;
+
+		result = write_page(tdbb, bdb, status, false, batch);
+
+		if (batch && batch->getCount() > queued)
+			return 1;
 	}
 
 	bdb->unLockIO(tdbb);
@@ -4866,7 +5221,8 @@ static int write_buffer(thread_db* tdbb,
 }
 
 
-static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const status, const bool inAst)
+static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const status, const bool inAst,
+	IoBatch* batch)
 {
 /**************************************
  *
@@ -4877,6 +5233,9 @@ static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const s
  * Functional description
  *	Do actions required when writing a database page,
  *	including journaling, shadowing.
+ *	If batch is given and the page may be written
+ *	asynchronously, it's only queued into the batch.
+ *	Buffer is marked clean by write_batch() then.
  *
  **************************************/
 
@@ -4992,14 +5351,25 @@ static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const s
 				class Pio : public CryptoManager::IOCallback
 				{
 				public:
-					Pio(jrd_file* f, BufferDesc* b, bool ast, bool tp, PageSpace* ps)
-						: file(f), bdb(b), inAst(ast), isTempPage(tp), pageSpace(ps)
+					Pio(jrd_file* f, BufferDesc* b, bool ast, bool tp, PageSpace* ps, IoBatch* bt)
+						: file(f), bdb(b), inAst(ast), isTempPage(tp), pageSpace(ps), batch(bt),
+						  queued(false)
 					{ }
 
 					bool callback(thread_db* tdbb, FbStatusVector* status, Ods::pag* page)
 					{
 						Database* dbb = tdbb->getDatabase();
 
+						// Header page and pages to be shadowed are written immediately
+
+						if (batch && !isTempPage && file == batch->getFile() &&
+							bdb->bdb_page != HEADER_PAGE_NUMBER && !dbb->dbb_shadow)
+						{
+							batch->add(bdb, page);
+							queued = true;
+							return true;
+						}
+
 						while (!PIO_write(tdbb, file, bdb, page, status))
 						{
 							if (isTempPage || !CCH_rollover_to_shadow(tdbb, dbb, file, inAst))
@@ -5021,26 +5391,34 @@ static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const s
 						return true;
 					}
 
+					bool isQueued() const
+					{
+						return queued;
+					}
+
 				private:
 					jrd_file* file;
 					BufferDesc* bdb;
 					bool inAst;
 					bool isTempPage;
 					PageSpace* pageSpace;
+					IoBatch* batch;
+					bool queued;
 				};
 
-				Pio io(pageSpace->file, bdb, inAst, isTempPage, pageSpace);
+				Pio io(pageSpace->file, bdb, inAst, isTempPage, pageSpace, batch);
 				result = dbb->dbb_crypto_manager->write(tdbb, status, page, &io);
 				if (!result && (bdb->bdb_flags & BDB_io_error))
 				{
 					return false;
 				}
 
+				if (result && io.isQueued())
+					return true;
+
 			}
 		}
 
-		if (result)
-			bdb->bdb_flags &= ~BDB_db_dirty;
 	}
 
 	if (!result)
@@ -5054,34 +5432,53 @@ static bool write_page(thread_db* tdbb, BufferDesc* bdb, FbStatusVector* const s
 		dbb->dbb_flags |= DBB_suspend_bgio;
 	}
 	else
-	{
-		// clear the dirty bit vector, since the buffer is now
-		// clean regardless of which transactions have modified it
+		page_written(tdbb, bdb);
 
-		// Destination difference page number is only valid between MARK and
-		// write_page so clean it now to avoid confusion
-		bdb->bdb_difference_page = 0;
-		bdb->bdb_transactions = 0;
-		bdb->bdb_mark_transaction = 0;
+	return result;
+}
 
-		if (!(bdb->bdb_bcb->bcb_flags & BCB_keep_pages))
-			removeDirty(bdb->bdb_bcb, bdb);
 
-		bdb->bdb_flags &= ~(BDB_must_write | BDB_system_dirty);
-		clear_dirty_flag_and_nbak_state(tdbb, bdb);
+static void page_written(thread_db* tdbb, BufferDesc* bdb)
+{
+/**************************************
+ *
+ *	p a g e _ w r i t t e n
+ *
+ **************************************
+ *
+ * Functional description
+ *	Mark buffer clean after its page image
+ *	is successfully written to disk.
+ *
+ **************************************/
+	Database* const dbb = tdbb->getDatabase();
 
-		if (bdb->bdb_flags & BDB_io_error)
-		{
-			// If a write error has cleared, signal background threads
-			// to resume their regular duties. If someone has freed up
-			// disk space these errors will spontaneously go away.
+	bdb->bdb_flags &= ~BDB_db_dirty;
 
-			bdb->bdb_flags &= ~BDB_io_error;
-			dbb->dbb_flags &= ~DBB_suspend_bgio;
-		}
-	}
+	// clear the dirty bit vector, since the buffer is now
+	// clean regardless of which transactions have modified it
 
-	return result;
+	// Destination difference page number is only valid between MARK and
+	// write_page so clean it now to avoid confusion
+	bdb->bdb_difference_page = 0;
+	bdb->bdb_transactions = 0;
+	bdb->bdb_mark_transaction = 0;
+
+	if (!(bdb->bdb_bcb->bcb_flags & BCB_keep_pages))
+		removeDirty(bdb);
+
+	bdb->bdb_flags &= ~(BDB_must_write | BDB_system_dirty);
+	clear_dirty_flag_and_nbak_state(tdbb, bdb);
+
+	if (bdb->bdb_flags & BDB_io_error)
+	{
+		// If a write error has cleared, signal background threads
+		// to resume their regular duties. If someone has freed up
+		// disk space these errors will spontaneously go away.
+
+		bdb->bdb_flags &= ~BDB_io_error;
+		dbb->dbb_flags &= ~DBB_suspend_bgio;
+	}
 }
 
 static void clear_dirty_flag_and_nbak_state(thread_db* tdbb, BufferDesc* bdb)
@@ -5106,10 +5503,10 @@ void recentlyUsed(BufferDesc* bdb)
 	if (oldFlags & BDB_lru_chained)
 		return;
 
-	BufferControl* bcb = bdb->bdb_bcb;
+	BufferPartition* const part = bdb->bdb_partition;
 
 #ifdef DEV_BUILD
-	volatile BufferDesc* chain = bcb->bcb_lru_chain;
+	volatile BufferDesc* chain = part->bcp_lru_chain;
 	for (; chain; chain = chain->bdb_lru_chain)
 	{
 		if (chain == bdb)
@@ -5118,14 +5515,14 @@ void recentlyUsed(BufferDesc* bdb)
 #endif
 	for (;;)
 	{
-		bdb->bdb_lru_chain = bcb->bcb_lru_chain;
-		if (bcb->bcb_lru_chain.compare_exchange_strong(bdb->bdb_lru_chain, bdb))
+		bdb->bdb_lru_chain = part->bcp_lru_chain;
+		if (part->bcp_lru_chain.compare_exchange_strong(bdb->bdb_lru_chain, bdb))
 			break;
 	}
 }
 
 
-void requeueRecentlyUsed(BufferControl* bcb)
+void requeueRecentlyUsed(BufferPartition* part)
 {
 	BufferDesc* chain = NULL;
 
@@ -5133,8 +5530,8 @@ void requeueRecentlyUsed(BufferControl* bcb)
 
 	for (;;)
 	{
-		chain = bcb->bcb_lru_chain;
-		if (bcb->bcb_lru_chain.compare_exchange_strong(chain, NULL))
+		chain = part->bcp_lru_chain;
+		if (part->bcp_lru_chain.compare_exchange_strong(chain, NULL))
 			break;
 	}
 
@@ -5156,14 +5553,109 @@ void requeueRecentlyUsed(BufferControl* bcb)
 	while ((bdb = reversed) != NULL)
 	{
 		reversed = bdb->bdb_lru_chain;
-		QUE_DELETE(bdb->bdb_in_use);
-		QUE_INSERT(bcb->bcb_in_use, bdb->bdb_in_use);
+
+		// Probation que is FIFO, its buffers stay in place
+
+		if (!bdb->bdb_probation)
+		{
+			QUE_DELETE(bdb->bdb_in_use);
+			QUE_INSERT(part->bcp_in_use, bdb->bdb_in_use);
+		}
 
 		bdb->bdb_lru_chain = NULL;
 		bdb->bdb_flags &= ~BDB_lru_chained;
 	}
 
-	chain = bcb->bcb_lru_chain;
+	chain = part->bcp_lru_chain;
+}
+
+
+void GhostPages::resize(MemoryPool& pool, ULONG capacity, ULONG partCount)
+{
+	// Old content is not worth to be preserved
+
+	delete[] gp_entries;
+	gp_entries = NULL;
+	delete[] gp_hash;
+	gp_hash = NULL;
+
+	gp_entries = FB_NEW_POOL(pool) Entry[capacity];
+	gp_hash = FB_NEW_POOL(pool) ULONG[capacity];
+	gp_capacity = capacity;
+	gp_next = 0;
+	gp_part_count = partCount;
+
+	for (ULONG i = 0; i < capacity; i++)
+	{
+		gp_entries[i].used = false;
+		gp_entries[i].next = 0;
+		gp_hash[i] = 0;
+	}
+}
+
+
+void GhostPages::add(const PageNumber& page)
+{
+	if (!gp_capacity)
+		return;
+
+	// Replace the oldest entry
+
+	const ULONG slot = gp_next;
+	gp_next = (gp_next + 1) % gp_capacity;
+
+	if (gp_entries[slot].used)
+		unlink(slot);
+
+	Entry& entry = gp_entries[slot];
+	entry.pageNum = page.getPageNum();
+	entry.pageSpace = page.getPageSpaceID();
+	entry.used = true;
+
+	ULONG* const chain = getChain(entry.pageNum);
+	entry.next = *chain;
+	*chain = slot + 1;
+}
+
+
+bool GhostPages::remove(const PageNumber& page)
+{
+	if (!gp_capacity)
+		return false;
+
+	const ULONG pageNum = page.getPageNum();
+
+	for (ULONG ptr = *getChain(pageNum); ptr; ptr = gp_entries[ptr - 1].next)
+	{
+		const Entry& entry = gp_entries[ptr - 1];
+
+		if (entry.pageNum == pageNum && entry.pageSpace == page.getPageSpaceID())
+		{
+			unlink(ptr - 1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void GhostPages::unlink(ULONG slot)
+{
+	Entry& entry = gp_entries[slot];
+	fb_assert(entry.used);
+
+	for (ULONG* ptr = getChain(entry.pageNum); *ptr; ptr = &gp_entries[*ptr - 1].next)
+	{
+		if (*ptr == slot + 1)
+		{
+			*ptr = entry.next;
+			break;
+		}
+	}
+
+	entry.used = false;
+	entry.next = 0;
 }
 
 
@@ -5189,10 +5681,15 @@ void BufferControl::destroy(BufferControl* bcb)
 
 bool BufferDesc::addRef(thread_db* tdbb, SyncType syncType, int wait)
 {
-	if (wait == 1)
-		bdb_syncPage.lock(NULL, syncType, FB_FUNCTION);
-	else if (!bdb_syncPage.lock(NULL, syncType, FB_FUNCTION, -wait * 1000))
-		return false;
+	if (!bdb_syncPage.lockConditional(syncType, FB_FUNCTION))
+	{
+		thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::LATCH_WAITS);
+
+		if (wait == 1)
+			bdb_syncPage.lock(NULL, syncType, FB_FUNCTION);
+		else if (!bdb_syncPage.lock(NULL, syncType, FB_FUNCTION, -wait * 1000))
+			return false;
+	}
 
 	++bdb_use_count;
 
@@ -5282,6 +5779,22 @@ void BufferDesc::lockIO(thread_db* tdbb)
 }
 
 
+bool BufferDesc::lockIOConditional(thread_db* tdbb)
+{
+	if (!bdb_syncIO.lockConditional(SYNC_EXCLUSIVE, FB_FUNCTION))
+		return false;
+
+	fb_assert(!bdb_io_locks && bdb_io != tdbb || bdb_io_locks && bdb_io == tdbb);
+
+	bdb_io = tdbb;
+	bdb_io->registerBdb(this);
+	++bdb_io_locks;
+	++bdb_use_count;
+
+	return true;
+}
+
+
 void BufferDesc::unLockIO(thread_db* tdbb)
 {
 	fb_assert(bdb_io && bdb_io == tdbb);
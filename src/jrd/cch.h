@@ -27,13 +27,13 @@
 #include "../include/fb_blk.h"
 #include "../common/classes/alloc.h"
 #include "../common/classes/RefCounted.h"
+#include "../common/classes/locks.h"
+#include "../common/classes/condition.h"
 #include "../common/classes/semaphore.h"
 #include "../common/classes/SyncObject.h"
 #include "../common/ThreadStart.h"
-#ifdef SUPERSERVER_V2
+#include "../common/classes/tree.h"
 #include "../jrd/sbm.h"
-#include "../jrd/pag.h"
-#endif
 
 #include "../jrd/que.h"
 #include "../jrd/lls.h"
@@ -73,12 +73,139 @@ const ULONG MAX_PAGE_BUFFERS = MAX_SLONG - 1;
 #endif
 
 
+// Page cache partitions constraints.
+
+const ULONG MAX_CACHE_PARTITIONS = 64;
+const ULONG MIN_PARTITION_BUFFERS = 1024;	// used when number of partitions is chosen automatically
+
+
+// GhostPages -- FIFO of numbers of pages recently evicted from the probation
+// que of the 2Q replacement policy. Page found there when it's read again is
+// known to be re-referenced and goes directly into the main LRU que.
+
+class GhostPages
+{
+public:
+	GhostPages()
+		: gp_entries(NULL), gp_hash(NULL), gp_capacity(0), gp_next(0), gp_part_count(1)
+	{}
+
+	~GhostPages()
+	{
+		delete[] gp_entries;
+		delete[] gp_hash;
+	}
+
+	void resize(Firebird::MemoryPool& pool, ULONG capacity, ULONG partCount);
+	void add(const PageNumber& page);
+	bool remove(const PageNumber& page);
+
+private:
+	struct Entry
+	{
+		ULONG	pageNum;
+		USHORT	pageSpace;
+		bool	used;
+		ULONG	next;		// next entry in hash chain plus one, zero is end of chain
+	};
+
+	// All pages of the partition have the same remainder of division by the
+	// number of partitions, use the quotient like BufferControl::getHashKey()
+	ULONG* getChain(ULONG pageNum) const
+	{
+		return &gp_hash[(pageNum / gp_part_count) % gp_capacity];
+	}
+
+	void unlink(ULONG slot);
+
+	Entry*	gp_entries;		// ring of entries, gp_next is the oldest one
+	ULONG*	gp_hash;		// hash chains heads, entry index plus one
+	ULONG	gp_capacity;
+	ULONG	gp_next;
+	ULONG	gp_part_count;	// number of partitions pages are spread over
+};
+
+
+// BufferPartition -- independently locked part of the page cache.
+// Pages are spread over partitions by page number. Buffer for the page is
+// searched and allocated within page's partition only, every buffer belongs
+// to the same partition during all its life.
+
+class BufferPartition
+{
+public:
+	explicit BufferPartition(ULONG id)
+		: bcp_id(id)
+	{
+		bcp_hash = NULL;
+		bcp_hash_size = 0;
+		QUE_INIT(bcp_in_use);
+		QUE_INIT(bcp_probation);
+		bcp_probation_count = 0;
+		bcp_probation_target = 0;
+		QUE_INIT(bcp_pending);
+		QUE_INIT(bcp_empty);
+		QUE_INIT(bcp_dirty);
+		bcp_lru_chain = NULL;
+		bcp_dirty_count = 0;
+		bcp_count = 0;
+		bcp_inuse = 0;
+		bcp_free_minimum = 0;
+	}
+
+	~BufferPartition()
+	{
+		delete[] bcp_hash;
+	}
+
+	que* getHashChain(ULONG key) const
+	{
+		return &bcp_hash[key % bcp_hash_size];
+	}
+
+	const ULONG	bcp_id;				// Partition number
+
+	que*		bcp_hash;			// Hash table of buffers by page number
+	ULONG		bcp_hash_size;		// Number of hash chains
+	que			bcp_in_use;			// Que of buffers in use, LRU que of partition
+
+	// 2Q replacement policy: newly read pages are put into FIFO probation que
+	// and moved into bcp_in_use only when referenced again after eviction
+	que			bcp_probation;		// Probation que of buffers
+	ULONG		bcp_probation_count;	// Number of buffers in probation que
+	ULONG		bcp_probation_target;	// Desired maximum of buffers in probation que
+	GhostPages	bcp_ghosts;			// Pages recently evicted from probation que
+
+	que			bcp_pending;		// Que of buffers which are going to be freed and reassigned
+	que			bcp_empty;			// Que of empty buffers
+
+	// Recently used buffer put there without locking LRU que (bcp_in_use).
+	// When bcp_syncLRU is locked this chain is merged into bcp_in_use. See also
+	// requeueRecentlyUsed() and recentlyUsed()
+	std::atomic<BufferDesc*>	bcp_lru_chain;
+
+	que			bcp_dirty;			// que of dirty buffers
+	SLONG		bcp_dirty_count;	// count of pages in dirty que
+	ULONG		bcp_count;			// Number of buffers in partition
+	ULONG		bcp_inuse;			// Number of buffers in use
+	SSHORT		bcp_free_minimum;	// Threshold to activate cache writer
+
+	Firebird::SyncObject	bcp_syncObject;		// Guards hash table, pending and empty ques
+	Firebird::SyncObject	bcp_syncLRU;		// Guards LRU and probation ques, ghost pages
+	Firebird::SyncObject	bcp_syncDirty;		// Guards dirty que
+
+	// Number of times the locks above were not granted immediately
+	Firebird::AtomicCounter	bcp_hash_waits;
+	Firebird::AtomicCounter	bcp_lru_waits;
+	Firebird::AtomicCounter	bcp_dirty_waits;
+};
+
+
 // BufferControl -- Buffer control block -- one per system
 
 struct bcb_repeat
 {
 	BufferDesc*	bcb_bdb;		// Buffer descriptor block
-	que			bcb_page_mod;	// Que of buffers with page mod n
 };
 
 class BufferControl : public pool_alloc<type_bcb>
@@ -87,25 +214,27 @@ class BufferControl : public pool_alloc<type_bcb>
 		: bcb_bufferpool(&p),
 		  bcb_memory_stats(&parentStats),
 		  bcb_memory(p),
-		  bcb_writer_fini(p, cache_writer, THREAD_medium)
+		  bcb_writer_fini(p, cache_writer, THREAD_medium),
+		  bcb_reader_fini(p, cache_reader, THREAD_medium)
 	{
 		bcb_database = NULL;
-		QUE_INIT(bcb_in_use);
-		QUE_INIT(bcb_pending);
-		QUE_INIT(bcb_empty);
-		QUE_INIT(bcb_dirty);
-		bcb_dirty_count = 0;
+		bcb_partitions = NULL;
+		bcb_part_count = 0;
+		bcb_next_partition = 0;
+		bcb_policy = CACHE_POLICY_LRU;
 		bcb_free = NULL;
 		bcb_flags = 0;
-		bcb_free_minimum = 0;
 		bcb_count = 0;
-		bcb_inuse = 0;
 		bcb_prec_walk_mark = 0;
 		bcb_page_size = 0;
 		bcb_page_incarnation = 0;
-#ifdef SUPERSERVER_V2
 		bcb_prefetch = NULL;
-#endif
+		bcb_commit_mask = 0;
+		bcb_commit_group = 1;
+		bcb_commit_done = 0;
+		bcb_commit_failed = 0;
+		bcb_commit_leader = false;
+		bcb_commit_flushing = false;
 	}
 
 public:
@@ -113,37 +242,38 @@ public:
 	static BufferControl* create(Database* dbb);
 	static void destroy(BufferControl*);
 
+	BufferPartition* getPartition(const PageNumber& page) const
+	{
+		return bcb_partitions[page.getPageNum() % bcb_part_count];
+	}
+
+	// Key of the page in the hash table of its partition
+	ULONG getHashKey(const PageNumber& page) const
+	{
+		return page.getPageNum() / bcb_part_count;
+	}
+
 	Database*	bcb_database;
 
 	Firebird::MemoryPool* bcb_bufferpool;
 	Firebird::MemoryStats bcb_memory_stats;
 
 	UCharStack	bcb_memory;			// Large block partitioned into buffers
-	que			bcb_in_use;			// Que of buffers in use, main LRU que
-	que			bcb_pending;		// Que of buffers which are going to be freed and reassigned
-	que			bcb_empty;			// Que of empty buffers
-
-	// Recently used buffer put there without locking common LRU que (bcb_in_use).
-	// When bcb_syncLRU is locked this chain is merged into bcb_in_use. See also
-	// requeueRecentlyUsed() and recentlyUsed()
-	std::atomic<BufferDesc*>	bcb_lru_chain;
 
-	que			bcb_dirty;			// que of dirty buffers
-	SLONG		bcb_dirty_count;	// count of pages in dirty page btree
+	BufferPartition**	bcb_partitions;		// Independently locked parts of the cache
+	ULONG		bcb_part_count;		// Number of partitions
+	ULONG		bcb_next_partition;	// Partition to put next allocated buffer into
+	int			bcb_policy;			// Buffers replacement policy, see CachePolicy setting
 
 	Precedence*	bcb_free;			// Free precedence blocks
 	SSHORT		bcb_flags;			// see below
-	SSHORT		bcb_free_minimum;	// Threshold to activate cache writer
 	ULONG		bcb_count;			// Number of buffers allocated
-	ULONG		bcb_inuse;			// Number of buffers in use
 	ULONG		bcb_prec_walk_mark;	// mark value used in precedence graph walk
 	ULONG		bcb_page_size;		// Database page size in bytes
 	ULONG		bcb_page_incarnation;	// Cache page incarnation counter
 
-	Firebird::SyncObject	bcb_syncObject;
-	Firebird::SyncObject	bcb_syncDirtyBdbs;
+	Firebird::SyncObject	bcb_syncObject;		// Guards bcb_rpt
 	Firebird::SyncObject	bcb_syncPrecedence;
-	Firebird::SyncObject	bcb_syncLRU;
 	//Firebird::SyncObject	bcb_syncPageWrite;
 
 	typedef ThreadFinishSync<BufferControl*> BcbThreadSync;
@@ -152,15 +282,24 @@ public:
 	Firebird::Semaphore bcb_writer_sem;		// Wake up cache writer
 	Firebird::Semaphore bcb_writer_init;	// Cache writer initialization
 	BcbThreadSync bcb_writer_fini;			// Cache writer finalization
-#ifdef SUPERSERVER_V2
+
 	static void cache_reader(BufferControl* bcb);
-	// the code in cch.cpp is not tested for semaphore instead event !!!
 	Firebird::Semaphore bcb_reader_sem;		// Wake up cache reader
 	Firebird::Semaphore bcb_reader_init;	// Cache reader initialization
 	BcbThreadSync bcb_reader_fini;			// Cache reader finalization
 
-	PageBitmap*	bcb_prefetch;		// Bitmap of pages to prefetch
-#endif
+	Firebird::Mutex	bcb_prefetch_mutex;	// Guards bcb_prefetch
+	PageBitmap*	bcb_prefetch;			// Bitmap of pages to prefetch
+
+	// Group commit, see groupFlush() in cch.cpp
+	Firebird::Mutex		bcb_commit_mutex;	// Guards the fields below
+	Firebird::Condition	bcb_commit_cond;	// A group was flushed
+	SLONG		bcb_commit_mask;		// Transactions of the group being collected
+	ULONG		bcb_commit_group;		// Number of the group being collected
+	ULONG		bcb_commit_done;		// Last flushed group
+	ULONG		bcb_commit_failed;		// Last group whose flush failed
+	bool		bcb_commit_leader;		// The group being collected has a leader
+	bool		bcb_commit_flushing;	// Some group is being flushed
 
 	void exceptionHandler(const Firebird::Exception& ex, BcbThreadSync::ThreadRoutine* routine);
 
@@ -171,12 +310,11 @@ const int BCB_keep_pages	= 1;	// set during btc_flush(), pages not removed from
 const int BCB_cache_writer	= 2;	// cache writer thread has been started
 const int BCB_writer_start  = 4;    // cache writer thread is starting now
 const int BCB_writer_active	= 8;	// no need to post writer event count
-#ifdef SUPERSERVER_V2
 const int BCB_cache_reader	= 16;	// cache reader thread has been started
 const int BCB_reader_active	= 32;	// cache reader not blocked on event
-#endif
 const int BCB_free_pending	= 64;	// request cache writer to free pages
 const int BCB_exclusive		= 128;	// there is only BCB in whole system
+const int BCB_reader_start	= 256;	// cache reader thread is starting now
 
 
 // BufferDesc -- Buffer descriptor block
@@ -186,6 +324,7 @@ class BufferDesc : public pool_alloc<type_bdb>
 public:
 	explicit BufferDesc(BufferControl* bcb)
 		: bdb_bcb(bcb),
+		  bdb_partition(NULL),
 		  bdb_page(0, 0),
 		  bdb_pending_page(0, 0)
 	{
@@ -205,6 +344,7 @@ public:
 		bdb_scan_count = 0;
 		bdb_difference_page = 0;
 		bdb_prec_walk_mark = 0;
+		bdb_probation = false;
 	}
 
 	bool addRef(thread_db* tdbb, Firebird::SyncType syncType, int wait = 1);
@@ -213,6 +353,7 @@ public:
 	void release(thread_db* tdbb, bool repost);
 
 	void lockIO(thread_db*);
+	bool lockIOConditional(thread_db*);
 	void unLockIO(thread_db*);
 
 	bool isLocked() const
@@ -231,9 +372,10 @@ public:
 	}
 
 	BufferControl*	bdb_bcb;
+	BufferPartition*	bdb_partition;	// Cache partition the buffer belongs to
 	Firebird::SyncObject	bdb_syncPage;
 	Lock*		bdb_lock;				// Lock block for buffer
-	que			bdb_que;				// Either mod que in hash table or bcb_pending que if BDB_free_pending flag is set
+	que			bdb_que;				// Either hash chain, bcp_pending or bcp_empty que of the partition
 	que			bdb_in_use;				// queue of buffers in use
 	que			bdb_dirty;				// dirty pages LRU queue
 	BufferDesc*	bdb_lru_chain;			// pending LRU chain
@@ -260,6 +402,7 @@ public:
 	Firebird::AtomicCounter	bdb_scan_count;		// concurrent sequential scans
 	ULONG       bdb_difference_page;			// Number of page in difference file, NBAK
 	ULONG		bdb_prec_walk_mark;				// mark value used in precedence graph walk
+	bool		bdb_probation;					// buffer is in probation que, guarded by bcp_syncLRU
 };
 
 // bdb_flags
@@ -284,6 +427,7 @@ const int BDB_prefetch			= 0x4000;	// page has been prefetched but not yet refer
 const int BDB_no_blocking_ast	= 0x8000;	// No blocking AST registered with page lock
 const int BDB_lru_chained		= 0x10000;	// buffer is in pending LRU chain
 const int BDB_nbak_state_lock	= 0x20000;	// nbak state lock should be released after buffer is written
+const int BDB_scan_only			= 0x40000;	// page was used by large scans or garbage collector only
 
 // bdb_ast_flags
 
@@ -341,34 +485,10 @@ enum LATCH
 
 
 
-#ifdef SUPERSERVER_V2
-#include "../jrd/os/pio.h"
-
 // Constants used by prefetch mechanism
 
-const int PREFETCH_MAX_TRANSFER	= 16384;	// maximum block I/O transfer (bytes)
 // maximum pages allowed per prefetch request
-const int PREFETCH_MAX_PAGES	= (2 * PREFETCH_MAX_TRANSFER / MIN_PAGE_SIZE);
-
-// Prefetch block
-
-class Prefetch : public pool_alloc<type_prf>
-{
-public:
-	thread_db*	prf_tdbb;			// thread database context
-	SLONG		prf_start_page;		// starting page of multipage prefetch
-	USHORT		prf_max_prefetch;	// maximum no. of pages to prefetch
-	USHORT		prf_page_count;		// actual no. of pages being prefetched
-	phys_io_blk	prf_piob;			// physical I/O status block
-	SCHAR*		prf_aligned_buffer;	// buffer address aligned for raw (OS cache bypass) I/O
-	SCHAR*		prf_io_buffer;		// I/O buffer address
-	UCHAR		prf_flags;
-	BufferDesc*	prf_bdbs[PREFETCH_MAX_TRANSFER / MIN_PAGE_SIZE];
-	SCHAR		prf_unaligned_buffer[PREFETCH_MAX_TRANSFER + MIN_PAGE_SIZE];
-};
-
-const int PRF_active	= 1;		// prefetch block currently in use
-#endif // SUPERSERVER_V2
+const int PREFETCH_MAX_PAGES	= 256;
 
 typedef Firebird::SortedArray<SLONG, Firebird::InlineStorage<SLONG, 256>, SLONG> PagesArray;
 
@@ -55,6 +55,7 @@ void		CCH_flush(Jrd::thread_db* tdbb, USHORT flush_flag, TraNumber tra_number);
 bool		CCH_free_page(Jrd::thread_db*);
 SLONG		CCH_get_incarnation(Jrd::win*);
 void		CCH_get_related(Jrd::thread_db*, Jrd::PageNumber, Jrd::PagesArray&);
+bool		CCH_group_commit(Jrd::thread_db*);
 Ods::pag*	CCH_handoff(Jrd::thread_db*, Jrd::win*, ULONG, int, SCHAR, int, const bool);
 void		CCH_init(Jrd::thread_db*, ULONG);
 void		CCH_init2(Jrd::thread_db*);
@@ -63,10 +64,8 @@ void		CCH_must_write(Jrd::thread_db*, Jrd::win*);
 void		CCH_precedence(Jrd::thread_db*, Jrd::win*, ULONG);
 void		CCH_precedence(Jrd::thread_db*, Jrd::win*, Jrd::PageNumber);
 void		CCH_tra_precedence(Jrd::thread_db*, Jrd::win*, TraNumber traNum);
-#ifdef SUPERSERVER_V2
 void		CCH_prefetch(Jrd::thread_db*, SLONG*, SSHORT);
 bool		CCH_prefetch_pages(Jrd::thread_db*);
-#endif
 void		CCH_release(Jrd::thread_db*, Jrd::win*, const bool);
 void		CCH_release_exclusive(Jrd::thread_db*);
 bool		CCH_rollover_to_shadow(Jrd::thread_db* tdbb, Jrd::Database* dbb, Jrd::jrd_file*, const bool);
@@ -134,12 +133,10 @@ inline void CCH_MARK_MUST_WRITE(Jrd::thread_db* tdbb, Jrd::win* window)
 	CCH_mark(tdbb, window, 0, 1);
 }
 
-#ifdef SUPERSERVER_V2
 inline void CCH_PREFETCH(Jrd::thread_db* tdbb, SLONG* pages, SSHORT count)
 {
 	CCH_prefetch (tdbb, pages, count);
 }
-#endif
 
 //#define CCH_FETCH(tdbb, window, lock, type)		  CCH_fetch (tdbb, window, lock, type, 1, true)
 //#define CCH_FETCH_NO_SHADOW(tdbb, window, lock, type)		  CCH_fetch (tdbb, window, lock, type, 1, false)
@@ -163,6 +160,7 @@ const USHORT FLUSH_RLSE		= 2;		// release page locks after flush
 const USHORT FLUSH_TRAN		= 4;		// flush transaction dirty buffers from dirty btree
 const USHORT FLUSH_SWEEP	= 8;		// flush dirty buffers from garbage collection
 const USHORT FLUSH_SYSTEM	= 16;		// flush system transaction only from dirty btree
+const USHORT FLUSH_TIP		= 32;		// group commit: flush the TIP change after the data pages
 const USHORT FLUSH_FINI		= (FLUSH_ALL | FLUSH_RLSE);
 
 #endif // JRD_CCH_PROTO_H
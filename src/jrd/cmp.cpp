@@ -92,6 +92,7 @@
 #include "../dsql/BoolNodes.h"
 #include "../dsql/ExprNodes.h"
 #include "../dsql/StmtNodes.h"
+#include "../dsql/dsql_proto.h"
 
 using namespace Jrd;
 using namespace Firebird;
@@ -275,6 +276,26 @@ const Format* CMP_format(thread_db* tdbb, CompilerScratch* csb, StreamType strea
 }
 
 
+// Someone is trying to drop an index, release the cached statements that may use it.
+static int blocking_ast_index(void* ast_object)
+{
+	IndexLock* const index = static_cast<IndexLock*>(ast_object);
+
+	try
+	{
+		Database* const dbb = index->idl_lock->lck_dbb;
+
+		AsyncContextHolder tdbb(dbb, FB_FUNCTION, index->idl_lock);
+
+		DSQL_purge_statement_cache(tdbb);
+	}
+	catch (const Exception&)
+	{} // no-op
+
+	return 0;
+}
+
+
 IndexLock* CMP_get_index_lock(thread_db* tdbb, jrd_rel* relation, USHORT id)
 {
 /**************************************
@@ -313,7 +334,8 @@ IndexLock* CMP_get_index_lock(thread_db* tdbb, jrd_rel* relation, USHORT id)
 	index->idl_id = id;
 	index->idl_count = 0;
 
-	Lock* lock = FB_NEW_RPT(*relation->rel_pool, 0) Lock(tdbb, sizeof(SLONG), LCK_idx_exist);
+	Lock* lock = FB_NEW_RPT(*relation->rel_pool, 0)
+		Lock(tdbb, sizeof(SLONG), LCK_idx_exist, index, blocking_ast_index);
 	index->idl_lock = lock;
 	lock->setKey((relation->rel_id << 16) | id);
 
@@ -252,6 +252,10 @@ enum drq_type_t
 	drq_l_pub_rel_name,		// lookup relation by name
 	drq_l_pub_all_rels,		// iterate through all user relations
 	drq_e_pub_tab_all,		// erase relation from all publication
+	drq_l_stat_rel,			// lookup relation (set statistics)
+	drq_l_stat_fld,			// lookup relation field (set statistics)
+	drq_e_rel_stats,		// erase relation column statistics
+	drq_e_fld_stats,		// erase column statistics
 
 	drq_MAX
 };
@@ -70,11 +70,11 @@
 	static_assert(f_rol_sys_priv == 5, "Wrong field id");
 	static_assert(f_backup_name == 5, "Wrong field id");
 	static_assert(f_mon_db_crypt_state == 22, "Wrong field id");
-	static_assert(f_mon_att_remote_crypt == 25, "Wrong field id");
+	static_assert(f_mon_att_repl_queue == 29, "Wrong field id");
 	static_assert(f_mon_tra_stat_id == 12, "Wrong field id");
 	static_assert(f_mon_stmt_timer == 9, "Wrong field id");
 	static_assert(f_mon_call_pkg_name == 9, "Wrong field id");
-	static_assert(f_mon_io_page_marks == 5, "Wrong field id");
+	static_assert(f_mon_io_page_run_writes == 9, "Wrong field id");
 	static_assert(f_mon_rec_imgc == 16, "Wrong field id");
 	static_assert(f_mon_ctx_var_value == 3, "Wrong field id");
 	static_assert(f_mon_mem_max_alloc == 5, "Wrong field id");
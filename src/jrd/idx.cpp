@@ -31,6 +31,7 @@
 
 #include "firebird.h"
 #include <string.h>
+#include <algorithm>
 #include "../jrd/jrd.h"
 #include "../jrd/val.h"
 #include "../jrd/intl.h"
@@ -1077,6 +1078,13 @@ void IDX_store(thread_db* tdbb, record_param* rpb, jrd_tra* transaction)
 	insertion.iib_transaction = transaction;
 	insertion.iib_btr_level = 0;
 
+	// Keys of the non-unique indices of a relation loaded by a batch are inserted later
+
+	const jrd_req* const request = tdbb->getRequest();
+	DeferredIndexKeys* const deferred = (request && request->req_deferred_keys &&
+		request->req_deferred_keys->getRelation() == rpb->rpb_relation) ?
+			request->req_deferred_keys : NULL;
+
 	RelationPages* relPages = rpb->rpb_relation->getPages(tdbb);
 	WIN window(relPages->rel_pg_space_id, -1);
 
@@ -1091,6 +1099,12 @@ void IDX_store(thread_db* tdbb, record_param* rpb, jrd_tra* transaction)
 			context.raise(tdbb, error_code, rpb->rpb_record);
 		}
 
+		if (deferred && DeferredIndexKeys::defer(&idx))
+		{
+			deferred->add(&idx, &key, rpb->rpb_number);
+			continue;
+		}
+
 		if ( (error_code = insert_key(tdbb, rpb->rpb_relation, rpb->rpb_record, transaction,
 									  &window, &insertion, context)) )
 		{
@@ -1099,6 +1113,173 @@ void IDX_store(thread_db* tdbb, record_param* rpb, jrd_tra* transaction)
 	}
 }
 
+jrd_rel* DeferredIndexKeys::getTarget(const JrdStatement* statement)
+{
+/**************************************
+ *
+ *	g e t T a r g e t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Return the relation which indices may be loaded
+ *	by a batch executing the statement, or NULL.
+ *	The statement should store into a single regular
+ *	table without triggers and shouldn't read anything,
+ *	so nobody may look into the indices before the
+ *	batch is done.
+ *
+ **************************************/
+	if (statement->fors.hasData() || statement->subStatements.hasData())
+		return NULL;
+
+	jrd_rel* relation = NULL;
+
+	for (const Resource* rsc = statement->resources.begin(); rsc != statement->resources.end(); ++rsc)
+	{
+		switch (rsc->rsc_type)
+		{
+			case Resource::rsc_relation:
+				if (relation)
+					return NULL;
+				relation = rsc->rsc_rel;
+				break;
+
+			case Resource::rsc_index:
+			case Resource::rsc_collation:
+				break;
+
+			default:
+				return NULL;
+		}
+	}
+
+	if (!relation || relation->isSystem() || relation->isTemporary() || relation->isVirtual() ||
+		relation->isView() || relation->rel_file || relation->rel_pre_store || relation->rel_post_store)
+	{
+		return NULL;
+	}
+
+	return relation;
+}
+
+
+bool DeferredIndexKeys::Compare::operator()(const Entry& e1, const Entry& e2) const
+{
+	if (e1.indexId != e2.indexId)
+		return e1.indexId < e2.indexId;
+
+	const int result = memcmp(m_data + e1.offset, m_data + e2.offset, MIN(e1.length, e2.length));
+
+	if (result)
+		return result < 0;
+
+	if (e1.length != e2.length)
+		return e1.length < e2.length;
+
+	return e1.number < e2.number;
+}
+
+
+void DeferredIndexKeys::add(const index_desc* idx, const temporary_key* key, RecordNumber number)
+{
+/**************************************
+ *
+ *	a d d
+ *
+ **************************************
+ *
+ * Functional description
+ *	Keep the key of the row being stored.
+ *
+ **************************************/
+	Entry& entry = m_entries.add();
+	entry.number = number.getValue();
+	entry.offset = m_data.getCount();
+	entry.length = key->key_length;
+	entry.indexId = idx->idx_id;
+	entry.nulls = key->key_nulls;
+	entry.flags = key->key_flags;
+
+	m_data.add(key->key_data, key->key_length);
+}
+
+
+void DeferredIndexKeys::flush(thread_db* tdbb, jrd_tra* transaction)
+{
+/**************************************
+ *
+ *	f l u s h
+ *
+ **************************************
+ *
+ * Functional description
+ *	Insert the accepted keys into the indices
+ *	in the key order.
+ *
+ **************************************/
+	SET_TDBB(tdbb);
+
+	discard();
+
+	if (m_entries.isEmpty())
+		return;
+
+	std::sort(m_entries.begin(), m_entries.end(), Compare(m_data.begin()));
+
+	temporary_key key;
+
+	index_desc idx;
+	idx.idx_id = idx_invalid;
+
+	index_insertion insertion;
+	insertion.iib_relation = m_relation;
+	insertion.iib_key = &key;
+	insertion.iib_descriptor = &idx;
+	insertion.iib_transaction = transaction;
+	insertion.iib_btr_level = 0;
+
+	RelationPages* relPages = m_relation->getPages(tdbb);
+	WIN window(relPages->rel_pg_space_id, -1);
+
+	const Entry* entry = m_entries.begin();
+
+	while (entry < m_entries.end() &&
+		BTR_next_index(tdbb, m_relation, transaction, &idx, &window))
+	{
+		while (entry < m_entries.end() && entry->indexId < idx.idx_id)
+			++entry;
+
+		if (entry == m_entries.end() || entry->indexId != idx.idx_id)
+			continue;
+
+		// The index root is released by every insertion, fetch it again for the next key
+
+		for (; entry < m_entries.end() && entry->indexId == idx.idx_id; ++entry)
+		{
+			if (!window.win_bdb)
+				CCH_FETCH(tdbb, &window, LCK_read, pag_root);
+
+			key.key_length = entry->length;
+			memcpy(key.key_data, m_data.begin() + entry->offset, entry->length);
+			key.key_flags = entry->flags;
+			key.key_nulls = entry->nulls;
+
+			insertion.iib_number.setValue(entry->number);
+			insertion.iib_duplicates = NULL;
+			BTR_insert(tdbb, &window, &insertion);
+		}
+	}
+
+	if (window.win_bdb)
+		CCH_RELEASE(tdbb, &window);
+
+	m_entries.clear();
+	m_data.clear();
+	m_acceptedEntries = m_acceptedData = 0;
+}
+
+
 static bool cmpRecordKeys(thread_db* tdbb,
 						  Record* rec1, jrd_rel* rel1, index_desc* idx1,
 						  Record* rec2, jrd_rel* rel2, index_desc* idx2)
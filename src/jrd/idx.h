@@ -304,6 +304,11 @@ static const struct ini_idx_t indices[] =
 		SEGMENT(f_pubtab_tab_name, idx_string),		// table name
 		SEGMENT(f_pubtab_pub_name, idx_string)		// publication name
 	}},
+	// define index RDB$INDEX_57 for RDB$COLUMN_STATISTICS unique RDB$RELATION_NAME, RDB$FIELD_NAME;
+	INDEX(57, rel_col_stats, idx_unique, 2)
+		SEGMENT(f_cst_rel_name, idx_metadata),	// relation name
+		SEGMENT(f_cst_fld_name, idx_metadata)	// field name
+	}},
 };
 
 #define SYSTEM_INDEX_COUNT FB_NELEM(indices)
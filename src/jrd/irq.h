@@ -180,6 +180,7 @@ enum irq_type_t
 	irq_dbb_ss_definer,		// get database sql security value
 	irq_out_proc_param_dep,	// check output procedure parameter dependency
 	irq_l_pub_tab_state,	// lookup publication state for a table
+	irq_l_col_stats,		// lookup column statistics of a table
 
 	irq_MAX
 };
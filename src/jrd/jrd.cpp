@@ -1053,6 +1053,7 @@ namespace Jrd
 		ULONG	dpb_remote_flags;
 		ReplicaMode	dpb_replica_mode;
 		bool	dpb_set_db_replica;
+		ULONG	dpb_parallel_workers;
 
 		// here begin compound objects
 		// for constructor to work properly dpb_user_name
@@ -7073,6 +7074,10 @@ void DatabaseOptions::get(const UCHAR* dpb, USHORT dpb_length, bool& invalid_cli
 			rdr.getString(dpb_decfloat_traps);
 			break;
 
+		case isc_dpb_parallel_workers:
+			dpb_parallel_workers = (ULONG) rdr.getInt();
+			break;
+
 		default:
 			break;
 		}
@@ -7315,6 +7320,7 @@ static JAttachment* create_attachment(const PathName& alias_name,
 	attachment->att_client_version = options.dpb_client_version;
 	attachment->att_remote_protocol = options.dpb_remote_protocol;
 	attachment->att_ext_call_depth = options.dpb_ext_call_depth;
+	attachment->setParallelWorkers(options.dpb_parallel_workers);
 
 	StableAttachmentPart* sAtt = FB_NEW StableAttachmentPart(attachment);
 	attachment->setStable(sAtt);
@@ -7469,6 +7475,9 @@ void release_attachment(thread_db* tdbb, Jrd::Attachment* attachment)
 	if (attachment->att_event_session)
 		dbb->eventManager()->deleteSession(attachment->att_event_session);
 
+	// Cached DSQL statements own some of the requests
+	DSQL_purge_statement_cache(tdbb);
+
     // CMP_release() changes att_requests.
 	while (attachment->att_requests.hasData())
 		CMP_release(tdbb, attachment->att_requests.back());
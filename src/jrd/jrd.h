@@ -740,6 +740,36 @@ public:
 		bool m_autoStop;
 	};
 
+	// Accounts a wait lasting for the guard scope: the number of waits
+	// is bumped at the given index, the microseconds spent at the next one
+	class WaitGuard
+	{
+	public:
+		WaitGuard(thread_db* tdbb, RuntimeStatistics::StatType type)
+			: m_tdbb(tdbb),
+			  m_type(type),
+			  m_start(tdbb ? fb_utils::query_performance_counter() : 0)
+		{
+		}
+
+		~WaitGuard()
+		{
+			if (!m_tdbb)
+				return;
+
+			const SINT64 elapsed = fb_utils::query_performance_counter() - m_start;
+
+			m_tdbb->bumpStats(m_type);
+			m_tdbb->bumpStats(RuntimeStatistics::StatType(m_type + 1),
+				elapsed * 1000000 / fb_utils::query_performance_frequency());
+		}
+
+	private:
+		thread_db* const m_tdbb;
+		const RuntimeStatistics::StatType m_type;
+		const SINT64 m_start;
+	};
+
 private:
 	Firebird::RefPtr<TimeoutTimer> tdbb_reqTimer;
 
@@ -46,6 +46,7 @@ namespace Jrd
 	class DeferredWork;
 	struct FieldInfo;
 	class ExceptionItem;
+	class RelationStatistics;
 
 	// index status
 	enum IndexStatus
@@ -93,6 +94,7 @@ Jrd::jrd_fld*	MET_get_field(const Jrd::jrd_rel*, USHORT);
 ULONG		MET_get_rel_flags_from_TYPE(USHORT);
 bool		MET_get_repl_state(Jrd::thread_db*, const Firebird::MetaName&);
 void		MET_get_shadow_files(Jrd::thread_db*, bool);
+const Jrd::RelationStatistics*	MET_get_statistics(Jrd::thread_db*, Jrd::jrd_rel*);
 void		MET_load_db_triggers(Jrd::thread_db*, int);
 void		MET_load_ddl_triggers(Jrd::thread_db* tdbb);
 bool		MET_load_exception(Jrd::thread_db*, Jrd::ExceptionItem&);
@@ -122,6 +124,7 @@ void		MET_prepare(Jrd::thread_db*, Jrd::jrd_tra*, USHORT, const UCHAR*);
 Jrd::jrd_prc*	MET_procedure(Jrd::thread_db*, USHORT, bool, USHORT);
 Jrd::jrd_rel*	MET_relation(Jrd::thread_db*, USHORT);
 void		MET_release_existence(Jrd::thread_db*, Jrd::jrd_rel*);
+void		MET_reset_statistics(Jrd::jrd_rel*);
 void		MET_release_trigger(Jrd::thread_db*, Jrd::TrigVector**, const Firebird::MetaName&);
 void		MET_release_triggers(Jrd::thread_db*, Jrd::TrigVector**);
 #ifdef DEV_BUILD
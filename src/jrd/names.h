@@ -288,6 +288,7 @@ NAME("MON$AUTO_COMMIT", nam_mon_auto_commit)
 NAME("MON$AUTO_UNDO", nam_mon_auto_undo)
 NAME("MON$BACKUP_STATE", nam_mon_backup_state)
 NAME("MON$BACKVERSION_READS", nam_mon_bkversion_reads)
+NAME("MON$CACHE_PARTITIONS", nam_mon_cache_parts)
 NAME("MON$CALL_ID", nam_mon_call_id)
 NAME("MON$CALL_STACK", nam_mon_calls)
 NAME("MON$CALLER_ID", nam_mon_caller_id)
@@ -299,13 +300,23 @@ NAME("MON$CRYPT_PAGE", nam_mon_crypt_page)
 NAME("MON$CRYPT_STATE", nam_mon_crypt_state)
 NAME("MON$DATABASE", nam_mon_database)
 NAME("MON$DATABASE_NAME", nam_mon_db_name)
+NAME("MON$DIRTY_PAGES", nam_mon_dirty_pages)
+NAME("MON$DIRTY_WAITS", nam_mon_dirty_waits)
 NAME("MON$EXPLAINED_PLAN", nam_mon_expl_plan)
+NAME("MON$EXECUTIONS", nam_mon_executions)
 NAME("MON$FORCED_WRITES", nam_mon_forced_writes)
 NAME("MON$FRAGMENT_READS", nam_mon_fragment_reads)
 NAME("MON$GARBAGE_COLLECTION", nam_mon_gc)
+NAME("MON$HASH_WAITS", nam_mon_hash_waits)
 NAME("MON$IO_STATS", nam_mon_io_stats)
 NAME("MON$ISOLATION_MODE", nam_mon_iso_mode)
+NAME("MON$LATCH_WAITS", nam_mon_latch_waits)
+NAME("MON$LATCH_WAIT_TIME", nam_mon_latch_wait_time)
+NAME("MON$LATENCY_LIMIT", nam_mon_latency_limit)
 NAME("MON$LOCK_TIMEOUT", nam_mon_lock_timeout)
+NAME("MON$LOCK_WAITS", nam_mon_lock_waits)
+NAME("MON$LOCK_WAIT_TIME", nam_mon_lock_wait_time)
+NAME("MON$LRU_WAITS", nam_mon_lru_waits)
 NAME("MON$MAX_MEMORY_USED", nam_mon_max_used)
 NAME("MON$MAX_MEMORY_ALLOCATED", nam_mon_max_alloc)
 NAME("MON$MEMORY_USAGE", nam_mon_mem_usage)
@@ -314,6 +325,8 @@ NAME("MON$MEMORY_ALLOCATED", nam_mon_mem_alloc)
 NAME("MON$NEXT_TRANSACTION", nam_mon_nt)
 NAME("MON$PAGE_SIZE", nam_mon_page_size)
 NAME("MON$READ_ONLY", nam_mon_read_only)
+NAME("MON$READ_WAITS", nam_mon_read_waits)
+NAME("MON$READ_WAIT_TIME", nam_mon_read_wait_time)
 NAME("MON$RESERVE_SPACE", nam_mon_res_space)
 NAME("MON$OBJECT_NAME", nam_mon_obj_name)
 NAME("MON$OBJECT_TYPE", nam_mon_obj_type)
@@ -328,9 +341,14 @@ NAME("MON$PACKAGE_NAME", nam_mon_pkg_name)
 NAME("MON$PAGE_BUFFERS", nam_mon_page_bufs)
 NAME("MON$PAGE_FETCHES", nam_mon_page_fetches)
 NAME("MON$PAGE_MARKS", nam_mon_page_marks)
+NAME("MON$PAGE_PREFETCHES", nam_mon_page_prefetches)
+NAME("MON$PAGE_PREFETCH_HITS", nam_mon_page_prefetch_hits)
 NAME("MON$PAGE_READS", nam_mon_page_reads)
+NAME("MON$PAGE_RUN_WRITES", nam_mon_page_run_writes)
+NAME("MON$PAGE_WRITE_RUNS", nam_mon_page_write_runs)
 NAME("MON$PAGE_WRITES", nam_mon_page_writes)
 NAME("MON$PAGES", nam_mon_pages)
+NAME("MON$PARTITION_ID", nam_mon_part_id)
 NAME("MON$RECORD_BACKOUTS", nam_mon_rec_backouts)
 NAME("MON$RECORD_CONFLICTS", nam_mon_rec_conflicts)
 NAME("MON$RECORD_DELETES", nam_mon_rec_deletes)
@@ -365,10 +383,13 @@ NAME("MON$STAT_ID", nam_mon_stat_id)
 NAME("MON$STATE", nam_mon_state)
 NAME("MON$STATEMENTS", nam_mon_statements)
 NAME("MON$STATEMENT_ID", nam_mon_stmt_id)
+NAME("MON$STATEMENT_LATENCY", nam_mon_stmt_latency)
 NAME("MON$SWEEP_INTERVAL", nam_mon_sweep_int)
 NAME("MON$SYSTEM_FLAG", nam_mon_sys_flag)
 NAME("MON$TABLE_NAME", nam_mon_tab_name)
 NAME("MON$TABLE_STATS", nam_mon_tab_stats)
+NAME("MON$TEMP_WAITS", nam_mon_temp_waits)
+NAME("MON$TEMP_WAIT_TIME", nam_mon_temp_wait_time)
 NAME("MON$TIMESTAMP", nam_mon_timestamp)
 NAME("MON$TOP_TRANSACTION", nam_mon_top)
 NAME("MON$TRANSACTIONS", nam_mon_transactions)
@@ -376,6 +397,9 @@ NAME("MON$TRANSACTION_ID", nam_mon_tra_id)
 NAME("MON$USER", nam_mon_user)
 NAME("MON$VARIABLE_NAME", nam_mon_var_name)
 NAME("MON$VARIABLE_VALUE", nam_mon_var_value)
+NAME("MON$WAIT_STATS", nam_mon_wait_stats)
+NAME("MON$WRITE_WAITS", nam_mon_write_waits)
+NAME("MON$WRITE_WAIT_TIME", nam_mon_write_wait_time)
 
 NAME("SEC$USERS", nam_sec_users)
 NAME("SEC$USER_ATTRIBUTES", nam_sec_user_attributes)
@@ -421,6 +445,11 @@ NAME("MON$WIRE_COMPRESSED", nam_wire_compressed)
 NAME("MON$WIRE_ENCRYPTED", nam_wire_encrypted)
 NAME("MON$WIRE_CRYPT_PLUGIN", nam_wire_crypt_plugin)
 
+NAME("MON$STATEMENT_CACHE_HITS", nam_mon_stmt_cache_hits)
+NAME("MON$STATEMENT_CACHE_MISSES", nam_mon_stmt_cache_misses)
+NAME("MON$REPLICATION_LAG", nam_mon_repl_lag)
+NAME("MON$REPLICATION_QUEUE", nam_mon_repl_queue)
+
 NAME("RDB$TIME_ZONES", nam_time_zones)
 NAME("RDB$TIME_ZONE_ID", nam_tz_id)
 NAME("RDB$TIME_ZONE_NAME", nam_tz_name)
@@ -435,3 +464,12 @@ NAME("RDB$PUBLICATIONS", nam_pubs)
 NAME("RDB$PUBLICATION_NAME", nam_pub_name)
 NAME("RDB$PUBLICATION_TABLES", nam_pub_tables)
 NAME("RDB$TABLE_NAME", nam_tab_name)
+
+NAME("RDB$COLUMN_STATISTICS", nam_col_stats)
+NAME("RDB$RECORD_COUNT", nam_record_count)
+NAME("RDB$DATA_PAGES", nam_data_pages)
+NAME("RDB$NULL_FRACTION", nam_null_fraction)
+NAME("RDB$DISTINCT_VALUES", nam_distinct_values)
+NAME("RDB$HISTOGRAM", nam_histogram)
+
+NAME("RDB$RECORD_CODEC", nam_record_codec)
@@ -123,7 +123,9 @@ const USHORT ODS_CURRENT12		= 0;
 // Minor versions for ODS 13
 
 const USHORT ODS_CURRENT13_0	= 0;	// Firebird 4.0 features
-const USHORT ODS_CURRENT13		= 0;
+const USHORT ODS_CURRENT13_1	= 1;	// Table RDB$COLUMN_STATISTICS, all-visible data pages,
+										// RDB$RELATIONS.RDB$RECORD_CODEC, new monitoring tables and columns
+const USHORT ODS_CURRENT13		= 1;
 
 // useful ODS macros. These are currently used to flag the version of the
 // system triggers and system indices in ini.e
@@ -144,6 +146,7 @@ const USHORT ODS_11_1		= ENCODE_ODS(ODS_VERSION11, 1);
 const USHORT ODS_11_2		= ENCODE_ODS(ODS_VERSION11, 2);
 const USHORT ODS_12_0		= ENCODE_ODS(ODS_VERSION12, 0);
 const USHORT ODS_13_0		= ENCODE_ODS(ODS_VERSION13, 0);
+const USHORT ODS_13_1		= ENCODE_ODS(ODS_VERSION13, 1);
 
 const USHORT ODS_FIREBIRD_FLAG = 0x8000;
 
@@ -171,7 +174,7 @@ const USHORT ODS_RELEASED = ODS_CURRENT13_0;	// The lowest stable minor version
 const USHORT ODS_CURRENT = ODS_CURRENT13;		// The highest defined minor version
 												// number for this ODS_VERSION!
 
-const USHORT ODS_CURRENT_VERSION = ODS_13_0;	// Current ODS version in use which includes
+const USHORT ODS_CURRENT_VERSION = ODS_13_1;	// Current ODS version in use which includes
 												// both major and minor ODS versions!
 
 
@@ -346,6 +349,7 @@ const UCHAR dpg_large		= 0x04;		// Large object is on page
 const UCHAR dpg_swept		= 0x08;		// Sweep has nothing to do on this page
 const UCHAR dpg_secondary	= 0x10;	// Primary record versions not stored on this page
 									// Set in dpm.epp's extend_relation() but never tested.
+const UCHAR dpg_all_visible	= 0x20;	// All records on page are visible to every transaction
 
 
 // Index root page
@@ -662,6 +666,7 @@ const UCHAR ppg_dp_large		= 0x02;		// Large object is on data page
 const UCHAR ppg_dp_swept		= 0x04;		// Sweep has nothing to do on data page
 const UCHAR ppg_dp_secondary	= 0x08;		// Primary record versions not stored on data page
 const UCHAR ppg_dp_empty		= 0x10;		// Data page is empty
+const UCHAR ppg_dp_all_visible	= 0x20;		// All records on data page are visible to every transaction
 
 const UCHAR PPG_DP_ALL_BITS	= (1 << PPG_DP_BITS_NUM) - 1;
 
@@ -833,6 +838,7 @@ const USHORT rhd_damaged		= 128;		// object is known to be damaged
 const USHORT rhd_gc_active		= 256;		// garbage collecting dead record version
 const USHORT rhd_uk_modified	= 512;		// record key field values are changed
 const USHORT rhd_long_tranum	= 1024;		// transaction number is 64-bit
+const USHORT rhd_lz				= 2048;		// data is packed with the LZ codec
 
 
 // This (not exact) copy of class DSC is used to store descriptors on disk.
@@ -44,6 +44,7 @@
 #include "firebird.h"
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include "../jrd/jrd.h"
 #include "../jrd/align.h"
 #include "../jrd/val.h"
@@ -57,6 +58,7 @@
 #include "../jrd/ini.h"
 #include "../jrd/intl.h"
 #include "../jrd/Collation.h"
+#include "../jrd/ColumnStatistics.h"
 #include "../common/gdsassert.h"
 #include "../jrd/btr_proto.h"
 #include "../jrd/cch_proto.h"
@@ -309,6 +311,7 @@ namespace
 
 static bool augment_stack(ValueExprNode*, ValueExprNodeStack&);
 static bool augment_stack(BoolExprNode*, BoolExprNodeStack&);
+static bool check_hash_grouping(thread_db*, OptimizerBlk*, const SortNode*);
 static void check_indices(const CompilerScratch::csb_repeat*);
 static void check_sorts(CompilerScratch*, RseNode*);
 static void class_mask(USHORT, ValueExprNode**, ULONG*);
@@ -326,6 +329,8 @@ static void gen_join(thread_db* tdbb, OptimizerBlk* opt, const StreamList& strea
 	RiverList& river_list, SortNode** sort_clause, PlanNode* plan_clause);
 static RecordSource* gen_outer(thread_db* tdbb, OptimizerBlk* opt, RseNode* rse,
 	RiverList& river_list, SortNode** sort_clause);
+static RecordSource* gen_hash_outer(thread_db* tdbb, OptimizerBlk* opt, RecordSource* outer_rsb,
+	BoolExprNode* outer_boolean, StreamType inner_stream, RecordSource* inner_rsb, JoinType join_type);
 static RecordSource* gen_residual_boolean(thread_db* tdbb, OptimizerBlk* opt, RecordSource* prior_rsb);
 static RecordSource* gen_retrieval(thread_db* tdbb, OptimizerBlk* opt, StreamType stream,
 	SortNode** sort_ptr, bool outer_flag, bool inner_flag, BoolExprNode** return_boolean);
@@ -391,6 +396,14 @@ inline bool TEST_DEP_ARRAYS(const ULONG* ar1, const ULONG* ar2)
 
 const int CACHE_PAGES_PER_STREAM			= 15;
 
+// hash aggregation costs, relative to a single sort key comparison
+
+const double HASH_GROUPING_RECORD_COST		= 4.0;	// key build, hash lookup, aggregates state copy
+const double HASH_GROUPING_SPILL_COST		= 16.0;	// per record and partitioning level
+const double HASH_GROUPING_ENTRY_SIZE		= 128;	// approximate memory used per group
+const double HASH_GROUPING_PARTITIONS		= 16;
+const double HASH_GROUPING_MIN_CARDINALITY	= 1000;
+
 // enumeration of sort datatypes
 
 static const UCHAR sort_dtypes[] =
@@ -805,6 +818,17 @@ RecordSource* OPT_compile(thread_db* tdbb, CompilerScratch* csb, RseNode* rse,
 		sort = NULL;
 	}
 
+	// if the caller allows grouping by hashing, decide whether it's cheaper
+	// than the sort; let the caller know if the sort is kept
+
+	if (rse->flags & RseNode::FLAG_OPT_HASH_GROUPING)
+	{
+		if (sort && !project && check_hash_grouping(tdbb, opt, sort))
+			sort = NULL;
+		else
+			rse->flags &= ~RseNode::FLAG_OPT_HASH_GROUPING;
+	}
+
 	// check index usage in all the base streams to ensure
 	// that any user-specified access plan is followed
 
@@ -971,6 +995,85 @@ static bool augment_stack(BoolExprNode* node, BoolExprNodeStack& stack)
 }
 
 
+static bool check_hash_grouping(thread_db* tdbb, OptimizerBlk* opt, const SortNode* group)
+{
+/**************************************
+ *
+ *	c h e c k _ h a s h _ g r o u p i n g
+ *
+ **************************************
+ *
+ * Functional description
+ *	Decide whether grouping the records by hashing is cheaper
+ *	than sorting them. The number of groups is estimated using
+ *	the index statistics of the grouping fields. Hashing avoids
+ *	the N*log(N) comparisons of the sort, but gets expensive when
+ *	the groups don't fit in memory and have to be spilled.
+ *
+ **************************************/
+	DEV_BLKCHK(opt, type_opt);
+	SET_TDBB(tdbb);
+
+	CompilerScratch* const csb = opt->opt_csb;
+
+	double cardinality = MINIMUM_CARDINALITY;
+
+	for (StreamType i = 0; i < opt->compileStreams.getCount(); i++)
+	{
+		const CompilerScratch::csb_repeat* const tail = &csb->csb_rpt[opt->compileStreams[i]];
+		cardinality = MAX(cardinality, tail->csb_cardinality);
+	}
+
+	if (cardinality < HASH_GROUPING_MIN_CARDINALITY)
+		return false;
+
+	double groups = MINIMUM_CARDINALITY;
+
+	for (const NestConst<ValueExprNode>* ptr = group->expressions.begin();
+		 ptr != group->expressions.end(); ++ptr)
+	{
+		// without statistics assume that every record makes its own group
+		double distinct = cardinality;
+
+		const FieldNode* const field = nodeAs<FieldNode>(*ptr);
+
+		if (field)
+		{
+			const CompilerScratch::csb_repeat* const tail = &csb->csb_rpt[field->fieldStream];
+			const index_desc* idx = tail->csb_idx ? tail->csb_idx->items : NULL;
+
+			for (USHORT i = 0; idx && i < tail->csb_indices; ++i, ++idx)
+			{
+				const double selectivity = idx->idx_rpt[0].idx_selectivity;
+
+				if (idx->idx_rpt[0].idx_field == field->fieldId && selectivity > 0)
+					distinct = MIN(distinct, 1 / selectivity);
+			}
+		}
+
+		groups *= distinct;
+	}
+
+	groups = MIN(groups, cardinality);
+
+	const double sortCost = cardinality * log(cardinality) / log(2.0);
+	double hashCost = cardinality * HASH_GROUPING_RECORD_COST;
+
+	// groups that don't fit in memory are written to and read back from
+	// temporary space, once per every level of partitioning
+	const double capacity = MAX(tdbb->getDatabase()->dbb_config->getHashAggregateMemory() /
+		HASH_GROUPING_ENTRY_SIZE, MINIMUM_CARDINALITY);
+
+	if (groups > capacity)
+	{
+		const double levels = ceil(log(groups / capacity) / log(HASH_GROUPING_PARTITIONS));
+		hashCost += cardinality * HASH_GROUPING_SPILL_COST * levels;
+	}
+
+	return (hashCost < sortCost);
+}
+
+
 static void check_indices(const CompilerScratch::csb_repeat* csb_tail)
 {
 /**************************************
@@ -1088,6 +1191,7 @@ static void check_sorts(CompilerScratch* csb, RseNode* rse)
 			{
 				set_direction(project, group);
 				project = rse->rse_projection = NULL;
+				static_cast<AggregateSourceNode*>(sub_rse)->orderedGroups = true;
 			}
 		}
 
@@ -1124,6 +1228,7 @@ static void check_sorts(CompilerScratch* csb, RseNode* rse)
 				set_direction(sort, group);
 				set_position(sort, group, static_cast<AggregateSourceNode*>(sub_rse)->map);
 				sort = rse->rse_sorted = NULL;
+				static_cast<AggregateSourceNode*>(sub_rse)->orderedGroups = true;
 			}
 		}
 
@@ -2101,7 +2206,9 @@ static RecordSource* gen_outer(thread_db* tdbb, OptimizerBlk* opt, RseNode* rse,
 												true, false, &boolean);
 		}
 
-		if (!stream_i.stream_rsb)
+		const bool hasInnerRsb = (stream_i.stream_rsb != NULL);
+
+		if (!hasInnerRsb)
 		{
 			// AB: the sort clause for the inner stream of an OUTER JOIN
 			//	   should never be used for the index retrieval
@@ -2109,6 +2216,18 @@ static RecordSource* gen_outer(thread_db* tdbb, OptimizerBlk* opt, RseNode* rse,
 				gen_retrieval(tdbb, opt, stream_i.stream_num, NULL, false, true, NULL);
 		}
 
+		// If the inner stream is a base relation retrieved independently of
+		// the outer stream, hash it once rather than rescan it for every
+		// outer record
+		if (!hasInnerRsb)
+		{
+			RecordSource* const rsb = gen_hash_outer(tdbb, opt, stream_o.stream_rsb, boolean,
+				stream_i.stream_num, stream_i.stream_rsb, OUTER_JOIN);
+
+			if (rsb)
+				return rsb;
+		}
+
 		// generate a parent boolean rsb for any remaining booleans that
 		// were not satisfied via an index lookup
 		stream_i.stream_rsb = gen_residual_boolean(tdbb, opt, stream_i.stream_rsb);
@@ -2136,10 +2255,17 @@ static RecordSource* gen_outer(thread_db* tdbb, OptimizerBlk* opt, RseNode* rse,
 			gen_retrieval(tdbb, opt, stream_i.stream_num, NULL, false, true, NULL);
 	}
 
-	RecordSource* const innerRsb = gen_residual_boolean(tdbb, opt, stream_i.stream_rsb);
+	RecordSource* rsb1 = hasInnerRsb ? NULL :
+		gen_hash_outer(tdbb, opt, stream_o.stream_rsb, boolean,
+					   stream_i.stream_num, stream_i.stream_rsb, OUTER_JOIN);
+
+	if (!rsb1)
+	{
+		RecordSource* const innerRsb = gen_residual_boolean(tdbb, opt, stream_i.stream_rsb);
 
-	RecordSource* const rsb1 = FB_NEW_POOL(*tdbb->getDefaultPool())
-		NestedLoopJoin(csb, stream_o.stream_rsb, innerRsb, boolean, OUTER_JOIN);
+		rsb1 = FB_NEW_POOL(*tdbb->getDefaultPool())
+			NestedLoopJoin(csb, stream_o.stream_rsb, innerRsb, boolean, OUTER_JOIN);
+	}
 
 	for (FB_SIZE_T i = 0; i < opt->opt_conjuncts.getCount(); i++)
 	{
@@ -2171,15 +2297,166 @@ static RecordSource* gen_outer(thread_db* tdbb, OptimizerBlk* opt, RseNode* rse,
 			gen_retrieval(tdbb, opt, stream_o.stream_num, NULL, false, false, NULL);
 	}
 
-	RecordSource* const outerRsb = gen_residual_boolean(tdbb, opt, stream_o.stream_rsb);
+	RecordSource* rsb2 = hasOuterRsb ? NULL :
+		gen_hash_outer(tdbb, opt, stream_i.stream_rsb, boolean,
+					   stream_o.stream_num, stream_o.stream_rsb, ANTI_JOIN);
 
-	RecordSource* const rsb2 = FB_NEW_POOL(*tdbb->getDefaultPool())
-		NestedLoopJoin(csb, stream_i.stream_rsb, outerRsb, boolean, ANTI_JOIN);
+	if (!rsb2)
+	{
+		RecordSource* const outerRsb = gen_residual_boolean(tdbb, opt, stream_o.stream_rsb);
+
+		rsb2 = FB_NEW_POOL(*tdbb->getDefaultPool())
+			NestedLoopJoin(csb, stream_i.stream_rsb, outerRsb, boolean, ANTI_JOIN);
+	}
 
 	return FB_NEW_POOL(*tdbb->getDefaultPool()) FullOuterJoin(csb, rsb1, rsb2);
 }
 
 
+static RecordSource* gen_hash_outer(thread_db* tdbb, OptimizerBlk* opt, RecordSource* outer_rsb,
+	BoolExprNode* outer_boolean, StreamType inner_stream, RecordSource* inner_rsb, JoinType join_type)
+{
+/**************************************
+ *
+ *	g e n _ h a s h _ o u t e r
+ *
+ **************************************
+ *
+ * Functional description
+ *	Try to build an outer or anti hash join between an already
+ *	generated outer stream and an inner base stream. Equalities
+ *	between the two sides not consumed by an index retrieval
+ *	become the hash keys, while all remaining conjuncts (keys
+ *	included, to reject hash collisions) form the join condition.
+ *	Return NULL if there is no suitable equality or if the inner
+ *	retrieval depends on the outer stream, as the inner stream is
+ *	read only once, before any outer record is fetched.
+ *
+ **************************************/
+	DEV_BLKCHK(opt, type_opt);
+	SET_TDBB(tdbb);
+
+	CompilerScratch* const csb = opt->opt_csb;
+	MemoryPool& pool = *tdbb->getDefaultPool();
+
+	for (const OptimizerBlk::opt_conjunct* tail = opt->opt_conjuncts.begin();
+		 tail < opt->opt_conjuncts.end(); tail++)
+	{
+		BoolExprNode* const node = tail->opt_conjunct_node;
+
+		if ((tail->opt_conjunct_flags & opt_conjunct_used) &&
+			node->findStream(csb, inner_stream) && !node->computable(csb, inner_stream, true))
+		{
+			return NULL;
+		}
+	}
+
+	NestValueArray* const outerKeys = FB_NEW_POOL(pool) NestValueArray(pool);
+	NestValueArray* const innerKeys = FB_NEW_POOL(pool) NestValueArray(pool);
+
+	OptimizerBlk::opt_conjunct* const begin = opt->opt_conjuncts.begin();
+	const OptimizerBlk::opt_conjunct* const end = begin + opt->opt_base_conjuncts;
+
+	for (OptimizerBlk::opt_conjunct* tail = begin; tail < end; tail++)
+	{
+		if (tail->opt_conjunct_flags & opt_conjunct_used)
+			continue;
+
+		BoolExprNode* const node = tail->opt_conjunct_node;
+		ComparativeBoolNode* const cmpNode = nodeAs<ComparativeBoolNode>(node);
+
+		if (!cmpNode || (cmpNode->blrOp != blr_eql && cmpNode->blrOp != blr_equiv) ||
+			(node->nodFlags & ExprNode::FLAG_RESIDUAL))
+		{
+			continue;
+		}
+
+		ValueExprNode* node1 = cmpNode->arg1;
+		ValueExprNode* node2 = cmpNode->arg2;
+
+		// node1 must be computable from the inner stream alone,
+		// node2 must not depend on the inner stream at all
+
+		if (!node1->computable(csb, inner_stream, true))
+		{
+			ValueExprNode* const temp = node1;
+			node1 = node2;
+			node2 = temp;
+		}
+
+		if (!node1->computable(csb, inner_stream, true) || !node1->findStream(csb, inner_stream) ||
+			node2->findStream(csb, inner_stream) || !node2->computable(csb, INVALID_STREAM, false))
+		{
+			continue;
+		}
+
+		dsc result, desc1, desc2;
+		node1->getDesc(tdbb, csb, &desc1);
+		node2->getDesc(tdbb, csb, &desc2);
+
+		// Ensure that arguments can be compared in the binary form
+		if (!CVT2_get_binary_comparable_desc(&result, &desc1, &desc2))
+			continue;
+
+		// Cast the arguments, if required
+		if (!DSC_EQUIV(&result, &desc1, true))
+		{
+			CastNode* cast = FB_NEW_POOL(pool) CastNode(pool);
+			cast->source = node1;
+			cast->castDesc = result;
+			cast->impureOffset = CMP_impure(csb, sizeof(impure_value));
+			node1 = cast;
+		}
+
+		if (!DSC_EQUIV(&result, &desc2, true))
+		{
+			CastNode* cast = FB_NEW_POOL(pool) CastNode(pool);
+			cast->source = node2;
+			cast->castDesc = result;
+			cast->impureOffset = CMP_impure(csb, sizeof(impure_value));
+			node2 = cast;
+		}
+
+		innerKeys->add(node1);
+		outerKeys->add(node2);
+	}
+
+	if (innerKeys->isEmpty())
+	{
+		delete outerKeys;
+		delete innerKeys;
+		return NULL;
+	}
+
+	// Conjuncts local to the inner stream filter it before it gets hashed,
+	// everything else not yet consumed becomes the join condition
+
+	BoolExprNode* inner_boolean = NULL;
+	BoolExprNode* boolean = NULL;
+
+	for (OptimizerBlk::opt_conjunct* tail = begin; tail < end; tail++)
+	{
+		if (tail->opt_conjunct_flags & opt_conjunct_used)
+			continue;
+
+		BoolExprNode* const node = tail->opt_conjunct_node;
+
+		if (node->computable(csb, inner_stream, true))
+			compose(pool, &inner_boolean, node);
+		else
+			compose(pool, &boolean, node);
+
+		tail->opt_conjunct_flags |= opt_conjunct_used;
+	}
+
+	if (inner_boolean)
+		inner_rsb = FB_NEW_POOL(pool) FilteredStream(csb, inner_rsb, inner_boolean);
+
+	return FB_NEW_POOL(pool) HashJoin(tdbb, csb, join_type, outer_rsb, inner_rsb,
+		outerKeys, innerKeys, outer_boolean, boolean);
+}
+
+
 static RecordSource* gen_residual_boolean(thread_db* tdbb, OptimizerBlk* opt, RecordSource* prior_rsb)
 {
 /**************************************
@@ -3073,7 +3350,19 @@ static double get_cardinality(thread_db* tdbb, jrd_rel* relation, const Format*
 	}
 
 	MET_post_existence(tdbb, relation);
-	const double cardinality = DPM_cardinality(tdbb, relation, format);
+
+	double cardinality;
+	const RelationStatistics* const statistics = MET_get_statistics(tdbb, relation);
+
+	if (statistics && statistics->dataPages)
+	{
+		// Scale the sampled record count to the current table size
+		const ULONG dataPages = DPM_data_pages(tdbb, relation);
+		cardinality = (double) statistics->recordCount * dataPages / statistics->dataPages;
+	}
+	else
+		cardinality = DPM_cardinality(tdbb, relation, format);
+
 	MET_release_existence(tdbb, relation);
 
 	return cardinality;
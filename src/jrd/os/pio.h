@@ -34,10 +34,18 @@
 #include "../common/classes/array.h"
 #include "../common/classes/File.h"
 
+namespace Ods {
+	struct pag;
+}
+
 namespace Jrd {
 
+class BufferDesc;
+
 #ifdef UNIX
 
+class IoRing;
+
 class jrd_file : public pool_alloc_rpt<SCHAR, type_fil>
 {
 public:
@@ -48,6 +56,7 @@ public:
 	USHORT fil_fudge;			// Fudge factor for page relocation
 	int fil_desc;
 	Firebird::Mutex fil_mutex;
+	IoRing* fil_ring;			// Asynchronous I/O ring, if used
 	USHORT fil_flags;
 	SCHAR fil_string[1];		// Expanded file name
 };
@@ -90,6 +99,90 @@ const USHORT FIL_sh_write			= 8;	// file opened in shared write mode
 const USHORT FIL_no_fast_extend		= 16;	// file not supports fast extending
 const USHORT FIL_raw_device			= 32;	// file is raw device
 
+// Set of page writes passed to the operating system at once, see PIO_write_batch().
+// Page images are copied into the batch, thus the buffers may be released or
+// encrypted in place right after the page is added. Images are stored one after
+// another in the order of adding, so a run of adjacent pages is written by one request.
+
+class IoBatch
+{
+public:
+	struct Item
+	{
+		BufferDesc* bdb;		// buffer being written
+		UCHAR* buffer;			// copy of page image
+		bool done;				// write completed successfully
+	};
+
+	IoBatch(MemoryPool& pool, jrd_file* file, ULONG pageSize, ULONG ioBlockSize, FB_SIZE_T capacity)
+		: bat_file(file), bat_page_size(pageSize), bat_capacity(capacity),
+		  bat_items(pool), bat_memory(pool)
+	{
+		UCHAR* const memory = bat_memory.getBuffer(capacity * pageSize + ioBlockSize);
+		bat_buffers = FB_ALIGN(memory, ioBlockSize);
+	}
+
+	void add(BufferDesc* bdb, const Ods::pag* page)
+	{
+		fb_assert(!isFull());
+
+		Item item;
+		item.bdb = bdb;
+		item.buffer = bat_buffers + bat_items.getCount() * bat_page_size;
+		item.done = false;
+		memcpy(item.buffer, page, bat_page_size);
+
+		bat_items.add(item);
+	}
+
+	void clear()
+	{
+		bat_items.clear();
+	}
+
+	bool isEmpty() const
+	{
+		return bat_items.isEmpty();
+	}
+
+	bool isFull() const
+	{
+		return bat_items.getCount() >= bat_capacity;
+	}
+
+	FB_SIZE_T getCount() const
+	{
+		return bat_items.getCount();
+	}
+
+	Item& operator[](FB_SIZE_T index)
+	{
+		return bat_items[index];
+	}
+
+	jrd_file* getFile() const
+	{
+		return bat_file;
+	}
+
+	ULONG getPageSize() const
+	{
+		return bat_page_size;
+	}
+
+private:
+	jrd_file* const bat_file;
+	const ULONG bat_page_size;
+	const FB_SIZE_T bat_capacity;
+	Firebird::HalfStaticArray<Item, 64> bat_items;
+	Firebird::Array<UCHAR> bat_memory;
+	UCHAR* bat_buffers;
+};
+
+// Maximum number of writes passed to the OS at once
+
+const FB_SIZE_T IO_BATCH_PAGES = 64;
+
 // Physical IO trace events
 
 const SSHORT trace_create	= 1;
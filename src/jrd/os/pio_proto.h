@@ -30,6 +30,7 @@ namespace Jrd {
 	class jrd_file;
 	class Database;
 	class BufferDesc;
+	class IoBatch;
 }
 
 namespace Ods {
@@ -67,6 +68,8 @@ inline bool PIO_on_raw_device(const Firebird::PathName&)
 }
 #endif
 bool	PIO_write(Jrd::thread_db*, Jrd::jrd_file*, Jrd::BufferDesc*, Ods::pag*, Jrd::FbStatusVector*);
+bool	PIO_write_batch_supported(const Jrd::jrd_file*);
+void	PIO_write_batch(Jrd::thread_db*, Jrd::IoBatch&);
 
 #endif // JRD_PIO_PROTO_H
 
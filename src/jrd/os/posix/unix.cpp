@@ -48,6 +48,15 @@
 #ifdef HAVE_LINUX_FALLOC_H
 #include <linux/falloc.h>
 #endif
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define HAVE_IO_URING
+#endif
+#endif
 
 #ifdef SUPPORT_RAW_DEVICES
 #include <sys/ioctl.h>
@@ -128,6 +137,7 @@ static jrd_file* setup_file(Database*, const PathName&, const int, const bool, c
 static void lockDatabaseFile(int& desc, const bool shareMode, const bool temporary,
 							 const char* fileName, ISC_STATUS operation);
 static bool unix_error(const TEXT*, const jrd_file*, ISC_STATUS, FbStatusVector* = NULL);
+static bool write_file(const jrd_file*, const void*, SINT64, FB_UINT64);
 #if !(defined HAVE_PREAD && defined HAVE_PWRITE)
 static SLONG pread(int, SCHAR*, SLONG, SLONG);
 static SLONG pwrite(int, SCHAR*, SLONG, SLONG);
@@ -139,6 +149,279 @@ static int  raw_devices_unlink_database (const PathName&);
 static int	openFile(const Firebird::PathName&, const bool, const bool, const bool);
 static void	maybeCloseFile(int&);
 
+
+namespace Jrd {
+
+#ifdef HAVE_IO_URING
+
+// Minimal wrapper around Linux io_uring interface, used to keep a number
+// of page writes in flight. Direct system calls are used, thus no liburing
+// dependency is required. Ring is shared by all threads working with the
+// database file, ring_mutex should be locked while submitting and reaping.
+
+class IoRing
+{
+public:
+	IoRing()
+		: ring_fd(-1), ring_entries(0), ring_in_flight(0), ring_to_submit(0), ring_broken(false),
+		  sq_ptr(NULL), cq_ptr(NULL), sq_size(0), cq_size(0), sqes(NULL), sqes_size(0)
+	{ }
+
+	~IoRing()
+	{
+		if (sqes)
+			munmap(sqes, sqes_size);
+
+		if (cq_ptr && cq_ptr != sq_ptr)
+			munmap(cq_ptr, cq_size);
+
+		if (sq_ptr)
+			munmap(sq_ptr, sq_size);
+
+		if (ring_fd >= 0)
+			close(ring_fd);
+	}
+
+	static IoRing* create(MemoryPool& pool, const char* fileName)
+	{
+		IoRing* ring = FB_NEW_POOL(pool) IoRing;
+
+		if (!ring->init(RING_DEPTH))
+		{
+			gds__log("Database: %s\n\tio_uring is not available (errno %d), synchronous I/O is used",
+				fileName, errno);
+
+			delete ring;
+			return NULL;
+		}
+
+		return ring;
+	}
+
+	// Queue write of a buffer, return false if the ring is full. User data
+	// should be unique among requests in flight and less than RING_DEPTH.
+	bool queueWrite(int fd, const void* buffer, unsigned length, FB_UINT64 offset, FB_UINT64 userData)
+	{
+		fb_assert(userData < RING_DEPTH);
+
+		if (ring_in_flight >= ring_entries || userData >= RING_DEPTH)
+			return false;
+
+		const unsigned tail = *sq_tail;
+		const unsigned index = tail & sq_mask;
+
+		// iovec must stay valid until request is completed,
+		// thus it's indexed by user data and never moves
+
+		struct iovec* const iov = &ring_iovecs[userData];
+		iov->iov_base = const_cast<void*>(buffer);
+		iov->iov_len = length;
+
+		io_uring_sqe* const sqe = &sqes[index];
+		memset(sqe, 0, sizeof(io_uring_sqe));
+		sqe->opcode = IORING_OP_WRITEV;
+		sqe->fd = fd;
+		sqe->addr = (FB_UINT64) (IPTR) iov;
+		sqe->len = 1;
+		sqe->off = offset;
+		sqe->user_data = userData;
+
+		sq_array[index] = index;
+		__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+		ring_to_submit++;
+		ring_in_flight++;
+		return true;
+	}
+
+	// Submit queued requests and wait for at least one completion.
+	// Interrupted and temporarily failed calls are retried a few times,
+	// on failure errno describes the last error.
+	bool wait()
+	{
+		for (int i = 0; i < IO_RETRY; i++)
+		{
+			const int rc = (int) syscall(__NR_io_uring_enter, ring_fd, ring_to_submit, 1,
+				IORING_ENTER_GETEVENTS, NULL, 0);
+
+			if (rc >= 0)
+			{
+				ring_to_submit -= MIN((unsigned) rc, ring_to_submit);
+				return true;
+			}
+
+			if (SYSCALL_INTERRUPTED(errno))
+				continue;
+
+			if (errno != EAGAIN && errno != EBUSY)
+				break;
+
+			const int savedErrno = errno;
+			Thread::yield();
+			errno = savedErrno;
+		}
+
+		return false;
+	}
+
+	// Stop using the ring after an error. Requests not taken by the kernel
+	// yet are removed from the submission queue, completion of the taken ones
+	// is awaited as they refer the caller's buffers. Their results are lost,
+	// thus the caller should consider all its requests as failed.
+	void abandon()
+	{
+		const unsigned tail = *sq_tail;
+		const unsigned pending = tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+
+		__atomic_store_n(sq_tail, tail - pending, __ATOMIC_RELEASE);
+		ring_in_flight -= MIN(pending, ring_in_flight);
+		ring_to_submit = 0;
+
+		FB_UINT64 userData;
+		int result;
+
+		while (ring_in_flight)
+		{
+			if (!reap(userData, result))
+				Thread::sleep(1);
+		}
+
+		ring_broken = true;
+	}
+
+	bool isBroken() const
+	{
+		return ring_broken;
+	}
+
+	// Get next completed request, if any
+	bool reap(FB_UINT64& userData, int& result)
+	{
+		const unsigned head = *cq_head;
+
+		if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+			return false;
+
+		const io_uring_cqe* const cqe = &cqes[head & cq_mask];
+		userData = cqe->user_data;
+		result = cqe->res;
+
+		__atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+
+		fb_assert(ring_in_flight > 0);
+		ring_in_flight--;
+		return true;
+	}
+
+	unsigned inFlight() const
+	{
+		return ring_in_flight;
+	}
+
+	Mutex ring_mutex;
+
+private:
+	bool init(unsigned entries)
+	{
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+
+		ring_fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+		if (ring_fd < 0)
+			return false;
+
+		ring_entries = MIN(params.sq_entries, RING_DEPTH);
+
+		sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		bool singleMap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			singleMap = true;
+			sq_size = cq_size = MAX(sq_size, cq_size);
+		}
+#endif
+
+		void* ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			ring_fd, IORING_OFF_SQ_RING);
+		if (ptr == MAP_FAILED)
+			return false;
+		sq_ptr = ptr;
+
+		if (singleMap)
+			cq_ptr = sq_ptr;
+		else
+		{
+			ptr = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				ring_fd, IORING_OFF_CQ_RING);
+			if (ptr == MAP_FAILED)
+				return false;
+			cq_ptr = ptr;
+		}
+
+		sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		ptr = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			ring_fd, IORING_OFF_SQES);
+		if (ptr == MAP_FAILED)
+			return false;
+		sqes = (io_uring_sqe*) ptr;
+
+		UCHAR* const sq = (UCHAR*) sq_ptr;
+		sq_head = (unsigned*) (sq + params.sq_off.head);
+		sq_tail = (unsigned*) (sq + params.sq_off.tail);
+		sq_mask = *(unsigned*) (sq + params.sq_off.ring_mask);
+		sq_array = (unsigned*) (sq + params.sq_off.array);
+
+		UCHAR* const cq = (UCHAR*) cq_ptr;
+		cq_head = (unsigned*) (cq + params.cq_off.head);
+		cq_tail = (unsigned*) (cq + params.cq_off.tail);
+		cq_mask = *(unsigned*) (cq + params.cq_off.ring_mask);
+		cqes = (io_uring_cqe*) (cq + params.cq_off.cqes);
+
+		return true;
+	}
+
+	// Batch has no more pages than that, thus no more runs to write
+	static const unsigned RING_DEPTH = IO_BATCH_PAGES;
+
+	struct iovec ring_iovecs[RING_DEPTH];
+
+	int ring_fd;
+	unsigned ring_entries;
+	unsigned ring_in_flight;
+	unsigned ring_to_submit;
+	bool ring_broken;
+
+	void* sq_ptr;
+	void* cq_ptr;
+	size_t sq_size;
+	size_t cq_size;
+	io_uring_sqe* sqes;
+	size_t sqes_size;
+
+	unsigned* sq_head;
+	unsigned* sq_tail;
+	unsigned sq_mask;
+	unsigned* sq_array;
+	unsigned* cq_head;
+	unsigned* cq_tail;
+	unsigned cq_mask;
+	io_uring_cqe* cqes;
+};
+
+#else // HAVE_IO_URING
+
+class IoRing
+{
+};
+
+#endif // HAVE_IO_URING
+
+} // namespace Jrd
+
+
 int PIO_add_file(thread_db* tdbb, jrd_file* main_file, const PathName& file_name, SLONG start)
 {
 /**************************************
@@ -196,6 +479,9 @@ void PIO_close(jrd_file* main_file)
 			close(file->fil_desc);
 			file->fil_desc = -1;
 		}
+
+		delete file->fil_ring;
+		file->fil_ring = NULL;
 	}
 }
 
@@ -760,6 +1046,7 @@ bool PIO_read(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
 
 	Database* const dbb = tdbb->getDatabase();
 
+	thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::READ_WAITS);
 	EngineCheckout cout(tdbb, FB_FUNCTION, true);
 
 	const FB_UINT64 size = dbb->dbb_page_size;
@@ -810,8 +1097,6 @@ bool PIO_write(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
  *	Write a data page.  Oh wow.
  *
  **************************************/
-	int i;
-	SINT64 bytes;
 	FB_UINT64 offset;
 
 	if (file->fil_desc == -1)
@@ -819,19 +1104,15 @@ bool PIO_write(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
 
 	Database* const dbb = tdbb->getDatabase();
 
+	thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::WRITE_WAITS);
 	EngineCheckout cout(tdbb, FB_FUNCTION, true);
 
 	const SLONG size = dbb->dbb_page_size;
 
-	for (i = 0; i < IO_RETRY; i++)
-	{
-		if (!(file = seek_file(file, bdb, &offset, status_vector)))
-			return false;
-		if ((bytes = os_utils::pwrite(file->fil_desc, page, size, LSEEK_OFFSET_CAST offset)) == size)
-			break;
-		if (bytes < 0 && !SYSCALL_INTERRUPTED(errno))
-			return unix_error("write", file, isc_io_write_err, status_vector);
-	}
+	if (!(file = seek_file(file, bdb, &offset, status_vector)))
+		return false;
+	if (!write_file(file, page, size, offset))
+		return unix_error("write", file, isc_io_write_err, status_vector);
 
 
 	// os_utils::posix_fadvise(file->desc, offset, size, POSIX_FADV_DONTNEED);
@@ -839,6 +1120,173 @@ bool PIO_write(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
 }
 
 
+bool PIO_write_batch_supported(const jrd_file* file)
+{
+/**************************************
+ *
+ *	P I O _ w r i t e _ b a t c h _ s u p p o r t e d
+ *
+ **************************************
+ *
+ * Functional description
+ *	Check if it makes sense to collect page
+ *	writes into batches for the given file.
+ *
+ **************************************/
+
+	// Adjacent pages are coalesced with either I/O backend
+
+	return file->fil_desc != -1;
+}
+
+
+void PIO_write_batch(thread_db* tdbb, IoBatch& batch)
+{
+/**************************************
+ *
+ *	P I O _ w r i t e _ b a t c h
+ *
+ **************************************
+ *
+ * Functional description
+ *	Write a set of pages. Runs of pages adjacent both in the
+ *	file and in the batch are coalesced into single requests,
+ *	with io_uring all the requests are kept in flight at once.
+ *	Pages written successfully are marked as done, the rest
+ *	should be re-written by the caller using PIO_write which
+ *	also reports an error.
+ *
+ **************************************/
+	struct Run
+	{
+		jrd_file* file;
+		FB_UINT64 offset;
+		FB_SIZE_T first;
+		FB_SIZE_T count;
+	};
+
+	jrd_file* const main_file = batch.getFile();
+	const ULONG size = batch.getPageSize();
+
+	HalfStaticArray<Run, IO_BATCH_PAGES> runs;
+	FB_SIZE_T mergedRuns = 0, mergedPages = 0;
+
+	{	// scope
+		thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::WRITE_WAITS);
+		EngineCheckout cout(tdbb, FB_FUNCTION, true);
+		FbLocalStatus status;
+
+		Run* current = NULL;
+
+		for (FB_SIZE_T i = 0; i < batch.getCount(); i++)
+		{
+			FB_UINT64 offset;
+			jrd_file* const file = seek_file(main_file, batch[i].bdb, &offset, &status);
+
+			if (!file)
+			{
+				current = NULL;
+				continue;
+			}
+
+			if (current && current->file == file && current->offset + current->count * size == offset)
+				current->count++;
+			else
+			{
+				current = &runs.add();
+				current->file = file;
+				current->offset = offset;
+				current->first = i;
+				current->count = 1;
+			}
+		}
+
+#ifdef HAVE_IO_URING
+		IoRing* const ring = main_file->fil_ring;
+
+		if (ring && !ring->isBroken())
+		{
+			MutexLockGuard guard(ring->ring_mutex, FB_FUNCTION);
+
+			FB_SIZE_T next = 0;
+			while (!ring->isBroken() && (next < runs.getCount() || ring->inFlight()))
+			{
+				for (; next < runs.getCount(); next++)
+				{
+					const Run& run = runs[next];
+
+					if (!ring->queueWrite(run.file->fil_desc, batch[run.first].buffer,
+							run.count * size, run.offset, next))
+					{
+						break;
+					}
+				}
+
+				if (!ring->inFlight())
+					break;
+
+				if (!ring->wait())
+				{
+					// Pages not marked as done are re-written by the caller,
+					// further batches of the file use synchronous I/O
+
+					unix_error("io_uring_enter", main_file, isc_io_write_err, &status);
+					ring->abandon();
+					break;
+				}
+
+				FB_UINT64 index;
+				int result;
+
+				while (ring->reap(index, result))
+				{
+					fb_assert(index < runs.getCount());
+					const Run& run = runs[index];
+
+					if (result == (int) (run.count * size))
+					{
+						for (FB_SIZE_T i = 0; i < run.count; i++)
+							batch[run.first + i].done = true;
+					}
+				}
+			}
+		}
+		else
+#endif
+		{
+			for (FB_SIZE_T n = 0; n < runs.getCount(); n++)
+			{
+				const Run& run = runs[n];
+
+				// Page images of a run are contiguous in the batch,
+				// so the whole run is written by a single call
+
+				if (write_file(run.file, batch[run.first].buffer, run.count * size, run.offset))
+				{
+					for (FB_SIZE_T j = 0; j < run.count; j++)
+						batch[run.first + j].done = true;
+				}
+			}
+		}
+
+		for (FB_SIZE_T n = 0; n < runs.getCount(); n++)
+		{
+			if (runs[n].count > 1)
+			{
+				mergedRuns++;
+				mergedPages += runs[n].count;
+			}
+		}
+	}
+
+	if (mergedRuns)
+	{
+		tdbb->bumpStats(RuntimeStatistics::PAGE_WRITE_RUNS, mergedRuns);
+		tdbb->bumpStats(RuntimeStatistics::PAGE_RUN_WRITES, mergedPages);
+	}
+}
+
+
 static jrd_file* seek_file(jrd_file* file, BufferDesc* bdb, FB_UINT64* offset,
 	FbStatusVector* status_vector)
 {
@@ -889,6 +1337,43 @@ static jrd_file* seek_file(jrd_file* file, BufferDesc* bdb, FB_UINT64* offset,
 }
 
 
+static bool write_file(const jrd_file* file, const void* buffer, SINT64 length, FB_UINT64 offset)
+{
+/**************************************
+ *
+ *	w r i t e _ f i l e
+ *
+ **************************************
+ *
+ * Functional description
+ *	Write a block at the given offset of the file,
+ *	retrying interrupted and partial writes.
+ *	Return false with errno set on failure.
+ *
+ **************************************/
+
+	if (file->fil_desc == -1)
+	{
+		errno = EBADF;
+		return false;
+	}
+
+	for (int i = 0; i < IO_RETRY; i++)
+	{
+		const SINT64 bytes = os_utils::pwrite(file->fil_desc, buffer, length, LSEEK_OFFSET_CAST offset);
+
+		if (bytes == length)
+			return true;
+
+		if (bytes < 0 && !SYSCALL_INTERRUPTED(errno))
+			return false;
+	}
+
+	errno = EIO;
+	return false;
+}
+
+
 static int openFile(const PathName& name, const bool forcedWrites,
 	const bool notUseFSCache, const bool readOnly)
 {
@@ -971,6 +1456,12 @@ static jrd_file* setup_file(Database* dbb,
 			file->fil_flags |= FIL_sh_write;
 		if (onRawDev)
 			file->fil_flags |= FIL_raw_device;
+
+		file->fil_ring = NULL;
+#ifdef HAVE_IO_URING
+		if (!readOnly && dbb->dbb_config->getIOBackend() == IO_BACKEND_IO_URING)
+			file->fil_ring = IoRing::create(*dbb->dbb_permanent, file->fil_string);
+#endif
 	}
 	catch (const Exception&)
 	{
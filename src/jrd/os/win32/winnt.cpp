@@ -570,6 +570,7 @@ bool PIO_read(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
 
 	const DWORD size = dbb->dbb_page_size;
 
+	thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::READ_WAITS);
 	EngineCheckout cout(tdbb, FB_FUNCTION, true);
 	FileExtendLockGuard extLock(file->fil_ext_lock, false);
 
@@ -744,6 +745,7 @@ bool PIO_write(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
 
 	const DWORD size = dbb->dbb_page_size;
 
+	thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::WRITE_WAITS);
 	EngineCheckout cout(tdbb, FB_FUNCTION, true);
 	FileExtendLockGuard extLock(file->fil_ext_lock, false);
 
@@ -765,6 +767,45 @@ bool PIO_write(thread_db* tdbb, jrd_file* file, BufferDesc* bdb, Ods::pag* page,
 }
 
 
+bool PIO_write_batch_supported(const jrd_file* /*file*/)
+{
+/**************************************
+ *
+ *	P I O _ w r i t e _ b a t c h _ s u p p o r t e d
+ *
+ **************************************
+ *
+ * Functional description
+ *	Batched writes are not implemented on Windows yet.
+ *
+ **************************************/
+
+	return false;
+}
+
+
+void PIO_write_batch(thread_db* tdbb, IoBatch& batch)
+{
+/**************************************
+ *
+ *	P I O _ w r i t e _ b a t c h
+ *
+ **************************************
+ *
+ * Functional description
+ *	Write a set of pages one by one.
+ *
+ **************************************/
+	FbLocalStatus status;
+
+	for (FB_SIZE_T i = 0; i < batch.getCount(); i++)
+	{
+		IoBatch::Item& item = batch[i];
+		item.done = PIO_write(tdbb, batch.getFile(), item.bdb, (Ods::pag*) item.buffer, &status);
+	}
+}
+
+
 ULONG PIO_get_number_of_pages(const jrd_file* file, const USHORT pagesize)
 {
 /**************************************
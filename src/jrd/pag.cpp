@@ -1337,13 +1337,11 @@ void PAG_init(thread_db* tdbb)
 	dbb->dbb_max_records = Ods::maxRecsPerDP(dbb->dbb_page_size);
 	dbb->dbb_max_idx = Ods::maxIndices(dbb->dbb_page_size);
 
-	// Compute prefetch constants from database page size and maximum prefetch
-	// transfer size. Double pages per prefetch request so that cache reader
-	// can overlap prefetch I/O with database computation over previously prefetched pages.
-#ifdef SUPERSERVER_V2
-	dbb->dbb_prefetch_sequence = PREFETCH_MAX_TRANSFER / dbb->dbb_page_size;
-	dbb->dbb_prefetch_pages = dbb->dbb_prefetch_sequence * 2;
-#endif
+	// Compute prefetch constants from the configured read-ahead window. Issue prefetch
+	// requests every half of window so that cache reader can overlap prefetch I/O with
+	// database computation over previously prefetched pages.
+	dbb->dbb_prefetch_pages = (USHORT) MIN(dbb->dbb_config->getReadAheadWindow(), PREFETCH_MAX_PAGES);
+	dbb->dbb_prefetch_sequence = MAX(dbb->dbb_prefetch_pages / 2, 1);
 }
 
 
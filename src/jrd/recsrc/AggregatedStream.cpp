@@ -18,12 +18,17 @@
  */
 
 #include "firebird.h"
+#include "../common/classes/Hash.h"
 #include "../jrd/jrd.h"
+#include "../jrd/intl.h"
+#include "../jrd/TempSpace.h"
 #include "../dsql/Nodes.h"
+#include "../dsql/AggNodes.h"
 #include "../dsql/ExprNodes.h"
 #include "../jrd/cmp_proto.h"
 #include "../jrd/evl_proto.h"
 #include "../jrd/exe_proto.h"
+#include "../jrd/intl_proto.h"
 #include "../jrd/mov_proto.h"
 #include "../jrd/vio_proto.h"
 #include "../jrd/Attachment.h"
@@ -400,3 +405,714 @@ bool AggregatedStream::getRecord(thread_db* tdbb) const
 	rpb->rpb_number.setValid(true);
 	return true;
 }
+
+// ----------------------------------
+// Data access: aggregation by hashing
+// ----------------------------------
+
+namespace
+{
+	const char* const SCRATCH = "fb_hashagg_";
+
+	const ULONG HASH_SIZES[] = {1009, 4099, 16411, 65537, 262147, 1048583, 4194319, 16777259};
+
+	const ULONG ENTRY_BLOCK_SIZE = 65536;
+
+	const unsigned PARTITION_BITS = 4;
+	const unsigned PARTITION_COUNT = 1 << PARTITION_BITS;
+	const unsigned MAX_SPILL_LEVEL = 32 / PARTITION_BITS - 1;
+
+	const FB_SIZE_T ENTRY_ALIGNMENT = alignof(impure_value_ex);
+
+	// Values kept entirely inside impure_value::vlu_misc, so they may be copied bytewise
+	bool isFixedValue(const dsc& desc)
+	{
+		return desc.dsc_dtype != dtype_unknown && !desc.isText() && !desc.isBlob() &&
+			!desc.isDbKey() && desc.dsc_dtype != dtype_array && desc.dsc_dtype != dtype_quad &&
+			desc.dsc_length <= sizeof(impure_value::vlu_misc);
+	}
+}
+
+class HashAggregate::HashTable : public PermanentStorage
+{
+	// Groups are fixed length entries allocated in blocks and chained into
+	// hash slots. Every entry holds the group key followed by the data the
+	// caller keeps for the group. When the table exceeds its memory budget,
+	// all entries are written into partitions chosen by the hash value and
+	// the table starts from scratch. At the end of the input every partition
+	// is loaded and aggregated separately, partitioning it further if needed.
+
+	struct Entry
+	{
+		Entry* next;
+		ULONG hash;
+	};
+
+	struct Partition
+	{
+		Partition()
+			: space(NULL), count(0), level(0)
+		{}
+
+		TempSpace* space;
+		FB_UINT64 count;
+		unsigned level;
+	};
+
+public:
+	HashTable(MemoryPool& pool, ULONG keyLength, ULONG dataLength, ULONG budget)
+		: PermanentStorage(pool),
+		  m_keyLength(keyLength),
+		  m_keyOffset(FB_ALIGN(sizeof(Entry), ENTRY_ALIGNMENT)),
+		  m_dataOffset(FB_ALIGN(m_keyOffset + keyLength, ENTRY_ALIGNMENT)),
+		  m_entryLength(FB_ALIGN(m_dataOffset + dataLength, ENTRY_ALIGNMENT)),
+		  m_blockLength(MAX(ENTRY_BLOCK_SIZE, m_entryLength)),
+		  m_budget(budget),
+		  m_slots(pool), m_blocks(pool), m_pending(pool),
+		  m_position(0), m_key(pool), m_scratch(NULL),
+		  m_blockUsed(0), m_count(0), m_sizeIndex(0),
+		  m_iterSlot(0), m_iterEntry(NULL),
+		  m_level(0), m_spilled(false)
+	{
+		m_key.getBuffer(keyLength);
+		m_slots.resize(HASH_SIZES[0]);
+		memset(m_slots.begin(), 0, m_slots.getCount() * sizeof(Entry*));
+	}
+
+	~HashTable()
+	{
+		clear();
+
+		for (unsigned i = 0; i < PARTITION_COUNT; i++)
+			delete m_spill[i].space;
+
+		for (FB_SIZE_T i = 0; i < m_pending.getCount(); i++)
+			delete m_pending[i].space;
+
+		delete m_current.space;
+		delete[] m_scratch;
+	}
+
+	UCHAR* getKeyBuffer()
+	{
+		return m_key.begin();
+	}
+
+	// Look for the group having the key of the key buffer
+	UCHAR* find(ULONG hash) const
+	{
+		for (Entry* entry = m_slots[hash % m_slots.getCount()]; entry; entry = entry->next)
+		{
+			if (entry->hash == hash && !memcmp(getKey(entry), m_key.begin(), m_keyLength))
+				return getData(entry);
+		}
+
+		return NULL;
+	}
+
+	// Add the group having the key of the key buffer, its data is not initialized
+	UCHAR* add(ULONG hash)
+	{
+		if (m_count >= m_slots.getCount() && m_sizeIndex < FB_NELEM(HASH_SIZES) - 1)
+			resize(HASH_SIZES[++m_sizeIndex]);
+
+		if (m_blocks.isEmpty() || m_blockUsed + m_entryLength > m_blockLength)
+		{
+			m_blocks.add(FB_NEW_POOL(getPool()) UCHAR[m_blockLength]);
+			m_blockUsed = 0;
+		}
+
+		Entry* const entry = (Entry*) (m_blocks.back() + m_blockUsed);
+		m_blockUsed += m_entryLength;
+
+		entry->hash = hash;
+		memcpy(getKey(entry), m_key.begin(), m_keyLength);
+
+		Entry** const slot = &m_slots[hash % m_slots.getCount()];
+		entry->next = *slot;
+		*slot = entry;
+
+		m_count++;
+
+		return getData(entry);
+	}
+
+	// Whether the next new group should be preceded by spilling the table
+	bool isFull() const
+	{
+		if (!m_count || m_level > MAX_SPILL_LEVEL)
+			return false;
+
+		const FB_UINT64 used = (FB_UINT64) m_blocks.getCount() * m_blockLength +
+			m_slots.getCount() * sizeof(Entry*);
+
+		return used + m_entryLength > m_budget;
+	}
+
+	// Move all groups into the partitions of the current level
+	void spill()
+	{
+		for (FB_SIZE_T i = 0; i < m_slots.getCount(); i++)
+		{
+			for (Entry* entry = m_slots[i]; entry; entry = entry->next)
+			{
+				Partition& partition = m_spill[getPartition(entry->hash, m_level)];
+
+				if (!partition.space)
+				{
+					partition.space = FB_NEW_POOL(getPool()) TempSpace(getPool(), SCRATCH);
+					partition.level = m_level;
+				}
+
+				partition.space->write(partition.count * m_entryLength, entry, m_entryLength);
+				partition.count++;
+			}
+		}
+
+		clear();
+		m_spilled = true;
+	}
+
+	// All input of the current phase was aggregated. Unless something was
+	// spilled, the table contains complete groups to be returned. Otherwise
+	// spill the remaining groups too and put the partitions into the queue.
+	void finishPhase()
+	{
+		if (m_spilled)
+		{
+			spill();
+
+			for (unsigned i = 0; i < PARTITION_COUNT; i++)
+			{
+				if (m_spill[i].space)
+				{
+					m_pending.add(m_spill[i]);
+					m_spill[i] = Partition();
+				}
+			}
+
+			m_spilled = false;
+		}
+
+		m_iterSlot = 0;
+		m_iterEntry = NULL;
+	}
+
+	// Return the next complete group
+	UCHAR* next()
+	{
+		while (!m_iterEntry)
+		{
+			if (m_iterSlot >= m_slots.getCount())
+				return NULL;
+
+			m_iterEntry = m_slots[m_iterSlot++];
+		}
+
+		Entry* const entry = m_iterEntry;
+		m_iterEntry = entry->next;
+
+		return getData(entry);
+	}
+
+	// Start aggregating the next spilled partition
+	bool nextPartition()
+	{
+		if (m_pending.isEmpty())
+			return false;
+
+		clear();
+
+		delete m_current.space;
+		m_current = m_pending.pop();
+		m_position = 0;
+		m_level = m_current.level + 1;
+
+		return true;
+	}
+
+	// Read the next group of the current partition, its key goes to the key buffer
+	const UCHAR* fetch(ULONG& hash)
+	{
+		if (m_position >= m_current.count)
+		{
+			delete m_current.space;
+			m_current = Partition();
+			return NULL;
+		}
+
+		if (!m_scratch)
+			m_scratch = FB_NEW_POOL(getPool()) UCHAR[m_entryLength];
+
+		m_current.space->read(m_position * m_entryLength, m_scratch, m_entryLength);
+		m_position++;
+
+		Entry* const entry = (Entry*) m_scratch;
+		hash = entry->hash;
+		memcpy(m_key.begin(), getKey(entry), m_keyLength);
+
+		return getData(entry);
+	}
+
+private:
+	UCHAR* getKey(Entry* entry) const
+	{
+		return (UCHAR*) entry + m_keyOffset;
+	}
+
+	UCHAR* getData(Entry* entry) const
+	{
+		return (UCHAR*) entry + m_dataOffset;
+	}
+
+	static unsigned getPartition(ULONG hash, unsigned level)
+	{
+		// Scramble the hash and take the next group of its bits at every level
+		const ULONG scrambled = hash * 2654435761u;
+		return (scrambled >> (32 - PARTITION_BITS * (level + 1))) & (PARTITION_COUNT - 1);
+	}
+
+	void resize(ULONG size)
+	{
+		Array<Entry*> slots(getPool());
+		slots.resize(size);
+		memset(slots.begin(), 0, size * sizeof(Entry*));
+
+		for (FB_SIZE_T i = 0; i < m_slots.getCount(); i++)
+		{
+			for (Entry* entry = m_slots[i]; entry; )
+			{
+				Entry* const next = entry->next;
+				Entry** const slot = &slots[entry->hash % size];
+				entry->next = *slot;
+				*slot = entry;
+				entry = next;
+			}
+		}
+
+		m_slots.assign(slots);
+	}
+
+	void clear()
+	{
+		for (FB_SIZE_T i = 0; i < m_blocks.getCount(); i++)
+			delete[] m_blocks[i];
+
+		m_blocks.clear();
+		m_blockUsed = 0;
+		m_count = 0;
+
+		m_sizeIndex = 0;
+		m_slots.resize(HASH_SIZES[0]);
+		memset(m_slots.begin(), 0, m_slots.getCount() * sizeof(Entry*));
+
+		m_iterSlot = 0;
+		m_iterEntry = NULL;
+	}
+
+	const ULONG m_keyLength;
+	const ULONG m_keyOffset;
+	const ULONG m_dataOffset;
+	const ULONG m_entryLength;
+	const ULONG m_blockLength;
+	const ULONG m_budget;
+
+	Array<Entry*> m_slots;
+	Array<UCHAR*> m_blocks;
+	Array<Partition> m_pending;
+	Partition m_spill[PARTITION_COUNT];
+	Partition m_current;
+	FB_UINT64 m_position;
+
+	Array<UCHAR> m_key;
+	UCHAR* m_scratch;
+
+	ULONG m_blockUsed;
+	ULONG m_count;
+	unsigned m_sizeIndex;
+
+	FB_SIZE_T m_iterSlot;
+	Entry* m_iterEntry;
+
+	unsigned m_level;
+	bool m_spilled;
+};
+
+HashAggregate::HashAggregate(thread_db* tdbb, CompilerScratch* csb, StreamType stream,
+			NestValueArray* group, MapNode* map, RecordSource* next)
+	: BaseAggWinStream(tdbb, csb, stream, group, map, false, next),
+	  m_keyDescs(csb->csb_pool),
+	  m_aggs(csb->csb_pool),
+	  m_keyLength(0)
+{
+	fb_assert(group && map);
+
+	for (NestConst<ValueExprNode>* ptr = group->begin(); ptr != group->end(); ++ptr)
+	{
+		dsc desc;
+		(*ptr)->getDesc(tdbb, csb, &desc);
+
+		if (desc.isText())
+		{
+			USHORT keyLength = desc.getStringLength();
+
+			if (IS_INTL_DATA(&desc))
+				keyLength = INTL_key_length(tdbb, INTL_INDEX_TYPE(&desc), keyLength);
+
+			desc.makeText(keyLength, ttype_none);
+		}
+
+		m_keyDescs.add(desc);
+
+		// Every key value is preceded by its NULL indicator
+		m_keyLength += 1 + desc.dsc_length;
+	}
+
+	for (NestConst<ValueExprNode>* ptr = map->sourceList.begin(); ptr != map->sourceList.end(); ++ptr)
+	{
+		const AggNode* const aggNode = nodeAs<AggNode>(*ptr);
+
+		if (aggNode)
+			m_aggs.add(aggNode);
+	}
+
+	// The group data is the aggregated record image followed by the aggregate values
+	m_statesOffset = FB_ALIGN(m_format->fmt_length, ENTRY_ALIGNMENT);
+	m_dataLength = m_statesOffset + m_aggs.getCount() * sizeof(impure_value_ex);
+}
+
+// Check whether the grouping keys and aggregate functions may be handled by HashAggregate.
+// Aggregates must keep their whole state inside a single impure value to allow saving
+// it per group and combining partial results of spilled groups.
+bool HashAggregate::isSupported(thread_db* tdbb, CompilerScratch* csb,
+	NestValueArray* group, MapNode* map)
+{
+	if (!group || group->isEmpty() || !map)
+		return false;
+
+	for (NestConst<ValueExprNode>* ptr = group->begin(); ptr != group->end(); ++ptr)
+	{
+		dsc desc;
+		(*ptr)->getDesc(tdbb, csb, &desc);
+
+		// Approximate, DECFLOAT and WITH TIME ZONE values may be equal having different
+		// binary representations
+		if (!desc.isText() &&
+			(!isFixedValue(desc) || desc.isApprox() || desc.isDecFloat() || desc.isDateTimeTz()))
+		{
+			return false;
+		}
+	}
+
+	for (NestConst<ValueExprNode>* ptr = map->sourceList.begin(); ptr != map->sourceList.end(); ++ptr)
+	{
+		AggNode* const aggNode = nodeAs<AggNode>(*ptr);
+
+		if (!aggNode)
+			continue;
+
+		const bool count = nodeIs<CountAggNode>(aggNode);
+
+		if (aggNode->distinct ||
+			!(count || nodeIs<SumAggNode>(aggNode) || nodeIs<AvgAggNode>(aggNode) ||
+			  nodeIs<MaxMinAggNode>(aggNode)))
+		{
+			return false;
+		}
+
+		if (aggNode->arg && !count)
+		{
+			dsc desc;
+			aggNode->arg->getDesc(tdbb, csb, &desc);
+
+			if (!isFixedValue(desc))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void HashAggregate::open(thread_db* tdbb) const
+{
+	BaseAggWinStream::open(tdbb);
+
+	jrd_req* const request = tdbb->getRequest();
+	Impure* const impure = getImpure(request);
+
+	delete impure->irsb_hash_table;
+
+	MemoryPool& pool = *tdbb->getDefaultPool();
+
+	impure->irsb_hash_table = FB_NEW_POOL(pool) HashTable(pool, m_keyLength, m_dataLength,
+		tdbb->getDatabase()->dbb_config->getHashAggregateMemory());
+}
+
+void HashAggregate::close(thread_db* tdbb) const
+{
+	jrd_req* const request = tdbb->getRequest();
+	Impure* const impure = getImpure(request);
+
+	if (impure->irsb_flags & irsb_open)
+	{
+		delete impure->irsb_hash_table;
+		impure->irsb_hash_table = NULL;
+	}
+
+	BaseAggWinStream::close(tdbb);
+}
+
+void HashAggregate::print(thread_db* tdbb, string& plan, bool detailed, unsigned level) const
+{
+	if (detailed)
+	{
+		string extras;
+		extras.printf(" (key length: %" ULONGFORMAT", group length: %" ULONGFORMAT")",
+					  m_keyLength, m_dataLength);
+
+		plan += printIndent(++level) + "Hash Aggregate" + extras;
+	}
+
+	m_next->print(tdbb, plan, detailed, level);
+}
+
+bool HashAggregate::getRecord(thread_db* tdbb) const
+{
+	if (--tdbb->tdbb_quantum < 0)
+		JRD_reschedule(tdbb, 0, true);
+
+	jrd_req* const request = tdbb->getRequest();
+	record_param* const rpb = &request->req_rpb[m_stream];
+	Impure* const impure = getImpure(request);
+
+	if (!(impure->irsb_flags & irsb_open))
+	{
+		rpb->rpb_number.setValid(false);
+		return false;
+	}
+
+	HashTable* const table = impure->irsb_hash_table;
+
+	// The whole input is aggregated before the first group is returned
+
+	if (impure->state == STATE_GROUPING)
+	{
+		aggregateInput(tdbb, request, table);
+		impure->state = STATE_FETCHED;
+	}
+
+	while (impure->state == STATE_FETCHED)
+	{
+		const UCHAR* const entry = table->next();
+
+		if (entry)
+		{
+			rpb->rpb_record->copyDataFrom(entry);
+			restoreStates(request, entry);
+			aggExecute(tdbb, request, m_groupMap->sourceList, m_groupMap->targetList);
+
+			rpb->rpb_number.setValid(true);
+			return true;
+		}
+
+		if (table->nextPartition())
+			loadPartition(tdbb, request, table);
+		else
+			impure->state = STATE_EOF;
+	}
+
+	rpb->rpb_number.setValid(false);
+	return false;
+}
+
+// Build the binary comparable key of the current group values, return its hash value
+ULONG HashAggregate::computeKey(thread_db* tdbb, jrd_req* request, UCHAR* keyBuffer) const
+{
+	memset(keyBuffer, 0, m_keyLength);
+
+	UCHAR* keyPtr = keyBuffer;
+
+	for (FB_SIZE_T i = 0; i < m_keyDescs.getCount(); i++)
+	{
+		const dsc& keyDesc = m_keyDescs[i];
+		dsc* const desc = EVL_expr(tdbb, request, (*m_group)[i]);
+
+		if (desc && !(request->req_flags & req_null))
+		{
+			*keyPtr = 1;
+
+			if (desc->isText())
+			{
+				dsc to;
+				to.makeText(keyDesc.dsc_length, desc->getTextType(), keyPtr + 1);
+
+				if (IS_INTL_DATA(desc))
+				{
+					// Convert the INTL string into the binary comparable form
+					INTL_string_to_key(tdbb, INTL_INDEX_TYPE(desc),
+									   desc, &to, INTL_KEY_UNIQUE);
+				}
+				else
+				{
+					// This call ensures that the padding bytes are appended
+					MOV_move(tdbb, desc, &to);
+				}
+			}
+			else if (desc->dsc_dtype == keyDesc.dsc_dtype && desc->dsc_scale == keyDesc.dsc_scale)
+			{
+				// Key values are not aligned, so use plain byte copying
+				memcpy(keyPtr + 1, desc->dsc_address, keyDesc.dsc_length);
+			}
+			else
+			{
+				impure_value temp;
+				dsc to = keyDesc;
+				to.dsc_address = (UCHAR*) &temp.vlu_misc;
+				MOV_move(tdbb, desc, &to);
+				memcpy(keyPtr + 1, to.dsc_address, keyDesc.dsc_length);
+			}
+		}
+
+		keyPtr += 1 + keyDesc.dsc_length;
+	}
+
+	fb_assert(keyPtr - keyBuffer == m_keyLength);
+
+	return InternalHash::hash(m_keyLength, keyBuffer);
+}
+
+// Read the input stream and accumulate its records in the hash table
+void HashAggregate::aggregateInput(thread_db* tdbb, jrd_req* request, HashTable* table) const
+{
+	while (m_next->getRecord(tdbb))
+	{
+		const ULONG hash = computeKey(tdbb, request, table->getKeyBuffer());
+		UCHAR* entry = table->find(hash);
+
+		if (entry)
+			restoreStates(request, entry);
+		else
+		{
+			if (table->isFull())
+				table->spill();
+
+			entry = table->add(hash);
+			initGroup(tdbb, request, entry);
+		}
+
+		for (const AggNode* const* aggNode = m_aggs.begin(); aggNode != m_aggs.end(); ++aggNode)
+			(*aggNode)->aggPass(tdbb, request);
+
+		saveStates(request, entry);
+	}
+
+	table->finishPhase();
+}
+
+// Combine the partial groups of a spilled partition
+void HashAggregate::loadPartition(thread_db* tdbb, jrd_req* request, HashTable* table) const
+{
+	ULONG hash;
+	const UCHAR* from;
+
+	while ( (from = table->fetch(hash)) )
+	{
+		if (--tdbb->tdbb_quantum < 0)
+			JRD_reschedule(tdbb, 0, true);
+
+		UCHAR* const entry = table->find(hash);
+
+		if (entry)
+			mergeGroup(tdbb, request, entry, from);
+		else
+		{
+			if (table->isFull())
+				table->spill();
+
+			memcpy(table->add(hash), from, m_dataLength);
+		}
+	}
+
+	table->finishPhase();
+}
+
+// Start a new group from the current input record
+void HashAggregate::initGroup(thread_db* tdbb, jrd_req* request, UCHAR* entry) const
+{
+	aggInit(tdbb, request, m_groupMap);
+
+	// Non-aggregated values depend on the group key only, evaluate them once per group
+
+	const NestConst<ValueExprNode>* const sourceEnd = m_groupMap->sourceList.end();
+
+	for (const NestConst<ValueExprNode>* source = m_groupMap->sourceList.begin(),
+			*target = m_groupMap->targetList.begin();
+		 source != sourceEnd;
+		 ++source, ++target)
+	{
+		if (!nodeIs<AggNode>(*source) && !nodeIs<LiteralNode>(*source))
+			EXE_assignment(tdbb, *source, *target);
+	}
+
+	request->req_rpb[m_stream].rpb_record->copyDataTo(entry);
+}
+
+// Add the partial aggregate values of a spilled group to the group kept in the table
+void HashAggregate::mergeGroup(thread_db* tdbb, jrd_req* request, UCHAR* entry,
+	const UCHAR* from) const
+{
+	restoreStates(request, entry);
+
+	const UCHAR* state = from + m_statesOffset;
+
+	for (const AggNode* const* ptr = m_aggs.begin(); ptr != m_aggs.end();
+		 ++ptr, state += sizeof(impure_value_ex))
+	{
+		const AggNode* const aggNode = *ptr;
+		impure_value_ex* const impure = request->getImpure<impure_value_ex>(aggNode->impureOffset);
+
+		impure_value_ex value;
+		memcpy(&value, state, sizeof(impure_value_ex));
+		value.vlu_desc.dsc_address = (UCHAR*) &value.vlu_misc;
+
+		if (nodeIs<CountAggNode>(aggNode))
+		{
+			if (aggNode->dialect1)
+				impure->vlu_misc.vlu_long += value.vlu_misc.vlu_long;
+			else
+				impure->vlu_misc.vlu_int64 += value.vlu_misc.vlu_int64;
+		}
+		else if (value.vlux_count)
+		{
+			// Pass the partial result as a single value, then fix the number of values seen
+			aggNode->aggPass(tdbb, request, &value.vlu_desc);
+			impure->vlux_count += value.vlux_count - 1;
+		}
+	}
+
+	saveStates(request, entry);
+}
+
+void HashAggregate::saveStates(jrd_req* request, UCHAR* entry) const
+{
+	UCHAR* state = entry + m_statesOffset;
+
+	for (const AggNode* const* aggNode = m_aggs.begin(); aggNode != m_aggs.end();
+		 ++aggNode, state += sizeof(impure_value_ex))
+	{
+		memcpy(state, request->getImpure<impure_value_ex>((*aggNode)->impureOffset),
+			sizeof(impure_value_ex));
+	}
+}
+
+void HashAggregate::restoreStates(jrd_req* request, const UCHAR* entry) const
+{
+	const UCHAR* state = entry + m_statesOffset;
+
+	for (const AggNode* const* aggNode = m_aggs.begin(); aggNode != m_aggs.end();
+		 ++aggNode, state += sizeof(impure_value_ex))
+	{
+		memcpy(request->getImpure<impure_value_ex>((*aggNode)->impureOffset), state,
+			sizeof(impure_value_ex));
+	}
+}
@@ -32,6 +32,8 @@
 
 #include "RecordSource.h"
 
+#include <algorithm>
+
 using namespace Firebird;
 using namespace Jrd;
 
@@ -39,13 +41,21 @@ using namespace Jrd;
 // Data access: hash join
 // ----------------------
 
-// NS: FIXME - Why use static hash table here??? Hash table shall support dynamic resizing
-static const ULONG HASH_SIZE = 1009;
-static const ULONG BUCKET_PREALLOCATE_SIZE = 32;	// 256 bytes per slot
+// Hash table sizes, every next one is a prime about twice as big as the previous one
+static const ULONG HASH_SIZES[] =
+{
+	1009, 2027, 4057, 8117, 16249, 32503, 65011, 130027, 260081, 520193,
+	1040387, 2080777, 4161557, 8323151, 16646317, 33292687, 66585377, 133170769
+};
 
 class HashJoin::HashTable : public PermanentStorage
 {
-	class CollisionList
+	// Hashed rows of a single inner stream. Entries are collected while
+	// the stream is being buffered. Then the hash table size is chosen to
+	// fit the number of rows and entries are grouped by slots, being
+	// ordered by hash value inside every slot.
+
+	class HashedStream
 	{
 		static const FB_SIZE_T INVALID_ITERATOR = FB_SIZE_T(~0);
 
@@ -59,37 +69,85 @@ class HashJoin::HashTable : public PermanentStorage
 				: hash(h), position(pos)
 			{}
 
-			static const ULONG generate(const Entry& item)
-			{
-				return item.hash;
-			}
-
 			ULONG hash;
 			ULONG position;
 		};
 
 	public:
-		CollisionList(MemoryPool& pool)
-			: m_collisions(pool, BUCKET_PREALLOCATE_SIZE),
+		explicit HashedStream(MemoryPool& pool)
+			: m_entries(pool), m_slots(pool), m_tableSize(0),
 			  m_iterator(INVALID_ITERATOR)
-		{
-			m_collisions.setSortMode(FB_ARRAY_SORT_MANUAL);
-		}
+		{}
 
-		void sort()
+		void add(ULONG hash, ULONG position)
 		{
-			m_collisions.sort();
+			m_entries.add(Entry(hash, position));
 		}
 
-		void add(ULONG hash, ULONG position)
+		void build()
 		{
-			m_collisions.add(Entry(hash, position));
+			const FB_SIZE_T count = m_entries.getCount();
+
+			m_tableSize = HASH_SIZES[FB_NELEM(HASH_SIZES) - 1];
+
+			for (FB_SIZE_T i = 0; i < FB_NELEM(HASH_SIZES); i++)
+			{
+				if (HASH_SIZES[i] >= count)
+				{
+					m_tableSize = HASH_SIZES[i];
+					break;
+				}
+			}
+
+			const ULONG tableSize = m_tableSize;
+
+			std::sort(m_entries.begin(), m_entries.end(),
+				[tableSize](const Entry& item1, const Entry& item2)
+				{
+					const ULONG slot1 = item1.hash % tableSize, slot2 = item2.hash % tableSize;
+					return (slot1 != slot2) ? slot1 < slot2 : item1.hash < item2.hash;
+				});
+
+			// Remember where every slot starts
+
+			m_slots.resize(m_tableSize + 1);
+
+			FB_SIZE_T pos = 0;
+
+			for (ULONG slot = 0; slot < m_tableSize; slot++)
+			{
+				m_slots[slot] = pos;
+
+				while (pos < count && m_entries[pos].hash % m_tableSize == slot)
+					pos++;
+			}
+
+			m_slots[m_tableSize] = count;
 		}
 
 		bool locate(ULONG hash)
 		{
-			if (m_collisions.find(hash, m_iterator))
+			const ULONG slot = hash % m_tableSize;
+
+			FB_SIZE_T lo = m_slots[slot];
+			const FB_SIZE_T end = m_slots[slot + 1];
+			FB_SIZE_T hi = end;
+
+			while (lo < hi)
+			{
+				const FB_SIZE_T mid = (lo + hi) / 2;
+
+				if (m_entries[mid].hash < hash)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			if (lo < end && m_entries[lo].hash == hash)
+			{
+				m_iterator = lo;
 				return true;
+			}
 
 			m_iterator = INVALID_ITERATOR;
 			return false;
@@ -97,10 +155,10 @@ class HashJoin::HashTable : public PermanentStorage
 
 		bool iterate(ULONG hash, ULONG& position)
 		{
-			if (m_iterator >= m_collisions.getCount())
+			if (m_iterator >= m_entries.getCount())
 				return false;
 
-			const Entry& collision = m_collisions[m_iterator++];
+			const Entry& collision = m_entries[m_iterator++];
 
 			if (hash != collision.hash)
 			{
@@ -113,105 +171,98 @@ class HashJoin::HashTable : public PermanentStorage
 		}
 
 	private:
-		SortedArray<Entry, EmptyStorage<Entry>, ULONG, Entry> m_collisions;
+		Array<Entry> m_entries;
+		Array<FB_SIZE_T> m_slots;
+		ULONG m_tableSize;
 		FB_SIZE_T m_iterator;
 	};
 
 public:
-	HashTable(MemoryPool& pool, ULONG streamCount, ULONG tableSize = HASH_SIZE)
-		: PermanentStorage(pool), m_streamCount(streamCount),
-		  m_tableSize(tableSize), m_slot(0)
+	HashTable(MemoryPool& pool, ULONG streamCount)
+		: PermanentStorage(pool), m_streams(pool)
 	{
-		m_collisions = FB_NEW_POOL(pool) CollisionList*[streamCount * tableSize];
-		memset(m_collisions, 0, streamCount * tableSize * sizeof(CollisionList*));
+		for (ULONG i = 0; i < streamCount; i++)
+			m_streams.add(FB_NEW_POOL(pool) HashedStream(pool));
 	}
 
 	~HashTable()
 	{
-		for (ULONG i = 0; i < m_streamCount * m_tableSize; i++)
-			delete m_collisions[i];
-
-		delete[] m_collisions;
+		for (FB_SIZE_T i = 0; i < m_streams.getCount(); i++)
+			delete m_streams[i];
 	}
 
 	void put(ULONG stream, ULONG hash, ULONG position)
 	{
-		const ULONG slot = hash % m_tableSize;
-
-		fb_assert(stream < m_streamCount);
-		fb_assert(slot < m_tableSize);
-
-		CollisionList* collisions = m_collisions[stream * m_tableSize + slot];
-
-		if (!collisions)
-		{
-			collisions = FB_NEW_POOL(getPool()) CollisionList(getPool());
-			m_collisions[stream * m_tableSize + slot] = collisions;
-		}
+		fb_assert(stream < m_streams.getCount());
 
-		collisions->add(hash, position);
+		m_streams[stream]->add(hash, position);
 	}
 
 	bool setup(ULONG hash)
 	{
-		const ULONG slot = hash % m_tableSize;
-
-		for (ULONG i = 0; i < m_streamCount; i++)
+		for (FB_SIZE_T i = 0; i < m_streams.getCount(); i++)
 		{
-			CollisionList* const collisions = m_collisions[i * m_tableSize + slot];
-
-			if (!collisions)
-				return false;
-
-			if (!collisions->locate(hash))
+			if (!m_streams[i]->locate(hash))
 				return false;
 		}
 
-		m_slot = slot;
 		return true;
 	}
 
 	void reset(ULONG stream, ULONG hash)
 	{
-		fb_assert(stream < m_streamCount);
+		fb_assert(stream < m_streams.getCount());
 
-		CollisionList* const collisions = m_collisions[stream * m_tableSize + m_slot];
-		collisions->locate(hash);
+		m_streams[stream]->locate(hash);
 	}
 
 	bool iterate(ULONG stream, ULONG hash, ULONG& position)
 	{
-		fb_assert(stream < m_streamCount);
+		fb_assert(stream < m_streams.getCount());
 
-		CollisionList* const collisions = m_collisions[stream * m_tableSize + m_slot];
-		return collisions->iterate(hash, position);
+		return m_streams[stream]->iterate(hash, position);
 	}
 
 	void sort()
 	{
-		for (ULONG i = 0; i < m_streamCount * m_tableSize; i++)
-		{
-			CollisionList* const collisions = m_collisions[i];
-
-			if (collisions)
-				collisions->sort();
-		}
+		for (FB_SIZE_T i = 0; i < m_streams.getCount(); i++)
+			m_streams[i]->build();
 	}
 
 private:
-	const ULONG m_streamCount;
-	const ULONG m_tableSize;
-	CollisionList** m_collisions;
-	ULONG m_slot;
+	HalfStaticArray<HashedStream*, 8> m_streams;
 };
 
 
 HashJoin::HashJoin(thread_db* tdbb, CompilerScratch* csb, FB_SIZE_T count,
 				   RecordSource* const* args, NestValueArray* const* keys)
-	: m_args(csb->csb_pool, count - 1)
+	: m_joinType(INNER_JOIN), m_args(csb->csb_pool, count - 1),
+	  m_boolean(NULL), m_outerBoolean(NULL)
 {
 	fb_assert(count >= 2);
 
+	init(tdbb, csb, count, args, keys);
+}
+
+HashJoin::HashJoin(thread_db* tdbb, CompilerScratch* csb, JoinType joinType,
+				   RecordSource* outer, RecordSource* inner,
+				   NestValueArray* outerKeys, NestValueArray* innerKeys,
+				   BoolExprNode* outerBoolean, BoolExprNode* boolean)
+	: m_joinType(joinType), m_args(csb->csb_pool, 1),
+	  m_boolean(boolean), m_outerBoolean(outerBoolean)
+{
+	fb_assert(joinType == OUTER_JOIN || joinType == ANTI_JOIN);
+	fb_assert(outer && inner);
+
+	RecordSource* const args[] = {outer, inner};
+	NestValueArray* const keys[] = {outerKeys, innerKeys};
+
+	init(tdbb, csb, 2, args, keys);
+}
+
+void HashJoin::init(thread_db* tdbb, CompilerScratch* csb, FB_SIZE_T count,
+					RecordSource* const* args, NestValueArray* const* keys)
+{
 	m_impure = CMP_impure(csb, sizeof(Impure));
 
 	m_leader.source = args[0];
@@ -349,6 +400,19 @@ bool HashJoin::getRecord(thread_db* tdbb) const
 			if (!m_leader.source->getRecord(tdbb))
 				return false;
 
+			if (m_joinType != INNER_JOIN)
+			{
+				if (m_outerBoolean && !m_outerBoolean->execute(tdbb, request))
+				{
+					// The boolean pertaining to the leading stream is false
+					// so just join it to a null valued inner stream
+					m_args[0].source->nullRecords(tdbb);
+					return true;
+				}
+
+				impure->irsb_flags &= ~irsb_joined;
+			}
+
 			// Compute and hash the comparison keys
 
 			impure->irsb_leader_hash =
@@ -358,12 +422,55 @@ bool HashJoin::getRecord(thread_db* tdbb) const
 			// Setup the hash table for the iteration through collisions.
 
 			if (!impure->irsb_hash_table->setup(impure->irsb_leader_hash))
-				continue;
+			{
+				if (m_joinType == INNER_JOIN)
+					continue;
+
+				m_args[0].source->nullRecords(tdbb);
+				return true;
+			}
 
 			impure->irsb_flags &= ~irsb_mustread;
 			impure->irsb_flags |= irsb_first;
 		}
 
+		if (m_joinType != INNER_JOIN)
+		{
+			// Look for the next inner record really matching the leading one,
+			// different keys may have the same hash value
+
+			bool found = false;
+
+			while (fetchRecord(tdbb, impure, 0))
+			{
+				if (!m_boolean || m_boolean->execute(tdbb, request))
+				{
+					found = true;
+					break;
+				}
+			}
+
+			if (found)
+			{
+				impure->irsb_flags |= irsb_joined;
+
+				if (m_joinType == OUTER_JOIN)
+					return true;
+			}
+
+			impure->irsb_flags |= irsb_mustread;
+
+			if (!(impure->irsb_flags & irsb_joined))
+			{
+				// The current leading record has not been joined to anything.
+				// Join it to a null valued inner stream.
+				m_args[0].source->nullRecords(tdbb);
+				return true;
+			}
+
+			continue;
+		}
+
 		// Fetch collisions from the inner streams
 
 		if (impure->irsb_flags & irsb_first)
@@ -414,7 +521,25 @@ void HashJoin::print(thread_db* tdbb, string& plan, bool detailed, unsigned leve
 {
 	if (detailed)
 	{
-		plan += printIndent(++level) + "Hash Join (inner)";
+		plan += printIndent(++level) + "Hash Join ";
+
+		switch (m_joinType)
+		{
+			case INNER_JOIN:
+				plan += "(inner)";
+				break;
+
+			case OUTER_JOIN:
+				plan += "(outer)";
+				break;
+
+			case ANTI_JOIN:
+				plan += "(anti)";
+				break;
+
+			default:
+				fb_assert(false);
+		}
 
 		m_leader.source->print(tdbb, plan, true, level);
 
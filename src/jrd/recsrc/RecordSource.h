@@ -175,6 +175,7 @@ namespace Jrd
 		struct Impure : public RecordSource::Impure
 		{
 			RecordBitmap** irsb_bitmap;
+			RecordNumber irsb_prefetch_number;		// where to issue next prefetch request
 		};
 
 	public:
@@ -773,6 +774,52 @@ namespace Jrd
 		bool getRecord(thread_db* tdbb) const;
 	};
 
+	class HashAggregate : public BaseAggWinStream<HashAggregate, RecordSource>
+	{
+		class HashTable;
+
+	public:
+		struct Impure : public BaseAggWinStream::Impure
+		{
+			HashTable* irsb_hash_table;
+		};
+
+	public:
+		HashAggregate(thread_db* tdbb, CompilerScratch* csb, StreamType stream,
+			NestValueArray* group, MapNode* map, RecordSource* next);
+
+		static bool isSupported(thread_db* tdbb, CompilerScratch* csb,
+			NestValueArray* group, MapNode* map);
+
+	public:
+		void open(thread_db* tdbb) const override;
+		void close(thread_db* tdbb) const override;
+
+		void print(thread_db* tdbb, Firebird::string& plan, bool detailed, unsigned level) const override;
+		bool getRecord(thread_db* tdbb) const override;
+
+	protected:
+		Impure* getImpure(jrd_req* request) const
+		{
+			return request->getImpure<Impure>(m_impure);
+		}
+
+	private:
+		ULONG computeKey(thread_db* tdbb, jrd_req* request, UCHAR* keyBuffer) const;
+		void aggregateInput(thread_db* tdbb, jrd_req* request, HashTable* table) const;
+		void loadPartition(thread_db* tdbb, jrd_req* request, HashTable* table) const;
+		void initGroup(thread_db* tdbb, jrd_req* request, UCHAR* entry) const;
+		void mergeGroup(thread_db* tdbb, jrd_req* request, UCHAR* entry, const UCHAR* from) const;
+		void saveStates(jrd_req* request, UCHAR* entry) const;
+		void restoreStates(jrd_req* request, const UCHAR* entry) const;
+
+		Firebird::Array<dsc> m_keyDescs;
+		Firebird::Array<const AggNode*> m_aggs;
+		ULONG m_keyLength;
+		ULONG m_statesOffset;
+		ULONG m_dataLength;
+	};
+
 	class WindowedStream : public RecordSource
 	{
 	public:
@@ -1043,6 +1090,10 @@ namespace Jrd
 	public:
 		HashJoin(thread_db* tdbb, CompilerScratch* csb, FB_SIZE_T count,
 				 RecordSource* const* args, NestValueArray* const* keys);
+		HashJoin(thread_db* tdbb, CompilerScratch* csb, JoinType joinType,
+				 RecordSource* outer, RecordSource* inner,
+				 NestValueArray* outerKeys, NestValueArray* innerKeys,
+				 BoolExprNode* outerBoolean, BoolExprNode* boolean);
 
 		void open(thread_db* tdbb) const override;
 		void close(thread_db* tdbb) const override;
@@ -1061,12 +1112,17 @@ namespace Jrd
 		void nullRecords(thread_db* tdbb) const override;
 
 	private:
+		void init(thread_db* tdbb, CompilerScratch* csb, FB_SIZE_T count,
+				  RecordSource* const* args, NestValueArray* const* keys);
 		ULONG computeHash(thread_db* tdbb, jrd_req* request,
 						  const SubStream& sub, UCHAR* buffer) const;
 		bool fetchRecord(thread_db* tdbb, Impure* impure, FB_SIZE_T stream) const;
 
+		const JoinType m_joinType;
 		SubStream m_leader;
 		Firebird::Array<SubStream> m_args;
+		NestConst<BoolExprNode> const m_boolean;		// join condition, outer and anti joins only
+		NestConst<BoolExprNode> const m_outerBoolean;	// condition on the leading stream only
 	};
 
 	class MergeJoin : public RecordSource
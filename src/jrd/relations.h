@@ -146,6 +146,7 @@ RELATION(nam_relations, rel_relations, ODS_8_0, rel_persistent)
 	FIELD(f_rel_flags, nam_flags, fld_flag_nullable, 0, ODS_8_0)
 	FIELD(f_rel_type, nam_r_type, fld_r_type, 0, ODS_11_1)
 	FIELD(f_rel_sql_security, nam_sql_security, fld_b_sql_security, 1, ODS_13_0)
+	FIELD(f_rel_codec, nam_record_codec, fld_flag_nullable, 1, ODS_13_1)
 END_RELATION
 
 // Relation 7 (RDB$VIEW_RELATIONS)
@@ -524,6 +525,10 @@ RELATION(nam_mon_attachments, rel_mon_attachments, ODS_11_1, rel_virtual)
 	FIELD(f_mon_att_wire_compressed, nam_wire_compressed, fld_bool, 0, ODS_13_0)
 	FIELD(f_mon_att_wire_encrypted, nam_wire_encrypted, fld_bool, 0, ODS_13_0)
 	FIELD(f_mon_att_remote_crypt, nam_wire_crypt_plugin, fld_remote_crypt, 0, ODS_12_0)
+	FIELD(f_mon_att_stmt_cache_hits, nam_mon_stmt_cache_hits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_att_stmt_cache_misses, nam_mon_stmt_cache_misses, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_att_repl_lag, nam_mon_repl_lag, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_att_repl_queue, nam_mon_repl_queue, fld_counter, 0, ODS_13_1)
 END_RELATION
 
 // Relation 35 (MON$TRANSACTIONS)
@@ -579,6 +584,10 @@ RELATION(nam_mon_io_stats, rel_mon_io_stats, ODS_11_1, rel_virtual)
 	FIELD(f_mon_io_page_writes, nam_mon_page_writes, fld_counter, 0, ODS_11_1)
 	FIELD(f_mon_io_page_fetches, nam_mon_page_fetches, fld_counter, 0, ODS_11_1)
 	FIELD(f_mon_io_page_marks, nam_mon_page_marks, fld_counter, 0, ODS_11_1)
+	FIELD(f_mon_io_page_prefetches, nam_mon_page_prefetches, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_io_page_prefetch_hits, nam_mon_page_prefetch_hits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_io_page_write_runs, nam_mon_page_write_runs, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_io_page_run_writes, nam_mon_page_run_writes, fld_counter, 0, ODS_13_1)
 END_RELATION
 
 // Relation 39 (MON$RECORD_STATS)
@@ -719,3 +728,47 @@ RELATION(nam_pub_tables, rel_pub_tables, ODS_13_0, rel_persistent)
 	FIELD(f_pubtab_pub_name, nam_pub_name, fld_pub_name, 1, ODS_13_0)
 	FIELD(f_pubtab_tab_name, nam_tab_name, fld_r_name, 1, ODS_13_0)
 END_RELATION
+
+// Relation 53 (MON$CACHE_PARTITIONS)
+RELATION(nam_mon_cache_parts, rel_mon_cache_parts, ODS_13_1, rel_virtual)
+	FIELD(f_mon_cp_id, nam_mon_part_id, fld_stat_id, 0, ODS_13_1)
+	FIELD(f_mon_cp_page_bufs, nam_mon_page_bufs, fld_page_bufs, 0, ODS_13_1)
+	FIELD(f_mon_cp_dirty_pages, nam_mon_dirty_pages, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_cp_hash_waits, nam_mon_hash_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_cp_lru_waits, nam_mon_lru_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_cp_dirty_waits, nam_mon_dirty_waits, fld_counter, 0, ODS_13_1)
+END_RELATION
+
+// Relation 54 (RDB$COLUMN_STATISTICS)
+RELATION(nam_col_stats, rel_col_stats, ODS_13_1, rel_persistent)
+	FIELD(f_cst_rel_name, nam_r_name, fld_r_name, 1, ODS_13_1)
+	FIELD(f_cst_fld_name, nam_f_name, fld_f_name, 1, ODS_13_1)
+	FIELD(f_cst_rec_count, nam_record_count, fld_counter, 1, ODS_13_1)
+	FIELD(f_cst_data_pages, nam_data_pages, fld_counter, 1, ODS_13_1)
+	FIELD(f_cst_null_fraction, nam_null_fraction, fld_statistics, 1, ODS_13_1)
+	FIELD(f_cst_distinct, nam_distinct_values, fld_statistics, 1, ODS_13_1)
+	FIELD(f_cst_histogram, nam_histogram, fld_histogram, 1, ODS_13_1)
+END_RELATION
+
+// Relation 55 (MON$WAIT_STATS)
+RELATION(nam_mon_wait_stats, rel_mon_wait_stats, ODS_13_1, rel_virtual)
+	FIELD(f_mon_wait_stat_id, nam_mon_stat_id, fld_stat_id, 0, ODS_13_1)
+	FIELD(f_mon_wait_stat_group, nam_mon_stat_group, fld_stat_group, 0, ODS_13_1)
+	FIELD(f_mon_wait_latch_waits, nam_mon_latch_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_latch_time, nam_mon_latch_wait_time, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_lock_waits, nam_mon_lock_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_lock_time, nam_mon_lock_wait_time, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_read_waits, nam_mon_read_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_read_time, nam_mon_read_wait_time, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_write_waits, nam_mon_write_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_write_time, nam_mon_write_wait_time, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_temp_waits, nam_mon_temp_waits, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_wait_temp_time, nam_mon_temp_wait_time, fld_counter, 0, ODS_13_1)
+END_RELATION
+
+// Relation 56 (MON$STATEMENT_LATENCY)
+RELATION(nam_mon_stmt_latency, rel_mon_stmt_latency, ODS_13_1, rel_virtual)
+	FIELD(f_mon_lat_stmt_id, nam_mon_stmt_id, fld_stmt_id, 0, ODS_13_1)
+	FIELD(f_mon_lat_limit, nam_mon_latency_limit, fld_counter, 0, ODS_13_1)
+	FIELD(f_mon_lat_executions, nam_mon_executions, fld_counter, 0, ODS_13_1)
+END_RELATION
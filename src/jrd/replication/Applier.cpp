@@ -28,22 +28,29 @@
 #include "../jrd/req.h"
 #include "../jrd/ini.h"
 #include "ibase.h"
+#include "../common/ThreadStart.h"
+#include "../common/classes/condition.h"
+#include "../common/isc_proto.h"
 #include "../jrd/btr_proto.h"
 #include "../jrd/cch_proto.h"
 #include "../jrd/cmp_proto.h"
 #include "../jrd/dpm_proto.h"
 #include "../jrd/idx_proto.h"
+#include "../jrd/ini_proto.h"
 #include "../jrd/jrd_proto.h"
 #include "../jrd/lck_proto.h"
 #include "../jrd/met_proto.h"
 #include "../jrd/mov_proto.h"
+#include "../jrd/pag_proto.h"
 #include "../jrd/rlck_proto.h"
 #include "../jrd/tra_proto.h"
 #include "../jrd/vio_proto.h"
+#include "../jrd/Monitoring.h"
 #include "../dsql/dsql_proto.h"
 #include "firebird/impl/sqlda_pub.h"
 
 #include "Applier.h"
+#include "Config.h"
 #include "Protocol.h"
 #include "Publisher.h"
 #include "Utils.h"
@@ -177,9 +184,526 @@ namespace
 		thread_db* m_tdbb;
 	};
 
+	// Milliseconds passed since the block was replicated
+
+	SINT64 getBlockLag(const UCHAR* data)
+	{
+		const auto header = (const Block*) data;
+		const auto now = TimeZoneUtil::getCurrentGmtTimeStamp().utc_timestamp;
+
+		const SINT64 ticks =
+			TimeStamp::timeStampToTicks(now) - TimeStamp::timeStampToTicks(header->timestamp);
+
+		return MAX(ticks, 0) / (ISC_TIME_SECONDS_PRECISION / 1000);
+	}
+
+	// Queued blocks, the dispatcher waits for the workers when there are more of them
+	const FB_SIZE_T MAX_QUEUED_BLOCKS = 256;
+
 } // namespace
 
 
+namespace Jrd {
+
+// Worker threads applying the replicated transactions in parallel. Every
+// transaction is applied by one worker with its own system attachment, the
+// blocks passed to a worker are applied in the order they were received.
+// A block is passed to the worker after the transactions which changed the
+// same primary/unique keys, or the keys referenced by its foreign keys, and
+// ended before are applied, as the master has serialized them the same way. Commits are applied in the order they were
+// received. Blocks changing unknown keys (DDL, tables without a key) are
+// applied when nothing else is being applied.
+
+class ApplyWorkers
+{
+	typedef ThreadFinishSync<ApplyWorkers*> WorkerThread;
+
+	struct Job
+	{
+		explicit Job(MemoryPool& pool)
+			: data(pool), traNum(0), worker(0), commitNo(0), end(false)
+		{}
+
+		Array<UCHAR> data;
+		TraNumber traNum;
+		unsigned worker;
+		FB_UINT64 commitNo;		// order of the commit, zero if the block doesn't commit
+		bool end;				// the last block of the transaction
+	};
+
+	struct Transaction
+	{
+		explicit Transaction(MemoryPool& pool)
+			: keys(pool), worker(0), ended(false), opaque(false)
+		{}
+
+		ObjectsArray<string> keys;	// keys owned by the transaction
+		unsigned worker;
+		bool ended;					// the last block is queued
+		bool opaque;				// some of the changed keys are unknown
+	};
+
+	typedef GenericMap<Pair<NonPooled<TraNumber, Transaction*> > > TransactionMap;
+	typedef GenericMap<Pair<Left<string, TraNumber> > > KeyOwnerMap;
+
+public:
+	ApplyWorkers(MemoryPool& pool, Database* dbb, const UserId& user)
+		: m_pool(pool), m_dbb(dbb), m_user(user), m_threads(pool), m_load(pool),
+		  m_jobs(pool), m_transactions(pool), m_owners(pool),
+		  m_started(0), m_commits(0), m_committed(0), m_shutdown(false)
+	{}
+
+	~ApplyWorkers()
+	{
+		shutdown();
+	}
+
+	// Start up to count threads, return the number of running ones
+	unsigned start(unsigned count)
+	{
+		try
+		{
+			while (m_threads.getCount() < count)
+			{
+				AutoPtr<WorkerThread> thread(FB_NEW_POOL(m_pool) WorkerThread(m_pool, worker, THREAD_medium));
+				thread->run(this);
+				m_threads.add(thread.release());
+			}
+		}
+		catch (const Exception& ex)
+		{
+			exceptionHandler(ex, worker);
+		}
+
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		m_load.resize(m_threads.getCount(), 0);
+
+		return m_threads.getCount();
+	}
+
+	// Pass the block to the worker applying its transaction
+	void dispatch(thread_db* tdbb, Applier* applier, ULONG length, const UCHAR* data)
+	{
+		const auto header = (const Block*) data;
+		const auto traNum = header->traNumber;
+
+		// Empty block asks to wait until all blocks received before are applied
+
+		if (!header->dataLength)
+		{
+			drain(tdbb);
+			return;
+		}
+
+		// Blocks out of transactions are applied by the replicator itself
+
+		if (!traNum)
+		{
+			drain(tdbb);
+			applier->apply(tdbb, length, data);
+			m_lag.setValue(getBlockLag(data));
+			return;
+		}
+
+		ObjectsArray<string> keys(*tdbb->getDefaultPool());
+		bool commit = false;
+		bool opaque;
+
+		try
+		{
+			opaque = !applier->getKeys(tdbb, length, data, keys, commit);
+		}
+		catch (const Exception&)
+		{
+			// The worker reports the error, if it's really an error
+			fb_utils::init_status(tdbb->tdbb_status_vector);
+			opaque = true;
+		}
+
+		AutoPtr<Job> job(FB_NEW_POOL(m_pool) Job(m_pool));
+		job->data.assign(data, length);
+		job->traNum = traNum;
+		job->end = (header->flags & BLOCK_END_TRANS) != 0;
+
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+		Transaction* transaction = NULL;
+		if (!m_transactions.get(traNum, transaction))
+		{
+			transaction = FB_NEW_POOL(m_pool) Transaction(m_pool);
+
+			for (unsigned i = 1; i < m_load.getCount(); i++)
+			{
+				if (m_load[i] < m_load[transaction->worker])
+					transaction->worker = i;
+			}
+
+			m_load[transaction->worker]++;
+			m_transactions.put(traNum, transaction);
+		}
+
+		if (opaque)
+			transaction->opaque = true;
+
+		while (true)
+		{
+			checkStatus();
+
+			if (m_jobs.getCount() < MAX_QUEUED_BLOCKS &&
+				(opaque ? m_jobs.isEmpty() : !hasConflicts(traNum, transaction, keys)))
+			{
+				break;
+			}
+
+			m_cond.wait(m_mutex);
+		}
+
+		for (const auto& key : keys)
+		{
+			TraNumber owner;
+			if (!m_owners.get(key, owner) || owner != traNum)
+			{
+				m_owners.put(key, traNum);
+				transaction->keys.add(key);
+			}
+		}
+
+		if (job->end)
+			transaction->ended = true;
+
+		job->worker = transaction->worker;
+		job->commitNo = commit ? ++m_commits : 0;
+
+		m_jobs.add(job.release());
+		m_queueLength.setValue(m_jobs.getCount());
+		m_cond.notifyAll();
+
+		// Nothing is applied together with a block changing unknown keys: it's queued
+		// when the queue is empty and the next blocks are not dispatched until it's
+		// applied. The same is true for the end of a transaction changing unknown keys.
+
+		if (opaque || (transaction->ended && transaction->opaque))
+		{
+			while (m_jobs.hasData())
+			{
+				checkStatus();
+				m_cond.wait(m_mutex);
+			}
+
+			checkStatus();
+		}
+	}
+
+	// Wait until all queued blocks are applied
+	void drain(thread_db* tdbb)
+	{
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+		while (m_jobs.hasData())
+		{
+			checkStatus();
+			m_cond.wait(m_mutex);
+		}
+
+		checkStatus();
+	}
+
+	// Stop the workers, queued blocks are not applied and their transactions are rolled back
+	void shutdown()
+	{
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_shutdown = true;
+			m_cond.notifyAll();
+		}
+
+		while (m_threads.hasData())
+		{
+			WorkerThread* const thread = m_threads.pop();
+			thread->waitForCompletion();
+			delete thread;
+		}
+
+		while (m_jobs.hasData())
+			delete m_jobs.pop();
+
+		TransactionMap::Accessor accessor(&m_transactions);
+		if (accessor.getFirst())
+		{
+			do {
+				delete accessor.current()->second;
+			} while (accessor.getNext());
+		}
+
+		m_transactions.clear();
+		m_owners.clear();
+		m_queueLength.setValue(0);
+	}
+
+	SINT64 getLag() const
+	{
+		return m_lag.value();
+	}
+
+	SINT64 getQueueLength() const
+	{
+		return m_queueLength.value();
+	}
+
+	void exceptionHandler(const Exception& ex, WorkerThread::ThreadRoutine*)
+	{
+		FbLocalStatus status_vector;
+		ex.stuffException(&status_vector);
+		iscDbLogStatus(m_dbb->dbb_filename.c_str(), &status_vector);
+	}
+
+private:
+	static void worker(ApplyWorkers* workers)
+	{
+		workers->run();
+	}
+
+	// Raise the first error of the workers, the mutex is locked
+	void checkStatus()
+	{
+		if (!m_status.isSuccess())
+			Arg::StatusVector(&m_status).raise();
+	}
+
+	// Check if some key is owned by an ended transaction of another worker
+	bool hasConflicts(TraNumber traNum, const Transaction* transaction,
+					  const ObjectsArray<string>& keys)
+	{
+		for (const auto& key : keys)
+		{
+			TraNumber owner;
+			Transaction* ownerTransaction;
+
+			if (m_owners.get(key, owner) && owner != traNum &&
+				m_transactions.get(owner, ownerTransaction) &&
+				ownerTransaction->ended && ownerTransaction->worker != transaction->worker)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Take the next block of the worker, NULL at shutdown
+	Job* getJob(thread_db* tdbb, unsigned id)
+	{
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+		while (!m_shutdown)
+		{
+			Job* job = NULL;
+
+			for (const auto queued : m_jobs)
+			{
+				if (queued->worker == id)
+				{
+					job = queued;
+					break;
+				}
+			}
+
+			if (job)
+			{
+				// Nothing is applied after an error, the dispatcher reports it
+
+				if (!m_status.isSuccess())
+				{
+					finishJob(job);
+					continue;
+				}
+
+				if (!job->commitNo || job->commitNo == m_committed + 1)
+					return job;
+			}
+
+			m_cond.wait(m_mutex);
+		}
+
+		return NULL;
+	}
+
+	void jobDone(thread_db* tdbb, Job* job, const Exception* ex)
+	{
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+		if (ex && m_status.isSuccess())
+			ex->stuffException(&m_status);
+
+		finishJob(job);
+	}
+
+	// Forget the applied block and the keys of the ended transaction, the mutex is locked
+	void finishJob(Job* job)
+	{
+		FB_SIZE_T pos;
+		if (m_jobs.find(job, pos))
+			m_jobs.remove(pos);
+
+		if (job->commitNo)
+			m_committed = job->commitNo;
+
+		Transaction* transaction;
+		if (job->end && m_transactions.get(job->traNum, transaction))
+		{
+			for (const auto& key : transaction->keys)
+			{
+				TraNumber owner;
+				if (m_owners.get(key, owner) && owner == job->traNum)
+					m_owners.remove(key);
+			}
+
+			m_load[transaction->worker]--;
+			m_transactions.remove(job->traNum);
+			delete transaction;
+		}
+
+		m_queueLength.setValue(m_jobs.getCount());
+		m_cond.notifyAll();
+
+		delete job;
+	}
+
+	void run()
+	{
+		unsigned id;
+
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			id = m_started++;
+		}
+
+		FbLocalStatus status_vector;
+
+		try
+		{
+			UserId user(m_user);
+
+			Jrd::Attachment* const attachment = Jrd::Attachment::create(m_dbb);
+			RefPtr<SysStableAttachment> sAtt(FB_NEW SysStableAttachment(attachment));
+			attachment->setStable(sAtt);
+			attachment->att_filename = m_dbb->dbb_filename;
+			attachment->att_user = &user;
+
+			BackgroundContextHolder tdbb(m_dbb, attachment, &status_vector, FB_FUNCTION);
+
+			AutoPtr<Applier> applier;
+
+			try
+			{
+				LCK_init(tdbb, LCK_OWNER_attachment);
+				INI_init(tdbb);
+				INI_init2(tdbb);
+				PAG_header(tdbb, true);
+				PAG_attachment_id(tdbb);
+				TRA_init(attachment);
+
+				Monitoring::publishAttachment(tdbb);
+
+				sAtt->initDone();
+
+				applier = Applier::make(tdbb);
+
+				Job* job;
+				while ( (job = getJob(tdbb, id)) )
+				{
+					try
+					{
+						applier->apply(tdbb, job->data.getCount(), job->data.begin());
+						m_lag.setValue(getBlockLag(job->data.begin()));
+					}
+					catch (const Exception& ex)
+					{
+						fb_utils::init_status(tdbb->tdbb_status_vector);
+						jobDone(tdbb, job, &ex);
+						continue;
+					}
+
+					jobDone(tdbb, job, NULL);
+				}
+			}
+			catch (const Exception& ex)
+			{
+				// Blocks of this worker would never be applied, stop replication
+
+				EngineCheckout cout(tdbb, FB_FUNCTION);
+				MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+				if (m_status.isSuccess())
+					ex.stuffException(&m_status);
+
+				m_cond.notifyAll();
+			}
+
+			if (applier)
+			{
+				try
+				{
+					applier->shutdown(tdbb);
+				}
+				catch (const Exception& ex)
+				{
+					exceptionHandler(ex, NULL);
+				}
+
+				applier.reset();
+			}
+
+			Monitoring::cleanupAttachment(tdbb);
+			attachment->releaseLocks(tdbb);
+			LCK_fini(tdbb, LCK_OWNER_attachment);
+
+			attachment->releaseRelations(tdbb);
+		}
+		catch (const Exception& ex)
+		{
+			exceptionHandler(ex, NULL);
+		}
+	}
+
+	MemoryPool& m_pool;
+	Database* const m_dbb;
+	const UserId m_user;				// user of the replicator attachment
+	HalfStaticArray<WorkerThread*, 8> m_threads;
+	HalfStaticArray<unsigned, 8> m_load;	// active transactions of every worker
+	Array<Job*> m_jobs;					// blocks not applied yet, in the order received
+	TransactionMap m_transactions;		// transactions with queued or not ended blocks
+	KeyOwnerMap m_owners;				// last transaction changing a key
+	Mutex m_mutex;
+	Condition m_cond;					// signals any change of the state
+	unsigned m_started;					// number of worker ids given
+	FB_UINT64 m_commits;				// number of commits dispatched
+	FB_UINT64 m_committed;				// number of commits applied
+	bool m_shutdown;
+	FbLocalStatus m_status;				// first error of any worker
+	AtomicCounter m_lag;
+	AtomicCounter m_queueLength;
+};
+
+} // namespace Jrd
+
+
+Applier::Applier(MemoryPool& pool, const PathName& database, jrd_req* request)
+	: PermanentStorage(pool),
+	  m_txnMap(pool), m_keyMap(pool), m_database(pool, database),
+	  m_request(request), m_bitmap(FB_NEW_POOL(pool) RecordBitmap(pool)), m_record(NULL),
+	  m_depMap(pool), m_depIndices(pool), m_partnerRecord(NULL)
+{
+}
+
+Applier::~Applier()
+{
+}
+
 Applier* Applier::create(thread_db* tdbb)
 {
 	const auto dbb = tdbb->getDatabase();
@@ -192,6 +716,43 @@ Applier* Applier::create(thread_db* tdbb)
 	if (!attachment->locksmith(tdbb, REPLICATE_INTO_DATABASE))
 		status_exception::raise(Arg::Gds(isc_miss_prvlg) << "REPLICATE_INTO_DATABASE");
 
+	AutoPtr<Applier> applier(make(tdbb));
+
+	// Asynchronous replicas may apply transactions in parallel
+
+	ULONG workers = 1;
+
+	Array<Replication::Config*> replicas;
+	Replication::Config::enumerate(replicas);
+
+	for (auto replica : replicas)
+	{
+		if (replica->dbName == dbb->dbb_filename)
+			workers = replica->applyParallelWorkers;
+
+		delete replica;
+	}
+
+	workers = MIN(workers, dbb->dbb_config->getMaxParallelWorkers());
+
+	if (workers > 1)
+	{
+		auto& att_pool = *attachment->att_pool;
+		AutoPtr<ApplyWorkers> applyWorkers(FB_NEW_POOL(att_pool)
+			ApplyWorkers(att_pool, dbb, *attachment->att_user));
+
+		if (applyWorkers->start(workers))
+			applier->m_workers = applyWorkers.release();
+	}
+
+	return applier.release();
+}
+
+Applier* Applier::make(thread_db* tdbb)
+{
+	const auto dbb = tdbb->getDatabase();
+	const auto attachment = tdbb->getAttachment();
+
 	const auto req_pool = attachment->createPool();
 	Jrd::ContextPoolHolder context(tdbb, req_pool);
 	AutoPtr<CompilerScratch> csb(FB_NEW_POOL(*req_pool) CompilerScratch(*req_pool));
@@ -206,6 +767,12 @@ Applier* Applier::create(thread_db* tdbb)
 
 void Applier::shutdown(thread_db* tdbb)
 {
+	if (m_workers)
+	{
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		m_workers.reset();
+	}
+
 	TransactionMap::Accessor txnAccessor(&m_txnMap);
 	if (txnAccessor.getFirst())
 	{
@@ -218,9 +785,23 @@ void Applier::shutdown(thread_db* tdbb)
 	CMP_release(tdbb, m_request);
 	m_request = NULL;
 	m_record = NULL;
+	m_partnerRecord = NULL;
 
 	m_bitmap->clear();
 	m_txnMap.clear();
+	m_keyMap.clear();
+	m_depMap.clear();
+	m_depIndices.clear();
+}
+
+SINT64 Applier::getLag() const
+{
+	return m_workers ? m_workers->getLag() : m_lag.value();
+}
+
+SINT64 Applier::getQueueLength() const
+{
+	return m_workers ? m_workers->getQueueLength() : 0;
 }
 
 void Applier::process(thread_db* tdbb, ULONG length, const UCHAR* data)
@@ -232,130 +813,404 @@ void Applier::process(thread_db* tdbb, ULONG length, const UCHAR* data)
 
 	try
 	{
-		tdbb->tdbb_flags |= TDBB_replicator;
+		if (m_workers)
+			m_workers->dispatch(tdbb, this, length, data);
+		else
+		{
+			apply(tdbb, length, data);
+			m_lag.setValue(getBlockLag(data));
+		}
+	}
+	catch (const Exception& ex)
+	{
+		postError(tdbb->tdbb_status_vector, ex);
+		throw;
+	}
+}
+
+void Applier::apply(thread_db* tdbb, ULONG length, const UCHAR* data)
+{
+	tdbb->tdbb_flags |= TDBB_replicator;
 
-		BlockReader reader(length, data);
+	// Keys of the relations are looked up once per block
+	m_keyMap.clear();
 
-		const auto traNum = reader.getTransactionId();
-		const auto protocol = reader.getProtocolVersion();
+	BlockReader reader(length, data);
 
-		if (protocol != PROTOCOL_CURRENT_VERSION)
-			raiseError("Unsupported replication protocol version %u", protocol);
+	const auto traNum = reader.getTransactionId();
+	const auto protocol = reader.getProtocolVersion();
+
+	if (protocol != PROTOCOL_CURRENT_VERSION)
+		raiseError("Unsupported replication protocol version %u", protocol);
+
+	while (!reader.isEof())
+	{
+		const auto op = reader.getTag();
 
-		while (!reader.isEof())
+		switch (op)
 		{
-			const auto op = reader.getTag();
+		case opStartTransaction:
+			startTransaction(tdbb, traNum);
+			break;
+
+		case opPrepareTransaction:
+			prepareTransaction(tdbb, traNum);
+			break;
+
+		case opCommitTransaction:
+			commitTransaction(tdbb, traNum);
+			break;
+
+		case opRollbackTransaction:
+			rollbackTransaction(tdbb, traNum, false);
+			break;
+
+		case opCleanupTransaction:
+			rollbackTransaction(tdbb, traNum, true);
+			break;
+
+		case opStartSavepoint:
+			startSavepoint(tdbb, traNum);
+			break;
+
+		case opReleaseSavepoint:
+			cleanupSavepoint(tdbb, traNum, false);
+			break;
 
-			switch (op)
+		case opRollbackSavepoint:
+			cleanupSavepoint(tdbb, traNum, true);
+			break;
+
+		case opInsertRecord:
 			{
-			case opStartTransaction:
-				startTransaction(tdbb, traNum);
-				break;
+				const MetaName relName = reader.getMetaName();
+				const UCHAR* record = NULL;
+				const ULONG length = reader.getBinary(record);
+				insertRecord(tdbb, traNum, relName, length, record);
+			}
+			break;
 
-			case opPrepareTransaction:
-				prepareTransaction(tdbb, traNum);
-				break;
+		case opUpdateRecord:
+			{
+				const MetaName relName = reader.getMetaName();
+				const UCHAR* orgRecord = NULL;
+				const ULONG orgLength = reader.getBinary(orgRecord);
+				const UCHAR* newRecord = NULL;
+				const ULONG newLength = reader.getBinary(newRecord);
+				updateRecord(tdbb, traNum, relName,
+									  orgLength, orgRecord,
+									  newLength, newRecord);
+			}
+			break;
 
-			case opCommitTransaction:
-				commitTransaction(tdbb, traNum);
-				break;
+		case opDeleteRecord:
+			{
+				const MetaName relName = reader.getMetaName();
+				const UCHAR* record = NULL;
+				const ULONG length = reader.getBinary(record);
+				deleteRecord(tdbb, traNum, relName, length, record);
+			}
+			break;
 
-			case opRollbackTransaction:
-				rollbackTransaction(tdbb, traNum, false);
-				break;
+		case opStoreBlob:
+			{
+				bid blob_id;
+				blob_id.bid_quad.bid_quad_high = reader.getInt();
+				blob_id.bid_quad.bid_quad_low = reader.getInt();
+				const UCHAR* blob = NULL;
+				const ULONG length = reader.getBinary(blob);
+				storeBlob(tdbb, traNum, &blob_id, length, blob);
+			}
+			break;
 
-			case opCleanupTransaction:
-				rollbackTransaction(tdbb, traNum, true);
-				break;
+		case opExecuteSql:
+		case opExecuteSqlIntl:
+			{
+				const unsigned charset =
+					(op == opExecuteSql) ? CS_UTF8 : reader.getInt();
+				const string sql = reader.getString();
+				const MetaName ownerName = reader.getMetaName();
+				executeSql(tdbb, traNum, charset, sql, ownerName);
+			}
+			break;
 
-			case opStartSavepoint:
-				startSavepoint(tdbb, traNum);
-				break;
+		case opSetSequence:
+			{
+				const MetaName genName = reader.getMetaName();
+				const SINT64 value = reader.getBigInt();
+				setSequence(tdbb, genName, value);
+			}
+			break;
 
-			case opReleaseSavepoint:
-				cleanupSavepoint(tdbb, traNum, false);
-				break;
+		default:
+			fb_assert(false);
+		}
 
-			case opRollbackSavepoint:
-				cleanupSavepoint(tdbb, traNum, true);
-				break;
+		// Check cancellation flags and reset monitoring state if necessary
+		tdbb->checkCancelState(true);
+		Monitoring::checkState(tdbb);
+	}
+}
 
-			case opInsertRecord:
-				{
-					const MetaName relName = reader.getMetaName();
-					const UCHAR* record = NULL;
-					const ULONG length = reader.getBinary(record);
-					insertRecord(tdbb, traNum, relName, length, record);
-				}
-				break;
+// Collect the keys changed by the block for the parallel workers: primary/unique
+// keys of the changed records and the keys of the records their foreign keys
+// refer to. Returns false if some of the changes can't be identified by the key.
 
-			case opUpdateRecord:
-				{
-					const MetaName relName = reader.getMetaName();
-					const UCHAR* orgRecord = NULL;
-					const ULONG orgLength = reader.getBinary(orgRecord);
-					const UCHAR* newRecord = NULL;
-					const ULONG newLength = reader.getBinary(newRecord);
-					updateRecord(tdbb, traNum, relName,
-										  orgLength, orgRecord,
-										  newLength, newRecord);
-				}
-				break;
+bool Applier::getKeys(thread_db* tdbb, ULONG length, const UCHAR* data,
+					  ObjectsArray<string>& keys, bool& commit)
+{
+	m_keyMap.clear();
+	m_depMap.clear();
+	m_depIndices.clear();
 
-			case opDeleteRecord:
-				{
-					const MetaName relName = reader.getMetaName();
-					const UCHAR* record = NULL;
-					const ULONG length = reader.getBinary(record);
-					deleteRecord(tdbb, traNum, relName, length, record);
-				}
-				break;
+	BlockReader reader(length, data);
 
-			case opStoreBlob:
-				{
-					bid blob_id;
-					blob_id.bid_quad.bid_quad_high = reader.getInt();
-					blob_id.bid_quad.bid_quad_low = reader.getInt();
-					const UCHAR* blob = NULL;
-					const ULONG length = reader.getBinary(blob);
-					storeBlob(tdbb, traNum, &blob_id, length, blob);
-				}
-				break;
+	if (reader.getProtocolVersion() != PROTOCOL_CURRENT_VERSION)
+		return false;
 
-			case opExecuteSql:
-			case opExecuteSqlIntl:
-				{
-					const unsigned charset =
-						(op == opExecuteSql) ? CS_UTF8 : reader.getInt();
-					const string sql = reader.getString();
-					const MetaName ownerName = reader.getMetaName();
-					executeSql(tdbb, traNum, charset, sql, ownerName);
-				}
-				break;
+	while (!reader.isEof())
+	{
+		const auto op = reader.getTag();
 
-			case opSetSequence:
+		switch (op)
+		{
+		case opStartTransaction:
+		case opPrepareTransaction:
+		case opRollbackTransaction:
+		case opCleanupTransaction:
+		case opStartSavepoint:
+		case opReleaseSavepoint:
+		case opRollbackSavepoint:
+			break;
+
+		case opCommitTransaction:
+			commit = true;
+			break;
+
+		case opInsertRecord:
+		case opDeleteRecord:
+			{
+				const MetaName relName = reader.getMetaName();
+				const UCHAR* record = NULL;
+				const ULONG length = reader.getBinary(record);
+
+				if (!addKey(tdbb, relName, length, record, keys))
+					return false;
+			}
+			break;
+
+		case opUpdateRecord:
+			{
+				const MetaName relName = reader.getMetaName();
+				const UCHAR* orgRecord = NULL;
+				const ULONG orgLength = reader.getBinary(orgRecord);
+				const UCHAR* newRecord = NULL;
+				const ULONG newLength = reader.getBinary(newRecord);
+
+				if (!addKey(tdbb, relName, orgLength, orgRecord, keys) ||
+					!addKey(tdbb, relName, newLength, newRecord, keys))
 				{
-					const MetaName genName = reader.getMetaName();
-					const SINT64 value = reader.getBigInt();
-					setSequence(tdbb, genName, value);
+					return false;
 				}
-				break;
+			}
+			break;
 
-			default:
-				fb_assert(false);
+		case opStoreBlob:
+			{
+				reader.getInt();
+				reader.getInt();
+				const UCHAR* blob = NULL;
+				reader.getBinary(blob);
 			}
+			break;
+
+		case opSetSequence:
+			{
+				reader.getMetaName();
+				reader.getBigInt();
+			}
+			break;
 
-			// Check cancellation flags and reset monitoring state if necessary
-			tdbb->checkCancelState(true);
-			Monitoring::checkState(tdbb);
+		default:
+			// DDL and unknown operations
+			return false;
 		}
+	}
 
-	} // try
-	catch (const Exception& ex)
+	return true;
+}
+
+bool Applier::addKey(thread_db* tdbb, const MetaName& relName,
+					 ULONG length, const UCHAR* data,
+					 ObjectsArray<string>& keys)
+{
+	const auto relation = MET_lookup_relation(tdbb, relName);
+	if (!relation)
+		return false;
+
+	if (!(relation->rel_flags & REL_scanned))
+		MET_scan_relation(tdbb, relation);
+
+	index_desc idx;
+	if (!lookupKey(tdbb, relation, idx) || (idx.idx_flags & idx_expressn))
+		return false;
+
+	const auto format = findFormat(tdbb, relation, length);
+
+	record_param rpb;
+	rpb.rpb_relation = relation;
+
+	rpb.rpb_record = m_record;
+	const auto record = m_record =
+		VIO_record(tdbb, &rpb, format, m_request->req_pool);
+
+	record->copyDataFrom(data);
+
+	FB_SIZE_T count;
+	const index_desc* const indices = lookupDependencies(tdbb, relation, count);
+
+	for (FB_SIZE_T i = 0; i < count; i++)
 	{
-		postError(tdbb->tdbb_status_vector, ex);
-		throw;
+		index_desc dep = indices[i];
+		USHORT relId = relation->rel_id;
+		USHORT idxId = dep.idx_id;
+		temporary_key key;
+
+		if (dep.idx_flags & idx_foreign)
+		{
+			// Order the change after the changes of the referenced record
+
+			if (!makePartnerKey(tdbb, relation, record, dep, key))
+				return false;
+
+			if (!key.key_length)
+				continue;
+
+			relId = dep.idx_primary_relation;
+			idxId = dep.idx_primary_index;
+		}
+		else
+		{
+			if (BTR_key(tdbb, relation, record, &dep, &key, false) != idx_e_ok)
+				return false;
+
+			// NULLs don't conflict in the unique keys other than the chosen one
+
+			if (key.key_nulls && dep.idx_id != idx.idx_id)
+				continue;
+		}
+
+		string& value = keys.add();
+		value.assign((const char*) &relId, sizeof(USHORT));
+		value.append((const char*) &idxId, sizeof(USHORT));
+		value.append((const char*) key.key_data, key.key_length);
 	}
+
+	return true;
+}
+
+// Find the primary/unique and foreign key indices of the relation. They are looked
+// up once per block, like the keys, the result is valid till the next call.
+
+const index_desc* Applier::lookupDependencies(thread_db* tdbb, jrd_rel* relation, FB_SIZE_T& count)
+{
+	DependencyIndices slice;
+
+	if (!m_depMap.get(relation->rel_id, slice))
+	{
+		HalfStaticArray<index_desc, 8> indices;
+
+		RelationPages* const relPages = relation->getPages(tdbb);
+		auto page = relPages->rel_index_root;
+		if (!page)
+		{
+			DPM_scan_pages(tdbb);
+			page = relPages->rel_index_root;
+		}
+
+		const PageNumber root_page(relPages->rel_pg_space_id, page);
+		win window(root_page);
+		const auto root = (index_root_page*) CCH_FETCH(tdbb, &window, LCK_read, pag_root);
+
+		index_desc idx;
+
+		for (USHORT i = 0; i < root->irt_count; i++)
+		{
+			if (BTR_description(tdbb, relation, root, &idx, i) &&
+				!(idx.idx_flags & idx_expressn) &&
+				(idx.idx_flags & (idx_primary | idx_unique | idx_foreign)))
+			{
+				indices.add(idx);
+			}
+		}
+
+		CCH_RELEASE(tdbb, &window);
+
+		// Foreign keys with inactive partner are not checked, thus they order nothing
+
+		slice.first = m_depIndices.getCount();
+
+		for (auto& dep : indices)
+		{
+			if (!(dep.idx_flags & idx_foreign) || MET_lookup_partner(tdbb, relation, &dep, NULL))
+				m_depIndices.add(dep);
+		}
+
+		slice.count = m_depIndices.getCount() - slice.first;
+		m_depMap.put(relation->rel_id, slice);
+	}
+
+	count = slice.count;
+	return m_depIndices.begin() + slice.first;
+}
+
+// Make the key of the record referred by the foreign key as its partner index does.
+// Key length is zero if the foreign key contains NULLs and thus refers no record.
+// Returns false if the key can't be made.
+
+bool Applier::makePartnerKey(thread_db* tdbb, jrd_rel* relation, Record* record,
+							 const index_desc& idx, temporary_key& key)
+{
+	key.key_length = 0;
+
+	const auto partner = MET_relation(tdbb, idx.idx_primary_relation);
+
+	if (!(partner->rel_flags & REL_scanned))
+		MET_scan_relation(tdbb, partner);
+
+	index_desc partnerIdx;
+	if (!BTR_lookup(tdbb, partner, idx.idx_primary_index, &partnerIdx, partner->getPages(tdbb)) ||
+		partnerIdx.idx_count != idx.idx_count)
+	{
+		return false;
+	}
+
+	const auto format = MET_current(tdbb, partner);
+
+	record_param rpb;
+	rpb.rpb_relation = partner;
+
+	rpb.rpb_record = m_partnerRecord;
+	const auto partnerRecord = m_partnerRecord =
+		VIO_record(tdbb, &rpb, format, m_request->req_pool);
+
+	partnerRecord->nullify();
+
+	for (USHORT i = 0; i < idx.idx_count; i++)
+	{
+		dsc from;
+		if (!EVL_field(relation, record, idx.idx_rpt[i].idx_field, &from))
+			return true;
+
+		const USHORT id = partnerIdx.idx_rpt[i].idx_field;
+		dsc to = format->fmt_desc[id];
+		to.dsc_address = partnerRecord->getData() + (IPTR) to.dsc_address;
+
+		MOV_move(tdbb, &from, &to);
+		partnerRecord->clearNull(id);
+	}
+
+	return (BTR_key(tdbb, partner, partnerRecord, &partnerIdx, &key, false) == idx_e_ok);
 }
 
 void Applier::startTransaction(thread_db* tdbb, TraNumber traNum)
@@ -790,10 +1645,16 @@ void Applier::executeSql(thread_db* tdbb,
 	DSQL_execute_immediate(tdbb, attachment, &transaction,
 						   0, sql.c_str(), dialect,
 						   NULL, NULL, NULL, NULL, false);
+
+	// Keys may be changed
+	m_keyMap.clear();
 }
 
 bool Applier::lookupKey(thread_db* tdbb, jrd_rel* relation, index_desc& key)
 {
+	if (m_keyMap.get(relation->rel_id, key))
+		return (key.idx_id != idx_invalid);
+
 	RelationPages* const relPages = relation->getPages(tdbb);
 	auto page = relPages->rel_index_root;
 	if (!page)
@@ -831,6 +1692,8 @@ bool Applier::lookupKey(thread_db* tdbb, jrd_rel* relation, index_desc& key)
 
 	CCH_RELEASE(tdbb, &window);
 
+	m_keyMap.put(relation->rel_id, key);
+
 	return (key.idx_id != idx_invalid);
 }
 
@@ -25,18 +25,35 @@
 #define JRD_REPLICATION_APPLIER_H
 
 #include "../common/classes/array.h"
+#include "../common/classes/fb_atomic.h"
 #include "../common/classes/GenericMap.h"
+#include "../common/classes/objects_array.h"
 #include "../jrd/jrd.h"
+#include "../jrd/btr.h"
 #include "../jrd/tra.h"
 
 #include "Utils.h"
 
 namespace Jrd
 {
+	class ApplyWorkers;
+
 	class Applier : private Firebird::PermanentStorage
 	{
+		friend class ApplyWorkers;
+
 		typedef Firebird::GenericMap<Firebird::Pair<Firebird::NonPooled<TraNumber, jrd_tra*> > > TransactionMap;
+		typedef Firebird::GenericMap<Firebird::Pair<Firebird::NonPooled<USHORT, index_desc> > > KeyMap;
 		typedef Firebird::HalfStaticArray<bid, 16> BlobList;
+
+		// Part of m_depIndices describing the indices of a relation
+		struct DependencyIndices
+		{
+			FB_SIZE_T first;
+			FB_SIZE_T count;
+		};
+
+		typedef Firebird::GenericMap<Firebird::Pair<Firebird::NonPooled<USHORT, DependencyIndices> > > DependencyMap;
 /*
 		class ReplicatedTransaction : public Firebird::IReplicatedTransaction
 		{
@@ -125,11 +142,9 @@ namespace Jrd
 	public:
 		Applier(Firebird::MemoryPool& pool,
 				const Firebird::PathName& database,
-				Jrd::jrd_req* request)
-			: PermanentStorage(pool),
-			  m_txnMap(pool), m_database(pool, database),
-			  m_request(request), m_bitmap(FB_NEW_POOL(pool) RecordBitmap(pool)), m_record(NULL)
-		{}
+				Jrd::jrd_req* request);
+
+		~Applier();
 
 		static Applier* create(thread_db* tdbb);
 
@@ -137,12 +152,35 @@ namespace Jrd
 
 		void shutdown(thread_db* tdbb);
 
+		// Milliseconds between the replication of the last applied block and its apply
+		SINT64 getLag() const;
+		// Blocks received but not applied yet by the parallel workers
+		SINT64 getQueueLength() const;
+
 	private:
 		TransactionMap m_txnMap;
+		KeyMap m_keyMap;		// keys chosen by lookupKey() while applying the current block
 		const Firebird::PathName m_database;
 		jrd_req* m_request;
 		Firebird::AutoPtr<RecordBitmap> m_bitmap;
 		Record* m_record;
+		DependencyMap m_depMap;			// indices chosen by lookupDependencies() for the current block
+		Firebird::Array<index_desc> m_depIndices;
+		Record* m_partnerRecord;
+		Firebird::AutoPtr<ApplyWorkers> m_workers;
+		Firebird::AtomicCounter m_lag;
+
+		static Applier* make(thread_db* tdbb);
+
+		void apply(thread_db* tdbb, ULONG length, const UCHAR* data);
+		bool getKeys(thread_db* tdbb, ULONG length, const UCHAR* data,
+					 Firebird::ObjectsArray<Firebird::string>& keys, bool& commit);
+		bool addKey(thread_db* tdbb, const Firebird::MetaName& relName,
+					ULONG length, const UCHAR* data,
+					Firebird::ObjectsArray<Firebird::string>& keys);
+		const index_desc* lookupDependencies(thread_db* tdbb, jrd_rel* relation, FB_SIZE_T& count);
+		bool makePartnerKey(thread_db* tdbb, jrd_rel* relation, Record* record,
+							const index_desc& idx, temporary_key& key);
 
 		void startTransaction(thread_db* tdbb, TraNumber traNum);
 		void prepareTransaction(thread_db* tdbb, TraNumber traNum);
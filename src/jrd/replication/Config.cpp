@@ -56,6 +56,7 @@ namespace
 	const ULONG DEFAULT_LOG_GROUP_FLUSH_DELAY = 0;
 	const ULONG DEFAULT_APPLY_IDLE_TIMEOUT = 10;				// seconds
 	const ULONG DEFAULT_APPLY_ERROR_TIMEOUT = 60;				// seconds
+	const ULONG DEFAULT_APPLY_PARALLEL_WORKERS = 1;
 
 	void parseLong(const string& input, ULONG& output)
 	{
@@ -99,7 +100,8 @@ Config::Config()
 	  logSourceDirectory(getPool()),
 	  verboseLogging(false),
 	  applyIdleTimeout(DEFAULT_APPLY_IDLE_TIMEOUT),
-	  applyErrorTimeout(DEFAULT_APPLY_ERROR_TIMEOUT)
+	  applyErrorTimeout(DEFAULT_APPLY_ERROR_TIMEOUT),
+	  applyParallelWorkers(DEFAULT_APPLY_PARALLEL_WORKERS)
 {
 	sourceGuid.alignment = 0;
 }
@@ -121,7 +123,8 @@ Config::Config(const Config& other)
 	  logSourceDirectory(getPool(), other.logSourceDirectory),
 	  verboseLogging(other.verboseLogging),
 	  applyIdleTimeout(other.applyIdleTimeout),
-	  applyErrorTimeout(other.applyErrorTimeout)
+	  applyErrorTimeout(other.applyErrorTimeout),
+	  applyParallelWorkers(other.applyParallelWorkers)
 {
 	sourceGuid.alignment = 0;
 }
@@ -319,6 +322,10 @@ void Config::enumerate(Firebird::Array<Config*>& replicas)
 				{
 					parseLong(value, config->applyErrorTimeout);
 				}
+				else if (key == "apply_parallel_workers")
+				{
+					parseLong(value, config->applyParallelWorkers);
+				}
 			}
 		}
 
@@ -51,6 +51,7 @@ class jrd_tra;
 class Savepoint;
 class Cursor;
 class thread_db;
+class DeferredIndexKeys;
 
 // record parameter block
 
@@ -118,6 +119,7 @@ const USHORT rpb_damaged		= 128;		// record is busted
 const USHORT rpb_gc_active		= 256;		// garbage collecting dead record version
 const USHORT rpb_uk_modified	= 512;		// record key field values are changed
 const USHORT rpb_long_tranum	= 1024;		// transaction number is 64-bit
+const USHORT rpb_lz				= 2048;		// data is packed with the LZ codec
 
 // Stream flags
 
@@ -182,7 +184,8 @@ public:
 		  req_sorts(*req_pool),
 		  req_rpb(*req_pool),
 		  impureArea(*req_pool),
-		  req_auto_trans(*req_pool)
+		  req_auto_trans(*req_pool),
+		  req_deferred_keys(NULL)
 	{
 		fb_assert(statement);
 		setAttachment(attachment);
@@ -337,6 +340,8 @@ public:
 
 	StatusXcp req_last_xcp;			// last known exception
 	bool req_batch_mode;
+	LatencyHistogram req_latency;	// execution times of the DSQL statement
+	DeferredIndexKeys* req_deferred_keys;	// index keys of the bulk loaded relation, if any
 
 	template <typename T> T* getImpure(unsigned offset)
 	{
@@ -470,7 +470,6 @@ void SDW_dump_pages(thread_db* tdbb)
 
 	for (SLONG page_number = HEADER_PAGE + 1; page_number <= max; page_number++)
 	{
-#ifdef SUPERSERVER_V2
 		if (!(page_number % dbb->dbb_prefetch_sequence))
 		{
 			SLONG pages[PREFETCH_MAX_PAGES];
@@ -483,7 +482,7 @@ void SDW_dump_pages(thread_db* tdbb)
 
 			CCH_PREFETCH(tdbb, pages, i);
 		}
-#endif
+
 		for (Shadow* shadow = dbb->dbb_shadow; shadow; shadow = shadow->sdw_next)
 		{
 			if (!(shadow->sdw_flags & (SDW_INVALID | SDW_dumped)))
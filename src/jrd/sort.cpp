@@ -42,6 +42,10 @@
 #include "../jrd/val.h"
 #include "../jrd/err_proto.h"
 #include "../yvalve/gds_proto.h"
+#include "../common/isc_proto.h"
+#include "../common/utils_proto.h"
+#include "../common/ThreadStart.h"
+#include "../common/classes/semaphore.h"
 
 #ifdef HAVE_SYS_TYPES_H
 #include <sys/types.h>
@@ -157,6 +161,253 @@ namespace
 } // namespace
 
 
+namespace Jrd {
+
+// Worker threads of a sort. The attachment keeps filling the sort buffer
+// while the full buffers handed over to the workers are being ordered and
+// written as runs into the temp space. Every buffer is either the current
+// one of the sort or owned by SortWorkers, so their number never exceeds
+// the number of workers plus one.
+
+class SortWorkers
+{
+	typedef ThreadFinishSync<SortWorkers*> WorkerThread;
+
+public:
+	SortWorkers(MemoryPool& pool, Sort* sort)
+		: m_pool(pool), m_sort(sort), m_threads(pool), m_buffers(pool),
+		  m_queue(pool), m_free(pool), m_pending(0), m_shutdown(false),
+		  m_runs(0), m_time(0)
+	{}
+
+	~SortWorkers()
+	{
+		shutdown();
+
+		for (sort_buffer** iter = m_buffers.begin(); iter != m_buffers.end(); ++iter)
+			delete *iter;
+	}
+
+	// Start up to count threads, return the number of running ones
+	unsigned start(unsigned count)
+	{
+		try
+		{
+			while (m_threads.getCount() < count)
+			{
+				AutoPtr<WorkerThread> thread(FB_NEW_POOL(m_pool) WorkerThread(m_pool, worker, THREAD_medium));
+				thread->run(this);
+				m_threads.add(thread.release());
+			}
+		}
+		catch (const Exception& ex)
+		{
+			exceptionHandler(ex, worker);
+		}
+
+		return m_threads.getCount();
+	}
+
+	// Get a buffer to continue the sort with, waiting for a busy worker if
+	// necessary. A new buffer has no memory allocated yet.
+	sort_buffer* getBuffer()
+	{
+		while (true)
+		{
+			{	// scope
+				MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+				checkStatus();
+
+				if (m_free.hasData())
+					return m_free.pop();
+
+				if (m_buffers.getCount() < m_threads.getCount())
+				{
+					sort_buffer* const buffer = FB_NEW_POOL(m_pool) sort_buffer;
+					memset(buffer, 0, sizeof(sort_buffer));
+					m_buffers.add(buffer);
+					return buffer;
+				}
+			}
+
+			m_done.enter();
+		}
+	}
+
+	// Return a buffer which is not going to be used
+	void release(sort_buffer* buffer)
+	{
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+		m_free.push(buffer);
+	}
+
+	void put(sort_buffer* buffer)
+	{
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_queue.add(buffer);
+			m_pending++;
+		}
+
+		m_work.release();
+	}
+
+	// Wait until all runs are written
+	void wait()
+	{
+		while (true)
+		{
+			{	// scope
+				MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+				if (!m_pending)
+				{
+					checkStatus();
+					return;
+				}
+			}
+
+			m_done.enter();
+		}
+	}
+
+	void shutdown()
+	{
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_shutdown = true;
+		}
+
+		if (m_threads.hasData())
+			m_work.release(m_threads.getCount());
+
+		while (m_threads.hasData())
+		{
+			WorkerThread* const thread = m_threads.pop();
+			thread->waitForCompletion();
+			delete thread;
+		}
+	}
+
+	const HalfStaticArray<sort_buffer*, 8>& getBuffers() const
+	{
+		return m_buffers;
+	}
+
+	ULONG getRuns() const
+	{
+		return m_runs;
+	}
+
+	// Time spent by workers, in milliseconds
+	SINT64 getTime() const
+	{
+		return m_time * 1000 / fb_utils::query_performance_frequency();
+	}
+
+	void exceptionHandler(const Exception& ex, WorkerThread::ThreadRoutine*)
+	{
+		FbLocalStatus status_vector;
+		ex.stuffException(&status_vector);
+		iscDbLogStatus(m_sort->m_dbb->dbb_filename.c_str(), &status_vector);
+	}
+
+private:
+	static void worker(SortWorkers* workers)
+	{
+		workers->run();
+	}
+
+	void run()
+	{
+		while (true)
+		{
+			m_work.enter();
+
+			sort_buffer* buffer = NULL;
+			bool failed = false;
+
+			{	// scope
+				MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+				if (m_shutdown)
+					return;
+
+				if (m_queue.isEmpty())
+					continue;
+
+				buffer = m_queue[0];
+				m_queue.remove((FB_SIZE_T) 0);
+				failed = !m_status.isSuccess();
+			}
+
+			const SINT64 start = fb_utils::query_performance_counter();
+
+			if (!failed)
+			{
+				try
+				{
+					m_sort->sortBuffer(*buffer);
+					m_sort->orderAndSave(*buffer);
+				}
+				catch (const Exception& ex)
+				{
+					MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+					if (m_status.isSuccess())
+						ex.stuffException(&m_status);
+				}
+			}
+
+			{	// scope
+				MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+				m_time += fb_utils::query_performance_counter() - start;
+				m_runs++;
+				m_pending--;
+				m_free.push(buffer);
+			}
+
+			m_done.release();
+		}
+	}
+
+	// Raise the error of a worker as a sort error, called with m_mutex locked
+	void checkStatus()
+	{
+		if (m_status.isSuccess())
+			return;
+
+		const ISC_STATUS* const errors = m_status->getErrors();
+
+		if (errors[1] == isc_sort_err)
+			status_exception::raise(&m_status);
+
+		Firebird::Arg::Gds status(isc_sort_err);
+		status.append(Firebird::Arg::StatusVector(errors));
+		status.raise();
+	}
+
+	MemoryPool& m_pool;
+	Sort* const m_sort;
+	HalfStaticArray<WorkerThread*, 8> m_threads;
+	HalfStaticArray<sort_buffer*, 8> m_buffers;		// all buffers owned by workers
+	HalfStaticArray<sort_buffer*, 8> m_queue;		// buffers to be saved as runs
+	HalfStaticArray<sort_buffer*, 8> m_free;		// saved buffers ready for reuse
+	Mutex m_mutex;
+	Semaphore m_work;								// wakes up workers
+	Semaphore m_done;								// signals a buffer is saved
+	ULONG m_pending;
+	bool m_shutdown;
+	FbLocalStatus m_status;							// first error of any worker
+	ULONG m_runs;
+	SINT64 m_time;
+};
+
+} // namespace Jrd
+
+
 Sort::Sort(Database* dbb,
 		   SortOwner* owner,
 		   ULONG record_length,
@@ -168,7 +419,7 @@ Sort::Sort(Database* dbb,
 		   FB_UINT64 max_records)
 	: m_dbb(dbb), m_last_record(NULL), m_next_pointer(NULL), m_records(0),
 	  m_runs(NULL), m_merge(NULL), m_free_runs(NULL),
-	  m_flags(0), m_merge_pool(NULL),
+	  m_flags(0), m_merge_pool(NULL), m_workers(NULL),
 	  m_description(owner->getPool(), keys)
 {
 /**************************************
@@ -226,7 +477,7 @@ Sort::Sort(Database* dbb,
 
 		// Next, try to allocate a "big block". How big? Big enough!
 
-		allocateBuffer(pool);
+		m_memory = allocateBuffer(pool, m_size_memory);
 
 		m_end_memory = m_memory + m_size_memory;
 		m_first_pointer = (sort_record**) m_memory;
@@ -239,7 +490,7 @@ Sort::Sort(Database* dbb,
 		}
 		catch (const Exception&)
 		{
-			releaseBuffer();
+			releaseBuffer(m_memory, m_size_memory);
 			throw;
 		}
 
@@ -270,13 +521,16 @@ Sort::~Sort()
 	// Unlink the sort
 	m_owner->unlinkSort(this);
 
+	// Stop the workers before the temporary space goes away
+	stopWorkers();
+
 	// Release the temporary space
 	delete m_space;
 
 	// If runs are allocated and not in the big block, release them.
 	// Then release the big block.
 
-	releaseBuffer();
+	releaseBuffer(m_memory, m_size_memory);
 
 	// Clean up the runs that were used
 
@@ -401,6 +655,7 @@ void Sort::put(thread_db* tdbb, ULONG** record_address)
 					count++;
 				if (count < RUN_GROUP)
 					break;
+				waitForWorkers(tdbb);
 				mergeRuns(count);
 			}
 			init();
@@ -457,7 +712,14 @@ void Sort::sort(thread_db* tdbb)
 		// and we're ready for output.
 		if (!m_runs)
 		{
-			sortBuffer(tdbb);
+			sort_buffer buffer;
+			saveBuffer(buffer);
+
+			{	// scope
+				EngineCheckout cout(tdbb, FB_FUNCTION);
+				sortBuffer(buffer);
+			}
+
 			m_next_pointer = m_first_pointer + 1;
 			m_flags |= scb_sorted;
 			return;
@@ -466,6 +728,7 @@ void Sort::sort(thread_db* tdbb)
 		// Write the last records as a run_control
 
 		putRun(tdbb);
+		finishWorkers(tdbb);
 
 		CHECK_FILE(NULL);
 
@@ -629,7 +892,42 @@ void Sort::sort(thread_db* tdbb)
 }
 
 
-void Sort::allocateBuffer(MemoryPool& pool)
+FB_UINT64 Sort::readBlock(TempSpace* space, FB_UINT64 seek, UCHAR* address, ULONG length)
+{
+/**************************************
+ *
+ * Read a block of the scratch space. The time spent
+ * reading a block not kept in memory is accounted as
+ * a wait of the attachment, if we run on its behalf.
+ *
+ **************************************/
+	thread_db::WaitGuard waitGuard(space->inMemory(seek, length) ? NULL : JRD_get_thread_data(),
+		RuntimeStatistics::TEMP_WAITS);
+
+	const size_t bytes = space->read(seek, address, length);
+	fb_assert(bytes == length);
+	return seek + bytes;
+}
+
+
+FB_UINT64 Sort::writeBlock(TempSpace* space, FB_UINT64 seek, UCHAR* address, ULONG length)
+{
+/**************************************
+ *
+ * Write a block of the scratch space, accounting
+ * the wait as in readBlock().
+ *
+ **************************************/
+	thread_db::WaitGuard waitGuard(space->inMemory(seek, length) ? NULL : JRD_get_thread_data(),
+		RuntimeStatistics::TEMP_WAITS);
+
+	const size_t bytes = space->write(seek, address, length);
+	fb_assert(bytes == length);
+	return seek + bytes;
+}
+
+
+UCHAR* Sort::allocateBuffer(MemoryPool& pool, ULONG& size)
 {
 	if (m_dbb->dbb_sort_buffers.hasData() && m_max_alloc_size <= MAX_SORT_BUFFER_SIZE)
 	{
@@ -638,9 +936,8 @@ void Sort::allocateBuffer(MemoryPool& pool)
 		if (m_dbb->dbb_sort_buffers.hasData())
 		{
 			// The sort buffer cache has at least one big block, let's use it
-			m_size_memory = MAX_SORT_BUFFER_SIZE;
-			m_memory = m_dbb->dbb_sort_buffers.pop();
-			return;
+			size = MAX_SORT_BUFFER_SIZE;
+			return m_dbb->dbb_sort_buffers.pop();
 		}
 	}
 
@@ -654,8 +951,8 @@ void Sort::allocateBuffer(MemoryPool& pool)
 
 	try
 	{
-		m_size_memory = m_max_alloc_size;
-		m_memory = FB_NEW_POOL(*m_dbb->dbb_permanent) UCHAR[m_size_memory];
+		size = m_max_alloc_size;
+		return FB_NEW_POOL(*m_dbb->dbb_permanent) UCHAR[size];
 	}
 	catch (const BadAlloc&)
 	{
@@ -665,13 +962,12 @@ void Sort::allocateBuffer(MemoryPool& pool)
 		{
 			try
 			{
-				m_size_memory /= 2;
-				m_memory = FB_NEW_POOL(pool) UCHAR[m_size_memory];
-				break;
+				size /= 2;
+				return FB_NEW_POOL(pool) UCHAR[size];
 			}
 			catch (const BadAlloc&)
 			{
-				if (m_size_memory <= m_min_alloc_size)
+				if (size <= m_min_alloc_size)
 					throw;
 			}
 		}
@@ -679,7 +975,7 @@ void Sort::allocateBuffer(MemoryPool& pool)
 }
 
 
-void Sort::releaseBuffer()
+void Sort::releaseBuffer(UCHAR* memory, ULONG size)
 {
 	// Here we cache blocks to be reused later, but only the biggest ones
 
@@ -687,13 +983,13 @@ void Sort::releaseBuffer()
 
 	SyncLockGuard guard(&m_dbb->dbb_sortbuf_sync, SYNC_EXCLUSIVE, "Sort::releaseBuffer");
 
-	if (m_size_memory == MAX_SORT_BUFFER_SIZE &&
+	if (size == MAX_SORT_BUFFER_SIZE &&
 		m_dbb->dbb_sort_buffers.getCount() < MAX_CACHED_SORT_BUFFERS)
 	{
-		m_dbb->dbb_sort_buffers.push(m_memory);
+		m_dbb->dbb_sort_buffers.push(memory);
 	}
 	else
-		delete[] m_memory;
+		delete[] memory;
 }
 
 
@@ -1399,7 +1695,7 @@ void Sort::init()
 		{
 			UCHAR* const mem = FB_NEW_POOL(m_owner->getPool()) UCHAR[mem_size];
 
-			releaseBuffer();
+			releaseBuffer(m_memory, m_size_memory);
 
 			m_size_memory = mem_size;
 			m_memory = mem;
@@ -1858,7 +2154,7 @@ void Sort::quick(SLONG size, SORTP** pointers, ULONG length)
 }
 
 
-ULONG Sort::order()
+ULONG Sort::order(const sort_buffer& buffer)
 {
 /**************************************
  *
@@ -1868,22 +2164,22 @@ ULONG Sort::order()
  * can be written with a single disk write.
  *
  **************************************/
-	sort_record** ptr = m_first_pointer + 1;	// 1st ptr is low key
+	sort_record** ptr = buffer.sbf_first_pointer + 1;	// 1st ptr is low key
 
 	// Last inserted record, also the top of the memory where SORT_RECORDS can
 	// be written
-	sort_record* output = reinterpret_cast<sort_record*>(m_last_record);
+	sort_record* output = reinterpret_cast<sort_record*>(buffer.sbf_last_record);
 	sort_ptr_t* lower_limit = reinterpret_cast<sort_ptr_t*>(output);
 
 	HalfStaticArray<ULONG, 1024> record_buffer(m_owner->getPool());
-	SORTP* buffer = record_buffer.getBuffer(m_longs);
+	SORTP* temp = record_buffer.getBuffer(m_longs);
 
 	// Length of the key part of the record
 	const ULONG length = m_longs - SIZEOF_SR_BCKPTR_IN_LONGS;
 
-	// m_next_pointer points to the end of pointer memory or the beginning of
+	// sbf_next_pointer points to the end of pointer memory or the beginning of
 	// records
-	while (ptr < m_next_pointer)
+	while (ptr < buffer.sbf_next_pointer)
 	{
 		// If the next pointer is null, it's record has been eliminated as a
 		// duplicate. This is the only easy case.
@@ -1899,7 +2195,7 @@ ULONG Sort::order()
 		// If the lower limit of live records points to a deleted or used record,
 		// advance the lower limit
 
-		while (!*(lower_limit) && (lower_limit < (sort_ptr_t*) m_end_memory))
+		while (!*(lower_limit) && (lower_limit < (sort_ptr_t*) buffer.sbf_end_memory))
 		{
 			lower_limit = reinterpret_cast<sort_ptr_t*>(((SORTP*) lower_limit) + m_longs);
 		}
@@ -1928,23 +2224,23 @@ ULONG Sort::order()
 		// next record's old position (adjusting pointers as we go), then move
 		// the current record to output.
 
-		MOVE_32(length, (SORTP*) record->sr_sort_record.sort_record_key, buffer);
+		MOVE_32(length, (SORTP*) record->sr_sort_record.sort_record_key, temp);
 
 		**((sort_ptr_t***) lower_limit) =
 			reinterpret_cast<sort_ptr_t*>(record->sr_sort_record.sort_record_key);
 		MOVE_32(m_longs, lower_limit, record);
 		lower_limit = (sort_ptr_t*) ((SORTP*) lower_limit + m_longs);
 
-		MOVE_32(length, buffer, output);
+		MOVE_32(length, temp, output);
 		output = reinterpret_cast<sort_record*>((sort_ptr_t*) ((SORTP*) output + length));
 	}
 
 	return (((SORTP*) output) -
-			((SORTP*) m_last_record)) / (m_longs - SIZEOF_SR_BCKPTR_IN_LONGS);
+			((SORTP*) buffer.sbf_last_record)) / (m_longs - SIZEOF_SR_BCKPTR_IN_LONGS);
 }
 
 
-void Sort::orderAndSave(thread_db* tdbb)
+void Sort::orderAndSave(const sort_buffer& buffer)
 {
 /**************************************
  *
@@ -1956,14 +2252,12 @@ void Sort::orderAndSave(thread_db* tdbb)
  * scratch file as one big chunk
  *
  **************************************/
-	EngineCheckout(tdbb, FB_FUNCTION);
-
-	run_control* run = m_runs;
+	run_control* run = buffer.sbf_run;
 	run->run_records = 0;
 
-	sort_record** ptr = m_first_pointer + 1; // 1st ptr is low key
-	// m_next_pointer points to the end of pointer memory or the beginning of records
-	while (ptr < m_next_pointer)
+	sort_record** ptr = buffer.sbf_first_pointer + 1; // 1st ptr is low key
+	// sbf_next_pointer points to the end of pointer memory or the beginning of records
+	while (ptr < buffer.sbf_next_pointer)
 	{
 		// If the next pointer is null, it's record has been eliminated as a
 		// duplicate.  This is the only easy case.
@@ -1975,14 +2269,23 @@ void Sort::orderAndSave(thread_db* tdbb)
 
 	const ULONG key_length = (m_longs - SIZEOF_SR_BCKPTR_IN_LONGS) * sizeof(ULONG);
 	run->run_size = run->run_records * key_length;
-	run->run_seek = m_space->allocateSpace(run->run_size);
 
-	UCHAR* mem = m_space->inMemory(run->run_seek, run->run_size);
+	UCHAR* mem;
+
+	{	// scope
+		MutexLockGuard guard(m_sync, FB_FUNCTION);
+
+		run->run_seek = m_space->allocateSpace(run->run_size);
+		mem = m_space->inMemory(run->run_seek, run->run_size);
+	}
+
+	// Memory blocks of the temp space are never moved, so the records
+	// can be copied without holding the lock
 
 	if (mem)
 	{
-		ptr = m_first_pointer + 1;
-		while (ptr < m_next_pointer)
+		ptr = buffer.sbf_first_pointer + 1;
+		while (ptr < buffer.sbf_next_pointer)
 		{
 			SR* record = (SR*) (*ptr++);
 
@@ -1999,8 +2302,10 @@ void Sort::orderAndSave(thread_db* tdbb)
 	}
 	else
 	{
-		order();
-		writeBlock(m_space, run->run_seek, (UCHAR*) m_last_record, run->run_size);
+		order(buffer);
+
+		MutexLockGuard guard(m_sync, FB_FUNCTION);
+		writeBlock(m_space, run->run_seek, (UCHAR*) buffer.sbf_last_record, run->run_size);
 	}
 }
 
@@ -2030,19 +2335,106 @@ void Sort::putRun(thread_db* tdbb)
 	run->run_header.rmh_type = RMH_TYPE_RUN;
 	run->run_depth = 0;
 
+	if (!m_workers)
+	{
+		const Attachment* const attachment = tdbb->getAttachment();
+		const unsigned workers = attachment ?
+			attachment->getParallelWorkers() : m_dbb->dbb_config->getParallelWorkers();
+
+		if (workers > 1)
+			startWorkers(workers - 1);
+	}
+
+	if (m_workers)
+	{
+		// Hand the full buffer over to a worker and continue with a spare one
+
+		sort_buffer* buffer;
+
+		{	// scope
+			EngineCheckout cout(tdbb, FB_FUNCTION);
+			buffer = m_workers->getBuffer();
+		}
+
+		if (buffer->sbf_size_memory < m_size_memory)
+		{
+			// Spare buffers follow the growth of the sort buffer, see init()
+
+			if (buffer->sbf_memory)
+			{
+				releaseBuffer(buffer->sbf_memory, buffer->sbf_size_memory);
+				buffer->sbf_memory = NULL;
+				buffer->sbf_size_memory = 0;
+			}
+
+			try
+			{
+				if (m_size_memory > m_max_alloc_size)
+				{
+					buffer->sbf_memory = FB_NEW_POOL(m_owner->getPool()) UCHAR[m_size_memory];
+					buffer->sbf_size_memory = m_size_memory;
+				}
+				else
+					buffer->sbf_memory = allocateBuffer(m_owner->getPool(), buffer->sbf_size_memory);
+			}
+			catch (const Exception&)
+			{
+				buffer->sbf_size_memory = 0;
+				m_workers->release(buffer);
+				throw;
+			}
+		}
+
+		UCHAR* const memory = buffer->sbf_memory;
+		const ULONG size = buffer->sbf_size_memory;
+
+		saveBuffer(*buffer);
+		buffer->sbf_run = run;
+		m_workers->put(buffer);
+
+		m_memory = memory;
+		m_size_memory = size;
+		m_end_memory = m_memory + m_size_memory;
+		m_first_pointer = (sort_record**) m_memory;
+		return;
+	}
+
+	sort_buffer buffer;
+	saveBuffer(buffer);
+	buffer.sbf_run = run;
+
+	EngineCheckout cout(tdbb, FB_FUNCTION);
+
 	// Do the in-core sort. The first phase a duplicate handling we be performed
 	// in "sort".
 
-	sortBuffer(tdbb);
+	sortBuffer(buffer);
 
 	// Re-arrange records in physical order so they can be dumped in a single write
 	// operation
 
-	orderAndSave(tdbb);
+	orderAndSave(buffer);
+}
+
+
+void Sort::saveBuffer(sort_buffer& buffer) const
+{
+/**************************************
+ *
+ * Describe the current sort buffer.
+ *
+ **************************************/
+	buffer.sbf_memory = m_memory;
+	buffer.sbf_end_memory = m_end_memory;
+	buffer.sbf_size_memory = m_size_memory;
+	buffer.sbf_last_record = m_last_record;
+	buffer.sbf_first_pointer = m_first_pointer;
+	buffer.sbf_next_pointer = m_next_pointer;
+	buffer.sbf_run = NULL;
 }
 
 
-void Sort::sortBuffer(thread_db* tdbb)
+void Sort::sortBuffer(const sort_buffer& buffer)
 {
 /**************************************
  *
@@ -2052,23 +2444,22 @@ void Sort::sortBuffer(thread_db* tdbb)
  * been requested, detect and handle them.
  *
  **************************************/
-	EngineCheckout(tdbb, FB_FUNCTION);
 
 	// First, insert a pointer to the high key
 
-	*m_next_pointer = reinterpret_cast<sort_record*>(high_key);
+	*buffer.sbf_next_pointer = reinterpret_cast<sort_record*>(high_key);
 
 	// Next, call QuickSort. Keep in mind that the first pointer is the
 	// low key and not a record.
 
-	SORTP** j = (SORTP**) (m_first_pointer) + 1;
-	const ULONG n = (SORTP**) (m_next_pointer) - j;	// calculate # of records
+	SORTP** j = (SORTP**) (buffer.sbf_first_pointer) + 1;
+	const ULONG n = (SORTP**) (buffer.sbf_next_pointer) - j;	// calculate # of records
 
 	quick(n, j, m_longs);
 
 	// Scream through and correct any out of order pairs
 	// hvlad: don't compare user keys against high_key
-	while (j < (SORTP**) m_next_pointer - 1)
+	while (j < (SORTP**) buffer.sbf_next_pointer - 1)
 	{
 		SORTP** i = j;
 		j++;
@@ -2100,10 +2491,10 @@ void Sort::sortBuffer(thread_db* tdbb)
 	// slow pass, I suppose. Prove me wrong and win a trip for two to
 	// Cleveland, Ohio.
 
-	j = reinterpret_cast<SORTP**>(m_first_pointer + 1);
+	j = reinterpret_cast<SORTP**>(buffer.sbf_first_pointer + 1);
 
 	// hvlad: don't compare user keys against high_key
-	while (j < ((SORTP**) m_next_pointer) - 1)
+	while (j < ((SORTP**) buffer.sbf_next_pointer) - 1)
 	{
 		SORTP** i = j;
 		j++;
@@ -2119,7 +2510,15 @@ void Sort::sortBuffer(thread_db* tdbb)
 			diddleKey((UCHAR*) *i, false, true);
 			diddleKey((UCHAR*) *j, false, true);
 
-			if ((*m_dup_callback) ((const UCHAR*) *i, (const UCHAR*) *j, m_dup_callback_arg))
+			bool reject;
+
+			{	// scope
+				// Worker threads may call back concurrently
+				MutexLockGuard guard(m_sync, FB_FUNCTION);
+				reject = (*m_dup_callback) ((const UCHAR*) *i, (const UCHAR*) *j, m_dup_callback_arg);
+			}
+
+			if (reject)
 			{
 				((SORTP***) (*i))[BACK_OFFSET] = NULL;
 				*i = NULL;
@@ -2162,3 +2561,83 @@ void Sort::sortRunsBySeek(int n)
 	}
 	run->run_next = tail;
 }
+
+
+void Sort::startWorkers(unsigned count)
+{
+/**************************************
+ *
+ * Start threads ordering and saving runs in parallel with
+ * the caller, who keeps putting records into the sort.
+ *
+ **************************************/
+	m_workers = FB_NEW_POOL(m_owner->getPool()) SortWorkers(m_owner->getPool(), this);
+
+	// If no thread could be started, just continue single threaded
+
+	if (!m_workers->start(count))
+	{
+		delete m_workers;
+		m_workers = NULL;
+	}
+}
+
+
+void Sort::waitForWorkers(thread_db* tdbb)
+{
+/**************************************
+ *
+ * Wait until all runs handed over to workers are written.
+ *
+ **************************************/
+	if (m_workers)
+	{
+		EngineCheckout cout(tdbb, FB_FUNCTION);
+		m_workers->wait();
+	}
+}
+
+
+void Sort::finishWorkers(thread_db* tdbb)
+{
+/**************************************
+ *
+ * All the records are in, wait for the workers to complete
+ * and account their job.
+ *
+ **************************************/
+	if (!m_workers)
+		return;
+
+	waitForWorkers(tdbb);
+
+	tdbb->bumpStats(RuntimeStatistics::SORT_PARALLEL_RUNS, m_workers->getRuns());
+	tdbb->bumpStats(RuntimeStatistics::SORT_PARALLEL_TIME, m_workers->getTime());
+
+	stopWorkers();
+}
+
+
+void Sort::stopWorkers()
+{
+/**************************************
+ *
+ * Stop worker threads and release their buffers.
+ *
+ **************************************/
+	if (!m_workers)
+		return;
+
+	m_workers->shutdown();
+
+	const HalfStaticArray<sort_buffer*, 8>& buffers = m_workers->getBuffers();
+
+	for (sort_buffer* const* iter = buffers.begin(); iter != buffers.end(); ++iter)
+	{
+		if ((*iter)->sbf_memory)
+			releaseBuffer((*iter)->sbf_memory, (*iter)->sbf_size_memory);
+	}
+
+	delete m_workers;
+	m_workers = NULL;
+}
@@ -25,6 +25,7 @@
 #define JRD_SORT_H
 
 #include "../include/fb_blk.h"
+#include "../common/classes/locks.h"
 #include "../jrd/TempSpace.h"
 
 namespace Jrd {
@@ -32,6 +33,7 @@ namespace Jrd {
 // Forward declaration
 class Attachment;
 class SortOwner;
+class SortWorkers;
 struct merge_control;
 
 // SORTP is used throughout sort.c as a pointer into arrays of
@@ -246,6 +248,21 @@ struct merge_control
 };
 
 
+// Sort buffer being ordered and written into a run, either by the
+// sort itself or by one of its worker threads
+
+struct sort_buffer
+{
+	UCHAR*			sbf_memory;			// Memory for sort
+	UCHAR*			sbf_end_memory;		// End of memory
+	ULONG			sbf_size_memory;	// Bytes allocated
+	SR*				sbf_last_record;	// Address of last record
+	sort_record**	sbf_first_pointer;	// Pointer to the low key
+	sort_record**	sbf_next_pointer;	// Address for next pointer
+	run_control*	sbf_run;			// Run to be written
+};
+
+
 // Sort class
 
 typedef bool (*FPTR_REJECT_DUP_CALLBACK)(const UCHAR*, const UCHAR*, void*);
@@ -262,34 +279,30 @@ public:
 	void put(Jrd::thread_db*, ULONG**);
 	void sort(Jrd::thread_db*);
 
-	static FB_UINT64 readBlock(TempSpace* space, FB_UINT64 seek, UCHAR* address, ULONG length)
-	{
-		const size_t bytes = space->read(seek, address, length);
-		fb_assert(bytes == length);
-		return seek + bytes;
-	}
-
-	static FB_UINT64 writeBlock(TempSpace* space, FB_UINT64 seek, UCHAR* address, ULONG length)
-	{
-		const size_t bytes = space->write(seek, address, length);
-		fb_assert(bytes == length);
-		return seek + bytes;
-	}
+	static FB_UINT64 readBlock(TempSpace* space, FB_UINT64 seek, UCHAR* address, ULONG length);
+	static FB_UINT64 writeBlock(TempSpace* space, FB_UINT64 seek, UCHAR* address, ULONG length);
 
 private:
-	void allocateBuffer(MemoryPool&);
-	void releaseBuffer();
+	friend class SortWorkers;
+
+	UCHAR* allocateBuffer(MemoryPool&, ULONG&);
+	void releaseBuffer(UCHAR*, ULONG);
 
 	void diddleKey(UCHAR*, bool, bool);
 	sort_record* getMerge(merge_control*);
 	ULONG allocate(ULONG, ULONG, bool);
 	void init();
 	void mergeRuns(USHORT);
-	ULONG order();
-	void orderAndSave(Jrd::thread_db*);
+	ULONG order(const sort_buffer&);
+	void orderAndSave(const sort_buffer&);
 	void putRun(Jrd::thread_db*);
-	void sortBuffer(Jrd::thread_db*);
+	void saveBuffer(sort_buffer&) const;
+	void sortBuffer(const sort_buffer&);
 	void sortRunsBySeek(int);
+	void startWorkers(unsigned);
+	void waitForWorkers(Jrd::thread_db*);
+	void finishWorkers(Jrd::thread_db*);
+	void stopWorkers();
 
 #ifdef DEV_BUILD
 	void checkFile(const run_control*);
@@ -322,6 +335,9 @@ private:
 	ULONG m_min_alloc_size;						// MIN and MAX values
 	ULONG m_max_alloc_size;						// for the run buffer size
 
+	SortWorkers* m_workers;						// ALLOC: threads ordering and saving runs
+	Firebird::Mutex m_sync;						// Temp space and duplicates callback vs workers
+
 	Firebird::Array<sort_key_def> m_description;
 };
 
@@ -30,10 +30,125 @@
 
 using namespace Jrd;
 
+namespace
+{
+	// The LZ codec produces the sequences of a token byte (the literals count
+	// in the high nibble, the match length less LZ_MIN_MATCH in the low one),
+	// extra literals count bytes, literals, two bytes of the match offset and
+	// extra match length bytes. The last sequence has literals only.
+
+	const unsigned LZ_MIN_MATCH = 4;
+	const unsigned LZ_HASH_BITS = 12;
+	const unsigned LZ_MAX_OFFSET = MAX_USHORT;
+	const unsigned LZ_LAST_LITERALS = 5;	// bytes at the end never matched
+	const unsigned LZ_MATCH_LIMIT = 12;		// no match starts closer to the end
+
+	const struct
+	{
+		const char* name;
+		RecordCodec codec;
+	} codecs[] =
+	{
+		{"RLE", CODEC_RLE},
+		{"LZ", CODEC_LZ}
+	};
+
+	inline ULONG lzRead(const UCHAR* p)
+	{
+		ULONG value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	inline unsigned lzHash(ULONG value)
+	{
+		return (value * 2654435761U) >> (32 - LZ_HASH_BITS);
+	}
+
+	UCHAR* lzPutLength(UCHAR* output, FB_SIZE_T length)
+	{
+		for (; length >= MAX_UCHAR; length -= MAX_UCHAR)
+			*output++ = MAX_UCHAR;
+
+		*output++ = (UCHAR) length;
+		return output;
+	}
+
+	bool lzGetLength(const UCHAR*& input, const UCHAR* end, FB_SIZE_T& length)
+	{
+		UCHAR c;
+
+		do
+		{
+			if (input >= end)
+				return false;
+
+			c = *input++;
+			length += c;
+		} while (c == MAX_UCHAR);
+
+		return true;
+	}
+
+	UCHAR* lzUnpack(FB_SIZE_T inLength, const UCHAR* input, FB_SIZE_T outLength, UCHAR* output)
+	{
+		const UCHAR* const end = input + inLength;
+		const UCHAR* const start = output;
+		const UCHAR* const output_end = output + outLength;
+
+		while (input < end)
+		{
+			const UCHAR token = *input++;
+
+			FB_SIZE_T length = token >> 4;
+
+			if ((length == 15 && !lzGetLength(input, end, length)) ||
+				length > (FB_SIZE_T) (end - input) || length > (FB_SIZE_T) (output_end - output))
+			{
+				BUGCHECK(179);	// msg 179 decompression overran buffer
+			}
+
+			memcpy(output, input, length);
+			output += length;
+			input += length;
+
+			// The last sequence has no match
 
-Compressor::Compressor(MemoryPool& pool, FB_SIZE_T length, const UCHAR* data)
-	: m_control(pool), m_length(0)
+			if (input == end)
+				break;
+
+			if (end - input < 2)
+				BUGCHECK(179);	// msg 179 decompression overran buffer
+
+			const FB_SIZE_T offset = input[0] | (input[1] << 8);
+			input += 2;
+
+			length = token & 15;
+
+			if ((length == 15 && !lzGetLength(input, end, length)) ||
+				!offset || offset > (FB_SIZE_T) (output - start) ||
+				length + LZ_MIN_MATCH > (FB_SIZE_T) (output_end - output))
+			{
+				BUGCHECK(179);	// msg 179 decompression overran buffer
+			}
+
+			// Matches may overlap the output, copy them byte by byte
+
+			const UCHAR* ref = output - offset;
+
+			for (length += LZ_MIN_MATCH; length; --length)
+				*output++ = *ref++;
+		}
+
+		return output;
+	}
+} // namespace
+
+
+Compressor::Compressor(MemoryPool& pool, FB_SIZE_T length, const UCHAR* data, RecordCodec codec)
+	: m_control(pool), m_packed(pool), m_length(0), m_lz(false)
 {
+	const UCHAR* const input = data;
 	UCHAR* control = m_control.getBuffer((length + 1) / 2, false);
 	const UCHAR* const end = data + length;
 
@@ -94,6 +209,125 @@ Compressor::Compressor(MemoryPool& pool, FB_SIZE_T length, const UCHAR* data)
 
 	// set array size to the really used length
 	m_control.shrink(control - m_control.begin());
+
+	// LZ is used only if it packs the record better than RLE
+
+	if (codec == CODEC_LZ)
+		m_lz = packLZ(length, input);
+}
+
+bool Compressor::packLZ(FB_SIZE_T length, const UCHAR* data)
+{
+/**************************************
+ *
+ *	Compress a string with the LZ codec.
+ *	Return false if the result isn't shorter than
+ *	the RLE packed one.
+ *
+ **************************************/
+	if (length <= LZ_MATCH_LIMIT)
+		return false;
+
+	UCHAR* const start = m_packed.getBuffer(m_length, false);
+	const UCHAR* const output_end = start + m_length;
+	UCHAR* output = start;
+
+	// Positions of the recently seen 4-byte sequences
+
+	ULONG positions[1 << LZ_HASH_BITS];
+	memset(positions, 0, sizeof(positions));
+
+	const UCHAR* const end = data + length;
+	const UCHAR* const match_limit = end - LZ_MATCH_LIMIT;
+	const UCHAR* const last_literals = end - LZ_LAST_LITERALS;
+	const UCHAR* anchor = data;
+	const UCHAR* p = data;
+
+	while (p < match_limit)
+	{
+		const ULONG sequence = lzRead(p);
+		ULONG& position = positions[lzHash(sequence)];
+		const UCHAR* ref = data + position;
+		position = p - data;
+
+		if (ref >= p || p - ref > LZ_MAX_OFFSET || lzRead(ref) != sequence)
+		{
+			p++;
+			continue;
+		}
+
+		// Extend the match backward over the pending literals and then forward
+
+		while (p > anchor && ref > data && p[-1] == ref[-1])
+		{
+			p--;
+			ref--;
+		}
+
+		const UCHAR* match_end = p + LZ_MIN_MATCH;
+
+		for (const UCHAR* q = ref + LZ_MIN_MATCH; match_end < last_literals && *match_end == *q; q++)
+			match_end++;
+
+		const FB_SIZE_T literals = p - anchor;
+		const FB_SIZE_T match = match_end - p - LZ_MIN_MATCH;
+
+		if (literals + literals / MAX_UCHAR + match / MAX_UCHAR + 5 >= (FB_SIZE_T) (output_end - output))
+			return false;
+
+		UCHAR* const token = output++;
+		*token = (UCHAR) ((MIN(literals, 15) << 4) | MIN(match, 15));
+
+		if (literals >= 15)
+			output = lzPutLength(output, literals - 15);
+
+		memcpy(output, anchor, literals);
+		output += literals;
+
+		const FB_SIZE_T offset = p - ref;
+		*output++ = (UCHAR) offset;
+		*output++ = (UCHAR) (offset >> 8);
+
+		if (match >= 15)
+			output = lzPutLength(output, match - 15);
+
+		anchor = p = match_end;
+	}
+
+	const FB_SIZE_T literals = end - anchor;
+
+	if (literals + literals / MAX_UCHAR + 2 >= (FB_SIZE_T) (output_end - output))
+		return false;
+
+	*output++ = (UCHAR) (MIN(literals, 15) << 4);
+
+	if (literals >= 15)
+		output = lzPutLength(output, literals - 15);
+
+	memcpy(output, anchor, literals);
+	output += literals;
+
+	m_packed.shrink(output - start);
+	return true;
+}
+
+bool Compressor::getCodec(const char* name, RecordCodec& codec)
+{
+/**************************************
+ *
+ *	Lookup a record codec by name.
+ *
+ **************************************/
+	for (FB_SIZE_T i = 0; i < FB_NELEM(codecs); i++)
+	{
+		if (!strcmp(name, codecs[i].name))
+		{
+			codec = codecs[i].codec;
+			return true;
+		}
+	}
+
+	return false;
 }
 
 FB_SIZE_T Compressor::applyDiff(FB_SIZE_T diffLength,
@@ -156,6 +390,7 @@ FB_SIZE_T Compressor::pack(const UCHAR* input, FB_SIZE_T outLength, UCHAR* outpu
  *
  *	Compress a string into an area of known length.
  *	If it doesn't fit, throw BUGCHECK error.
+ *	The string is always packed with RLE.
  *
  **************************************/
 	const UCHAR* const start = input;
@@ -260,7 +495,8 @@ FB_SIZE_T Compressor::getPartialLength(FB_SIZE_T inLength, const UCHAR* input) c
 UCHAR* Compressor::unpack(FB_SIZE_T inLength,
 						  const UCHAR* input,
 						  FB_SIZE_T outLength,
-						  UCHAR* output)
+						  UCHAR* output,
+						  bool lz)
 {
 /**************************************
  *
@@ -268,6 +504,9 @@ UCHAR* Compressor::unpack(FB_SIZE_T inLength,
  *	Return the address where the output stopped.
  *
  **************************************/
+	if (lz)
+		return lzUnpack(inLength, input, outLength, output);
+
 	const UCHAR* const end = input + inLength;
 	const UCHAR* const output_end = output + outLength;
 
@@ -306,6 +545,61 @@ UCHAR* Compressor::unpack(FB_SIZE_T inLength,
 	return output;
 }
 
+FB_SIZE_T Compressor::getUnpackedLength(FB_SIZE_T inLength, const UCHAR* input, bool lz)
+{
+/**************************************
+ *
+ *	Compute the decompressed length of a compressed string.
+ *	Corrupted strings are counted till the damaged place.
+ *
+ **************************************/
+	const UCHAR* const end = input + inLength;
+	FB_SIZE_T length = 0;
+
+	while (input < end)
+	{
+		if (lz)
+		{
+			const UCHAR token = *input++;
+			FB_SIZE_T literals = token >> 4;
+
+			if (literals == 15 && !lzGetLength(input, end, literals))
+				break;
+
+			length += literals;
+			input += literals;
+
+			if (input >= end || end - input < 2)
+				break;
+
+			input += 2;
+			FB_SIZE_T match = token & 15;
+
+			if (match == 15 && !lzGetLength(input, end, match))
+				break;
+
+			length += match + LZ_MIN_MATCH;
+		}
+		else
+		{
+			const int len = (signed char) *input++;
+
+			if (len >= 0)
+			{
+				length += len;
+				input += len;
+			}
+			else
+			{
+				length -= len;
+				input++;
+			}
+		}
+	}
+
+	return length;
+}
+
 FB_SIZE_T Compressor::makeNoDiff(FB_SIZE_T outLength, UCHAR* output)
 {
 /**************************************
@@ -438,6 +732,12 @@ void Compressor::pack(const UCHAR* input, UCHAR* output) const
  *	Don't check nuttin' -- go for speed, man, raw SPEED!
  *
  **************************************/
+	if (m_lz)
+	{
+		memcpy(output, m_packed.begin(), m_packed.getCount());
+		return;
+	}
+
 	const UCHAR* control = m_control.begin();
 	const UCHAR* const dcc_end = m_control.end();
 
@@ -29,16 +29,37 @@
 
 namespace Jrd
 {
+	// Record compression codecs, see RDB$RELATIONS.RDB$RECORD_CODEC
+
+	enum RecordCodec
+	{
+		CODEC_RLE = 0,		// run-length encoding of repeating bytes
+		CODEC_LZ = 1		// LZ77 compression in the LZ4 block format
+	};
+
 	class Compressor
 	{
 	public:
-		Compressor(MemoryPool& pool, FB_SIZE_T length, const UCHAR* data);
+		Compressor(MemoryPool& pool, FB_SIZE_T length, const UCHAR* data,
+			RecordCodec codec = CODEC_RLE);
 
 		FB_SIZE_T getPackedLength() const
+		{
+			return m_lz ? m_packed.getCount() : m_length;
+		}
+
+		// Records split between pages are always packed with RLE
+
+		FB_SIZE_T getSplitLength() const
 		{
 			return m_length;
 		}
 
+		bool isLZ() const
+		{
+			return m_lz;
+		}
+
 		const UCHAR* getControl() const
 		{
 			return m_control.begin();
@@ -53,14 +74,21 @@ namespace Jrd
 		FB_SIZE_T pack(const UCHAR*, FB_SIZE_T, UCHAR*) const;
 		FB_SIZE_T getPartialLength(FB_SIZE_T, const UCHAR*) const;
 
-		static UCHAR* unpack(FB_SIZE_T, const UCHAR*, FB_SIZE_T, UCHAR*);
+		static bool getCodec(const char*, RecordCodec&);
+
+		static UCHAR* unpack(FB_SIZE_T, const UCHAR*, FB_SIZE_T, UCHAR*, bool);
+		static FB_SIZE_T getUnpackedLength(FB_SIZE_T, const UCHAR*, bool);
 		static FB_SIZE_T applyDiff(FB_SIZE_T, const UCHAR*, FB_SIZE_T, UCHAR* const);
 		static FB_SIZE_T makeDiff(FB_SIZE_T, const UCHAR*, FB_SIZE_T, UCHAR*, FB_SIZE_T, UCHAR*);
 		static FB_SIZE_T makeNoDiff(FB_SIZE_T, UCHAR*);
 
 	private:
+		bool packLZ(FB_SIZE_T, const UCHAR*);
+
 		Firebird::HalfStaticArray<UCHAR, 2048> m_control;
+		Firebird::HalfStaticArray<UCHAR, 2048> m_packed;
 		FB_SIZE_T m_length;
+		bool m_lz;
 	};
 
 } //namespace Jrd
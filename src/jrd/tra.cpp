@@ -1484,7 +1484,16 @@ void TRA_set_state(thread_db* tdbb, jrd_tra* transaction, TraNumber number, int
 	CCH_MARK(tdbb, &window);
 	const ULONG generation = tip->tip_header.pag_generation;
 #else
-	if (!(dbb->dbb_flags & DBB_shared) || !transaction  ||
+	// With group commit the TIP page is written by the flush of the whole group,
+	// see below. Mark it as changed by the committing transaction for that.
+
+	const bool groupCommit = transaction && transaction->tra_number == number &&
+		(transaction->tra_flags & TRA_write) && state == tra_committed &&
+		tdbb->getTransaction() == transaction && CCH_group_commit(tdbb);
+
+	if (groupCommit)
+		CCH_MARK(tdbb, &window);
+	else if (!(dbb->dbb_flags & DBB_shared) || !transaction  ||
 		(transaction->tra_flags & TRA_write) ||
 		old_state != tra_active || state != tra_committed)
 	{
@@ -1506,6 +1515,11 @@ void TRA_set_state(thread_db* tdbb, jrd_tra* transaction, TraNumber number, int
 
 	CCH_RELEASE(tdbb, &window);
 
+#ifndef SUPERSERVER_V2
+	if (groupCommit)
+		CCH_flush(tdbb, FLUSH_TRAN | FLUSH_TIP, number);
+#endif
+
 #ifdef SUPERSERVER_V2
 	// Let the TIP be lazily updated for read-only queries.
 	// To amortize write of TIP page for update transactions,
@@ -38,11 +38,13 @@
 #include <sys/stat.h>
 
 #include "../../common/StatusArg.h"
+#include "../../common/status.h"
 #include "../../common/classes/TempFile.h"
 #include "../../common/isc_proto.h"
 #include "../../common/isc_s_proto.h"
 #include "../../common/os/path_utils.h"
 #include "../../common/os/os_utils.h"
+#include "../../common/config/config.h"
 #include "../../jrd/trace/TraceLog.h"
 #include "../common/utils_proto.h"
 
@@ -52,18 +54,28 @@ namespace Jrd {
 
 const off_t MAX_LOG_FILE_SIZE = 1024 * 1024;
 const unsigned int MAX_FILE_NUM = (unsigned int) -1;
+const ULONG RING_FRAME_ALIGN = sizeof(ULONG);
 
 TraceLog::TraceLog(MemoryPool& pool, const PathName& fileName, bool reader) :
-	m_baseFileName(pool)
+	m_baseFileName(pool),
+	m_notice(pool)
 {
 	m_fileNum = 0;
 	m_fileHandle = -1;
 	m_reader = reader;
+	m_frameOffset = 0;
+
+	m_ringSize = 0;
+	if (const ULONG bufferSize = Config::getUserTraceLogBuffer())
+	{
+		for (m_ringSize = 1024; m_ringSize < bufferSize * 1024; m_ringSize <<= 1)
+			;
+	}
 
 	try
 	{
 		m_sharedMemory.reset(FB_NEW_POOL(pool)
-			SharedMemory<TraceLogHeader>(fileName.c_str(), sizeof(TraceLogHeader), this));
+			SharedMemory<TraceLogHeader>(fileName.c_str(), sizeof(TraceLogHeader) + m_ringSize, this));
 	}
 	catch (const Exception& ex)
 	{
@@ -71,10 +83,31 @@ TraceLog::TraceLog(MemoryPool& pool, const PathName& fileName, bool reader) :
 		throw;
 	}
 
+	// the region could be created by a process with another UserTraceLogBuffer,
+	// its ring size was taken from the header by initialize()
+
+	const ULONG length = sizeof(TraceLogHeader) + m_ringSize;
+	if (m_sharedMemory->sh_mem_length_mapped != length)
+	{
+#ifdef HAVE_OBJECT_MAP
+		FbLocalStatus statusVector;
+		if (!m_sharedMemory->remapFile(&statusVector, length, false))
+		{
+			iscLogStatus("TraceLog: cannot remap the shared memory region", &statusVector);
+			statusVector.raise();
+		}
+#else
+		(Arg::Gds(isc_random) << "TraceLog: ring buffer size mismatch").raise();
+#endif
+	}
+
 	char dir[MAXPATHLEN];
 	iscPrefixLock(dir, "", true);
 	PathUtils::concatPath(m_baseFileName, dir, fileName);
 
+	if (m_ringSize)
+		return;
+
 	TraceLogGuard guard(this);
 	if (m_reader)
 		m_fileNum = 0;
@@ -86,18 +119,27 @@ TraceLog::TraceLog(MemoryPool& pool, const PathName& fileName, bool reader) :
 
 TraceLog::~TraceLog()
 {
-	::close(m_fileHandle);
-
-	if (m_reader)
+	if (m_ringSize)
 	{
 		// indicate reader is gone
-		m_sharedMemory->getHeader()->readFileNum = MAX_FILE_NUM;
+		if (m_reader)
+			m_sharedMemory->getHeader()->readFileNum = MAX_FILE_NUM;
+	}
+	else
+	{
+		::close(m_fileHandle);
 
-		for (; m_fileNum <= m_sharedMemory->getHeader()->writeFileNum; m_fileNum++)
+		if (m_reader)
+		{
+			// indicate reader is gone
+			m_sharedMemory->getHeader()->readFileNum = MAX_FILE_NUM;
+
+			for (; m_fileNum <= m_sharedMemory->getHeader()->writeFileNum; m_fileNum++)
+				removeFile(m_fileNum);
+		}
+		else if (m_fileNum < m_sharedMemory->getHeader()->readFileNum)
 			removeFile(m_fileNum);
 	}
-	else if (m_fileNum < m_sharedMemory->getHeader()->readFileNum)
-		removeFile(m_fileNum);
 
 	const bool readerDone = (m_sharedMemory->getHeader()->readFileNum == MAX_FILE_NUM);
 
@@ -131,6 +173,9 @@ FB_SIZE_T TraceLog::read(void* buf, FB_SIZE_T size)
 {
 	fb_assert(m_reader);
 
+	if (m_ringSize)
+		return readRing(buf, size);
+
 	char* p = (char*) buf;
 	unsigned int readLeft = size;
 	while (readLeft)
@@ -185,6 +230,9 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 	if (m_sharedMemory->getHeader()->readFileNum == MAX_FILE_NUM)
 		return size;
 
+	if (m_ringSize)
+		return writeRing(buf, size);
+
 	TraceLogGuard guard(this);
 
 	const char* p = (const char*) buf;
@@ -233,8 +281,140 @@ FB_SIZE_T TraceLog::write(const void* buf, FB_SIZE_T size)
 	return size - writeLeft;
 }
 
+FB_SIZE_T TraceLog::readRing(void* buf, FB_SIZE_T size)
+{
+	TraceLogHeader* const header = m_sharedMemory->getHeader();
+
+	char* p = (char*) buf;
+	FB_SIZE_T readLeft = size;
+
+	while (readLeft)
+	{
+		// events lost since the last read are reported between the frames
+		if (!m_frameOffset && m_notice.isEmpty())
+		{
+			const ULONG lost = header->lostEvents.exchange(0);
+			if (lost)
+				m_notice.printf("\n--- %u trace events were lost as the reader fell behind ---\n", lost);
+		}
+
+		if (m_notice.hasData())
+		{
+			const FB_SIZE_T length = MIN(readLeft, m_notice.length());
+			memcpy(p, m_notice.c_str(), length);
+			m_notice.erase(0, length);
+
+			p += length;
+			readLeft -= length;
+			continue;
+		}
+
+		const ULONG readPos = header->readPos.load(std::memory_order_relaxed);
+
+		if (readPos == header->writePos.load(std::memory_order_acquire))
+			break;
+
+		// the length of a frame is stored when the writer is done with it
+
+		const std::atomic<ULONG>* const lengthPtr =
+			reinterpret_cast<const std::atomic<ULONG>*>(getRing() + (readPos & (m_ringSize - 1)));
+		const ULONG frameLength = lengthPtr->load(std::memory_order_acquire);
+
+		if (!frameLength)
+			break;
+
+		const ULONG length = MIN(readLeft, frameLength - m_frameOffset);
+		copyFromRing(readPos + sizeof(ULONG) + m_frameOffset, p, length);
+		m_frameOffset += length;
+
+		p += length;
+		readLeft -= length;
+
+		if (m_frameOffset == frameLength)
+		{
+			const ULONG frameSize = FB_ALIGN(sizeof(ULONG) + frameLength, RING_FRAME_ALIGN);
+			clearRing(readPos, frameSize);
+			m_frameOffset = 0;
+
+			header->readPos.store(readPos + frameSize, std::memory_order_release);
+		}
+	}
+
+	return (size - readLeft);
+}
+
+FB_SIZE_T TraceLog::writeRing(const void* buf, FB_SIZE_T size)
+{
+	TraceLogHeader* const header = m_sharedMemory->getHeader();
+
+	if (!size)
+		return 0;
+
+	const FB_UINT64 frameSize = FB_ALIGN(sizeof(ULONG) + (FB_UINT64) size, RING_FRAME_ALIGN);
+
+	// reserve the frame, or drop it if the reader fell behind
+
+	ULONG writePos = header->writePos.load(std::memory_order_relaxed);
+	do
+	{
+		const ULONG used = writePos - header->readPos.load(std::memory_order_acquire);
+
+		if (used + frameSize > m_ringSize)
+		{
+			header->lostEvents++;
+			return size;
+		}
+	} while (!header->writePos.compare_exchange_weak(writePos, writePos + (ULONG) frameSize));
+
+	// copy the data and publish the frame
+
+	copyToRing(writePos + sizeof(ULONG), buf, (ULONG) size);
+
+	std::atomic<ULONG>* const lengthPtr =
+		reinterpret_cast<std::atomic<ULONG>*>(getRing() + (writePos & (m_ringSize - 1)));
+	lengthPtr->store((ULONG) size, std::memory_order_release);
+
+	return size;
+}
+
+UCHAR* TraceLog::getRing()
+{
+	return reinterpret_cast<UCHAR*>(m_sharedMemory->getHeader()) + sizeof(TraceLogHeader);
+}
+
+void TraceLog::copyToRing(ULONG pos, const void* data, ULONG length)
+{
+	const ULONG offset = pos & (m_ringSize - 1);
+	const ULONG first = MIN(length, m_ringSize - offset);
+
+	memcpy(getRing() + offset, data, first);
+	memcpy(getRing(), static_cast<const UCHAR*>(data) + first, length - first);
+}
+
+void TraceLog::copyFromRing(ULONG pos, void* data, ULONG length)
+{
+	const ULONG offset = pos & (m_ringSize - 1);
+	const ULONG first = MIN(length, m_ringSize - offset);
+
+	memcpy(data, getRing() + offset, first);
+	memcpy(static_cast<UCHAR*>(data) + first, getRing(), length - first);
+}
+
+void TraceLog::clearRing(ULONG pos, ULONG length)
+{
+	const ULONG offset = pos & (m_ringSize - 1);
+	const ULONG first = MIN(length, m_ringSize - offset);
+
+	memset(getRing() + offset, 0, first);
+	memset(getRing(), 0, length - first);
+}
+
 ULONG TraceLog::getApproxLogSize() const
 {
+	// writers never wait for the reader of the ring buffer
+	if (m_ringSize)
+		return 0;
+
 	return (m_sharedMemory->getHeader()->writeFileNum - m_sharedMemory->getHeader()->readFileNum + 1) *
 			(MAX_LOG_FILE_SIZE / (1024 * 1024));
 }
@@ -257,12 +437,20 @@ bool TraceLog::initialize(SharedMemoryBase* sm, bool initialize)
 
 		hdr->readFileNum = 0;
 		hdr->writeFileNum = 0;
+
+		hdr->ringSize = m_ringSize;
+		hdr->readPos = 0;
+		hdr->writePos = 0;
+		hdr->lostEvents = 0;
+		memset(reinterpret_cast<UCHAR*>(hdr) + sizeof(TraceLogHeader), 0, m_ringSize);
 	}
 	else
 	{
 		fb_assert(hdr->mhb_type == SharedMemoryBase::SRAM_TRACE_LOG);
 		fb_assert(hdr->mhb_header_version == MemoryHeader::HEADER_VERSION);
 		fb_assert(hdr->mhb_version == TraceLogHeader::TRACE_LOG_VERSION);
+
+		m_ringSize = hdr->ringSize;
 	}
 
 	return true;
@@ -28,17 +28,35 @@
 #ifndef TRACE_LOG
 #define TRACE_LOG
 
+#include <atomic>
 #include "../../common/classes/fb_string.h"
 #include "../../common/isc_s_proto.h"
 
 namespace Jrd {
 
+// The output of a user trace session is passed to the reader either through
+// a set of log files or, if UserTraceLogBuffer is set, through a ring buffer
+// placed in the shared memory after the header.
+//
+// The ring is a sequence of frames. Each frame is a ULONG length of the data
+// followed by the data itself, and is aligned to ULONG. Positions grow
+// monotonically and wrap at the ring size, which is a power of two. Writers
+// reserve a frame moving writePos and publish it storing its length, so they
+// never wait for each other nor for the reader. The reader consumes published
+// frames in order, zeroes them and moves readPos. A frame which doesn't fit
+// into the free space is dropped and counted in lostEvents.
+
 struct TraceLogHeader : public Firebird::MemoryHeader
 {
-	static const USHORT TRACE_LOG_VERSION = 1;
+	static const USHORT TRACE_LOG_VERSION = 2;
 
 	volatile unsigned int readFileNum;
 	volatile unsigned int writeFileNum;
+
+	ULONG ringSize;					// size of the ring buffer, 0 if log files are used
+	std::atomic<ULONG> readPos;		// start of the first unread frame
+	std::atomic<ULONG> writePos;	// end of the last reserved frame
+	std::atomic<ULONG> lostEvents;	// frames dropped since the last read
 };
 
 class TraceLog : public Firebird::IpcObject
@@ -63,11 +81,22 @@ private:
 	int openFile(int fileNum);
 	int removeFile(int fileNum);
 
+	FB_SIZE_T readRing(void* buf, FB_SIZE_T size);
+	FB_SIZE_T writeRing(const void* buf, FB_SIZE_T size);
+
+	UCHAR* getRing();
+	void copyToRing(ULONG pos, const void* data, ULONG length);
+	void copyFromRing(ULONG pos, void* data, ULONG length);
+	void clearRing(ULONG pos, ULONG length);
+
 	Firebird::AutoPtr<Firebird::SharedMemory<TraceLogHeader> > m_sharedMemory;
 	Firebird::PathName m_baseFileName;
 	unsigned int m_fileNum;
 	int m_fileHandle;
 	bool m_reader;
+	ULONG m_ringSize;		// size of the ring buffer, 0 if log files are used
+	ULONG m_frameOffset;	// part of the current frame already read
+	Firebird::string m_notice;	// reader's message about lost events
 
 	class TraceLogGuard
 	{
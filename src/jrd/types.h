@@ -202,3 +202,6 @@ TYPE("NOT ENCRYPTED", 0, nam_mon_crypt_state)
 TYPE("ENCRYPTED", 1, nam_mon_crypt_state)
 TYPE("DECRYPT IN PROGRESS", 2, nam_mon_crypt_state)
 TYPE("ENCRYPT IN PROGRESS", 3, nam_mon_crypt_state)
+
+TYPE("RLE", 0, nam_record_codec)
+TYPE("LZ", 1, nam_record_codec)
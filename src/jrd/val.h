@@ -170,7 +170,7 @@ class Format : public pool_alloc<type_fmt>
 {
 public:
 	Format(MemoryPool& p, int len)
-		: fmt_length(0), fmt_count(len), fmt_version(0),
+		: fmt_length(0), fmt_count(len), fmt_version(0), fmt_codec(0),
 		  fmt_desc(p, fmt_count), fmt_defaults(p, fmt_count)
 	{
 		fmt_desc.resize(fmt_count);
@@ -200,6 +200,7 @@ public:
 	ULONG fmt_length;
 	USHORT fmt_count;
 	USHORT fmt_version;
+	UCHAR fmt_codec;		// codec to pack the records with, see RecordCodec
 	Firebird::Array<dsc> fmt_desc;
 	Firebird::Array<impure_value> fmt_defaults;
 
@@ -553,6 +553,7 @@ VI. ADDITIONAL NOTES
 #include "../jrd/rse.h"
 #include "../jrd/tra.h"
 #include "../jrd/svc.h"
+#include "../jrd/sqz.h"
 #include "../jrd/btr_proto.h"
 #include "../jrd/cch_proto.h"
 #include "../jrd/dpm_proto.h"
@@ -644,6 +645,13 @@ static void explain_pp_bits(const UCHAR bits, Firebird::string& names)
 		names.append("secondary");
 	}
 
+	if (bits & ppg_dp_all_visible)
+	{
+		if (!names.empty())
+			names.append(", ");
+		names.append("all-visible");
+	}
+
 	if (bits & ppg_dp_empty)
 	{
 		if (!names.empty())
@@ -1738,6 +1746,9 @@ Validation::RTN Validation::walk_data_page(jrd_rel* relation, ULONG page_number,
 	if (dp_flags & dpg_secondary)
 		pp_bits |= ppg_dp_secondary;
 
+	if (dp_flags & dpg_all_visible)
+		pp_bits |= ppg_dp_all_visible;
+
 	if (page->dpg_count == 0)
 		pp_bits |= ppg_dp_empty;
 
@@ -2714,22 +2725,8 @@ Validation::RTN Validation::walk_record(jrd_rel* relation, const rhd* header, US
 		end = p + length - offsetof(rhd, rhd_data[0]);
 	}
 
-	ULONG record_length = 0;
-
-	while (p < end)
-	{
-		const signed char c = *p++;
-		if (c >= 0)
-		{
-			record_length += c;
-			p += c;
-		}
-		else
-		{
-			record_length -= c;
-			p++;
-		}
-	}
+	ULONG record_length = (ULONG) Compressor::getUnpackedLength(end - p, (const UCHAR*) p,
+		(header->rhd_flags & rhd_lz) != 0);
 
 	// Next, chase down fragments, if any
 
@@ -2775,20 +2772,9 @@ Validation::RTN Validation::walk_record(jrd_rel* relation, const rhd* header, US
 			p = (SCHAR*) ((rhd*) fragment)->rhd_data;
 			end = p + line->dpg_length - offsetof(rhd, rhd_data[0]);
 		}
-		while (p < end)
-		{
-			const signed char c = *p++;
-			if (c >= 0)
-			{
-				record_length += c;
-				p += c;
-			}
-			else
-			{
-				record_length -= c;
-				p++;
-			}
-		}
+		record_length += (ULONG) Compressor::getUnpackedLength(end - p, (const UCHAR*) p,
+			(fragment->rhdf_flags & rhd_lz) != 0);
+
 		page_number = fragment->rhdf_f_page;
 		line_number = fragment->rhdf_f_line;
 		flags = fragment->rhdf_flags;
@@ -2834,6 +2820,12 @@ void restoreFlags(UCHAR* byte, UCHAR flags, bool empty)
 	else
 		*byte &= ~bit;
 
+	bit = PPG_DP_BIT_MASK(slot, ppg_dp_all_visible);
+	if (flags & dpg_all_visible)
+		*byte |= bit;
+	else
+		*byte &= ~bit;
+
 	bit = PPG_DP_BIT_MASK(slot, ppg_dp_empty);
 	if (empty)
 		*byte |= bit;
@@ -325,6 +325,12 @@ static const UCHAR gc_tpb[] =
 	isc_tpb_ignore_limbo
 };
 
+static const UCHAR sweep_tpb[] =
+{
+	isc_tpb_version1, isc_tpb_read,
+	isc_tpb_read_committed, isc_tpb_rec_version
+};
+
 
 inline void clearRecordStack(RecordStack& stack)
 {
@@ -1388,7 +1394,8 @@ void VIO_data(thread_db* tdbb, record_param* rpb, MemoryPool* pool)
 
 	// Snarf data from record
 
-	tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail);
+	tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail,
+		(rpb->rpb_flags & rpb_lz) != 0);
 
 	RuntimeStatistics::Accumulator fragments(tdbb, relation, RuntimeStatistics::RECORD_FRAGMENT_READS);
 
@@ -1401,7 +1408,8 @@ void VIO_data(thread_db* tdbb, record_param* rpb, MemoryPool* pool)
 		while (rpb->rpb_flags & rpb_incomplete)
 		{
 			DPM_fetch_fragment(tdbb, rpb, LCK_read);
-			tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail);
+			tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail,
+				(rpb->rpb_flags & rpb_lz) != 0);
 			++fragments;
 		}
 
@@ -1610,6 +1618,7 @@ bool VIO_erase(thread_db* tdbb, record_param* rpb, jrd_tra* transaction)
 		case rel_packages:
 		case rel_charsets:
 		case rel_pubs:
+		case rel_col_stats:
 			protect_system_table_delupd(tdbb, relation, "DELETE");
 			break;
 
@@ -2861,6 +2870,7 @@ bool VIO_modify(thread_db* tdbb, record_param* org_rpb, record_param* new_rpb, j
 		case rel_roles:
 		case rel_ccon:
 		case rel_pub_tables:
+		case rel_col_stats:
 			protect_system_table_delupd(tdbb, relation, "UPDATE");
 			break;
 
@@ -3798,6 +3808,10 @@ void VIO_store(thread_db* tdbb, record_param* rpb, jrd_tra* transaction)
 			DFW_post_work(transaction, dfw_change_repl_state, "", 1);
 			break;
 
+		case rel_col_stats:
+			protect_system_table_insert(tdbb, request, relation);
+			break;
+
 		default:    // Shut up compiler warnings
 			break;
 		}
@@ -3855,6 +3869,365 @@ void VIO_store(thread_db* tdbb, record_param* rpb, jrd_tra* transaction)
 }
 
 
+static void sweep_pages(thread_db* tdbb, record_param* rpb, jrd_tra* transaction, ULONG pp_sequence)
+{
+/**************************************
+ *
+ *	s w e e p _ p a g e s
+ *
+ **************************************
+ *
+ * Functional description
+ *	Sweep data pages listed at the given pointer page.
+ *
+ **************************************/
+	Database* const dbb = tdbb->getDatabase();
+	jrd_rel* const relation = rpb->rpb_relation;
+
+	// Data pages are read one by one, so the scan never crosses
+	// into the pointer page of another job
+
+	for (ULONG slot = 0; slot < dbb->dbb_dp_per_pp; slot++)
+	{
+		const SINT64 dpSequence = (SINT64) pp_sequence * dbb->dbb_dp_per_pp + slot;
+		rpb->rpb_number.setValue(dpSequence * dbb->dbb_max_records - 1);
+
+		while (DPM_next(tdbb, rpb, LCK_read, true))
+		{
+			if (!VIO_chase_record_version(tdbb, rpb, transaction, NULL, false, false))
+				continue;
+
+			CCH_RELEASE(tdbb, &rpb->getWindow(tdbb));
+
+			if (relation->rel_flags & REL_deleting)
+				return;
+
+			if (--tdbb->tdbb_quantum < 0)
+				JRD_reschedule(tdbb, SWEEP_QUANTUM, true);
+
+			transaction->tra_oldest_active = dbb->dbb_oldest_snapshot;
+			if (TipCache* cache = dbb->dbb_tip_cache)
+				cache->updateActiveSnapshots(tdbb, &tdbb->getAttachment()->att_active_snapshots);
+		}
+	}
+}
+
+
+namespace {
+
+// Worker threads of a sweep. Data pages of a relation are split into jobs of
+// one pointer page each, which are swept both by the workers and by the
+// sweeper itself. Every worker has its own system attachment and read-only
+// "precommitted" transaction, like the garbage collector.
+
+class SweepWorkers
+{
+	typedef ThreadFinishSync<SweepWorkers*> WorkerThread;
+
+	struct Job
+	{
+		USHORT relId;
+		ULONG sequence;		// pointer page sequence
+	};
+
+public:
+	SweepWorkers(MemoryPool& pool, Database* dbb)
+		: m_pool(pool), m_dbb(dbb), m_threads(pool), m_queue(pool),
+		  m_next(0), m_pending(0), m_shutdown(false), m_incomplete(false)
+	{}
+
+	~SweepWorkers()
+	{
+		shutdown();
+	}
+
+	// Start up to count threads, return the number of running ones
+	unsigned start(unsigned count)
+	{
+		try
+		{
+			while (m_threads.getCount() < count)
+			{
+				AutoPtr<WorkerThread> thread(FB_NEW_POOL(m_pool) WorkerThread(m_pool, worker, THREAD_medium));
+				thread->run(this);
+				m_threads.add(thread.release());
+			}
+		}
+		catch (const Exception& ex)
+		{
+			exceptionHandler(ex, worker);
+		}
+
+		return m_threads.getCount();
+	}
+
+	// Sweep the relation set in rpb, return false if some worker
+	// was not allowed to garbage collect it
+	bool sweep(thread_db* tdbb, record_param* rpb, jrd_tra* transaction, ULONG pp_count)
+	{
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+			m_queue.clear();
+			m_next = 0;
+
+			for (ULONG sequence = 0; sequence < pp_count; sequence++)
+			{
+				Job job;
+				job.relId = rpb->rpb_relation->rel_id;
+				job.sequence = sequence;
+				m_queue.add(job);
+			}
+
+			m_pending = pp_count;
+			m_incomplete = false;
+		}
+
+		m_work.release(MIN(pp_count, m_threads.getCount()));
+
+		while (true)
+		{
+			Job job;
+
+			if (getJob(job))
+			{
+				sweep_pages(tdbb, rpb, transaction, job.sequence);
+				jobDone();
+				continue;
+			}
+
+			{	// scope
+				MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+				if (!m_pending)
+					break;
+			}
+
+			EngineCheckout cout(tdbb, FB_FUNCTION);
+			m_done.enter();
+		}
+
+		if (!m_status.isSuccess())
+			ERR_post(Arg::StatusVector(&m_status));
+
+		return !m_incomplete;
+	}
+
+	void shutdown()
+	{
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_shutdown = true;
+		}
+
+		if (m_threads.hasData())
+			m_work.release(m_threads.getCount());
+
+		while (m_threads.hasData())
+		{
+			WorkerThread* const thread = m_threads.pop();
+			thread->waitForCompletion();
+			delete thread;
+		}
+	}
+
+	void exceptionHandler(const Exception& ex, WorkerThread::ThreadRoutine*)
+	{
+		FbLocalStatus status_vector;
+		ex.stuffException(&status_vector);
+		iscDbLogStatus(m_dbb->dbb_filename.c_str(), &status_vector);
+	}
+
+private:
+	static void worker(SweepWorkers* workers)
+	{
+		workers->run();
+	}
+
+	// Take the next job, unless some worker failed
+	bool getJob(Job& job)
+	{
+		MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+		if (m_next < m_queue.getCount() && (m_shutdown || !m_status.isSuccess()))
+		{
+			m_pending -= m_queue.getCount() - m_next;
+			m_next = m_queue.getCount();
+			m_done.release();
+		}
+
+		if (m_next == m_queue.getCount())
+			return false;
+
+		job = m_queue[m_next++];
+		return true;
+	}
+
+	void jobDone()
+	{
+		{	// scope
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_pending--;
+		}
+
+		m_done.release();
+	}
+
+	void sweepJob(thread_db* tdbb, record_param* rpb, jrd_tra* transaction, const Job& job)
+	{
+		jrd_rel* const relation = MET_lookup_relation_id(tdbb, job.relId, false);
+
+		if (!relation || (relation->rel_flags & (REL_deleted | REL_deleting)))
+			return;
+
+		jrd_rel::GCShared gcGuard(tdbb, relation);
+		if (!gcGuard.gcEnabled())
+		{
+			MutexLockGuard guard(m_mutex, FB_FUNCTION);
+			m_incomplete = true;
+			return;
+		}
+
+		rpb->rpb_relation = relation;
+		rpb->rpb_org_scans = relation->rel_scan_count++;
+
+		try
+		{
+			sweep_pages(tdbb, rpb, transaction, job.sequence);
+		}
+		catch (const Exception&)
+		{
+			--relation->rel_scan_count;
+			throw;
+		}
+
+		--relation->rel_scan_count;
+	}
+
+	void run()
+	{
+		FbLocalStatus status_vector;
+
+		try
+		{
+			UserId user;
+			user.setUserName("Sweep Worker");
+
+			Jrd::Attachment* const attachment = Jrd::Attachment::create(m_dbb);
+			RefPtr<SysStableAttachment> sAtt(FB_NEW SysStableAttachment(attachment));
+			attachment->setStable(sAtt);
+			attachment->att_filename = m_dbb->dbb_filename;
+			attachment->att_user = &user;
+
+			BackgroundContextHolder tdbb(m_dbb, attachment, &status_vector, FB_FUNCTION);
+			tdbb->tdbb_quantum = SWEEP_QUANTUM;
+			tdbb->tdbb_flags = TDBB_sweeper;
+
+			record_param rpb;
+			rpb.rpb_stream_flags = RPB_s_no_data | RPB_s_sweeper;
+			rpb.getWindow(tdbb).win_flags = WIN_large_scan;
+
+			jrd_tra* transaction = NULL;
+			bool busy = false;
+
+			try
+			{
+				LCK_init(tdbb, LCK_OWNER_attachment);
+				INI_init(tdbb);
+				INI_init2(tdbb);
+				PAG_header(tdbb, true);
+				PAG_attachment_id(tdbb);
+				TRA_init(attachment);
+
+				Monitoring::publishAttachment(tdbb);
+
+				sAtt->initDone();
+
+				transaction = TRA_start(tdbb, sizeof(sweep_tpb), sweep_tpb);
+				tdbb->setTransaction(transaction);
+
+				while (true)
+				{
+					{	// scope
+						EngineCheckout cout(tdbb, FB_FUNCTION);
+						m_work.enter();
+					}
+
+					{	// scope
+						MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+						if (m_shutdown)
+							break;
+					}
+
+					Job job;
+
+					while (getJob(job))
+					{
+						busy = true;
+						sweepJob(tdbb, &rpb, transaction, job);
+						busy = false;
+
+						jobDone();
+					}
+				}
+			}
+			catch (const Exception& ex)
+			{
+				// Jobs left are swept by the sweeper itself, unless we failed doing one of them
+
+				if (busy)
+				{
+					{	// scope
+						MutexLockGuard guard(m_mutex, FB_FUNCTION);
+
+						if (m_status.isSuccess())
+							ex.stuffException(&m_status);
+					}
+
+					jobDone();
+				}
+				else
+				{
+					ex.stuffException(&status_vector);
+					iscDbLogStatus(m_dbb->dbb_filename.c_str(), &status_vector);
+				}
+			}
+
+			delete rpb.rpb_record;
+
+			if (transaction)
+				TRA_commit(tdbb, transaction, false);
+
+			Monitoring::cleanupAttachment(tdbb);
+			attachment->releaseLocks(tdbb);
+			LCK_fini(tdbb, LCK_OWNER_attachment);
+
+			attachment->releaseRelations(tdbb);
+		}
+		catch (const Exception& ex)
+		{
+			exceptionHandler(ex, NULL);
+		}
+	}
+
+	MemoryPool& m_pool;
+	Database* const m_dbb;
+	HalfStaticArray<WorkerThread*, 8> m_threads;
+	Array<Job> m_queue;
+	FB_SIZE_T m_next;					// next job to take from the queue
+	Mutex m_mutex;
+	Semaphore m_work;					// wakes up workers
+	Semaphore m_done;					// signals a job is done
+	ULONG m_pending;					// jobs not finished yet
+	bool m_shutdown;
+	bool m_incomplete;					// garbage collection was disabled for a worker
+	FbLocalStatus m_status;				// first error of any worker
+};
+
+} // namespace
+
+
 bool VIO_sweep(thread_db* tdbb, jrd_tra* transaction, TraceSweepEvent* traceSweep)
 {
 /**************************************
@@ -3895,6 +4268,18 @@ bool VIO_sweep(thread_db* tdbb, jrd_tra* transaction, TraceSweepEvent* traceSwee
 	GarbageCollector* gc = dbb->dbb_garbage_collector;
 	bool ret = true;
 
+	// Sweep big relations using worker threads, if allowed
+
+	AutoPtr<SweepWorkers> workers;
+	const unsigned parallel = attachment->getParallelWorkers();
+
+	if (parallel > 1)
+	{
+		workers = FB_NEW_POOL(*attachment->att_pool) SweepWorkers(*attachment->att_pool, dbb);
+		if (!workers->start(parallel - 1))
+			workers.reset();
+	}
+
 	try {
 
 		for (FB_SIZE_T i = 1; (vector = attachment->att_relations) && i < vector->count(); i++)
@@ -3925,29 +4310,49 @@ bool VIO_sweep(thread_db* tdbb, jrd_tra* transaction, TraceSweepEvent* traceSwee
 					gc->sweptRelation(transaction->tra_oldest_active, relation->rel_id);
 				}
 
-				while (VIO_next_record(tdbb, &rpb, transaction, 0, false))
+				const vcl* const pages = relation->getPages(tdbb)->rel_pages;
+				bool complete = true;
+
+				if (workers && pages->count() > 1)
+					complete = workers->sweep(tdbb, &rpb, transaction, pages->count());
+				else
 				{
-					CCH_RELEASE(tdbb, &rpb.getWindow(tdbb));
+					while (VIO_next_record(tdbb, &rpb, transaction, 0, false))
+					{
+						CCH_RELEASE(tdbb, &rpb.getWindow(tdbb));
 
-					if (relation->rel_flags & REL_deleting)
-						break;
+						if (relation->rel_flags & REL_deleting)
+							break;
 
-					if (--tdbb->tdbb_quantum < 0)
-						JRD_reschedule(tdbb, SWEEP_QUANTUM, true);
+						if (--tdbb->tdbb_quantum < 0)
+							JRD_reschedule(tdbb, SWEEP_QUANTUM, true);
 
-					transaction->tra_oldest_active = dbb->dbb_oldest_snapshot;
-					if (TipCache* cache = dbb->dbb_tip_cache)
-						cache->updateActiveSnapshots(tdbb, &attachment->att_active_snapshots);
+						transaction->tra_oldest_active = dbb->dbb_oldest_snapshot;
+						if (TipCache* cache = dbb->dbb_tip_cache)
+							cache->updateActiveSnapshots(tdbb, &attachment->att_active_snapshots);
+					}
 				}
 
 				traceSweep->endSweepRelation(relation);
 
 				--relation->rel_scan_count;
+
+				if (!complete)
+				{
+					ret = false;
+					break;
+				}
 			}
 		}
 
 		delete rpb.rpb_record;
 
+		if (workers)
+		{
+			EngineCheckout cout(tdbb, FB_FUNCTION);
+			workers->shutdown();
+		}
+
 	}	// try
 	catch (const Firebird::Exception&)
 	{
@@ -3959,6 +4364,16 @@ bool VIO_sweep(thread_db* tdbb, jrd_tra* transaction, TraceSweepEvent* traceSwee
 				--relation->rel_scan_count;
 		}
 
+		if (workers)
+		{
+			// Workers may wait for pages we still hold
+
+			CCH_unwind(tdbb, false);
+
+			EngineCheckout cout(tdbb, FB_FUNCTION);
+			workers->shutdown();
+		}
+
 		ERR_punt();
 	}
 
@@ -4449,7 +4864,8 @@ static void delete_record(thread_db* tdbb, record_param* rpb, ULONG prior_page,
 			tail_end = tail + record->getLength();
 		}
 
-		tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail);
+		tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail,
+			(rpb->rpb_flags & rpb_lz) != 0);
 		rpb->rpb_prior = (rpb->rpb_flags & rpb_delta) ? record : 0;
 	}
 
@@ -4510,7 +4926,8 @@ static UCHAR* delete_tail(thread_db* tdbb,
 			BUGCHECK(248);		// msg 248 cannot find record fragment
 
 		if (tail)
-			tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail);
+			tail = Compressor::unpack(rpb->rpb_length, rpb->rpb_address, tail_end - tail, tail,
+				(rpb->rpb_flags & rpb_lz) != 0);
 
 		DPM_delete(tdbb, rpb, prior_page);
 		prior_page = rpb->rpb_page;
@@ -131,6 +131,28 @@ SSHORT LOCK_debug_level = 0;
 
 using namespace Firebird;
 
+namespace
+{
+	// Tell the CPU it's a spin wait loop, or give up the time slice
+	// when there is no such instruction
+
+	inline void spin_pause(ULONG count)
+	{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+		while (count--)
+			__builtin_ia32_pause();
+#elif defined(_MSC_VER)
+		while (count--)
+			YieldProcessor();
+#elif defined(__GNUC__) && defined(__aarch64__)
+		while (count--)
+			__asm__ __volatile__("yield");
+#else
+		Thread::yield();
+#endif
+	}
+}
+
 // hvlad: enable to log deadlocked owners and its PIDs in firebird.log
 //#define DEBUG_TRACE_DEADLOCKS
 
@@ -142,6 +164,7 @@ const SRQ_PTR DUMMY_OWNER = -1;
 const SLONG HASH_MIN_SLOTS	= 101;
 const SLONG HASH_MAX_SLOTS	= 65521;
 const USHORT HISTORY_BLOCKS	= 256;
+const ULONG MAX_SPIN_BACKOFF	= 1024;	// CPU pauses between acquire spins
 
 // SRQ_ABS_PTR uses this macro.
 #define SRQ_BASE                    ((UCHAR*) m_sharedMemory->getHeader())
@@ -172,6 +195,7 @@ LockManager::LockManager(const string& id, const Config* conf)
 	  m_cleanupSync(getPool(), blocking_action_thread, THREAD_high),
 	  m_sharedMemory(NULL),
 	  m_blockage(false),
+	  m_groupBlockage(false),
 	  m_dbId(id),
 	  m_config(conf),
 	  m_acquireSpins(m_config->getLockAcquireSpins()),
@@ -517,6 +541,9 @@ SRQ_PTR LockManager::enqueue(thread_db* tdbb,
 
 	USHORT hash_slot;
 	lbl* lock = find_lock(series, value, length, &hash_slot);
+	const USHORT hash_group = hash_slot % LHB_HASH_GROUPS;
+	account_acquire(&m_sharedMemory->getHeader()->lhb_hash_groups[hash_group]);
+
 	if (lock)
 	{
 		if (series < LCK_MAX_SERIES)
@@ -563,6 +590,7 @@ SRQ_PTR LockManager::enqueue(thread_db* tdbb,
 		++(m_sharedMemory->getHeader()->lhb_operations[0]);
 
 	lock->lbl_flags = 0;
+	lock->lbl_hash_group = (UCHAR) hash_group;
 	lock->lbl_pending_lrq_count = 0;
 
 	memset(lock->lbl_counts, 0, sizeof(lock->lbl_counts));
@@ -616,6 +644,8 @@ bool LockManager::convert(thread_db* tdbb,
 	++(m_sharedMemory->getHeader()->lhb_converts);
 
 	const lbl* lock = (lbl*) SRQ_ABS_PTR(request->lrq_lock);
+	account_acquire(&m_sharedMemory->getHeader()->lhb_hash_groups[lock->lbl_hash_group]);
+
 	if (lock->lbl_series < LCK_MAX_SERIES)
 		++(m_sharedMemory->getHeader()->lhb_operations[lock->lbl_series]);
 	else
@@ -659,6 +689,8 @@ UCHAR LockManager::downgrade(thread_db* tdbb,
 	++(m_sharedMemory->getHeader()->lhb_downgrades);
 
 	const lbl* lock = (lbl*) SRQ_ABS_PTR(request->lrq_lock);
+	account_acquire(&m_sharedMemory->getHeader()->lhb_hash_groups[lock->lbl_hash_group]);
+
 	UCHAR pending_state = LCK_none;
 
 	// Loop thru requests looking for pending conversions
@@ -722,6 +754,8 @@ bool LockManager::dequeue(const SRQ_PTR request_offset)
 	++(m_sharedMemory->getHeader()->lhb_deqs);
 
 	const lbl* lock = (lbl*) SRQ_ABS_PTR(request->lrq_lock);
+	account_acquire(&m_sharedMemory->getHeader()->lhb_hash_groups[lock->lbl_hash_group]);
+
 	if (lock->lbl_series < LCK_MAX_SERIES)
 		++(m_sharedMemory->getHeader()->lhb_operations[lock->lbl_series]);
 	else
@@ -1042,9 +1076,13 @@ void LockManager::acquire_shmem(SRQ_PTR owner_offset)
 	// Perform a spin wait on the lock table mutex. This should only
 	// be used on SMP machines; it doesn't make much sense otherwise.
 
+	// Back off a bit more after every failed try to not keep bouncing the
+	// mutex cache line between CPUs while it's held by somebody else.
+
 	const ULONG spins_to_try = m_acquireSpins ? m_acquireSpins : 1;
 	bool locked = false;
 	ULONG spins = 0;
+	ULONG backoff = 1;
 	while (spins++ < spins_to_try)
 	{
 		if (m_sharedMemory->mutexLockCond())
@@ -1054,6 +1092,14 @@ void LockManager::acquire_shmem(SRQ_PTR owner_offset)
 		}
 
 		m_blockage = true;
+
+		if (spins < spins_to_try)
+		{
+			spin_pause(backoff);
+
+			if (backoff < MAX_SPIN_BACKOFF)
+				backoff <<= 1;
+		}
 	}
 
 	// If the spin wait didn't succeed then wait forever
@@ -1087,6 +1133,7 @@ void LockManager::acquire_shmem(SRQ_PTR owner_offset)
 	fb_assert(!m_sharedMemory->justCreated());
 
 	++(m_sharedMemory->getHeader()->lhb_acquires);
+	m_groupBlockage = m_blockage;
 	if (m_blockage)
 	{
 		++(m_sharedMemory->getHeader()->lhb_acquire_blocks);
@@ -2071,6 +2118,31 @@ lbl* LockManager::find_lock(USHORT series,
 }
 
 
+void LockManager::account_acquire(lhg* group)
+{
+/**************************************
+ *
+ *	a c c o u n t _ a c q u i r e
+ *
+ **************************************
+ *
+ * Functional description
+ *	Account current lock table acquisition
+ *	to the hash slot group which is operated on.
+ *
+ **************************************/
+	ASSERT_ACQUIRED;
+
+	++group->lhg_acquires;
+
+	if (m_groupBlockage)
+	{
+		++group->lhg_acquire_blocks;
+		m_groupBlockage = false;
+	}
+}
+
+
 lrq* LockManager::get_request(SRQ_PTR offset)
 {
 /**************************************
@@ -3712,6 +3784,8 @@ void LockManager::wait_for_request(thread_db* tdbb, lrq* request, SSHORT lck_wai
  **************************************/
 	ASSERT_ACQUIRED;
 
+	thread_db::WaitGuard waitGuard(tdbb, RuntimeStatistics::LOCK_WAITS);
+
 	++(m_sharedMemory->getHeader()->lhb_waits);
 	const SLONG scan_interval = m_sharedMemory->getHeader()->lhb_scan_interval;
 
@@ -3732,6 +3806,7 @@ void LockManager::wait_for_request(thread_db* tdbb, lrq* request, SSHORT lck_wai
 	const SRQ_PTR lock_offset = request->lrq_lock;
 	lbl* lock = (lbl*) SRQ_ABS_PTR(lock_offset);
 	lock->lbl_pending_lrq_count++;
+	++(m_sharedMemory->getHeader()->lhb_hash_groups[lock->lbl_hash_group].lhg_waits);
 
 	if (!request->lrq_state)
 	{
@@ -93,7 +93,7 @@ const UCHAR type_lpr	= 7;
 
 // Version number of the lock table.
 // Must be increased every time the shmem layout is changed.
-const USHORT BASE_LHB_VERSION = 18;
+const USHORT BASE_LHB_VERSION = 19;
 
 #if SIZEOF_VOID_P == 8
 const USHORT PLATFORM_LHB_VERSION = 128;	// 64-bit target
@@ -103,6 +103,19 @@ const USHORT PLATFORM_LHB_VERSION	= 0;	// 32-bit target
 
 const USHORT LHB_VERSION	= PLATFORM_LHB_VERSION + BASE_LHB_VERSION;
 
+// Hash slots are grouped (slot modulo LHB_HASH_GROUPS) to account lock table
+// contention per group of locks. Groups are statistics only, they don't stripe
+// the lock table: the whole table is still protected by the single mutex.
+
+const USHORT LHB_HASH_GROUPS	= 16;
+
+struct lhg
+{
+	FB_UINT64 lhg_acquires;			// Lock table acquisitions to operate on the group
+	FB_UINT64 lhg_acquire_blocks;	// Acquisitions which had to wait for the mutex
+	FB_UINT64 lhg_waits;			// Requests which had to wait for the lock
+};
+
 // Lock header block -- one per lock file, lives up front
 
 struct lhb : public Firebird::MemoryHeader
@@ -142,6 +155,7 @@ struct lhb : public Firebird::MemoryHeader
 	FB_UINT64 lhb_wakeups;
 	FB_UINT64 lhb_scans;
 	FB_UINT64 lhb_deadlocks;
+	lhg lhb_hash_groups[LHB_HASH_GROUPS];	// Contention statistics of hash slot groups
 	srq lhb_data[LCK_MAX_SERIES];
 	srq lhb_hash[1];			// Hash table
 };
@@ -172,6 +186,7 @@ struct lbl
 	LOCK_DATA_T lbl_data;			// User data
 	UCHAR lbl_series;				// Lock series
 	UCHAR lbl_flags;				// Unused. Misc flags
+	UCHAR lbl_hash_group;			// Group of the hash slot, see LHB_HASH_GROUPS
 	USHORT lbl_pending_lrq_count;	// count of lbl_requests with LRQ_pending
 	USHORT lbl_counts[LCK_max];		// Counts of granted locks
 	UCHAR lbl_key[1];				// Key value
@@ -429,6 +444,7 @@ private:
 	lrq* deadlock_walk(lrq*, bool*);
 	void debug_delay(ULONG);
 	lbl* find_lock(USHORT, const UCHAR*, USHORT, USHORT*);
+	void account_acquire(lhg*);
 	lrq* get_request(SRQ_PTR);
 	void grant(lrq*, lbl*);
 	bool grant_or_que(thread_db*, lrq*, lbl*, SSHORT);
@@ -487,6 +503,7 @@ public:
 
 private:
 	bool m_blockage;
+	bool m_groupBlockage;		// last lock table acquisition had to wait
 
 	const Firebird::string& m_dbId;
 	const Config* const m_config;
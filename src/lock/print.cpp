@@ -855,6 +855,7 @@ int CLIB_ROUTINE main( int argc, char *argv[])
 	static const int MAX_MAX_COUNT_STATS = 21;
 	static const int LAST_MAX_COUNT_INDEX = MAX_MAX_COUNT_STATS - 1;
 	unsigned int distribution[MAX_MAX_COUNT_STATS] = {0}; // C++11 default brace initialization to zero
+	SLONG group_lock_count[LHB_HASH_GROUPS] = {0};
 	for (const srq* slot = LOCK_header->lhb_hash; i < LOCK_header->lhb_hash_slots; slot++, i++)
 	{
 		SLONG hash_lock_count = 0;
@@ -864,6 +865,7 @@ int CLIB_ROUTINE main( int argc, char *argv[])
 			++hash_total_count;
 			++hash_lock_count;
 		}
+		group_lock_count[i % LHB_HASH_GROUPS] += hash_lock_count;
 		if (hash_lock_count < hash_min_count)
 			hash_min_count = hash_lock_count;
 		if (hash_lock_count > hash_max_count)
@@ -890,6 +892,23 @@ int CLIB_ROUTINE main( int argc, char *argv[])
 	if (hash_max_count == LAST_MAX_COUNT_INDEX - 1)
 		FPRINTF(outfile, "\t\t>  : %8u\t(%d%%)\n", distribution[LAST_MAX_COUNT_INDEX], distribution[LAST_MAX_COUNT_INDEX] * 100 / LOCK_header->lhb_hash_slots);
 
+	// Contention statistics by the hash slot group (slot modulo number of groups)
+	// of the lock operated on. There is the single lock table mutex, so acquire
+	// blocks of a group are the waits for the whole table caused by its locks.
+	FPRINTF(outfile, "\tLock table contention by hash slot group:\n");
+	for (int n = 0; n < LHB_HASH_GROUPS; ++n)
+	{
+		const lhg* const group = &LOCK_header->lhb_hash_groups[n];
+		const float mutex_wait = group->lhg_acquires ?
+			(float) ((100. * group->lhg_acquire_blocks) / group->lhg_acquires) : 0;
+
+		FPRINTF(outfile,
+				"\t\t%-2d : Locks: %6" SLONGFORMAT", Table acquires: %6" UQUADFORMAT
+				", Table acquire blocks: %6" UQUADFORMAT" (%3.1f%%), Lock waits: %6" UQUADFORMAT"\n",
+				n, group_lock_count[n], group->lhg_acquires, group->lhg_acquire_blocks,
+				mutex_wait, group->lhg_waits);
+	}
+
 	const shb* a_shb = (shb*) SRQ_ABS_PTR(LOCK_header->lhb_secondary);
 	FPRINTF(outfile,
 			"\tRemove node: %6" SLONGFORMAT", Insert queue: %6" SLONGFORMAT
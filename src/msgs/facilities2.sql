@@ -3,13 +3,13 @@ set bulk_insert INSERT INTO FACILITIES (LAST_CHANGE, FACILITY, FAC_CODE, MAX_NUM
 --
 ('2020-03-04 16:39:50', 'JRD', 0, 949)
 ('2015-03-17 18:33:00', 'QLI', 1, 533)
-('2018-03-17 12:00:00', 'GFIX', 3, 136)
+('2018-03-17 12:00:00', 'GFIX', 3, 138)
 ('1996-11-07 13:39:40', 'GPRE', 4, 1)
 ('2017-02-05 20:37:00', 'DSQL', 7, 41)
 ('2018-06-22 11:46:00', 'DYN', 8, 309)
 ('1996-11-07 13:39:40', 'INSTALL', 10, 1)
 ('1996-11-07 13:38:41', 'TEST', 11, 4)
-('2020-03-20 12:45:00', 'GBAK', 12, 403)
+('2020-03-20 12:45:00', 'GBAK', 12, 406)
 ('2019-04-13 21:10:00', 'SQLERR', 13, 1047)
 ('1996-11-07 13:38:42', 'SQLWARN', 14, 613)
 ('2018-02-27 14:50:31', 'JRD_BUGCHK', 15, 308)
@@ -1804,6 +1804,8 @@ COMMIT WORK;
 ('gfix_role_req', 'ALICE_gfix', 'alice.c', NULL, 3, 133, NULL, 'SQL role name required', NULL, NULL);
 ('gfix_opt_repl', 'ALICE_gfix', 'alice.c', NULL, 3, 134, NULL, '   -repl(ica)           replica mode <none / read_only / read_write>', NULL, NULL);
 ('gfix_repl_mode_req', 'ALICE_gfix', 'alice.c', NULL, 3, 135, NULL, 'replica mode (none / read_only / read_write) required', NULL, NULL);
+('gfix_opt_parallel', 'ALICE_gfix', 'alice.c', NULL, 3, 136, NULL, '   -par(allel)          parallel workers <n> (-sweep)', NULL, NULL);
+('gfix_par_workers_req', 'ALICE_gfix', 'alice.c', NULL, 3, 137, NULL, 'number of parallel workers required', NULL, NULL);
 -- DSQL
 ('dsql_dbkey_from_non_table', 'MAKE_desc', 'make.c', NULL, 7, 2, NULL, 'Cannot SELECT RDB$DB_KEY from a stored procedure.', NULL, NULL);
 ('dsql_transitional_numeric', 'dsql_yyparse', 'parse.y', NULL, 7, 3, NULL, 'Precision 10 to 18 changed from DOUBLE PRECISION in SQL dialect 1 to 64-bit scaled integer in SQL dialect 3', NULL, NULL);
@@ -2570,6 +2572,9 @@ ERROR: Backup incomplete', NULL, NULL);
 (NULL, 'get_publication', 'restore.epp', NULL, 12, 400, NULL, 'publication', NULL, NULL);
 (NULL, 'get_pub_table', 'restore.epp', NULL, 12, 401, NULL, 'restoring publication for table @1', NULL, NULL);
 (NULL, 'get_pub_table', 'restore.epp', NULL, 12, 402, NULL, 'publication for table', NULL, NULL);
+(NULL, 'burp_usage', 'burp.c', NULL, 12, 403, NULL, '    @1PAR(ALLEL)           parallel workers', NULL, NULL);
+(NULL, NULL, 'burp.cpp', NULL, 12, 404, NULL, 'parallel workers parameter missing', NULL, NULL);
+(NULL, NULL, 'burp.cpp', NULL, 12, 405, NULL, 'expected parallel workers, encountered "@1"', NULL, NULL);
 -- SQLERR
 (NULL, NULL, NULL, NULL, 13, 1, NULL, 'Firebird error', NULL, NULL);
 (NULL, NULL, NULL, NULL, 13, 74, NULL, 'Rollback not performed', NULL, NULL);
@@ -998,6 +998,7 @@ static rem_port* analyze(ClntAuthBlock& cBlock, PathName& attach_name, unsigned
 	Firebird::ICryptKeyCallback* cryptCb);
 static void batch_gds_receive(rem_port*, struct rmtque *, USHORT);
 static void batch_dsql_fetch(rem_port*, struct rmtque *, USHORT);
+static void cache_inline_blob(Rdb*, const P_INLINE_BLOB*);
 static void clear_queue(rem_port*);
 static void clear_stmt_que(rem_port*, Rsr*);
 static void disconnect(rem_port*);
@@ -1005,6 +1006,7 @@ static void enqueue_receive(rem_port*, t_rmtque_fn, Rdb*, void*, Rrq::rrq_repeat
 static void dequeue_receive(rem_port*);
 static THREAD_ENTRY_DECLARE event_thread(THREAD_ENTRY_PARAM);
 static Rvnt* find_event(rem_port*, SLONG);
+static bool get_cached_blob_info(const Rbl*, unsigned, const UCHAR*, unsigned, UCHAR*);
 static bool get_new_dpb(ClumpletWriter&, const ParametersSet&);
 static void info(CheckStatusWrapper*, Rdb*, P_OP, USHORT, USHORT, USHORT,
 	const UCHAR*, USHORT, const UCHAR*, ULONG, UCHAR*);
@@ -1013,6 +1015,7 @@ static void init(CheckStatusWrapper*, ClntAuthBlock&, rem_port*, P_OP, PathName&
 static Rtr* make_transaction(Rdb*, USHORT);
 static void mov_dsql_message(const UCHAR*, const rem_fmt*, UCHAR*, const rem_fmt*);
 static void move_error(const Arg::StatusVector& v);
+static void open_cached_blob(IStatus*, Rbl*);
 static void receive_after_start(Rrq*, USHORT);
 static void receive_packet(rem_port*, PACKET *);
 static void receive_packet_noqueue(rem_port*, PACKET *);
@@ -1194,6 +1197,17 @@ void Blob::getInfo(CheckStatusWrapper* status,
 		rem_port* port = rdb->rdb_port;
 		RefMutexGuard portGuard(*port->port_sync, FB_FUNCTION);
 
+		// Inline blob knows the most often asked info items,
+		// ask the server only if something else is needed
+
+		if (blob->rbl_flags & Rbl::CACHED)
+		{
+			if (get_cached_blob_info(blob, itemsLength, items, bufferLength, buffer))
+				return;
+
+			open_cached_blob(status, blob);
+		}
+
 		info(status, rdb, op_info_blob, blob->rbl_id, 0,
 			 itemsLength, items, 0, 0, bufferLength, buffer);
 	}
@@ -1232,7 +1246,8 @@ void Blob::freeClientData(CheckStatusWrapper* status, bool force)
 
 		try
 		{
-			release_object(status, rdb, op_cancel_blob, blob->rbl_id);
+			if (!(blob->rbl_flags & Rbl::CACHED))
+				release_object(status, rdb, op_cancel_blob, blob->rbl_id);
 		}
 		catch (const Exception&)
 		{
@@ -1294,7 +1309,8 @@ void Blob::close(CheckStatusWrapper* status)
 			send_blob(status, blob, 0, NULL);
 		}
 
-		release_object(status, rdb, op_close_blob, blob->rbl_id);
+		if (!(blob->rbl_flags & Rbl::CACHED))
+			release_object(status, rdb, op_close_blob, blob->rbl_id);
 		release_blob(blob);
 		blob = NULL;
 	}
@@ -1818,16 +1834,43 @@ void Attachment::getInfo(CheckStatusWrapper* status,
 
 		UCHAR* temp_buffer = temp.getBuffer(buffer_length);
 
+		// Wire compression statistics are known to the port only, don't pass
+		// that item to the server
+
+		HalfStaticArray<UCHAR, 128> serverItems;
+		bool wireCompression = false;
+
+		for (const UCHAR* p = items; p < items + item_length; p++)
+		{
+			if (*p == fb_info_wire_compression)
+			{
+				wireCompression = true;
+				continue;
+			}
+
+			if (*p == fb_info_page_contents)
+			{
+				// the rest of the items may contain a page number
+				serverItems.add(p, items + item_length - p);
+				break;
+			}
+
+			serverItems.add(*p);
+		}
+
 		info(status, rdb, op_info_database, rdb->rdb_id, 0,
-			 item_length, items, 0, 0, buffer_length, temp_buffer);
+			 serverItems.getCount(), serverItems.begin(), 0, 0, buffer_length, temp_buffer);
 
 		string version;
 		port->versionInfo(version);
 
-		MERGE_database_info(temp_buffer, buffer, buffer_length,
+		const USHORT length = MERGE_database_info(temp_buffer, buffer, buffer_length,
 							DbImplementation::current.backwardCompatibleImplementation(), 3, 1,
 							reinterpret_cast<const UCHAR*>(version.c_str()),
 							reinterpret_cast<const UCHAR*>(port->port_host->str_data));
+
+		if (wireCompression && length && buffer[length - 1] == isc_info_end)
+			port->putCompressionInfo(buffer + length - 1, buffer + buffer_length);
 	}
 	catch (const Exception& ex)
 	{
@@ -4017,6 +4060,8 @@ int ResultSet::fetchNext(CheckStatusWrapper* status, void* buffer)
 
 		rem_port* port = rdb->rdb_port;
 
+		statement->fetchCalled();
+
 		BlrFromMessage outBlr(outputFormat, stmt->getDialect(), port->port_protocol);
 		unsigned int blr_length = outBlr.getLength();
 		const UCHAR* blr = outBlr.getBytes();
@@ -4124,7 +4169,15 @@ int ResultSet::fetchNext(CheckStatusWrapper* status, void* buffer)
 			sqldata->p_sqldata_blr.cstr_address = const_cast<unsigned char*>(blr);
 			sqldata->p_sqldata_message_number = 0;	// msg_type
 			sqldata->p_sqldata_messages = 0;
-			if (statement->rsr_select_format)
+			sqldata->p_sqldata_inline_blob_size = port->getPortConfig()->getMaxInlineBlobSize();
+			if (statement->rsr_select_format && port->port_protocol >= PROTOCOL_VERSION17)
+			{
+				// Size the batch by bytes, reorder data when the rows left in
+				// the local buffer are about to be consumed during a round trip
+
+				sqldata->p_sqldata_messages = REMOTE_compute_fetch_batch(port, statement);
+			}
+			else if (statement->rsr_select_format)
 			{
 				sqldata->p_sqldata_messages =
 					REMOTE_compute_batch_size(port, 0, op_fetch_response, statement->rsr_select_format);
@@ -4151,6 +4204,7 @@ int ResultSet::fetchNext(CheckStatusWrapper* status, void* buffer)
 
 			// Make the batch request - and force the packet over the wire
 
+			statement->batchRequested();
 			send_packet(port, packet);
 
 			statement->rsr_batch_count++;
@@ -4231,6 +4285,7 @@ int ResultSet::fetchNext(CheckStatusWrapper* status, void* buffer)
 		}
 
 		message->msg_address = NULL;
+		statement->fetchReturned();
 		return IStatus::RESULT_OK;
 	}
 	catch (const Exception& ex)
@@ -4896,6 +4951,43 @@ IBlob* Attachment::openBlob(CheckStatusWrapper* status, ITransaction* apiTra, IS
 		Rtr* transaction = remoteTransaction(apiTra);
 		CHECK_HANDLE(transaction, isc_bad_trans_handle);
 
+		// Blob sent by the server together with the fetched row may be read
+		// without opening it at the server, unless a filter is asked for
+
+		if (!bpb_length)
+		{
+			AutoPtr<InlineBlob> inlineBlob(transaction->getInlineBlob(*id));
+
+			if (inlineBlob)
+			{
+				const FB_SIZE_T length = inlineBlob->ibl_data.getCount();
+
+				Rbl* blob = FB_NEW Rbl;
+				blob->rbl_rdb = rdb;
+				blob->rbl_rtr = transaction;
+				blob->rbl_blob_id = *id;
+				blob->rbl_flags = Rbl::CACHED | Rbl::EOF_PENDING;
+				blob->rbl_info = inlineBlob->ibl_info;
+
+				if (length > blob->rbl_buffer_length)
+				{
+					blob->rbl_buffer = blob->rbl_data.getBuffer(length);
+					blob->rbl_buffer_length = (USHORT) length;
+				}
+
+				memcpy(blob->rbl_buffer, inlineBlob->ibl_data.begin(), length);
+				blob->rbl_ptr = blob->rbl_buffer;
+				blob->rbl_length = (USHORT) length;
+
+				blob->rbl_next = transaction->rtr_blobs;
+				transaction->rtr_blobs = blob;
+
+				Firebird::IBlob* b = FB_NEW Blob(blob);
+				b->addRef();
+				return b;
+			}
+		}
+
 		// Validate data length
 
 		CHECK_LENGTH(port, bpb_length);
@@ -5020,6 +5112,9 @@ void Blob::putSegment(CheckStatusWrapper* status, unsigned int segment_length, c
 
 		if (!(blob->rbl_flags & Rbl::CREATE))
 		{
+			if (blob->rbl_flags & Rbl::CACHED)
+				open_cached_blob(status, blob);
+
 			send_blob(status, blob, segment_length, segmentPtr);
 			fb_assert(false);
 		}
@@ -5702,6 +5797,9 @@ int Blob::seek(CheckStatusWrapper* status, int mode, int offset)
 		rem_port* port = rdb->rdb_port;
 		RefMutexGuard portGuard(*port->port_sync, FB_FUNCTION);
 
+		if (blob->rbl_flags & Rbl::CACHED)
+			open_cached_blob(status, blob);
+
 		PACKET* packet = &rdb->rdb_packet;
 		packet->p_operation = op_seek_blob;
 		P_SEEK* seek = &packet->p_seek;
@@ -6872,6 +6970,16 @@ static void batch_dsql_fetch(rem_port*	port,
 			throw;
 		}
 
+		statement->batchReceived();
+
+		// Blobs referenced by the row are sent ahead of it
+
+		if (packet->p_operation == op_inline_blob)
+		{
+			cache_inline_blob(rdb, &packet->p_inline_blob);
+			continue;
+		}
+
 		if (packet->p_operation != op_fetch_response)
 		{
 			statement->rsr_flags.set(Rsr::STREAM_ERR);
@@ -7080,6 +7188,43 @@ static void batch_gds_receive(rem_port*		port,
 }
 
 
+static void cache_inline_blob(Rdb* rdb, const P_INLINE_BLOB* packet)
+{
+/**************************************
+ *
+ *	c a c h e _ i n l i n e _ b l o b
+ *
+ **************************************
+ *
+ * Functional description
+ *	Save the blob sent by the server ahead of
+ *	the fetched row to be read later without
+ *	round trips to the server.
+ *
+ **************************************/
+	if (packet->p_inline_blob_data.cstr_length > MAX_USHORT)
+		return;
+
+	for (Rtr* transaction = rdb->rdb_transactions; transaction; transaction = transaction->rtr_next)
+	{
+		if (transaction->rtr_id == packet->p_inline_blob_transaction)
+		{
+			AutoPtr<InlineBlob> blob(FB_NEW InlineBlob);
+
+			blob->ibl_info.assign(packet->p_inline_blob_info.cstr_address,
+				packet->p_inline_blob_info.cstr_length);
+			blob->ibl_data.assign(packet->p_inline_blob_data.cstr_address,
+				packet->p_inline_blob_data.cstr_length);
+
+			if (transaction->putInlineBlob(packet->p_inline_blob_id, blob))
+				blob.release();
+
+			break;
+		}
+	}
+}
+
+
 static void clear_queue(rem_port* port)
 {
 /**************************************
@@ -7294,6 +7439,62 @@ static Rvnt* find_event( rem_port* port, SLONG id)
 }
 
 
+static bool get_cached_blob_info(const Rbl* blob, unsigned itemsLength, const UCHAR* items,
+	unsigned bufferLength, UCHAR* buffer)
+{
+/**************************************
+ *
+ *	g e t _ c a c h e d _ b l o b _ i n f o
+ *
+ **************************************
+ *
+ * Functional description
+ *	Answer the info request for an inline blob using
+ *	the info items sent by the server. Return false if
+ *	some of the requested items is not known.
+ *
+ **************************************/
+	UCHAR* ptr = buffer;
+	const UCHAR* const end = buffer + bufferLength;
+
+	for (const UCHAR* const itemsEnd = items + itemsLength; items < itemsEnd; items++)
+	{
+		if (*items == isc_info_end)
+			break;
+
+		const UCHAR* p = blob->rbl_info.begin();
+		const UCHAR* const infoEnd = blob->rbl_info.end();
+		USHORT length = 0;
+
+		for (; p + 3 <= infoEnd && *p != isc_info_end; p += 3 + length)
+		{
+			length = (USHORT) gds__vax_integer(p + 1, 2);
+
+			if (*p == *items)
+				break;
+		}
+
+		if (p + 3 > infoEnd || *p != *items || p + 3 + length > infoEnd)
+			return false;
+
+		if (ptr + 3 + length >= end)
+		{
+			if (ptr < end)
+				*ptr = isc_info_truncated;
+			return true;
+		}
+
+		memcpy(ptr, p, 3 + length);
+		ptr += 3 + length;
+	}
+
+	if (ptr < end)
+		*ptr = isc_info_end;
+
+	return true;
+}
+
+
 static bool get_new_dpb(ClumpletWriter& dpb, const ParametersSet& par)
 {
 /**************************************
@@ -7512,7 +7713,7 @@ static void authReceiveResponse(bool havePacket, ClntAuthBlock& cBlock, rem_port
 				n->cstr_length, n->cstr_address, n->cstr_address ? n->cstr_address[0] : 0));
 			if (packet->p_acpd.p_acpt_type & pflag_compress)
 			{
-				port->initCompression();
+				port->initCompression(packet->p_acpd.p_acpt_type);
 				port->port_flags |= PORT_compressed;
 			}
 			packet->p_acpd.p_acpt_type &= ptype_MASK;
@@ -7727,6 +7928,39 @@ static void move_error(const Arg::StatusVector& v)
 }
 
 
+static void open_cached_blob(IStatus* status, Rbl* blob)
+{
+/**************************************
+ *
+ *	o p e n _ c a c h e d _ b l o b
+ *
+ **************************************
+ *
+ * Functional description
+ *	Open an inline blob at the server when something
+ *	not known locally is asked for. Buffered contents
+ *	of the blob are still used for reading.
+ *
+ **************************************/
+	Rdb* rdb = blob->rbl_rdb;
+	Rtr* transaction = blob->rbl_rtr;
+
+	PACKET* packet = &rdb->rdb_packet;
+	packet->p_operation = op_open_blob2;
+	P_BLOB* p_blob = &packet->p_blob;
+	p_blob->p_blob_transaction = transaction->rtr_id;
+	p_blob->p_blob_id = blob->rbl_blob_id;
+	p_blob->p_blob_bpb.cstr_length = 0;
+	p_blob->p_blob_bpb.cstr_address = NULL;
+
+	send_and_receive(status, rdb, packet);
+
+	blob->rbl_id = packet->p_resp.p_resp_object;
+	SET_OBJECT(rdb, blob, blob->rbl_id);
+	blob->rbl_flags &= ~Rbl::CACHED;
+}
+
+
 static void receive_after_start(Rrq* request, USHORT msg_type)
 {
 /*****************************************
@@ -8118,7 +8352,9 @@ static void release_blob( Rbl* blob)
  **************************************/
 	Rtr* transaction = blob->rbl_rtr;
 	Rdb* rdb = blob->rbl_rdb;
-	rdb->rdb_port->releaseObject(blob->rbl_id);
+
+	if (!(blob->rbl_flags & Rbl::CACHED))
+		rdb->rdb_port->releaseObject(blob->rbl_id);
 
 	for (Rbl** p = &transaction->rtr_blobs; *p; p = &(*p)->rbl_next)
 	{
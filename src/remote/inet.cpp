@@ -95,6 +95,11 @@
 #include <sys/select.h>
 #endif
 
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_POLL)
+#include <sys/epoll.h>
+#define INET_EPOLL
+#endif
+
 #endif // !WIN_NT
 
 const int INET_RETRY_CALL = 5;
@@ -407,6 +412,221 @@ private:
 #endif
 };
 
+#ifdef INET_EPOLL
+
+// Edge-triggered epoll set of the multi-client server ports. Ports are added
+// once, when they are accepted, and removed when they are disconnected. Handles
+// reported by epoll_wait are kept in the queue until their ports have nothing
+// more to read, so the cost of the wakeup depends on the number of active
+// ports and not on the total number of connections.
+// Everything but select() should be called with port_mutex locked.
+
+class EpollSelect
+{
+private:
+	static const int MAX_EVENTS = 256;
+
+	struct Handle
+	{
+		rem_port* port;
+		bool queued;
+	};
+
+	typedef GenericMap<NonPooled<SOCKET, Handle> > HandleMap;
+	typedef GenericMap<NonPooled<rem_port*, SOCKET> > PortMap;
+
+	static bool hasData(const rem_port* port)
+	{
+#ifdef WIRE_COMPRESS_SUPPORT
+		if (port->port_flags & PORT_z_data)
+			return true;
+#endif
+		pollfd pf;
+		pf.fd = port->port_handle;
+		pf.events = POLLIN;
+		pf.revents = 0;
+
+		int n;
+		do
+		{
+			n = ::poll(&pf, 1, 0);
+		} while (n < 0 && SYSCALL_INTERRUPTED(errno));
+
+		// errors and hang-ups are handled by the receive() of the port
+		return n != 0;
+	}
+
+public:
+	explicit EpollSelect(MemoryPool& pool)
+		: slct_time(0), slct_epoll(-1), slct_count(0),
+		  slct_handles(pool), slct_ports(pool), slct_queue(pool), slct_pos(0)
+	{ }
+
+	~EpollSelect()
+	{
+		if (slct_epoll >= 0)
+			close(slct_epoll);
+	}
+
+	bool add(rem_port* port)
+	{
+		const SOCKET handle = port->port_handle;
+		if (handle == INVALID_SOCKET)
+			return false;
+
+		const Handle* const old = slct_handles.get(handle);
+		if (old)
+		{
+			if (old->port == port)
+				return true;
+
+			// socket was closed by force_close() and its descriptor reused
+			slct_ports.remove(old->port);
+		}
+
+		if (slct_epoll < 0)
+		{
+			slct_epoll = epoll_create1(EPOLL_CLOEXEC);
+			if (slct_epoll < 0)
+			{
+				gds__log("INET/select: epoll_create1 failed, errno = %d", errno);
+				return false;
+			}
+		}
+
+		epoll_event event;
+		event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+		event.data.u64 = 0;
+		event.data.fd = handle;
+
+		if (epoll_ctl(slct_epoll, EPOLL_CTL_ADD, handle, &event) < 0 &&
+			(errno != EEXIST || epoll_ctl(slct_epoll, EPOLL_CTL_MOD, handle, &event) < 0))
+		{
+			gds__log("INET/select: epoll_ctl failed, errno = %d", errno);
+			return false;
+		}
+
+		Handle entry;
+		entry.port = port;
+		entry.queued = false;
+		slct_handles.put(handle, entry);
+		slct_ports.put(port, handle);
+
+		// data could arrive before the handle was added
+		enqueue(handle);
+		return true;
+	}
+
+	void remove(rem_port* port)
+	{
+		SOCKET handle;
+		if (!slct_ports.get(port, handle))
+			return;
+
+		slct_ports.remove(port);
+		slct_handles.remove(handle);
+
+		// descriptor may be already closed, it's not an error
+		epoll_ctl(slct_epoll, EPOLL_CTL_DEL, handle, NULL);
+	}
+
+	void enqueue(SOCKET handle)
+	{
+		Handle* const h = slct_handles.get(handle);
+		if (h && !h->queued)
+		{
+			h->queued = true;
+			slct_queue.push(handle);
+		}
+	}
+
+	bool hasPorts() const
+	{
+		return slct_ports.count() != 0;
+	}
+
+	bool hasQueued() const
+	{
+		return slct_count > 0 || slct_pos < slct_queue.getCount();
+	}
+
+	// Returns next port which has something to read or its keepalive timer expired
+	rem_port* next()
+	{
+		for (int i = 0; i < slct_count; i++)
+			enqueue(slct_events[i].data.fd);
+		slct_count = 0;
+
+		if (slct_pos > MAX_EVENTS && slct_pos > slct_queue.getCount() / 2)
+		{
+			slct_queue.removeCount(0, slct_pos);
+			slct_pos = 0;
+		}
+
+		while (slct_pos < slct_queue.getCount())
+		{
+			const SOCKET handle = slct_queue[slct_pos++];
+			Handle* const h = slct_handles.get(handle);
+			if (!h || !h->queued)
+				continue;
+
+			h->queued = false;
+			rem_port* const port = h->port;
+
+			if (port->port_state != rem_port::PENDING)
+				continue;
+
+			if (hasData(port))
+			{
+				// Edge-triggered epoll will not report the data left after the
+				// single read of the port, so look at the handle again later.
+				h->queued = true;
+				slct_queue.push(handle);
+
+				port->port_dummy_timeout = port->port_dummy_packet_interval;
+				return port;
+			}
+
+			if (port->port_dummy_timeout < 0)
+				return port;
+		}
+
+		slct_queue.clear();
+		slct_pos = 0;
+		return NULL;
+	}
+
+	void select(timeval* timeout)
+	{
+		const int milliseconds = timeout ? timeout->tv_sec * 1000 + timeout->tv_usec / 1000 : -1;
+		slct_count = epoll_wait(slct_epoll, slct_events, MAX_EVENTS, milliseconds);
+	}
+
+	int getCount()
+	{
+		return slct_count;
+	}
+
+	time_t	slct_time;
+
+private:
+	int			slct_epoll;
+	int			slct_count;
+	epoll_event	slct_events[MAX_EVENTS];
+	HandleMap	slct_handles;
+	PortMap		slct_ports;
+	Array<SOCKET> slct_queue;
+	FB_SIZE_T	slct_pos;
+};
+
+typedef EpollSelect MultiSelect;
+
+#else // INET_EPOLL
+
+typedef Select MultiSelect;
+
+#endif // INET_EPOLL
+
 static bool		accept_connection(rem_port*, const P_CNCT*);
 #ifdef HAVE_SETITIMER
 static void		alarm_handler(int);
@@ -473,9 +693,9 @@ static bool		packet_send(rem_port*, const SCHAR*, SSHORT);
 static rem_port*		receive(rem_port*, PACKET *);
 static rem_port*		select_accept(rem_port*);
 
-static void		select_port(rem_port*, Select*, RemPortPtr&);
+static void		select_port(rem_port*, MultiSelect*, RemPortPtr&);
 static bool		select_multi(rem_port*, UCHAR* buffer, SSHORT bufsize, SSHORT* length, RemPortPtr&);
-static bool		select_wait(rem_port*, Select*);
+static bool		select_wait(rem_port*, MultiSelect*);
 static int		send_full(rem_port*, PACKET *);
 static int		send_partial(rem_port*, PACKET *);
 
@@ -524,7 +744,7 @@ ULONG INET_remote_buffer;
 static GlobalPtr<Mutex> init_mutex;
 static volatile bool INET_initialized = false;
 static volatile bool INET_shutting_down = false;
-static Firebird::GlobalPtr<Select> INET_select;
+static Firebird::GlobalPtr<MultiSelect> INET_select;
 static rem_port* inet_async_receive = NULL;
 
 
@@ -622,17 +842,24 @@ rem_port* INET_analyze(ClntAuthBlock* cBlock,
 		REMOTE_PROTOCOL(PROTOCOL_VERSION13, ptype_lazy_send, 4),
 		REMOTE_PROTOCOL(PROTOCOL_VERSION14, ptype_lazy_send, 5),
 		REMOTE_PROTOCOL(PROTOCOL_VERSION15, ptype_lazy_send, 6),
-		REMOTE_PROTOCOL(PROTOCOL_VERSION16, ptype_lazy_send, 7)
+		REMOTE_PROTOCOL(PROTOCOL_VERSION16, ptype_lazy_send, 7),
+		REMOTE_PROTOCOL(PROTOCOL_VERSION17, ptype_lazy_send, 8)
 	};
 	fb_assert(FB_NELEM(protocols_to_try) <= FB_NELEM(cnct->p_cnct_versions));
 	cnct->p_cnct_count = FB_NELEM(protocols_to_try);
 
+	// zlib remains mandatory as a fallback for the servers that can't use zstd
+	compression = compression && rem_port::checkCompression(WIRE_COMPRESS_ZLIB);
+	const bool zstd = compression && (*config)->getWireCompressionCodec() == WIRE_COMPRESS_ZSTD &&
+		rem_port::checkCompression(WIRE_COMPRESS_ZSTD);
+
 	for (size_t i = 0; i < cnct->p_cnct_count; i++) {
 		cnct->p_cnct_versions[i] = protocols_to_try[i];
-		if (compression && cnct->p_cnct_versions[i].p_cnct_version >= PROTOCOL_VERSION13 &&
-			rem_port::checkCompression())
+		if (compression && cnct->p_cnct_versions[i].p_cnct_version >= PROTOCOL_VERSION13)
 		{
 			cnct->p_cnct_versions[i].p_cnct_max_type |= pflag_compress;
+			if (zstd)
+				cnct->p_cnct_versions[i].p_cnct_max_type |= pflag_compress_zstd;
 		}
 	}
 
@@ -744,7 +971,7 @@ rem_port* INET_analyze(ClntAuthBlock* cBlock,
 		port->port_flags |= PORT_symmetric;
 	}
 
-	bool compress = accept->p_acpt_type & pflag_compress;
+	const USHORT acceptType = accept->p_acpt_type;
 	accept->p_acpt_type &= ptype_MASK;
 
 	if (accept->p_acpt_type != ptype_out_of_band) {
@@ -755,9 +982,9 @@ rem_port* INET_analyze(ClntAuthBlock* cBlock,
 		port->port_flags |= PORT_lazy;
 	}
 
-	if (compress)
+	if (acceptType & pflag_compress)
 	{
-		port->initCompression();
+		port->initCompression(acceptType);
 		port->port_flags |= PORT_compressed;
 	}
 
@@ -1457,6 +1684,14 @@ static rem_port* aux_connect(rem_port* port, PACKET* packet)
 		port->port_handle = n;
 		port->port_flags |= PORT_async;
 
+#ifdef INET_EPOLL
+		if (port->port_parent)
+		{
+			MutexLockGuard guard(port_mutex, FB_FUNCTION);
+			INET_select->add(port);
+		}
+#endif
+
 		get_peer_info(port);
 
 		return port;
@@ -1714,6 +1949,10 @@ static void disconnect(rem_port* port)
 	// If this is a sub-port, unlink it from its parent
 	port->unlinkParent();
 
+#ifdef INET_EPOLL
+	INET_select->remove(port);
+#endif
+
 	inet_ports->unRegisterPort(port);
 
 	if (delayClose)
@@ -2102,10 +2341,152 @@ static rem_port* select_accept( rem_port* main_port)
 		return port;
 	}
 
+#ifdef INET_EPOLL
+	{ // port_mutex scope
+		MutexLockGuard guard(port_mutex, FB_FUNCTION);
+		if (!INET_select->add(port))
+			inet_error(true, port, "epoll_ctl", isc_net_connect_err, INET_ERRNO);
+	}
+#endif
+
 	return 0;
 }
 
-static void select_port(rem_port* main_port, Select* selct, RemPortPtr& port)
+#ifdef INET_EPOLL
+static void select_port(rem_port* /*main_port*/, MultiSelect* selct, RemPortPtr& port)
+{
+/**************************************
+ *
+ *	s e l e c t _ p o r t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Return the next port block from the queue
+ *	of the ports reported by epoll which still
+ *	has something to read or its keepalive
+ *	timer has expired. Return NULL if the
+ *	queue is empty.
+ *
+ **************************************/
+
+	MutexLockGuard guard(port_mutex, FB_FUNCTION);
+
+	port = selct->next();
+}
+
+static bool select_wait(rem_port* main_port, MultiSelect* selct)
+{
+/**************************************
+ *
+ *	s e l e c t _ w a i t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Wait for something to read from the
+ *	ports added to the epoll set.
+ *
+ **************************************/
+	struct timeval timeout;
+
+	for (;;)
+	{
+		time_t delta_time;
+		if (selct->slct_time)
+		{
+			delta_time = time(NULL) - selct->slct_time;
+			selct->slct_time += delta_time;
+		}
+		else
+		{
+			delta_time = 0;
+			selct->slct_time = time(NULL);
+		}
+
+		bool found, queued;
+
+		{ // port_mutex scope
+			MutexLockGuard guard(port_mutex, FB_FUNCTION);
+
+			while (ports_to_close->hasData())
+			{
+				SOCKET s = ports_to_close->pop();
+				SOCLOSE(s);
+			}
+
+			// Ports are added to the epoll set when they are accepted and removed
+			// on disconnect, so walk the ports list only to expire keepalive timers,
+			// i.e. not more often than once a second, and on shutdown.
+
+			if (delta_time || INET_shutting_down || !selct->hasPorts())
+			{
+				for (rem_port* port = main_port; port; port = port->port_next)
+				{
+					if (port->port_state == rem_port::PENDING &&
+						// don't wait on still listening (not connected) async port
+						!(port->port_handle == INVALID_SOCKET && (port->port_flags & PORT_async)) &&
+						// if process is shuting down - don't listen on main port
+						(!INET_shutting_down || port != main_port))
+					{
+						if (!selct->add(port))
+							continue;
+
+						// Adjust down the port's keepalive timer.
+
+						if (port->port_dummy_packet_interval)
+						{
+							port->port_dummy_timeout -= delta_time;
+							if (port->port_dummy_timeout < 0)
+								selct->enqueue(port->port_handle);
+						}
+					}
+					else
+						selct->remove(port);
+				}
+			}
+
+			found = selct->hasPorts();
+			queued = selct->hasQueued();
+		} // port_mutex scope
+
+		if (!found)
+		{
+			if (!INET_shutting_down && (main_port->port_server_flags & SRVR_multi_client))
+				gds__log("INET/select_wait: client rundown complete, server exiting");
+
+			return false;
+		}
+
+		for (;;)
+		{
+			// Before waiting for incoming packet, check for server shutdown
+			if (tryStopMainThread && tryStopMainThread())
+			{
+				// this is not server port any more
+				main_port->port_server_flags &= ~SRVR_multi_client;
+				return false;
+			}
+
+			// Don't wait if some port was added with the data already received
+			timeout.tv_sec = queued ? 0 : SELECT_TIMEOUT;
+			timeout.tv_usec = 0;
+
+			selct->select(&timeout);
+			const int inetErrNo = INET_ERRNO;
+
+			if (selct->getCount() != -1)
+				return true;
+			if (INTERRUPT_ERROR(inetErrNo))
+				continue;
+
+			gds__log("INET/select_wait: epoll_wait failed, errno = %d", inetErrNo);
+			return false;
+		}	// for (;;)
+	}
+}
+#else // INET_EPOLL
+static void select_port(rem_port* main_port, MultiSelect* selct, RemPortPtr& port)
 {
 /**************************************
  *
@@ -2155,7 +2536,7 @@ static void select_port(rem_port* main_port, Select* selct, RemPortPtr& port)
 	}
 }
 
-static bool select_wait( rem_port* main_port, Select* selct)
+static bool select_wait( rem_port* main_port, MultiSelect* selct)
 {
 /**************************************
  *
@@ -2320,6 +2701,7 @@ static bool select_wait( rem_port* main_port, Select* selct)
 		}	// for (;;)
 	}
 }
+#endif // INET_EPOLL
 
 static int send_full( rem_port* port, PACKET * packet)
 {
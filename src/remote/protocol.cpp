@@ -707,6 +707,11 @@ bool_t xdr_protocol(XDR* xdrs, PACKET* p)
 		}
 		MAP(xdr_short, reinterpret_cast<SSHORT&>(sqldata->p_sqldata_message_number));
 		MAP(xdr_short, reinterpret_cast<SSHORT&>(sqldata->p_sqldata_messages));
+		{ // scope
+			rem_port* port = (rem_port*) xdrs->x_public;
+			if (port->port_protocol >= PROTOCOL_INLINE_BLOB)
+				MAP(xdr_u_long, sqldata->p_sqldata_inline_blob_size);
+		}
 		DEBUG_PRINTSIZE(xdrs, p->p_operation);
 		return P_TRUE(xdrs, p);
 
@@ -1111,6 +1116,18 @@ bool_t xdr_protocol(XDR* xdrs, PACKET* p)
 			return P_TRUE(xdrs, p);
 		}
 
+	case op_inline_blob:
+		{
+			P_INLINE_BLOB* blob = &p->p_inline_blob;
+			MAP(xdr_short, reinterpret_cast<SSHORT&>(blob->p_inline_blob_transaction));
+			MAP(xdr_quad, blob->p_inline_blob_id);
+			MAP(xdr_cstring, blob->p_inline_blob_info);
+			MAP(xdr_cstring, blob->p_inline_blob_data);
+			DEBUG_PRINTSIZE(xdrs, p->p_operation);
+
+			return P_TRUE(xdrs, p);
+		}
+
 	///case op_insert:
 	default:
 #ifdef DEV_BUILD
@@ -93,6 +93,13 @@ const USHORT PROTOCOL_VERSION15 = (FB_PROTOCOL_FLAG | 15);
 const USHORT PROTOCOL_VERSION16 = (FB_PROTOCOL_FLAG | 16);
 const USHORT PROTOCOL_STMT_TOUT = PROTOCOL_VERSION16;
 
+// Protocol 17:
+//	- supports inline blobs, i.e. sending small blobs together with the fetched rows
+//	- fetch batches are sized by the client and never cut by the server
+
+const USHORT PROTOCOL_VERSION17 = (FB_PROTOCOL_FLAG | 17);
+const USHORT PROTOCOL_INLINE_BLOB = PROTOCOL_VERSION17;
+
 // Architecture types
 
 enum P_ARCH
@@ -126,6 +133,7 @@ const USHORT ptype_MASK			= 0xFF;	// Mask - up to 255 types of protocol
 //
 // upper byte is used for protocol flags
 const USHORT pflag_compress		= 0x100;	// Turn on compression if possible
+const USHORT pflag_compress_zstd	= 0x200;	// Use zstd instead of zlib for compression
 
 // Generic object id
 
@@ -288,6 +296,8 @@ enum P_OP
 	op_repl_data			= 107,
 	op_repl_req				= 108,
 
+	op_inline_blob			= 109,	// Blob contents sent ahead of the fetched row
+
 	op_max
 };
 
@@ -596,6 +606,7 @@ typedef struct p_sqldata
     USHORT	p_sqldata_out_message_number;
     ULONG	p_sqldata_status;			// final eof status
 	ULONG	p_sqldata_timeout;			// statement timeout
+	ULONG	p_sqldata_inline_blob_size;	// max size of blobs to send inline with fetched rows
 } P_SQLDATA;
 
 typedef struct p_sqlfree
@@ -723,6 +734,17 @@ typedef struct p_replicate
 } P_REPLICATE;
 
 
+// Inline blob
+
+typedef struct p_inline_blob
+{
+	OBJCT			p_inline_blob_transaction;	// transaction object
+	SQUAD			p_inline_blob_id;			// blob id
+	CSTRING			p_inline_blob_info;			// blob info response
+	CSTRING			p_inline_blob_data;			// blob segments
+} P_INLINE_BLOB;
+
+
 // Generalize packet (sic!)
 
 typedef struct packet
@@ -775,6 +797,7 @@ typedef struct packet
 	P_BATCH_REGBLOB p_batch_regblob;	// Register already existing BLOB in batch
 	P_BATCH_SETBPB p_batch_setbpb;		// Set default BPB for batch
 	P_REPLICATE p_replicate;	// replicate
+	P_INLINE_BLOB p_inline_blob;	// Blob sent together with the fetched row
 
 public:
 	packet()
@@ -32,6 +32,7 @@
 #include "../remote/remot_proto.h"
 #include "../common/xdr_proto.h"
 #include "../yvalve/gds_proto.h"
+#include "../common/utils_proto.h"
 #include "../common/config/config.h"
 #include "../common/classes/init.h"
 #include "../common/db_alias.h"
@@ -39,6 +40,7 @@
 #include "../common/os/mod_loader.h"
 #include "../jrd/license.h"
 #include "../common/classes/ImplementHelper.h"
+#include "memory_routines.h"
 
 #ifdef DEV_BUILD
 Firebird::AtomicCounter rem_port::portCounter;
@@ -249,6 +251,64 @@ USHORT REMOTE_compute_batch_size(rem_port* port,
 }
 
 
+USHORT REMOTE_compute_fetch_batch(rem_port* port, Rsr* statement)
+{
+/**************************************
+ *
+ *	R E M O T E _ c o m p u t e _ f e t c h _ b a t c h
+ *
+ **************************************
+ *
+ * Functional description
+ *	Size the next batch of rows to fetch by bytes rather
+ *	than by rows, and choose the reorder level - number of
+ *	rows left in the client cache when the next batch is
+ *	asked for.
+ *
+ *	The first batch fills the packets the server would send
+ *	at once. Later the round trip time of a fetch and the
+ *	time the application spends on a row are known, and the
+ *	next batch is asked for when the rows left are about to
+ *	be consumed during the round trip, while the batch is made
+ *	big enough to keep the pipe full until the next reorder.
+ *
+ **************************************/
+	const rem_fmt* const format = statement->rsr_select_format;
+
+	const ULONG row_size = xdr_protocol_overhead(op_fetch_response) +
+		((port->port_flags & PORT_symmetric) ?
+			ROUNDUP(format->fmt_length, 4) :
+			ROUNDUP(format->fmt_net_length, 4));
+
+	FB_UINT64 batch_bytes = MAX_PACKETS_PER_BATCH * port->port_buff_size;
+	FB_UINT64 reorder = 0;
+
+	if (statement->rsr_fetch_rtt && statement->rsr_row_interval)
+	{
+		// Rows consumed by the application during a round trip, with a reserve
+
+		reorder = (FB_UINT64) statement->rsr_fetch_rtt * 5 / 4 / statement->rsr_row_interval + 1;
+		batch_bytes = MAX(batch_bytes, reorder * 2 * row_size);
+	}
+
+	// Don't ask for more than we can cache
+
+	batch_bytes = MIN(batch_bytes, MAX_BATCH_CACHE_SIZE);
+
+	FB_UINT64 result = batch_bytes / row_size;
+	result = MIN(result, MAX_BATCH_CACHE_SIZE / format->fmt_length);
+
+	// Must always send some messages, even if message is larger than packet
+
+	result = MAX(result, MIN_ROWS_PER_BATCH);
+	result = MIN(result, MAX_ROWS_PER_FETCH);
+
+	statement->rsr_reorder_level = (USHORT) (reorder ? MIN(reorder, result) : result / 2);
+
+	return static_cast<USHORT>(result);
+}
+
+
 Rrq* REMOTE_find_request(Rrq* request, USHORT level)
 {
 /**************************************
@@ -867,6 +927,105 @@ void Rsr::saveException(const Firebird::Exception& ex, bool overwrite)
 	}
 }
 
+static inline FB_UINT64 inlineBlobKey(const ISC_QUAD& id)
+{
+	return ((FB_UINT64) (ULONG) id.gds_quad_high << 32) | id.gds_quad_low;
+}
+
+static SINT64 getMicroseconds()
+{
+	static const double frequency = (double) fb_utils::query_performance_frequency();
+	return (SINT64) (fb_utils::query_performance_counter() * 1000000.0 / frequency);
+}
+
+static inline ULONG smoothTime(ULONG average, SINT64 sample)
+{
+	const ULONG value = (ULONG) MIN(MAX(sample, 1), MAX_SLONG);
+	return average ? (ULONG) (((FB_UINT64) average * 7 + value) / 8) : value;
+}
+
+void Rsr::fetchCalled()
+{
+	// Time spent by the application since the previous row was handed out
+
+	if (rsr_fetch_return)
+		rsr_row_interval = smoothTime(rsr_row_interval, getMicroseconds() - rsr_fetch_return);
+
+	rsr_fetch_return = 0;
+}
+
+void Rsr::fetchReturned()
+{
+	rsr_fetch_return = getMicroseconds();
+}
+
+void Rsr::batchRequested()
+{
+	// Time only the batches nothing else is waited for, so the
+	// time to receive them is not mixed with the application work
+
+	rsr_fetch_start = (!rsr_msgs_waiting && !rsr_batch_count) ? getMicroseconds() : 0;
+}
+
+void Rsr::batchReceived()
+{
+	if (rsr_fetch_start)
+	{
+		rsr_fetch_rtt = smoothTime(rsr_fetch_rtt, getMicroseconds() - rsr_fetch_start);
+		rsr_fetch_start = 0;
+	}
+}
+
+bool Rtr::putInlineBlob(const ISC_QUAD& id, InlineBlob* blob)
+{
+	// Don't let the unread blobs eat up the client memory, they
+	// can always be read from the server
+
+	const ULONG size = blob->ibl_data.getCount() + blob->ibl_info.getCount();
+	const FB_UINT64 key = inlineBlobKey(id);
+
+	InlineBlob** const old = rtr_inline_blobs.get(key);
+	if (old)
+	{
+		rtr_inline_size -= (*old)->ibl_data.getCount() + (*old)->ibl_info.getCount();
+		delete *old;
+		rtr_inline_blobs.remove(key);
+	}
+
+	if (rtr_inline_size + size > MAX_INLINE_BLOB_CACHE_SIZE)
+		return false;
+
+	rtr_inline_blobs.put(key, blob);
+	rtr_inline_size += size;
+	return true;
+}
+
+InlineBlob* Rtr::getInlineBlob(const ISC_QUAD& id)
+{
+	const FB_UINT64 key = inlineBlobKey(id);
+
+	InlineBlob** const blob = rtr_inline_blobs.get(key);
+	if (!blob)
+		return NULL;
+
+	InlineBlob* const result = *blob;
+	rtr_inline_blobs.remove(key);
+	rtr_inline_size -= result->ibl_data.getCount() + result->ibl_info.getCount();
+
+	return result;
+}
+
+void Rtr::clearInlineBlobs()
+{
+	InlineBlobMap::Accessor accessor(&rtr_inline_blobs);
+
+	for (bool found = accessor.getFirst(); found; found = accessor.getNext())
+		delete accessor.current()->second;
+
+	rtr_inline_blobs.clear();
+	rtr_inline_size = 0;
+}
+
 Firebird::string rem_port::getRemoteId() const
 {
 	fb_assert(port_protocol_id.hasData());
@@ -1343,6 +1502,7 @@ void rem_port::versionInfo(Firebird::string& version) const
 
 #ifdef WIRE_COMPRESS_SUPPORT
 static Firebird::InitInstance<Firebird::ZLib> zlib;
+static Firebird::InitInstance<Firebird::ZStd> zstd;
 #endif // WIRE_COMPRESS_SUPPORT
 
 rem_port::~rem_port()
@@ -1371,7 +1531,12 @@ rem_port::~rem_port()
 #endif
 
 #ifdef WIRE_COMPRESS_SUPPORT
-	if (port_compressed)
+	if (port_zstd_send)
+	{
+		zstd().freeCStream(port_zstd_send);
+		zstd().freeDStream(port_zstd_recv);
+	}
+	else if (port_compressed)
 	{
 		zlib().deflateEnd(&port_send_stream);
 		zlib().inflateEnd(&port_recv_stream);
@@ -1379,6 +1544,129 @@ rem_port::~rem_port()
 #endif
 }
 
+#ifdef WIRE_COMPRESS_SUPPORT
+static bool zstd_inflate(rem_port* port, PacketReceive* packet_receive, UCHAR* buffer,
+	SSHORT buffer_length, SSHORT* length)
+{
+	// Like inflate() the decompressor writes straight into the caller's buffer,
+	// the received data not consumed yet is kept in port_compressed
+
+	UCHAR* const compressed = &port->port_compressed[REM_RECV_OFFSET(port->port_buff_size)];
+	Firebird::ZStd::InBuffer in = {compressed, port->port_zstd_recv_size, port->port_zstd_recv_pos};
+	Firebird::ZStd::OutBuffer out = {buffer, (size_t) buffer_length, 0};
+
+	for (;;)
+	{
+		// Output may be left in the decompressor when the buffer was filled
+		if (in.pos < in.size || (port->port_flags & PORT_z_data))
+		{
+			const SINT64 start = getMicroseconds();
+			const size_t ret = zstd().decompressStream(port->port_zstd_recv, &out, &in);
+			port->port_zip_time += getMicroseconds() - start;
+
+			if (zstd().isError(ret))
+			{
+#ifdef COMPRESS_DEBUG
+				fprintf(stderr, "Decompress error %" SIZEFORMAT "\n", ret);
+#endif
+				port->port_flags &= ~PORT_z_data;
+				return false;
+			}
+
+			if (out.pos)
+			{
+				port->port_flags &= ~PORT_z_data;
+				break;
+			}
+
+			if (port->port_flags & PORT_z_data)		// Was called from select_multi() but nothing decompressed
+			{
+				port->port_flags &= ~PORT_z_data;
+				port->port_zstd_recv_pos = in.pos;
+				return false;
+			}
+		}
+
+		// Decompressor consumes all the input unless the output is full
+		fb_assert(in.pos == in.size);
+
+		SSHORT l = (SSHORT) port->port_buff_size;
+		if ((!packet_receive(port, compressed, l, &l)) || (l <= 0))
+		{
+			port->port_zstd_recv_pos = port->port_zstd_recv_size = 0;
+			return false;
+		}
+
+		in.size = l;
+		in.pos = 0;
+	}
+
+	port->port_zstd_recv_pos = in.pos;
+	port->port_zstd_recv_size = in.size;
+
+	*length = (SSHORT) out.pos;
+	port->port_zip_rcv_bytes += out.pos;
+
+	if (in.pos < in.size || out.pos == out.size)
+		port->port_flags |= PORT_z_data;
+
+	return true;
+}
+
+static bool zstd_deflate(rem_port* port, XDR* xdrs, PacketSend* packet_send, bool flush)
+{
+	UCHAR* const compressed = &port->port_compressed[REM_SEND_OFFSET(port->port_buff_size)];
+	Firebird::ZStd::InBuffer in = {xdrs->x_base, (size_t) (xdrs->x_private - xdrs->x_base), 0};
+	Firebird::ZStd::OutBuffer out = {compressed, port->port_buff_size, port->port_zstd_send_pos};
+
+	port->port_zip_snd_bytes += in.size;
+
+	for (;;)
+	{
+		const SINT64 start = getMicroseconds();
+
+		// flushStream() returns the amount of data left in the internal buffers
+		size_t ret;
+		if (in.pos < in.size)
+			ret = zstd().compressStream(port->port_zstd_send, &out, &in);
+		else if (flush)
+			ret = zstd().flushStream(port->port_zstd_send, &out);
+		else
+			break;
+
+		port->port_zip_time += getMicroseconds() - start;
+
+		if (zstd().isError(ret))
+		{
+#ifdef COMPRESS_DEBUG
+			fprintf(stderr, "Compress error %" SIZEFORMAT "\n", ret);
+#endif
+			return false;
+		}
+
+		const bool flushed = (in.pos == in.size) && flush && !ret;
+
+		if (out.pos == out.size || (flushed && out.pos))
+		{
+			if (!packet_send(port, (SCHAR*) compressed, (SSHORT) out.pos))
+				return false;
+
+			out.pos = 0;
+		}
+
+		if (flushed)
+			break;
+	}
+
+	port->port_zstd_send_pos = out.pos;
+
+	xdrs->x_private = xdrs->x_base;
+	xdrs->x_handy = port->port_buff_size;
+
+	return true;
+}
+#endif // WIRE_COMPRESS_SUPPORT
+
 bool REMOTE_inflate(rem_port* port, PacketReceive* packet_receive, UCHAR* buffer,
 	SSHORT buffer_length, SSHORT* length)
 {
@@ -1386,6 +1674,9 @@ bool REMOTE_inflate(rem_port* port, PacketReceive* packet_receive, UCHAR* buffer
 	if (!port->port_compressed)
 		return packet_receive(port, buffer, buffer_length, length);
 
+	if (port->port_zstd_recv)
+		return zstd_inflate(port, packet_receive, buffer, buffer_length, length);
+
 	z_stream& strm = port->port_recv_stream;
 	strm.avail_out = buffer_length;
 	strm.next_out = buffer;
@@ -1402,7 +1693,11 @@ bool REMOTE_inflate(rem_port* port, PacketReceive* packet_receive, UCHAR* buffer
 #endif
 #endif
 
-			if (zlib().inflate(&strm, Z_NO_FLUSH) != Z_OK)
+			const SINT64 start = getMicroseconds();
+			const int ret = zlib().inflate(&strm, Z_NO_FLUSH);
+			port->port_zip_time += getMicroseconds() - start;
+
+			if (ret != Z_OK)
 			{
 #ifdef COMPRESS_DEBUG
 				fprintf(stderr, "Inflate error\n");
@@ -1447,6 +1742,7 @@ bool REMOTE_inflate(rem_port* port, PacketReceive* packet_receive, UCHAR* buffer
 	}
 
 	*length = (SSHORT) (buffer_length - strm.avail_out);
+	port->port_zip_rcv_bytes += *length;
 	if (strm.avail_in)	// Z-buffer still has some data - probably can call inflate() once more on them
 		port->port_flags |= PORT_z_data;
 	else
@@ -1465,9 +1761,13 @@ bool REMOTE_deflate(XDR* xdrs, ProtoWrite* proto_write, PacketSend* packet_send,
 	if (!(port->port_compressed && (port->port_flags & PORT_compressed)))
 		return proto_write(xdrs);
 
+	if (port->port_zstd_send)
+		return zstd_deflate(port, xdrs, packet_send, flush);
+
 	z_stream& strm = port->port_send_stream;
 	strm.avail_in = xdrs->x_private - xdrs->x_base;
 	strm.next_in = (Bytef*) xdrs->x_base;
+	port->port_zip_snd_bytes += strm.avail_in;
 
 	if (!strm.next_out)
 	{
@@ -1486,7 +1786,10 @@ bool REMOTE_deflate(XDR* xdrs, ProtoWrite* proto_write, PacketSend* packet_send,
 		fprintf(stderr, "\n");
 #endif
 #endif
+		const SINT64 start = getMicroseconds();
 		int ret = zlib().deflate(&strm, flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+		port->port_zip_time += getMicroseconds() - start;
+
 		if (ret == Z_BUF_ERROR)
 			ret = 0;
 		if (ret != 0)
@@ -1532,24 +1835,112 @@ bool REMOTE_deflate(XDR* xdrs, ProtoWrite* proto_write, PacketSend* packet_send,
 #endif
 }
 
-bool rem_port::checkCompression()
+bool rem_port::checkCompression(int codec)
 {
 #ifdef WIRE_COMPRESS_SUPPORT
-	return zlib();
+	return codec == WIRE_COMPRESS_ZSTD ? zstd() : zlib();
 #else
 	return false;
 #endif
 }
 
-void rem_port::initCompression()
+void rem_port::putCompressionInfo(UCHAR* info, const UCHAR* end) const
+{
+	// Replaces isc_info_end at info with the fb_info_wire_compression item
+	const USHORT length = 1 + 5 * sizeof(SINT64);
+
+	if (info + 3 + length >= end)
+	{
+		*info = isc_info_truncated;
+		return;
+	}
+
+	*info++ = fb_info_wire_compression;
+	put_vax_short(info, length);
+	info += 2;
+
+	UCHAR codec = fb_info_wire_compression_none;
+	FB_UINT64 zipSent = 0, zipReceived = 0, zipTime = 0;
+
+#ifdef WIRE_COMPRESS_SUPPORT
+	if (port_compressed && (port_flags & PORT_compressed))
+		codec = port_zstd_send ? fb_info_wire_compression_zstd : fb_info_wire_compression_zlib;
+
+	zipSent = port_zip_snd_bytes;
+	zipReceived = port_zip_rcv_bytes;
+	zipTime = port_zip_time;
+#endif
+
+	*info++ = codec;
+	info += put_vax_int64(info, zipSent);
+	info += put_vax_int64(info, port_snd_bytes);
+	info += put_vax_int64(info, port_rcv_bytes);
+	info += put_vax_int64(info, zipReceived);
+	info += put_vax_int64(info, zipTime);
+	*info = isc_info_end;
+}
+
+void rem_port::initCompression(USHORT type)
 {
 #ifdef WIRE_COMPRESS_SUPPORT
-	if (port_protocol >= PROTOCOL_VERSION13 && !port_compressed && zlib())
+	if (port_protocol >= PROTOCOL_VERSION13 && !port_compressed && (type & pflag_compress_zstd) && zstd())
 	{
+		// Level 0 makes zstd use its default level
+		const int level = MIN(getPortConfig()->getWireCompressionLevel(), zstd().maxCLevel());
+
+		port_zstd_send = zstd().createCStream();
+		if (!port_zstd_send)
+			Firebird::BadAlloc::raise();
+
+		size_t ret = zstd().initCStream(port_zstd_send, level);
+		if (zstd().isError(ret))
+		{
+			zstd().freeCStream(port_zstd_send);
+			port_zstd_send = NULL;
+			(Firebird::Arg::Gds(isc_deflate_init) << Firebird::Arg::Num((SLONG) ret)).raise();
+		}
+
+		port_zstd_recv = zstd().createDStream();
+		ret = port_zstd_recv ? zstd().initDStream(port_zstd_recv) : 0;
+		if (!port_zstd_recv || zstd().isError(ret))
+		{
+			zstd().freeCStream(port_zstd_send);
+			port_zstd_send = NULL;
+			if (port_zstd_recv)
+				zstd().freeDStream(port_zstd_recv);
+			port_zstd_recv = NULL;
+			(Firebird::Arg::Gds(isc_inflate_init) << Firebird::Arg::Num((SLONG) ret)).raise();
+		}
+
+		try
+		{
+			port_compressed.reset(FB_NEW_POOL(getPool()) UCHAR[port_buff_size * 2]);
+		}
+		catch (const Firebird::Exception&)
+		{
+			zstd().freeCStream(port_zstd_send);
+			zstd().freeDStream(port_zstd_recv);
+			port_zstd_send = NULL;
+			port_zstd_recv = NULL;
+			throw;
+		}
+
+		memset(port_compressed, 0, port_buff_size * 2);
+
+#ifdef COMPRESS_DEBUG
+		fprintf(stderr, "Completed zstd init port %p\n", this);
+#endif
+	}
+	else if (port_protocol >= PROTOCOL_VERSION13 && !port_compressed && zlib())
+	{
+		const int configLevel = getPortConfig()->getWireCompressionLevel();
+		const int level = configLevel ? MIN(MAX(configLevel, Z_BEST_SPEED), Z_BEST_COMPRESSION) :
+			Z_DEFAULT_COMPRESSION;
+
 		port_send_stream.zalloc = Firebird::ZLib::allocFunc;
 		port_send_stream.zfree = Firebird::ZLib::freeFunc;
 		port_send_stream.opaque = Z_NULL;
-		int ret = zlib().deflateInit(&port_send_stream, Z_DEFAULT_COMPRESSION);
+		int ret = zlib().deflateInit(&port_send_stream, level);
 		if (ret != Z_OK)
 			(Firebird::Arg::Gds(isc_deflate_init) << Firebird::Arg::Num(ret)).raise();
 		port_send_stream.next_out = NULL;
@@ -41,6 +41,7 @@
 #include "../common/StatusHolder.h"
 #include "../common/classes/RefCounted.h"
 #include "../common/classes/GetPlugins.h"
+#include "../common/classes/GenericMap.h"
 #include "../common/classes/RefMutex.h"
 
 #include "firebird/Interface.h"
@@ -97,9 +98,14 @@ const ULONG MAX_PACKETS_PER_BATCH = 16;
 
 const ULONG MIN_ROWS_PER_BATCH = 10;
 const ULONG MAX_ROWS_PER_BATCH = 1000;
+const ULONG MAX_ROWS_PER_FETCH = MAX_SSHORT;	// sent as short in op_fetch
 
 const ULONG MAX_BATCH_CACHE_SIZE = 1024 * 1024; // 1 MB
 
+// Inline blobs constants
+
+const ULONG MAX_INLINE_BLOB_CACHE_SIZE = 16 * 1024 * 1024; // 16 MB, per transaction
+
 // fwd. decl.
 namespace Firebird {
 	class Exception;
@@ -189,8 +195,24 @@ public:
 };
 
 
+// Blob received by the client together with the fetched rows
+
+struct InlineBlob : public Firebird::GlobalStorage
+{
+	Firebird::UCharBuffer	ibl_info;		// response to the blob info items
+	Firebird::UCharBuffer	ibl_data;		// segments, each prefixed by its length
+
+public:
+	InlineBlob() :
+		ibl_info(getPool()), ibl_data(getPool())
+	{ }
+};
+
+
 struct Rtr : public Firebird::GlobalStorage, public TypedHandle<rem_type_rtr>
 {
+	typedef Firebird::GenericMap<Firebird::NonPooled<FB_UINT64, InlineBlob*> > InlineBlobMap;
+
 	Rdb*			rtr_rdb;
 	Rtr*			rtr_next;
 	struct Rbl*		rtr_blobs;
@@ -201,20 +223,30 @@ struct Rtr : public Firebird::GlobalStorage, public TypedHandle<rem_type_rtr>
 	Firebird::Array<Rsr*> rtr_cursors;
 	Rtr**			rtr_self;
 
+	InlineBlobMap	rtr_inline_blobs;		// blobs received together with the fetched rows
+	ULONG			rtr_inline_size;		// total size of the cached inline blobs
+
 public:
 	Rtr() :
 		rtr_rdb(0), rtr_next(0), rtr_blobs(0),
 		rtr_iface(NULL), rtr_id(0), rtr_limbo(0),
-		rtr_cursors(getPool()), rtr_self(NULL)
+		rtr_cursors(getPool()), rtr_self(NULL),
+		rtr_inline_blobs(getPool()), rtr_inline_size(0)
 	{ }
 
 	~Rtr()
 	{
 		if (rtr_self && *rtr_self == this)
 			*rtr_self = NULL;
+
+		clearInlineBlobs();
 	}
 
 	static ISC_STATUS badHandle() { return isc_bad_trans_handle; }
+
+	bool putInlineBlob(const ISC_QUAD& id, InlineBlob* blob);
+	InlineBlob* getInlineBlob(const ISC_QUAD& id);
+	void clearInlineBlobs();
 };
 
 
@@ -236,6 +268,8 @@ struct Rbl : public Firebird::GlobalStorage, public TypedHandle<rem_type_rbl>
 	USHORT		rbl_source_interp;	// source interp (for writing)
 	USHORT		rbl_target_interp;	// destination interp (for reading)
 	Rbl**		rbl_self;
+	ISC_QUAD	rbl_blob_id;		// blob id (for the inline blobs)
+	Firebird::UCharBuffer rbl_info;	// cached blob info (for the inline blobs)
 
 public:
 	// Values for rbl_flags
@@ -243,7 +277,8 @@ public:
 		EOF_SET = 1,
 		SEGMENT = 2,
 		EOF_PENDING = 4,
-		CREATE = 8
+		CREATE = 8,
+		CACHED = 16		// inline blob, not opened at the server
 	};
 
 public:
@@ -252,8 +287,12 @@ public:
 		rbl_buffer(rbl_data.getBuffer(BLOB_LENGTH)), rbl_ptr(rbl_buffer), rbl_iface(NULL),
 		rbl_offset(0), rbl_id(0), rbl_flags(0),
 		rbl_buffer_length(BLOB_LENGTH), rbl_length(0), rbl_fragment_length(0),
-		rbl_source_interp(0), rbl_target_interp(0), rbl_self(NULL)
-	{ }
+		rbl_source_interp(0), rbl_target_interp(0), rbl_self(NULL),
+		rbl_info(getPool())
+	{
+		rbl_blob_id.gds_quad_high = 0;
+		rbl_blob_id.gds_quad_low = 0;
+	}
 
 	~Rbl()
 	{
@@ -483,6 +522,11 @@ struct Rsr : public Firebird::GlobalStorage, public TypedHandle<rem_type_rsr>
 	USHORT			rsr_reorder_level; 	// Trigger pipelining at this level
 	USHORT			rsr_batch_count; 	// Count of batches in pipeline
 
+	SINT64			rsr_fetch_start;	// When the timed batch was asked for, 0 if none
+	SINT64			rsr_fetch_return;	// When the last row was handed out, 0 if none
+	ULONG			rsr_fetch_rtt;		// Smoothed time to receive a batch, microseconds
+	ULONG			rsr_row_interval;	// Smoothed time the application spends on a row
+
 	Firebird::string rsr_cursor_name;	// Name for cursor to be set on open
 	bool			rsr_delayed_format;	// Out format was delayed on execute, set it on fetch
 	unsigned int	rsr_timeout;		// Statement timeout to be set on open\execute
@@ -543,6 +587,7 @@ public:
 		rsr_format(0), rsr_message(0), rsr_buffer(0), rsr_status(0),
 		rsr_id(0), rsr_fmt_length(0),
 		rsr_rows_pending(0), rsr_msgs_waiting(0), rsr_reorder_level(0), rsr_batch_count(0),
+		rsr_fetch_start(0), rsr_fetch_return(0), rsr_fetch_rtt(0), rsr_row_interval(0),
 		rsr_cursor_name(getPool()), rsr_delayed_format(false), rsr_timeout(0), rsr_self(NULL)
 	{ }
 
@@ -574,6 +619,12 @@ public:
 	void checkIface(ISC_STATUS code = isc_unprepared_stmt);
 	void checkCursor();
 	void checkBatch();
+
+	// Timing of the fetches used to size the batches (client)
+	void fetchCalled();
+	void fetchReturned();
+	void batchRequested();
+	void batchReceived();
 };
 
 
@@ -1108,6 +1159,14 @@ struct rem_port : public Firebird::GlobalStorage, public Firebird::RefCounted
 #ifdef WIRE_COMPRESS_SUPPORT
 	z_stream port_send_stream, port_recv_stream;
 	UCharArrayAutoPtr	port_compressed;
+	Firebird::ZStd::CStream* port_zstd_send;	// zstd streams, used instead of zlib ones when not NULL
+	Firebird::ZStd::DStream* port_zstd_recv;
+	size_t				port_zstd_send_pos;		// length of compressed data not sent yet
+	size_t				port_zstd_recv_pos;		// compressed data received but not decompressed yet
+	size_t				port_zstd_recv_size;
+	FB_UINT64			port_zip_snd_bytes;		// data passed to the compressor
+	FB_UINT64			port_zip_rcv_bytes;		// data returned by the decompressor
+	FB_UINT64			port_zip_time;			// time spent by the codec, microseconds
 #endif
 
 public:
@@ -1143,6 +1202,11 @@ public:
 		port_client_crypt_callback(NULL), port_server_crypt_callback(NULL), port_crypt_name(getPool()),
 		port_replicator(NULL), port_buffer(FB_NEW_POOL(getPool()) UCHAR[rpt]),
 		port_snd_packets(0), port_rcv_packets(0), port_snd_bytes(0), port_rcv_bytes(0)
+#ifdef WIRE_COMPRESS_SUPPORT
+		, port_zstd_send(NULL), port_zstd_recv(NULL), port_zstd_send_pos(0),
+		port_zstd_recv_pos(0), port_zstd_recv_size(0),
+		port_zip_snd_bytes(0), port_zip_rcv_bytes(0), port_zip_time(0)
+#endif
 	{
 		addRef();
 		memset(&port_linger, 0, sizeof port_linger);
@@ -1164,8 +1228,9 @@ private:
 	friend class Firebird::RefPtr<rem_port>;
 
 public:
-	void initCompression();
-	static bool checkCompression();
+	void initCompression(USHORT type);
+	static bool checkCompression(int codec);
+	void putCompressionInfo(UCHAR* info, const UCHAR* end) const;
 	void linkParent(rem_port* const parent);
 	void unlinkParent();
 	Firebird::RefPtr<const Config> getPortConfig();
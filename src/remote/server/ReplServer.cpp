@@ -77,6 +77,10 @@ namespace
 	const USHORT CTL_VERSION1 = 1;
 	const USHORT CTL_CURRENT_VERSION = CTL_VERSION1;
 
+	// Blocks passed to the replica applying them in parallel before
+	// waiting for them to be applied and saving the progress
+	const ULONG PARALLEL_SYNC_BLOCKS = 64;
+
 	volatile bool* shutdownPtr = NULL;
 	AtomicCounter activeThreads;
 
@@ -436,6 +440,21 @@ namespace
 #endif
 		}
 
+		// Wait until the replica has applied all the blocks passed so far
+		bool sync(FbLocalStatus& status)
+		{
+#ifdef NO_DATABASE
+			return true;
+#else
+			Block header;
+			memset(&header, 0, sizeof(Block));
+			header.protocol = PROTOCOL_CURRENT_VERSION;
+
+			m_replicator->process(&status, sizeof(Block), (const UCHAR*) &header);
+			return status.isSuccess();
+#endif
+		}
+
 		bool isShutdown() const
 		{
 			return (m_attachment == NULL);
@@ -829,6 +848,12 @@ namespace
 					raiseError("Log file %s was unexpectedly changed", segment->filename.c_str());
 
 				ULONG totalLength = sizeof(SegmentHeader);
+				ULONG blocks = 0;
+
+				// Blocks applied in parallel are known to be applied only after sync()
+
+				const ULONG syncBlocks =
+					(target->getConfig()->applyParallelWorkers > 1) ? PARALLEL_SYNC_BLOCKS : 1;
 				while (totalLength < segment->header.hdr_length)
 				{
 					Block header;
@@ -869,7 +894,25 @@ namespace
 
 					totalLength += length;
 
-					control.savePartial(sequence, totalLength, transactions);
+					if (++blocks % syncBlocks == 0)
+					{
+						if (!target->sync(localStatus))
+						{
+							target->verbose("Segment %" UQUADFORMAT " replication failure before offset %u",
+											sequence, totalLength);
+
+							localStatus.raise();
+						}
+
+						control.savePartial(sequence, totalLength, transactions);
+					}
+				}
+
+				if (!target->sync(localStatus))
+				{
+					target->verbose("Segment %" UQUADFORMAT " replication failure", sequence);
+
+					localStatus.raise();
 				}
 
 				control.saveComplete(sequence, transactions);
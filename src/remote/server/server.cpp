@@ -710,7 +710,7 @@ public:
 				}
 
 				if (send->p_acpt.p_acpt_type & pflag_compress)
-					authPort->initCompression();
+					authPort->initCompression(send->p_acpt.p_acpt_type);
 				authPort->send(send);
 				if (send->p_acpt.p_acpt_type & pflag_compress)
 					authPort->port_flags |= PORT_compressed;
@@ -1170,11 +1170,12 @@ InitInstance<CryptKeyTypeManager> knownCryptKeyTypes;
 static void		free_request(server_req_t*);
 static server_req_t* alloc_request();
 static bool		link_request(rem_port*, server_req_t*);
+static server_req_t* dequeue_request();
 
 static bool		accept_connection(rem_port*, P_CNCT*, PACKET*);
 static ISC_STATUS	allocate_statement(rem_port*, /*P_RLSE*,*/ PACKET*);
 static void		append_request_chain(server_req_t*, server_req_t**);
-static void		append_request_next(server_req_t*, server_req_t**);
+static void		append_request_next(server_req_t*);
 static void		attach_database(rem_port*, P_OP, P_ATCH*, PACKET*);
 static void		attach_service(rem_port*, P_ATCH*, PACKET*);
 static bool		continue_authentication(rem_port*, PACKET*, PACKET*);
@@ -1189,6 +1190,7 @@ static void		cancel_operation(rem_port*, USHORT);
 static bool		check_request(Rrq*, USHORT, USHORT);
 static USHORT	check_statement_type(Rsr*);
 
+static void		get_inline_blob_fields(Rsr*, Array<USHORT>&);
 static bool		get_next_msg_no(Rrq*, USHORT, USHORT*);
 static Rtr*		make_transaction(Rdb*, ITransaction*);
 static void		ping_connection(rem_port*, PACKET*);
@@ -1201,6 +1203,7 @@ static void		release_sql_request(Rsr*);
 static void		release_transaction(Rtr*);
 
 static void		send_error(rem_port* port, PACKET* apacket, ISC_STATUS errcode);
+static void		send_inline_blobs(rem_port*, Rsr*, const Array<USHORT>&, ULONG, const UCHAR*);
 static void		send_error(rem_port* port, PACKET* apacket, const Firebird::Arg::StatusVector&);
 static void		set_server(rem_port*, USHORT);
 static int		shut_server(const int, const int, void*);
@@ -1280,11 +1283,16 @@ int Worker::m_cntGoing = 0;
 bool Worker::shutting_down = false;
 
 
+// Ports having queued or active requests, with the first (queued or active) request
+// of each port. Other requests of the port are chained to it using req_chain.
+typedef GenericMap<NonPooled<rem_port*, server_req_t*> > PortRequestMap;
+
 static GlobalPtr<Mutex> request_que_mutex;
 static server_req_t* request_que		= NULL;
+static server_req_t** request_que_tail	= &request_que;
 static server_req_t* free_requests		= NULL;
-static server_req_t* active_requests	= NULL;
-static int ports_active					= 0;	// length of active_requests
+static GlobalPtr<PortRequestMap> port_requests;
+static int ports_active					= 0;	// number of active requests
 static int ports_pending				= 0;	// length of request_que
 
 static GlobalPtr<Mutex> servers_mutex;
@@ -1533,45 +1541,30 @@ static bool link_request(rem_port* port, server_req_t* request)
  *
  **************************************/
 	const P_OP operation = request->req_receive.p_operation;
-	server_req_t* queue;
+	server_req_t* queue = NULL;
 
 	MutexLockGuard queGuard(request_que_mutex, FB_FUNCTION);
 
-	bool active = true;
-	queue = active_requests;
-
-	while (true)
+	if (port_requests->get(port, queue))
 	{
-		for (; queue; queue = queue->req_next)
+		// Don't queue a dummy keepalive packet if there is a request on this port
+		if (operation == op_dummy)
 		{
-			if (queue->req_port == port)
-			{
-				// Don't queue a dummy keepalive packet if there is a request on this port
-				if (operation == op_dummy)
-				{
-					free_request(request);
-					return true;
-				}
+			free_request(request);
+			return true;
+		}
 
-				append_request_chain(request, &queue->req_chain);
+		append_request_chain(request, &queue->req_chain);
 #ifdef DEBUG_REMOTE_MEMORY
-				printf("link_request %s request_queued %d\n",
-					active ? "ACTIVE" : "PENDING", port->port_requests_queued.value());
-				fflush(stdout);
+		printf("link_request request_queued %d\n", port->port_requests_queued.value());
+		fflush(stdout);
 #endif
-				break;
-			}
-		}
-
-		if (queue || !active)
-			break;
-
-		queue = request_que;
-		active = false;
 	}
-
-	if (!queue)
-		append_request_next(request, &request_que);
+	else
+	{
+		port_requests->put(port, request);
+		append_request_next(request);
+	}
 
 	++port->port_requests_queued;
 
@@ -1920,7 +1913,7 @@ static bool accept_connection(rem_port* port, P_CNCT* connect, PACKET* send)
 	P_ARCH architecture = arch_generic;
 	USHORT version = 0;
 	USHORT type = 0;
-	bool compress = false;
+	USHORT compress = 0;
 	bool accepted = false;
 	USHORT weight = 0;
 	const p_cnct::p_cnct_repeat* protocol = connect->p_cnct_versions;
@@ -1930,7 +1923,7 @@ static bool accept_connection(rem_port* port, P_CNCT* connect, PACKET* send)
 	{
 		if ((protocol->p_cnct_version == PROTOCOL_VERSION10 ||
 			 (protocol->p_cnct_version >= PROTOCOL_VERSION11 &&
-			  protocol->p_cnct_version <= PROTOCOL_VERSION16)) &&
+			  protocol->p_cnct_version <= PROTOCOL_VERSION17)) &&
 			 (protocol->p_cnct_architecture == arch_generic ||
 			  protocol->p_cnct_architecture == ARCHITECTURE) &&
 			protocol->p_cnct_weight >= weight)
@@ -1941,6 +1934,11 @@ static bool accept_connection(rem_port* port, P_CNCT* connect, PACKET* send)
 			architecture = protocol->p_cnct_architecture;
 			type = MIN(protocol->p_cnct_max_type & ptype_MASK, ptype_lazy_send);
 			compress = protocol->p_cnct_max_type & pflag_compress;
+			if (compress && (protocol->p_cnct_max_type & pflag_compress_zstd) &&
+				rem_port::checkCompression(WIRE_COMPRESS_ZSTD))
+			{
+				compress |= pflag_compress_zstd;
+			}
 		}
 	}
 
@@ -1949,12 +1947,12 @@ static bool accept_connection(rem_port* port, P_CNCT* connect, PACKET* send)
 
 	send->p_acpd.p_acpt_version = port->port_protocol = version;
 	send->p_acpd.p_acpt_architecture = architecture;
-	send->p_acpd.p_acpt_type = type | (compress ? pflag_compress : 0);
+	send->p_acpd.p_acpt_type = type | compress;
 	send->p_acpd.p_acpt_authenticated = 0;
 
 	send->p_acpt.p_acpt_version = port->port_protocol = version;
 	send->p_acpt.p_acpt_architecture = architecture;
-	send->p_acpt.p_acpt_type = type | (compress ? pflag_compress : 0);
+	send->p_acpt.p_acpt_type = type | compress;
 
 	// modify the version string to reflect the chosen protocol
 	string buffer;
@@ -2140,7 +2138,7 @@ static bool accept_connection(rem_port* port, P_CNCT* connect, PACKET* send)
 
 	send->p_operation = returnData ? op_accept_data : op_accept;
 	if (send->p_acpt.p_acpt_type & pflag_compress)
-		port->initCompression();
+		port->initCompression(send->p_acpt.p_acpt_type);
 	port->send(send);
 	if (send->p_acpt.p_acpt_type & pflag_compress)
 		port->port_flags |= PORT_compressed;
@@ -2169,7 +2167,7 @@ void ConnectAuth::accept(PACKET* send, Auth::WriterImplementation*)
 		authPort->extractNewKeys(s);
 		send->p_acpd.p_acpt_authenticated = 1;
 		if (send->p_acpt.p_acpt_type & pflag_compress)
-			authPort->initCompression();
+			authPort->initCompression(send->p_acpt.p_acpt_type);
 		authPort->send(send);
 		if (send->p_acpt.p_acpt_type & pflag_compress)
 			authPort->port_flags |= PORT_compressed;
@@ -2268,7 +2266,7 @@ static void append_request_chain(server_req_t* request, server_req_t** que_inst)
 }
 
 
-static void append_request_next(server_req_t* request, server_req_t** que_inst)
+static void append_request_next(server_req_t* request)
 {
 /**************************************
  *
@@ -2277,21 +2275,51 @@ static void append_request_next(server_req_t* request, server_req_t** que_inst)
  **************************************
  *
  * Functional description
- *	Traverse using req_next ptr and append
- *	a request at the end of a que.
- *	Return count of pending requests.
+ *	Append a request at the end of the
+ *	waiting requests queue.
  *
  **************************************/
 	MutexLockGuard queGuard(request_que_mutex, FB_FUNCTION);
 
-	while (*que_inst)
-		que_inst = &(*que_inst)->req_next;
+	*request_que_tail = request;
+	while (*request_que_tail)
+		request_que_tail = &(*request_que_tail)->req_next;
 
-	*que_inst = request;
 	ports_pending++;
 }
 
 
+static server_req_t* dequeue_request()
+{
+/**************************************
+ *
+ *	d e q u e u e _ r e q u e s t
+ *
+ **************************************
+ *
+ * Functional description
+ *	Take a request from the head of the
+ *	waiting requests queue.
+ *
+ **************************************/
+	MutexLockGuard queGuard(request_que_mutex, FB_FUNCTION);
+
+	server_req_t* const request = request_que;
+	if (request)
+	{
+		REMOTE_TRACE(("Dequeue request %p", request));
+		request_que = request->req_next;
+		if (!request_que)
+			request_que_tail = &request_que;
+
+		request->req_next = NULL;
+		ports_pending--;
+	}
+
+	return request;
+}
+
+
 static void addClumplets(ClumpletWriter* dpb_buffer,
 						 const ParametersSet& par,
 						 const rem_port* port)
@@ -3951,6 +3979,20 @@ ISC_STATUS rem_port::fetch(P_SQLDATA * sqldata, PACKET* sendL)
 		statement->rsr_delayed_format = false;
 	}
 
+	// Find out which blobs could be sent to the client together with the rows
+
+	Array<USHORT> inlineBlobs;
+	ULONG inlineBlobSize = 0;
+
+	if (this->port_protocol >= PROTOCOL_INLINE_BLOB && statement->rsr_rtr)
+	{
+		inlineBlobSize = MIN(sqldata->p_sqldata_inline_blob_size,
+			this->getPortConfig()->getMaxInlineBlobSize());
+
+		if (inlineBlobSize)
+			get_inline_blob_fields(statement, inlineBlobs);
+	}
+
 	// Get ready to ship the data out
 
 	const USHORT max_records = statement->rsr_flags.test(Rsr::NO_BATCH) ?
@@ -4020,6 +4062,11 @@ ISC_STATUS rem_port::fetch(P_SQLDATA * sqldata, PACKET* sendL)
 			statement->rsr_msgs_waiting--;
 		}
 
+		// Send the small blobs referenced by the row ahead of it
+
+		if (inlineBlobs.hasData())
+			send_inline_blobs(this, statement, inlineBlobs, inlineBlobSize, message->msg_address);
+
 		// There's a buffer waiting -- send it
 
 		if (!this->send_partial(sendL))
@@ -4027,12 +4074,16 @@ ISC_STATUS rem_port::fetch(P_SQLDATA * sqldata, PACKET* sendL)
 
 		message->msg_address = NULL;
 
-		// If we've hit maximum prefetch size, break out of loop
+		// If we've hit maximum prefetch size, break out of loop.
+		// Newer clients size the batches in bytes themselves.
 
 		const USHORT packets = this->port_snd_packets - org_packets;
 
-		if (packets >= MAX_PACKETS_PER_BATCH && count >= MIN_ROWS_PER_BATCH)
+		if (packets >= MAX_PACKETS_PER_BATCH && count >= MIN_ROWS_PER_BATCH &&
+			this->port_protocol < PROTOCOL_VERSION17)
+		{
 			break;
+		}
 	}
 
 	response->p_sqldata_status = rc ? 0 : 100;
@@ -4108,6 +4159,49 @@ ISC_STATUS rem_port::fetch(P_SQLDATA * sqldata, PACKET* sendL)
 }
 
 
+static void get_inline_blob_fields(Rsr* statement, Array<USHORT>& fields)
+{
+/**************************************
+ *
+ *	g e t _ i n l i n e _ b l o b _ f i e l d s
+ *
+ **************************************
+ *
+ * Functional description
+ *	Collect the positions of the blob fields in the
+ *	output message of a cursor. Arrays are skipped,
+ *	they are never read using the blob API.
+ *
+ **************************************/
+	const rem_fmt* const format = statement->rsr_format;
+
+	if (!format || !statement->rsr_cursor)
+		return;
+
+	LocalStatus ls;
+	CheckStatusWrapper status_vector(&ls);
+
+	RefPtr<IMessageMetadata> metadata(REF_NO_INCR, statement->rsr_cursor->getMetadata(&status_vector));
+	if (status_vector.getState() & IStatus::STATE_ERRORS)
+		return;
+
+	const unsigned count = metadata->getCount(&status_vector);
+	if (count * 2 != format->fmt_desc.getCount())
+		return;
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		const dsc& desc = format->fmt_desc[i * 2];
+
+		if ((desc.dsc_dtype == dtype_quad || desc.dsc_dtype == dtype_blob) &&
+			metadata->getType(&status_vector, i) == SQL_BLOB)
+		{
+			fields.add(i * 2);
+		}
+	}
+}
+
+
 static bool get_next_msg_no(Rrq* request, USHORT incarnation, USHORT * msg_number)
 {
 /**************************************
@@ -5900,6 +5994,152 @@ static void send_error(rem_port* port, PACKET* apacket, const Firebird::Arg::Sta
 }
 
 
+static void send_inline_blobs(rem_port* port, Rsr* statement, const Array<USHORT>& fields,
+	ULONG limit, const UCHAR* message)
+{
+/**************************************
+ *
+ *	s e n d _ i n l i n e _ b l o b s
+ *
+ **************************************
+ *
+ * Functional description
+ *	Send the contents of the small blobs referenced by
+ *	the fetched row ahead of the row itself, so the client
+ *	could read them without extra round trips. Blobs that
+ *	can't be sent are silently skipped, the client reads
+ *	them the usual way.
+ *
+ **************************************/
+	static const UCHAR info_items[] =
+	{
+		isc_info_blob_num_segments,
+		isc_info_blob_max_segment,
+		isc_info_blob_total_length,
+		isc_info_blob_type,
+		isc_info_end
+	};
+
+	Rtr* const transaction = statement->rsr_rtr;
+	const rem_fmt* const format = statement->rsr_format;
+
+	UCHAR info[64];
+	HalfStaticArray<UCHAR, BLOB_LENGTH> data;
+	PACKET packet;
+
+	for (const USHORT* field = fields.begin(); field != fields.end(); ++field)
+	{
+		const dsc* const desc = &format->fmt_desc[*field];
+		const SSHORT* const flag = (const SSHORT*) (message + (IPTR) desc[1].dsc_address);
+
+		if (*flag)
+			continue;
+
+		ISC_QUAD id;
+		memcpy(&id, message + (IPTR) desc->dsc_address, sizeof(id));
+
+		if (!id.gds_quad_high && !id.gds_quad_low)
+			continue;
+
+		LocalStatus ls;
+		CheckStatusWrapper status_vector(&ls);
+
+		ServBlob blob(REF_NO_INCR, statement->rsr_rdb->rdb_iface->openBlob(&status_vector,
+			transaction->rtr_iface, &id, 0, NULL));
+
+		if (status_vector.getState() & IStatus::STATE_ERRORS)
+			continue;
+
+		blob->getInfo(&status_vector, sizeof(info_items), info_items, sizeof(info), info);
+
+		if (status_vector.getState() & IStatus::STATE_ERRORS)
+		{
+			blob->cancel(&status_vector);
+			continue;
+		}
+
+		// Every segment is sent prefixed by its length, the same way op_get_segment does
+
+		SLONG segments = -1, total_length = -1;
+		const UCHAR* p = info;
+
+		for (const UCHAR* const end = info + sizeof(info); p + 3 <= end && *p != isc_info_end;)
+		{
+			const UCHAR item = *p++;
+			const USHORT length = (USHORT) gds__vax_integer(p, 2);
+			p += 2;
+
+			if (p + length > end)
+				break;
+
+			if (item == isc_info_blob_num_segments)
+				segments = gds__vax_integer(p, length);
+			else if (item == isc_info_blob_total_length)
+				total_length = gds__vax_integer(p, length);
+
+			p += length;
+		}
+
+		const ULONG info_length = (ULONG) (p - info);
+
+		if (segments < 0 || total_length < 0 ||
+			(FB_UINT64) total_length + (FB_UINT64) segments * 2 > limit)
+		{
+			blob->close(&status_vector);
+			continue;
+		}
+
+		UCHAR* const buffer = data.getBuffer(total_length + segments * 2);
+		UCHAR* ptr = buffer;
+		ULONG space = data.getCount();
+		int state = IStatus::RESULT_OK;
+
+		while (space > 2)
+		{
+			unsigned length;
+			state = blob->getSegment(&status_vector, space - 2, ptr + 2, &length);
+
+			if (state != IStatus::RESULT_OK && state != IStatus::RESULT_SEGMENT)
+				break;
+
+			ptr[0] = (UCHAR) length;
+			ptr[1] = (UCHAR) (length >> 8);
+			ptr += length + 2;
+			space -= length + 2;
+		}
+
+		// Make sure the whole blob was read
+
+		if (state == IStatus::RESULT_OK && space <= 2)
+		{
+			unsigned length;
+			UCHAR byte;
+			state = blob->getSegment(&status_vector, sizeof(byte), &byte, &length);
+		}
+
+		if (state != IStatus::RESULT_NO_DATA)
+		{
+			blob->close(&status_vector);
+			continue;
+		}
+
+		blob->close(&status_vector);
+
+		packet.p_operation = op_inline_blob;
+		P_INLINE_BLOB* const inline_blob = &packet.p_inline_blob;
+		inline_blob->p_inline_blob_transaction = transaction->rtr_id;
+		inline_blob->p_inline_blob_id = id;
+		inline_blob->p_inline_blob_info.cstr_length = info_length;
+		inline_blob->p_inline_blob_info.cstr_address = info;
+		inline_blob->p_inline_blob_data.cstr_length = (ULONG) (ptr - buffer);
+		inline_blob->p_inline_blob_data.cstr_address = buffer;
+
+		if (!port->send_partial(&packet))
+			break;
+	}
+}
+
+
 static void attach_service(rem_port* port, P_ATCH* attach, PACKET* sendL)
 {
 	WIRECRYPT_DEBUG(fprintf(stderr, "Line encryption %sabled on attach svc\n", port->port_crypt_complete ? "en" : "dis"));
@@ -6436,14 +6676,10 @@ static THREAD_ENTRY_DECLARE loopThread(THREAD_ENTRY_PARAM)
 	{
 		MutexEnsureUnlock reqQueGuard(request_que_mutex, FB_FUNCTION);
 		reqQueGuard.enter();
-		server_req_t* request = request_que;
+		server_req_t* request = dequeue_request();
 		if (request)
 		{
 			worker.setState(true);
-
-			REMOTE_TRACE(("Dequeue request %p", request_que));
-			request_que = request->req_next;
-			ports_pending--;
 			reqQueGuard.leave();
 
 			while (request)
@@ -6455,19 +6691,20 @@ static THREAD_ENTRY_DECLARE loopThread(THREAD_ENTRY_PARAM)
 				if (request->req_port->port_server_flags & SRVR_thread_per_port)
 				{
 					port = request->req_port;
+					{ // scope
+						MutexLockGuard queGuard(request_que_mutex, FB_FUNCTION);
+						port_requests->remove(port);
+					}
 					free_request(request);
 
 					SRVR_main(port, port->port_server_flags);
 					request = 0;
 					continue;
 				}
-				// Splice request into list of active requests, execute request,
-				// and unsplice
+				// Mark request as active, execute request, and unmark
 
 				{ // scope
 					MutexLockGuard queGuard(request_que_mutex, FB_FUNCTION);
-					request->req_next = active_requests;
-					active_requests = request;
 					ports_active++;
 				}
 
@@ -6533,18 +6770,11 @@ static THREAD_ENTRY_DECLARE loopThread(THREAD_ENTRY_PARAM)
 				{ // request_que_mutex scope
 					MutexLockGuard queGuard(request_que_mutex, FB_FUNCTION);
 
-					// Take request out of list of active requests
+					// Take request out of active requests. If there are chained
+					// requests, the first of them becomes the port's request below.
 
-					for (server_req_t** req_ptr = &active_requests; *req_ptr;
-						req_ptr = &(*req_ptr)->req_next)
-					{
-						if (*req_ptr == request)
-						{
-							*req_ptr = request->req_next;
-							ports_active--;
-							break;
-						}
-					}
+					ports_active--;
+					port_requests->remove(request->req_port);
 
 					// If this is a explicit or implicit disconnect, get rid of
 					// any chained requests
@@ -6586,10 +6816,9 @@ static THREAD_ENTRY_DECLARE loopThread(THREAD_ENTRY_PARAM)
 						// head of the queue
 						if (next)
 						{
-							append_request_next(next, &request_que);
-							request = request_que;
-							request_que = request->req_next;
-							ports_pending--;
+							port_requests->put(next->req_port, next);
+							append_request_next(next);
+							request = dequeue_request();
 						}
 						else {
 							request = NULL;
@@ -6840,11 +7069,6 @@ bool Worker::wakeUp()
 	for (server_req_t* req = request_que; req; req = req->req_next)
 		cnt++;
 	fb_assert(cnt == ports_pending);
-
-	cnt = 0;
-	for (server_req_t* req = active_requests; req; req = req->req_next)
-		cnt++;
-	fb_assert(cnt == ports_active);
 #endif
 
 	if (!ports_pending)
@@ -410,6 +410,7 @@ const SvcSwitches backupOptions[] =
 	{"bkp_keyname", putStringArgument, 0, isc_spb_bkp_keyname, 0 },
 	{"bkp_crypt", putStringArgument, 0, isc_spb_bkp_crypt, 0 },
 	{"bkp_zip", putOption, 0, isc_spb_bkp_zip, 0 },
+	{"bkp_parallel_workers", putIntArgument, 0, isc_spb_bkp_parallel_workers, 0},
 	{0, 0, 0, 0, 0}
 };
 
@@ -420,6 +421,7 @@ const SvcSwitches restoreOptions[] =
 	{"res_length", putIntArgument, 0, isc_spb_res_length, 0},
 	{"verbose", putSingleTag, 0, isc_spb_verbose, 0},
 	{"res_buffers", putIntArgument, 0, isc_spb_res_buffers, 0},
+	{"res_parallel_workers", putIntArgument, 0, isc_spb_res_parallel_workers, 0},
 	{"res_page_size", putIntArgument, 0, isc_spb_res_page_size, 0},
 	{"res_access_mode", putAccessMode, 0, isc_spb_res_access_mode, 0},
 	{"res_deactivate_idx", putOption, 0, isc_spb_res_deactivate_idx, 0},
@@ -471,6 +473,7 @@ const SvcSwitches repairOptions[] =
 	{"rpr_commit_trans", putIntArgument, 0, isc_spb_rpr_commit_trans, 0},
 	{"rpr_rollback_trans", putIntArgument, 0, isc_spb_rpr_rollback_trans, 0},
 	{"rpr_recover_two_phase", putIntArgument, 0, isc_spb_rpr_recover_two_phase, 0},
+	{"rpr_par_workers", putIntArgument, 0, isc_spb_rpr_par_workers, 0},
 	{"rpr_commit_trans_64", putBigIntArgument, 0, isc_spb_rpr_commit_trans_64, 0},
 	{"rpr_rollback_trans_64", putBigIntArgument, 0, isc_spb_rpr_rollback_trans_64, 0},
 	{"rpr_recover_two_phase_64", putBigIntArgument, 0, isc_spb_rpr_recover_two_phase_64, 0},
@@ -509,6 +509,36 @@ void TracePluginImpl::appendGlobalCounts(const PerformanceInfo* info)
 		record.append(temp);
 	}
 
+	if ((cnt = info->pin_counters[RuntimeStatistics::SORT_PARALLEL_RUNS]) != 0)
+	{
+		temp.printf(", %" QUADFORMAT"d parallel sort run(s) in %" QUADFORMAT"d ms", cnt,
+			info->pin_counters[RuntimeStatistics::SORT_PARALLEL_TIME]);
+		record.append(temp);
+	}
+
+	static const struct
+	{
+		RuntimeStatistics::StatType type;
+		const char* name;
+	} waits[] =
+	{
+		{RuntimeStatistics::LATCH_WAITS, "latch"},
+		{RuntimeStatistics::LOCK_WAITS, "lock"},
+		{RuntimeStatistics::READ_WAITS, "read"},
+		{RuntimeStatistics::WRITE_WAITS, "write"},
+		{RuntimeStatistics::TEMP_WAITS, "temp"}
+	};
+
+	for (int i = 0; i < FB_NELEM(waits); i++)
+	{
+		if ((cnt = info->pin_counters[waits[i].type]) != 0)
+		{
+			temp.printf(", %" QUADFORMAT"d %s wait(s) in %" QUADFORMAT"d us", cnt, waits[i].name,
+				info->pin_counters[waits[i].type + 1]);
+			record.append(temp);
+		}
+	}
+
 	record.append(NEWLINE);
 }
 